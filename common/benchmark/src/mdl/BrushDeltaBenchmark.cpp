@@ -0,0 +1,129 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "mdl/Brush.h"
+#include "mdl/BrushBuilder.h"
+#include "mdl/BrushDelta.h"
+#include "mdl/BrushGeometry.h"
+#include "mdl/CircleShape.h"
+#include "mdl/MapFormat.h"
+
+#include "kdl/result.h"
+
+#include "vm/bbox.h"
+#include "vm/vec.h"
+
+#include <fmt/format.h>
+
+#include <vector>
+
+namespace tb::mdl
+{
+namespace
+{
+
+constexpr size_t NumDragSteps = 100;
+
+/**
+ * Estimates the memory needed to store a copy of the given brush, not counting the heap
+ * allocations made by the face attributes.
+ */
+size_t estimateSnapshotSize(const Brush& brush)
+{
+  return sizeof(Brush)
+         + brush.faceCount() * (sizeof(BrushFace) + sizeof(BrushFaceGeometry))
+         + brush.vertexCount() * sizeof(BrushVertex)
+         + brush.edgeCount() * (sizeof(BrushEdge) + 2 * sizeof(BrushHalfEdge));
+}
+
+size_t estimateDeltaSize(const BrushDelta& delta)
+{
+  return sizeof(BrushDelta) + delta.faceCount() * (sizeof(size_t) + sizeof(BrushFace))
+         + delta.vertexCount() * sizeof(vm::vec3d);
+}
+
+} // namespace
+
+TEST_CASE("BrushDeltaBenchmark.benchVertexDrag")
+{
+  const auto worldBounds = vm::bbox3d{8192.0};
+  auto builder = BrushBuilder{MapFormat::Valve, worldBounds};
+
+  // drag a vertex on the rim of a cylinder upwards, one grid unit per step
+  auto brushes = std::vector<Brush>{
+    builder.createCylinder(
+      vm::bbox3d{{-64, -64, -64}, {64, 64, 64}},
+      EdgeAlignedCircle{16},
+      vm::axis::z,
+      "material")
+    | kdl::value()};
+
+  auto vertexPosition = brushes.front().vertexPositions().front();
+  for (size_t i = 0; i < NumDragSteps; ++i)
+  {
+    auto brush = brushes.back();
+    REQUIRE(brush.moveVertices(worldBounds, {vertexPosition}, vm::vec3d{0, 0, 1})
+              .is_success());
+
+    // the moved vertex is recomputed from the brush faces and may be off by a bit
+    vertexPosition = brush.findClosestVertexPosition(vertexPosition + vm::vec3d{0, 0, 1});
+    brushes.push_back(std::move(brush));
+  }
+
+  auto deltas = std::vector<BrushDelta>{};
+  deltas.reserve(NumDragSteps);
+  timeLambda(
+    [&]() {
+      for (size_t i = 1; i < brushes.size(); ++i)
+      {
+        deltas.emplace_back(brushes[i - 1], brushes[i]);
+      }
+    },
+    fmt::format("compute {} brush deltas", NumDragSteps));
+
+  timeLambda(
+    [&]() {
+      for (size_t i = deltas.size(); i > 0; --i)
+      {
+        CHECK((deltas[i - 1].revert(worldBounds, brushes[i]) | kdl::value())
+              == brushes[i - 1]);
+      }
+    },
+    fmt::format("revert {} brush deltas", NumDragSteps));
+
+  auto snapshotSize = size_t(0);
+  auto deltaSize = size_t(0);
+  for (size_t i = 0; i < deltas.size(); ++i)
+  {
+    snapshotSize += estimateSnapshotSize(brushes[i]);
+    deltaSize += estimateDeltaSize(deltas[i]);
+  }
+
+  fmt::print(
+    "brush with {} faces: {} bytes per vertex move for snapshots, {} bytes for deltas\n",
+    brushes.back().faceCount(),
+    snapshotSize / NumDragSteps,
+    deltaSize / NumDragSteps);
+
+  CHECK(deltaSize < snapshotSize);
+}
+
+} // namespace tb::mdl
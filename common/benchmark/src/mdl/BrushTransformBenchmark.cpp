@@ -0,0 +1,167 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "mdl/Brush.h"
+#include "mdl/BrushBuilder.h"
+#include "mdl/BrushFace.h"
+#include "mdl/CircleShape.h"
+#include "mdl/MapFormat.h"
+
+#include "kdl/result.h"
+
+#include "vm/bbox.h"
+#include "vm/mat.h"
+#include "vm/mat_ext.h"
+#include "vm/scalar.h"
+#include "vm/vec.h"
+
+#include <fmt/format.h>
+
+#include <vector>
+
+namespace tb::mdl
+{
+namespace
+{
+
+constexpr size_t NumBrushes = 20000;
+constexpr size_t NumDragSteps = 10;
+
+std::vector<Brush> makeBrushes(const vm::bbox3d& worldBounds)
+{
+  auto builder = BrushBuilder{MapFormat::Valve, worldBounds};
+  const auto cuboid =
+    builder.createCuboid(vm::bbox3d{{0, 0, 0}, {32, 32, 32}}, "material") | kdl::value();
+  const auto cylinder = builder.createCylinder(
+                          vm::bbox3d{{0, 0, 0}, {32, 32, 32}},
+                          EdgeAlignedCircle{8},
+                          vm::axis::z,
+                          "material")
+                        | kdl::value();
+
+  // lay out the brushes on a grid so that they stay within the world bounds
+  auto result = std::vector<Brush>{};
+  result.reserve(NumBrushes);
+  for (size_t i = 0; i < NumBrushes; ++i)
+  {
+    const auto x = double(i % 100) * 64.0 - 3200.0;
+    const auto y = double(i / 100) * 64.0 - 6400.0;
+
+    auto brush = i % 2 == 0 ? cuboid : cylinder;
+    REQUIRE(brush.transform(worldBounds, vm::translation_matrix(vm::vec3d{x, y, 0}), true)
+              .is_success());
+    result.push_back(std::move(brush));
+  }
+  return result;
+}
+
+// Returns the number of brushes that could not be transformed. The caller checks it
+// after timing so that the assertions are not part of the measurement.
+size_t transformBrushes(
+  const vm::bbox3d& worldBounds,
+  std::vector<Brush>& brushes,
+  const vm::mat4x4d& transformation)
+{
+  auto failures = size_t(0);
+  for (auto& brush : brushes)
+  {
+    if (!brush.transform(worldBounds, transformation, true).is_success())
+    {
+      ++failures;
+    }
+  }
+  return failures;
+}
+
+// Transforms the faces and builds new geometry from the transformed faces, which is what
+// Brush::transform must do for transformations that are not rigid.
+void rebuildBrushes(
+  const vm::bbox3d& worldBounds,
+  std::vector<Brush>& brushes,
+  const vm::mat4x4d& transformation)
+{
+  for (auto& brush : brushes)
+  {
+    for (size_t i = 0; i < brush.faceCount(); ++i)
+    {
+      REQUIRE(brush.face(i).transform(transformation, true).is_success());
+    }
+    brush = Brush::create(worldBounds, brush.faces()) | kdl::value();
+  }
+}
+
+} // namespace
+
+TEST_CASE("BrushTransformBenchmark.benchTranslation")
+{
+  const auto worldBounds = vm::bbox3d{8192.0};
+  const auto translation = vm::translation_matrix(vm::vec3d{16, 0, 0});
+
+  auto brushes = makeBrushes(worldBounds);
+  auto failures = size_t(0);
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < NumDragSteps; ++i)
+      {
+        failures += transformBrushes(worldBounds, brushes, translation);
+      }
+    },
+    fmt::format("translate {} brushes {} times", NumBrushes, NumDragSteps));
+  REQUIRE(failures == 0u);
+
+  auto rebuiltBrushes = makeBrushes(worldBounds);
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < NumDragSteps; ++i)
+      {
+        rebuildBrushes(worldBounds, rebuiltBrushes, translation);
+      }
+    },
+    fmt::format(
+      "translate {} brushes {} times by rebuilding their geometry",
+      NumBrushes,
+      NumDragSteps));
+
+  CHECK(brushes == rebuiltBrushes);
+}
+
+TEST_CASE("BrushTransformBenchmark.benchRotation")
+{
+  const auto worldBounds = vm::bbox3d{8192.0};
+  const auto rotation = vm::rotation_matrix(vm::vec3d{0, 0, 1}, vm::to_radians(90.0));
+
+  auto brushes = makeBrushes(worldBounds);
+  auto failures = size_t(0);
+  timeLambda(
+    [&]() { failures = transformBrushes(worldBounds, brushes, rotation); },
+    fmt::format("rotate {} brushes by 90 degrees", NumBrushes));
+  REQUIRE(failures == 0u);
+
+  auto rebuiltBrushes = makeBrushes(worldBounds);
+  timeLambda(
+    [&]() { rebuildBrushes(worldBounds, rebuiltBrushes, rotation); },
+    fmt::format(
+      "rotate {} brushes by 90 degrees by rebuilding their geometry", NumBrushes));
+
+  CHECK(brushes == rebuiltBrushes);
+}
+
+} // namespace tb::mdl
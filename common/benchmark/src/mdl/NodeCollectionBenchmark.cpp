@@ -0,0 +1,143 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "mdl/Entity.h"
+#include "mdl/EntityNode.h"
+#include "mdl/ModelUtils.h"
+#include "mdl/NodeCollection.h"
+
+#include "vm/bbox.h"
+
+#include <fmt/format.h>
+
+#include <memory>
+#include <vector>
+
+namespace tb::mdl
+{
+namespace
+{
+
+constexpr size_t NumNodes = 300'000;
+constexpr size_t NumDragSteps = 100;
+
+std::vector<std::unique_ptr<EntityNode>> makeEntityNodes()
+{
+  auto result = std::vector<std::unique_ptr<EntityNode>>{};
+  result.reserve(NumNodes);
+  for (size_t i = 0; i < NumNodes; ++i)
+  {
+    const auto origin = fmt::format("{} {} 0", int(i % 512) * 16, int(i / 512) * 16);
+    result.push_back(
+      std::make_unique<EntityNode>(Entity{{{"classname", "light"}, {"origin", origin}}}));
+  }
+  return result;
+}
+
+} // namespace
+
+TEST_CASE("NodeCollectionBenchmark.benchSelection")
+{
+  const auto entityNodes = makeEntityNodes();
+
+  auto allNodes = std::vector<Node*>{};
+  auto evenNodes = std::vector<Node*>{};
+  auto oddNodes = std::vector<Node*>{};
+  for (size_t i = 0; i < entityNodes.size(); ++i)
+  {
+    allNodes.push_back(entityNodes[i].get());
+    (i % 2 == 0 ? evenNodes : oddNodes).push_back(entityNodes[i].get());
+  }
+
+  auto selectedNodes = NodeCollection{};
+  auto selectionBounds = vm::bbox3d{};
+
+  timeLambda(
+    [&]() {
+      selectedNodes.addNodes(allNodes);
+      selectionBounds = computeLogicalBounds(selectedNodes.nodes());
+    },
+    fmt::format("select all {} nodes", NumNodes));
+  CHECK(selectedNodes.nodeCount() == NumNodes);
+
+  timeLambda(
+    [&]() { selectedNodes.removeNodes(oddNodes); },
+    fmt::format("deselect {} of {} nodes", oddNodes.size(), NumNodes));
+  CHECK(selectedNodes.nodeCount() == evenNodes.size());
+
+  timeLambda(
+    [&]() {
+      selectedNodes.removeNodes(evenNodes);
+      selectedNodes.addNodes(oddNodes);
+      selectionBounds = computeLogicalBounds(selectedNodes.nodes());
+    },
+    fmt::format("select inverse of {} nodes", NumNodes));
+  CHECK(selectedNodes.nodes() == oddNodes);
+
+  // simulate a drag selection that adds a few nodes to a large selection in each step
+  const auto nodesPerStep = evenNodes.size() / NumDragSteps;
+  const auto dragStep = [&](const size_t i) {
+    return std::vector<Node*>{
+      std::next(evenNodes.begin(), long(i * nodesPerStep)),
+      std::next(evenNodes.begin(), long((i + 1) * nodesPerStep))};
+  };
+
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < NumDragSteps; ++i)
+      {
+        const auto nodes = dragStep(i);
+        selectedNodes.addNodes(nodes);
+        selectionBounds = vm::merge(selectionBounds, computeLogicalBounds(nodes));
+      }
+    },
+    fmt::format(
+      "drag select {} nodes in {} steps, extending bounds",
+      NumDragSteps * nodesPerStep,
+      NumDragSteps));
+  CHECK(selectionBounds == computeLogicalBounds(selectedNodes.nodes()));
+
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < NumDragSteps; ++i)
+      {
+        selectedNodes.removeNodes(dragStep(i));
+      }
+    },
+    fmt::format(
+      "drag deselect {} nodes in {} steps", NumDragSteps * nodesPerStep, NumDragSteps));
+  CHECK(selectedNodes.nodes() == oddNodes);
+
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < NumDragSteps; ++i)
+      {
+        selectedNodes.addNodes(dragStep(i));
+        selectionBounds = computeLogicalBounds(selectedNodes.nodes());
+      }
+    },
+    fmt::format(
+      "drag select {} nodes in {} steps, recomputing bounds",
+      NumDragSteps * nodesPerStep,
+      NumDragSteps));
+}
+
+} // namespace tb::mdl
@@ -0,0 +1,197 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "mdl/BrushBuilder.h"
+#include "mdl/BrushNode.h"
+#include "mdl/EditorContext.h"
+#include "mdl/EntityNode.h"
+#include "mdl/Group.h"
+#include "mdl/GroupNode.h"
+#include "mdl/Layer.h"
+#include "mdl/LayerNode.h"
+#include "mdl/MapFormat.h"
+#include "mdl/ModelUtils.h"
+#include "mdl/ParallelTraversal.h"
+#include "mdl/PatchNode.h"
+#include "mdl/TagManager.h"
+#include "mdl/TagMatcher.h"
+#include "mdl/WorldNode.h"
+
+#include "kdl/overload.h"
+#include "kdl/result.h"
+#include "kdl/task_manager.h"
+
+#include <fmt/format.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace tb::mdl
+{
+namespace
+{
+
+constexpr size_t NumLayers = 8;
+constexpr size_t NumGroupsPerLayer = 64;
+constexpr size_t NumBrushesPerGroup = 256;
+
+std::vector<SmartTag> makeSmartTags()
+{
+  return {
+    SmartTag{"clip", {}, std::make_unique<MaterialNameTagMatcher>("*clip*")},
+    SmartTag{"skip", {}, std::make_unique<MaterialNameTagMatcher>("*skip*")},
+    SmartTag{"detail", {}, std::make_unique<ContentFlagsTagMatcher>(1 << 27)},
+    SmartTag{
+      "translucent", {}, std::make_unique<SurfaceFlagsTagMatcher>((1 << 4) | (1 << 5))},
+  };
+}
+
+std::unique_ptr<WorldNode> makeWorld(const bool grouped = true)
+{
+  const auto worldBounds = vm::bbox3d{8192.0};
+  const auto builder = BrushBuilder{MapFormat::Quake2, worldBounds};
+
+  auto worldNode =
+    std::make_unique<WorldNode>(EntityPropertyConfig{}, Entity{}, MapFormat::Quake2);
+  for (size_t i = 0; i < NumLayers; ++i)
+  {
+    auto* layerNode = new LayerNode{Layer{fmt::format("layer {}", i)}};
+    worldNode->addChild(layerNode);
+
+    for (size_t j = 0; j < NumGroupsPerLayer; ++j)
+    {
+      Node* parentNode = layerNode;
+      if (grouped)
+      {
+        parentNode = new GroupNode{Group{fmt::format("group {}", j)}};
+        layerNode->addChild(parentNode);
+      }
+
+      for (size_t k = 0; k < NumBrushesPerGroup; ++k)
+      {
+        const auto materialName = fmt::format("material{}", k);
+        parentNode->addChild(
+          new BrushNode{builder.createCube(64.0, materialName) | kdl::value()});
+      }
+    }
+  }
+  return worldNode;
+}
+
+} // namespace
+
+TEST_CASE("ParallelTraversalBenchmark.benchUpdateTags")
+{
+  auto tagManager = TagManager{};
+  tagManager.registerSmartTags(makeSmartTags());
+
+  const auto worldNode = makeWorld();
+  const auto numBrushes = NumLayers * NumGroupsPerLayer * NumBrushesPerGroup;
+
+  const auto initializeTags = kdl::overload(
+    [](WorldNode*) {},
+    [](LayerNode*) {},
+    [](GroupNode*) {},
+    [](EntityNode*) {},
+    [&](BrushNode* brushNode) { brushNode->initializeTags(tagManager); },
+    [](PatchNode*) {});
+
+  timeLambda(
+    [&]() {
+      worldNode->accept(kdl::overload(
+        [](auto&& thisLambda, WorldNode* world) { world->visitChildren(thisLambda); },
+        [](auto&& thisLambda, LayerNode* layer) { layer->visitChildren(thisLambda); },
+        [](auto&& thisLambda, GroupNode* group) { group->visitChildren(thisLambda); },
+        [](auto&& thisLambda, EntityNode* entity) { entity->visitChildren(thisLambda); },
+        [&](BrushNode* brushNode) { brushNode->initializeTags(tagManager); },
+        [](PatchNode*) {}));
+    },
+    fmt::format("update tags of {} brushes serially", numBrushes));
+
+  for (const auto numThreads : {1u, 2u, 4u, 8u})
+  {
+    auto taskManager = kdl::task_manager{numThreads};
+    timeLambda(
+      [&]() { parallelVisitAll({worldNode.get()}, taskManager, initializeTags); },
+      fmt::format("update tags of {} brushes with {} threads", numBrushes, numThreads));
+  }
+
+  for (const auto numThreads : {1u, 2u, 4u, 8u})
+  {
+    auto taskManager = kdl::task_manager{numThreads};
+    auto faceCount = size_t(0);
+    timeLambda(
+      [&]() {
+        faceCount = parallelVisitAllAndReduce(
+          {worldNode.get()},
+          taskManager,
+          size_t(0),
+          kdl::overload(
+            [](size_t&, WorldNode*) {},
+            [](size_t&, LayerNode*) {},
+            [](size_t&, GroupNode*) {},
+            [](size_t&, EntityNode*) {},
+            [](size_t& count, BrushNode* brushNode) {
+              count += brushNode->brush().faceCount();
+            },
+            [](size_t&, PatchNode*) {}),
+          std::plus<size_t>{});
+      },
+      fmt::format("count faces of {} brushes with {} threads", numBrushes, numThreads));
+    CHECK(faceCount == numBrushes * 6);
+  }
+}
+
+TEST_CASE("ParallelTraversalBenchmark.benchCollectSelectableNodes")
+{
+  // without groups, every brush must be checked
+  const auto worldNode = makeWorld(false);
+  const auto numBrushes = NumLayers * NumGroupsPerLayer * NumBrushesPerGroup;
+
+  auto editorContext = EditorContext{};
+  const auto nodes = std::vector<Node*>{worldNode.get()};
+
+  // the editor context caches its results, so they are invalidated before each run
+  worldNode->invalidateCachedEditorStates();
+  auto expected = std::vector<Node*>{};
+  timeLambda(
+    [&]() { expected = collectSelectableNodes(nodes, editorContext); },
+    fmt::format("collect selectable nodes of {} brushes serially", numBrushes));
+  REQUIRE(expected.size() == numBrushes);
+
+  for (const auto numThreads : {1u, 2u, 4u, 8u})
+  {
+    auto taskManager = kdl::task_manager{numThreads};
+    auto actual = std::vector<Node*>{};
+
+    worldNode->invalidateCachedEditorStates();
+    timeLambda(
+      [&]() { actual = collectSelectableNodes(nodes, editorContext, taskManager); },
+      fmt::format(
+        "collect selectable nodes of {} brushes with {} threads",
+        numBrushes,
+        numThreads));
+    CHECK(actual == expected);
+  }
+}
+
+} // namespace tb::mdl
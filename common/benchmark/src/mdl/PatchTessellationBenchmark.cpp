@@ -0,0 +1,238 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "mdl/BezierPatch.h"
+#include "mdl/PatchGridCache.h"
+#include "mdl/PatchNode.h"
+
+#include "kdl/task_manager.h"
+
+#include <fmt/format.h>
+
+#include <cmath>
+#include <memory>
+#include <numbers>
+#include <vector>
+
+namespace tb::mdl
+{
+namespace
+{
+
+constexpr size_t NumPatches = 8192;
+
+using CP = BezierPatch::Point;
+
+/**
+ * Creates a mix of flat floor pieces, slightly bent terrain pieces, arches and cylinders
+ * of various sizes. All patches are offset along the X axis by the given offset so that
+ * patches created with different offsets do not share their grids.
+ */
+std::vector<BezierPatch> makePatches(const double offset)
+{
+  auto result = std::vector<BezierPatch>{};
+  result.reserve(NumPatches);
+
+  for (size_t i = 0; i < NumPatches; ++i)
+  {
+    const auto x = offset + double(i) * 512.0;
+    const auto size = 16.0 * double(1u << (i % 5u));
+
+    switch (i % 4u)
+    {
+    case 0: // flat floor
+      result.emplace_back(
+        3,
+        3,
+        std::vector<CP>{
+          {x, 0, 0, 0, 0},
+          {x + size, 0, 0, 0.5, 0},
+          {x + 2.0 * size, 0, 0, 1, 0},
+          {x, size, 0, 0, 0.5},
+          {x + size, size, 0, 0.5, 0.5},
+          {x + 2.0 * size, size, 0, 1, 0.5},
+          {x, 2.0 * size, 0, 0, 1},
+          {x + size, 2.0 * size, 0, 0.5, 1},
+          {x + 2.0 * size, 2.0 * size, 0, 1, 1}},
+        "floor");
+      break;
+    case 1: // terrain with a small bump
+      result.emplace_back(
+        3,
+        3,
+        std::vector<CP>{
+          {x, 0, 0, 0, 0},
+          {x + size, 0, 0, 0.5, 0},
+          {x + 2.0 * size, 0, 0, 1, 0},
+          {x, size, 0, 0, 0.5},
+          {x + size, size, 2, 0.5, 0.5},
+          {x + 2.0 * size, size, 0, 1, 0.5},
+          {x, 2.0 * size, 0, 0, 1},
+          {x + size, 2.0 * size, 0, 0.5, 1},
+          {x + 2.0 * size, 2.0 * size, 0, 1, 1}},
+        "terrain");
+      break;
+    case 2: // half cylinder arch made of two quarter circles
+    case 3: // full cylinder made of four quarter circles
+    {
+      const auto quarters = i % 4u == 2u ? size_t(2) : size_t(4);
+      const auto rowCount = 2u * quarters + 1u;
+
+      auto controlPoints = std::vector<CP>{};
+      for (size_t row = 0; row < rowCount; ++row)
+      {
+        // even rows lie on the circle, odd rows on the corners of the enclosing square
+        const auto angle = std::numbers::pi / 4.0 * double(row);
+        const auto radius = row % 2u == 0u ? size : size * std::numbers::sqrt2;
+        const auto v = double(row) / double(rowCount - 1u);
+        for (size_t col = 0; col < 3; ++col)
+        {
+          controlPoints.emplace_back(
+            x + radius * std::cos(angle),
+            radius * std::sin(angle),
+            double(col) * 64.0,
+            double(col) / 2.0,
+            v);
+        }
+      }
+      result.emplace_back(rowCount, 3, std::move(controlPoints), "cylinder");
+      break;
+    }
+    }
+  }
+
+  return result;
+}
+
+size_t countTriangles(const PatchGrid& grid)
+{
+  return 2u * grid.quadRowCount() * grid.quadColumnCount();
+}
+
+} // namespace
+
+TEST_CASE("PatchTessellationBenchmark.benchAdaptiveTessellation")
+{
+  const auto patches = makePatches(0.0);
+
+  auto fixedGrids = std::vector<PatchGrid>{};
+  fixedGrids.reserve(patches.size());
+  timeLambda(
+    [&]() {
+      for (const auto& patch : patches)
+      {
+        fixedGrids.push_back(makePatchGrid(patch, 3u));
+      }
+    },
+    fmt::format("tessellate {} patches with 3 subdivisions", patches.size()));
+
+  auto adaptiveGrids = std::vector<PatchGrid>{};
+  adaptiveGrids.reserve(patches.size());
+  timeLambda(
+    [&]() {
+      for (const auto& patch : patches)
+      {
+        adaptiveGrids.push_back(
+          makePatchGrid(patch, computeSubdivisionsPerSurface(patch)));
+      }
+    },
+    fmt::format("tessellate {} patches adaptively", patches.size()));
+
+  auto fixedTriangles = size_t(0);
+  for (const auto& grid : fixedGrids)
+  {
+    fixedTriangles += countTriangles(grid);
+  }
+
+  auto adaptiveTriangles = size_t(0);
+  for (const auto& grid : adaptiveGrids)
+  {
+    adaptiveTriangles += countTriangles(grid);
+  }
+
+  fmt::print(
+    "{} triangles with 3 subdivisions, {} triangles with adaptive subdivisions ({:.1f}% "
+    "fewer)\n",
+    fixedTriangles,
+    adaptiveTriangles,
+    100.0 * (1.0 - double(adaptiveTriangles) / double(fixedTriangles)));
+
+  CHECK(adaptiveTriangles <= fixedTriangles);
+}
+
+TEST_CASE("PatchTessellationBenchmark.benchCachedTessellation")
+{
+  auto taskManager = kdl::task_manager{};
+  auto cache = PatchGridCache{};
+
+  const auto patches = makePatches(1'000'000.0);
+  const auto patchPtrs = [&]() {
+    auto result = std::vector<const BezierPatch*>{};
+    for (const auto& patch : patches)
+    {
+      result.push_back(&patch);
+    }
+    return result;
+  }();
+
+  auto grids = std::vector<std::shared_ptr<const PatchGrid>>{};
+  timeLambda(
+    [&]() {
+      for (const auto& patch : patches)
+      {
+        grids.push_back(cache.get(patch));
+      }
+    },
+    fmt::format("tessellate {} patches serially", patches.size()));
+
+  // simulates linked groups or undo, all grids are found in the cache
+  auto cachedGrids = std::vector<std::shared_ptr<const PatchGrid>>{};
+  timeLambda(
+    [&]() {
+      for (const auto& patch : patches)
+      {
+        cachedGrids.push_back(cache.get(patch));
+      }
+    },
+    fmt::format("tessellate {} cached patches serially", patches.size()));
+
+  CHECK(cachedGrids == grids);
+
+  const auto otherPatches = makePatches(2'000'000.0);
+  const auto otherPatchPtrs = [&]() {
+    auto result = std::vector<const BezierPatch*>{};
+    for (const auto& patch : otherPatches)
+    {
+      result.push_back(&patch);
+    }
+    return result;
+  }();
+
+  auto parallelGrids = std::vector<std::shared_ptr<const PatchGrid>>{};
+  timeLambda(
+    [&]() { parallelGrids = cache.get(otherPatchPtrs, taskManager); },
+    fmt::format("tessellate {} patches in parallel", otherPatches.size()));
+
+  CHECK(parallelGrids.size() == otherPatches.size());
+  CHECK(cache.get(patchPtrs, taskManager) == grids);
+}
+
+} // namespace tb::mdl
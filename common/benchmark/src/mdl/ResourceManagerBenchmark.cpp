@@ -0,0 +1,155 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "Result.h"
+#include "mdl/Resource.h"
+#include "mdl/ResourceManager.h"
+
+#include "kdl/reflection_impl.h"
+#include "kdl/task_manager.h"
+
+#include <fmt/format.h>
+
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace tb::mdl
+{
+namespace
+{
+
+constexpr size_t NumResources = 2048;
+constexpr size_t NumVisibleResources = 32;
+
+struct BenchmarkResource
+{
+  void upload(const bool) const {}
+  void drop(const bool) const {}
+
+  kdl_reflect_inline_empty(BenchmarkResource);
+};
+
+using BenchmarkResourceT = Resource<BenchmarkResource>;
+
+void loadResources(
+  const LoadPriority visibleLoadPriority, const std::optional<size_t> maxConcurrentLoads)
+{
+  using namespace std::chrono_literals;
+
+  auto taskManager = kdl::task_manager{};
+  auto resourceManager = ResourceManager{
+    maxConcurrentLoads.value_or(defaultMaxConcurrentLoads(taskManager.worker_count()))};
+
+  auto resources = std::vector<std::shared_ptr<BenchmarkResourceT>>{};
+  for (size_t i = 0; i < NumResources; ++i)
+  {
+    resources.push_back(resourceManager.addResource(std::make_shared<BenchmarkResourceT>(
+      []() {
+        // simulates reading and decoding a texture
+        std::this_thread::sleep_for(200us);
+        return Result<BenchmarkResource>{BenchmarkResource{}};
+      },
+      LoadPolicy::OnDemand)));
+  }
+
+  // all resources are used in the map, but the visible ones come last
+  for (auto& resource : resources)
+  {
+    resource->requestLoad();
+  }
+  for (size_t i = NumResources - NumVisibleResources; i < NumResources; ++i)
+  {
+    resources[i]->requestLoad(visibleLoadPriority);
+  }
+
+  const auto allReady = [&](const size_t first) {
+    return [&, first]() {
+      for (size_t i = first; i < NumResources; ++i)
+      {
+        if (!std::holds_alternative<ResourceReady<BenchmarkResource>>(
+              resources[i]->state()))
+        {
+          return false;
+        }
+      }
+      return true;
+    };
+  };
+
+  // the editor processes the resources on a timer that fires every 20ms
+  const auto processOnTimer = [&](const auto& isDone) {
+    while (!isDone())
+    {
+      const auto nextTick = std::chrono::steady_clock::now() + 20ms;
+      resourceManager.process(
+        [&](auto task) { return taskManager.run_task(std::move(task)); },
+        ProcessContext{false, [](auto, auto) {}},
+        20ms);
+      std::this_thread::sleep_until(nextTick);
+    }
+  };
+
+  const auto concurrency = maxConcurrentLoads ? fmt::format("{}", *maxConcurrentLoads)
+                                              : std::string{"default"};
+  timeLambda(
+    [&]() {
+      timeLambda(
+        [&]() { processOnTimer(allReady(NumResources - NumVisibleResources)); },
+        fmt::format(
+          "load {} visible of {} resources with {} priority and {} concurrent loads",
+          NumVisibleResources,
+          NumResources,
+          visibleLoadPriority == LoadPriority::High ? "high" : "normal",
+          concurrency));
+      processOnTimer(allReady(0));
+    },
+    fmt::format(
+      "load all {} resources with {} concurrent loads", NumResources, concurrency));
+
+  resources.clear();
+  while (resourceManager.needsProcessing())
+  {
+    resourceManager.process(
+      [&](auto task) { return taskManager.run_task(std::move(task)); },
+      ProcessContext{false, [](auto, auto) {}});
+  }
+}
+
+} // namespace
+
+TEST_CASE("ResourceManagerBenchmark.timeToVisibleResources")
+{
+  loadResources(LoadPriority::Normal, std::nullopt);
+  loadResources(LoadPriority::High, std::nullopt);
+}
+
+TEST_CASE("ResourceManagerBenchmark.totalLoadTime")
+{
+  // not limiting the number of concurrent loads is equivalent to submitting all loader
+  // tasks to the task manager at once
+  loadResources(LoadPriority::High, NumResources);
+  loadResources(LoadPriority::High, std::nullopt);
+}
+
+} // namespace tb::mdl
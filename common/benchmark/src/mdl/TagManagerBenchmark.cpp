@@ -0,0 +1,168 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "mdl/BrushBuilder.h"
+#include "mdl/BrushFace.h"
+#include "mdl/BrushNode.h"
+#include "mdl/MapFormat.h"
+#include "mdl/TagManager.h"
+#include "mdl/TagMatcher.h"
+
+#include "kdl/result.h"
+#include "kdl/task_manager.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <bit>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace tb::mdl
+{
+namespace
+{
+
+constexpr size_t NumBrushes = 1'000'000 / 6;
+constexpr size_t NumMaterials = 512;
+
+std::vector<SmartTag> makeSmartTags()
+{
+  return {
+    SmartTag{"caulk", {}, std::make_unique<MaterialNameTagMatcher>("*caulk*")},
+    SmartTag{"clip", {}, std::make_unique<MaterialNameTagMatcher>("*clip*")},
+    SmartTag{"hint", {}, std::make_unique<MaterialNameTagMatcher>("*hint*")},
+    SmartTag{"origin", {}, std::make_unique<MaterialNameTagMatcher>("*origin*")},
+    SmartTag{"skip", {}, std::make_unique<MaterialNameTagMatcher>("*skip*")},
+    SmartTag{"trigger", {}, std::make_unique<MaterialNameTagMatcher>("*trigger*")},
+    SmartTag{"detail", {}, std::make_unique<ContentFlagsTagMatcher>(1 << 27)},
+    SmartTag{
+      "translucent", {}, std::make_unique<SurfaceFlagsTagMatcher>((1 << 4) | (1 << 5))},
+  };
+}
+
+std::string materialName(const size_t i)
+{
+  static const auto prefixes = std::vector<std::string>{
+    "base_wall", "base_floor", "gothic_block", "common/clip", "common/caulk", "sfx"};
+  return fmt::format("textures/{}/material{}", prefixes[i % prefixes.size()], i);
+}
+
+std::vector<std::unique_ptr<BrushNode>> makeBrushNodes()
+{
+  const auto worldBounds = vm::bbox3d{8192.0};
+  const auto builder = BrushBuilder{MapFormat::Quake2, worldBounds};
+
+  auto result = std::vector<std::unique_ptr<BrushNode>>{};
+  result.reserve(NumBrushes);
+  for (size_t i = 0; i < NumBrushes; ++i)
+  {
+    result.push_back(std::make_unique<BrushNode>(
+      builder.createCube(
+        64.0,
+        materialName((i * 6 + 0) % NumMaterials),
+        materialName((i * 6 + 1) % NumMaterials),
+        materialName((i * 6 + 2) % NumMaterials),
+        materialName((i * 6 + 3) % NumMaterials),
+        materialName((i * 6 + 4) % NumMaterials),
+        materialName((i * 6 + 5) % NumMaterials))
+      | kdl::value()));
+  }
+  return result;
+}
+
+size_t countFaceTags(const std::vector<std::unique_ptr<BrushNode>>& brushNodes)
+{
+  auto result = size_t(0);
+  for (const auto& brushNode : brushNodes)
+  {
+    for (const auto& face : brushNode->brush().faces())
+    {
+      result += size_t(std::popcount(face.tagMask()));
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+TEST_CASE("TagManagerBenchmark.benchUpdateFaceTags")
+{
+  auto taskManager = kdl::task_manager{};
+
+  auto tagManager = TagManager{};
+  tagManager.registerSmartTags(makeSmartTags());
+
+  const auto brushNodes = makeBrushNodes();
+  const auto numFaces = brushNodes.size() * 6;
+
+  auto expectedFaceTags = size_t(0);
+  timeLambda(
+    [&]() {
+      for (const auto& brushNode : brushNodes)
+      {
+        for (const auto& face : brushNode->brush().faces())
+        {
+          for (const auto& tag : tagManager.smartTags())
+          {
+            expectedFaceTags += tag.matches(face) ? 1u : 0u;
+          }
+        }
+      }
+    },
+    fmt::format("evaluate all tag matchers for {} faces", numFaces));
+
+  timeLambda(
+    [&]() {
+      for (const auto& brushNode : brushNodes)
+      {
+        brushNode->initializeTags(tagManager);
+      }
+    },
+    fmt::format("update tags of {} faces with material tag cache", numFaces));
+  CHECK(countFaceTags(brushNodes) == expectedFaceTags);
+
+  timeLambda(
+    [&]() {
+      constexpr auto BrushesPerTask = size_t(1024);
+
+      auto tasks = std::vector<std::function<bool()>>{};
+      for (size_t first = 0; first < brushNodes.size(); first += BrushesPerTask)
+      {
+        tasks.emplace_back([&, first]() {
+          const auto last = std::min(first + BrushesPerTask, brushNodes.size());
+          for (auto i = first; i < last; ++i)
+          {
+            brushNodes[i]->initializeTags(tagManager);
+          }
+          return true;
+        });
+      }
+      taskManager.run_tasks_and_wait(tasks);
+    },
+    fmt::format(
+      "update tags of {} faces with material tag cache in parallel", numFaces));
+  CHECK(countFaceTags(brushNodes) == expectedFaceTags);
+}
+
+} // namespace tb::mdl
@@ -19,19 +19,29 @@
 
 #include "../../test/src/Catch2.h"
 #include "BenchmarkUtils.h"
+#include "io/NodeReader.h"
+#include "io/TestParserStatus.h"
 #include "mdl/BrushBuilder.h"
 #include "mdl/BrushFace.h"
 #include "mdl/BrushNode.h"
+#include "mdl/EntityProperties.h"
 #include "mdl/MapFormat.h"
 #include "mdl/Material.h"
+#include "mdl/NodeQueries.h"
 #include "mdl/Texture.h"
 #include "mdl/WorldNode.h"
+#include "render/BrushEdgeTable.h"
 #include "render/BrushRenderer.h"
 
 #include "kdl/result.h"
+#include "kdl/task_manager.h"
+#include "kdl/vector_utils.h"
 
 #include <fmt/format.h>
 
+#include <filesystem>
+#include <fstream>
+#include <sstream>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -90,6 +100,26 @@ auto makeBrushes()
   return std::tuple{std::move(result), std::move(materials)};
 }
 
+std::vector<mdl::Node*> readMap(
+  const std::filesystem::path& path,
+  const mdl::MapFormat mapFormat,
+  kdl::task_manager& taskManager)
+{
+  auto stream = std::ifstream{path};
+  auto str = std::stringstream{};
+  str << stream.rdbuf();
+
+  auto status = io::TestParserStatus{};
+  return io::NodeReader::read(
+           str.str(),
+           mapFormat,
+           vm::bbox3d{8192.0},
+           {},
+           status,
+           taskManager)
+         | kdl::value();
+}
+
 } // namespace
 
 TEST_CASE("BrushRendererBenchmark.benchBrushRenderer")
@@ -149,4 +179,190 @@ TEST_CASE("BrushRendererBenchmark.benchBrushRenderer")
     "validate remaining brushes");
 }
 
+TEST_CASE("BrushRendererBenchmark.benchFullInvalidation")
+{
+  auto [brushes, materials] = makeBrushes();
+
+  auto taskManager = kdl::task_manager{};
+  const auto parallel = GENERATE(false, true);
+  const auto mode = parallel ? "in parallel" : "serially";
+
+  BrushRenderer r;
+  if (parallel)
+  {
+    r.setTaskManager(taskManager);
+  }
+
+  for (const auto& brush : brushes)
+  {
+    r.addBrush(brush.get());
+  }
+  r.validate();
+
+  timeLambda(
+    [&]() {
+      r.invalidate();
+      r.validate();
+    },
+    fmt::format("invalidate and validate {} brushes {}", brushes.size(), mode));
+
+  timeLambda(
+    [&]() {
+      for (const auto& brush : brushes)
+      {
+        brush->invalidateVertexCache();
+      }
+      r.invalidate();
+      r.validate();
+    },
+    fmt::format(
+      "invalidate and validate {} brushes and their vertex caches {}",
+      brushes.size(),
+      mode));
+}
+
+TEST_CASE("BrushRendererBenchmark.benchCompactionAfterEditingSession")
+{
+  constexpr size_t NumEdits = 16;
+  constexpr size_t MaxMovedSizePerStep = 1 << 16;
+
+  auto [brushes, materials] = makeBrushes();
+
+  BrushRenderer r;
+  for (const auto& brush : brushes)
+  {
+    r.addBrush(brush.get());
+  }
+  r.validate();
+
+  // simulate a long editing session: in each edit, a scattered set of brushes is
+  // removed, and the brushes removed in the previous edit are added again, which leaves
+  // gaps in the VBOs
+  const auto editedBrushes = [&](const size_t edit) {
+    auto result = std::vector<const mdl::BrushNode*>{};
+    for (size_t i = (edit * 7) % NumEdits; i < brushes.size(); i += NumEdits)
+    {
+      result.push_back(brushes[i].get());
+    }
+    return result;
+  };
+
+  for (size_t edit = 0; edit < NumEdits; ++edit)
+  {
+    for (const auto* brush : editedBrushes(edit))
+    {
+      r.removeBrush(brush);
+    }
+    if (edit > 0)
+    {
+      for (const auto* brush : editedBrushes(edit - 1))
+      {
+        r.addBrush(brush);
+      }
+    }
+    if (!r.valid())
+    {
+      r.validate();
+    }
+  }
+
+  const auto printStats = [](const auto& stats) {
+    fmt::print(
+      "{} vertices in {} blocks, {} free blocks, largest free block {}, "
+      "fragmentation {:.2f}\n",
+      stats.usedSize,
+      stats.usedBlockCount,
+      stats.freeBlockCount,
+      stats.largestFreeBlock,
+      stats.fragmentation());
+  };
+  printStats(r.vertexFragmentationStats());
+
+  auto steps = size_t(0);
+  timeLambda(
+    [&]() {
+      while (r.compact(MaxMovedSizePerStep))
+      {
+        ++steps;
+      }
+    },
+    "compact VBOs after editing session");
+  fmt::print("compacted in {} steps of {} elements\n", steps, MaxMovedSizePerStep);
+  printStats(r.vertexFragmentationStats());
+
+  CHECK(r.vertexFragmentationStats().fragmentation() == 0.0);
+}
+
+TEST_CASE("BrushRendererBenchmark.benchVertexLayouts")
+{
+  auto [brushes, materials] = makeBrushes();
+
+  const auto layout = GENERATE(BrushVertexLayout::Full, BrushVertexLayout::Packed);
+  const auto layoutName = layout == BrushVertexLayout::Full ? "full" : "packed";
+
+  auto taskManager = kdl::task_manager{};
+
+  BrushRenderer r;
+  r.setTaskManager(taskManager);
+  r.setVertexLayout(layout);
+  for (const auto& brush : brushes)
+  {
+    r.addBrush(brush.get());
+  }
+
+  timeLambda(
+    [&]() { r.validate(); },
+    fmt::format("validate {} brushes with {} vertices", brushes.size(), layoutName));
+
+  const auto vertexBytes = r.vertexFragmentationStats().usedSize * r.vertexSize();
+  fmt::print(
+    "{} vertices: {} bytes per vertex, {} bytes per brush\n",
+    layoutName,
+    r.vertexSize(),
+    vertexBytes / brushes.size());
+}
+
+TEST_CASE("BrushRendererBenchmark.benchEdgeDeduplication")
+{
+  using MapAndFormat = std::tuple<std::string, mdl::MapFormat>;
+  const auto [mapPath, mapFormat] = GENERATE(values<MapAndFormat>({
+    {"fixture/test/io/Map/rtz_q1.map", mdl::MapFormat::Standard},
+    {"fixture/test/mdl/Brush/curvetut-crash.map", mdl::MapFormat::Valve},
+  }));
+
+  auto taskManager = kdl::task_manager{};
+  auto nodes = readMap(mapPath, mapFormat, taskManager);
+  const auto brushNodes = mdl::collectNodesAndDescendants(
+    nodes, [](const mdl::BrushNode*) { return true; });
+
+  BrushRenderer r;
+  r.setTaskManager(taskManager);
+  r.setDeduplicateEdges(true);
+  for (auto* node : brushNodes)
+  {
+    r.addBrush(static_cast<const mdl::BrushNode*>(node));
+  }
+
+  timeLambda(
+    [&]() { r.validate(); },
+    fmt::format("validate {} brushes with edge deduplication", brushNodes.size()));
+
+  const auto* edgeTable = r.edgeTable();
+  REQUIRE(edgeTable != nullptr);
+
+  const auto edges = edgeTable->referenceCount();
+  const auto uniqueEdges = edgeTable->edgeCount();
+  fmt::print(
+    "{}: {} edges, {} unique edges ({:.1f}% fewer line vertices)\n",
+    std::filesystem::path{mapPath}.filename().string(),
+    edges,
+    uniqueEdges,
+    edges > 0 ? 100.0 * double(edges - uniqueEdges) / double(edges) : 0.0);
+
+  CHECK(uniqueEdges <= edges);
+
+  r.clear();
+  kdl::vec_clear_and_delete(nodes);
+}
+
 } // namespace tb::render
@@ -0,0 +1,162 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "render/AttrString.h"
+#include "render/FontGlyph.h"
+#include "render/FontTexture.h"
+#include "render/TextureFont.h"
+
+#include <fmt/format.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace tb::render
+{
+namespace
+{
+
+constexpr size_t NumLabels = 5'000;
+constexpr size_t NumClassnames = 64;
+constexpr size_t NumFrames = 100;
+
+auto makeFont()
+{
+  constexpr auto FirstChar = static_cast<unsigned char>(' ');
+  constexpr auto CharCount = static_cast<unsigned char>(96);
+  constexpr auto CellSize = size_t(16);
+
+  auto glyphs = std::vector<FontGlyph>{};
+  for (size_t i = 0; i < CharCount; ++i)
+  {
+    glyphs.emplace_back((i % 10) * CellSize, (i / 10) * CellSize, 8, 14, 9);
+  }
+
+  return std::make_unique<TextureFont>(
+    std::make_unique<FontTexture>(CharCount, CellSize, 2),
+    glyphs,
+    12,
+    4,
+    16,
+    FirstChar,
+    CharCount);
+}
+
+auto makeLabels()
+{
+  auto result = std::vector<AttrString>{};
+  result.reserve(NumLabels);
+  for (size_t i = 0; i < NumLabels; ++i)
+  {
+    auto label = AttrString{};
+    label.appendCentered(fmt::format("item_classname_{}", i % NumClassnames));
+    result.push_back(std::move(label));
+  }
+  return result;
+}
+
+} // namespace
+
+TEST_CASE("TextureFontBenchmark.benchLabelLayout")
+{
+  const auto font = makeFont();
+  const auto labels = makeLabels();
+
+  auto vertexCount = size_t(0);
+  timeLambda(
+    [&]() {
+      for (size_t frame = 0; frame < NumFrames; ++frame)
+      {
+        for (const auto& label : labels)
+        {
+          const auto size = font->measure(label);
+          const auto quads = font->quads(label, true);
+          vertexCount += quads.size() + size_t(size.x() > 0.0f);
+        }
+      }
+    },
+    fmt::format("lay out {} labels in {} frames", labels.size(), NumFrames));
+
+  auto cachedVertexCount = size_t(0);
+  timeLambda(
+    [&]() {
+      for (size_t frame = 0; frame < NumFrames; ++frame)
+      {
+        for (const auto& label : labels)
+        {
+          const auto layout = font->layout(label);
+          cachedVertexCount += layout->quads.size() + size_t(layout->size.x() > 0.0f);
+        }
+      }
+    },
+    fmt::format(
+      "look up {} cached label layouts in {} frames", labels.size(), NumFrames));
+
+  CHECK(cachedVertexCount == vertexCount);
+}
+
+TEST_CASE("TextureFontBenchmark.benchFrameWithTransientText")
+{
+  // every entity has a distinct label, and every frame also draws strings that are only
+  // shown once, e.g. distances or coordinates that change while the mouse moves
+  constexpr size_t NumEntityLabels = 2'000;
+  constexpr size_t NumTransientStrings = 1'000;
+
+  const auto font = makeFont();
+
+  auto entityLabels = std::vector<AttrString>{};
+  for (size_t i = 0; i < NumEntityLabels; ++i)
+  {
+    auto label = AttrString{};
+    label.appendCentered(
+      fmt::format("item_classname_{} (entity {})", i % NumClassnames, i));
+    entityLabels.push_back(std::move(label));
+  }
+
+  auto vertexCount = size_t(0);
+  timeLambda(
+    [&]() {
+      for (size_t frame = 0; frame < NumFrames; ++frame)
+      {
+        for (const auto& label : entityLabels)
+        {
+          vertexCount += font->layout(label)->quads.size();
+        }
+        for (size_t i = 0; i < NumTransientStrings; ++i)
+        {
+          const auto value = float(frame * NumTransientStrings + i);
+          auto string = AttrString{};
+          string.appendCentered(fmt::format("{:.2f}", value));
+          vertexCount += font->layout(string)->quads.size();
+        }
+      }
+    },
+    fmt::format(
+      "lay out {} entity labels and {} transient strings in {} frames",
+      NumEntityLabels,
+      NumTransientStrings,
+      NumFrames));
+
+  CHECK(vertexCount > 0);
+}
+
+} // namespace tb::render
@@ -0,0 +1,183 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "mdl/BrushBuilder.h"
+#include "mdl/BrushNode.h"
+#include "mdl/MapFormat.h"
+#include "mdl/PickResult.h"
+#include "render/PerspectiveCamera.h"
+#include "ui/Lasso.h"
+#include "ui/VertexHandleManager.h"
+
+#include "kdl/result.h"
+
+#include "vm/bbox.h"
+#include "vm/vec.h"
+
+#include <fmt/format.h>
+
+#include <cmath>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+namespace tb::ui
+{
+namespace
+{
+
+constexpr size_t NumQueries = 1000;
+
+/**
+ * Creates enough cubes to produce the given number of vertex handles. The cubes are laid
+ * out in a lattice so that no two cubes share a vertex.
+ */
+std::vector<std::unique_ptr<mdl::BrushNode>> createBrushNodes(
+  const vm::bbox3d& worldBounds, const size_t handleCount)
+{
+  auto builder = mdl::BrushBuilder{mdl::MapFormat::Quake3, worldBounds};
+
+  const auto brushCount = handleCount / 8;
+  const auto perAxis = size_t(std::ceil(std::cbrt(double(brushCount))));
+
+  auto result = std::vector<std::unique_ptr<mdl::BrushNode>>{};
+  result.reserve(brushCount);
+  for (size_t i = 0; i < brushCount; ++i)
+  {
+    const auto min =
+      vm::vec3d{
+        double(i % perAxis),
+        double((i / perAxis) % perAxis),
+        double(i / (perAxis * perAxis))}
+      * 32.0;
+    result.push_back(std::make_unique<mdl::BrushNode>(
+      builder.createCuboid(vm::bbox3d{min, min + vm::vec3d{16, 16, 16}}, "material")
+      | kdl::value()));
+  }
+  return result;
+}
+
+void benchVertexHandleManager(const size_t handleCount)
+{
+  const auto worldBounds = vm::bbox3d{65536.0};
+  const auto brushNodes = createBrushNodes(worldBounds, handleCount);
+
+  auto manager = VertexHandleManager{};
+  timeLambda(
+    [&]() {
+      for (const auto& brushNode : brushNodes)
+      {
+        manager.addHandles(brushNode.get());
+      }
+    },
+    fmt::format("add {} vertex handles", brushNodes.size() * 8));
+
+  const auto handles = manager.allHandles();
+  REQUIRE(handles.size() == brushNodes.size() * 8);
+
+  auto queryHandles = std::vector<vm::vec3d>{};
+  for (size_t i = 0; i < NumQueries; ++i)
+  {
+    queryHandles.push_back(handles[i * handles.size() / NumQueries]);
+  }
+
+  // look at the lattice from one of its corners
+  const auto bounds = vm::bbox3d::merge_all(handles.begin(), handles.end());
+  const auto camera = render::PerspectiveCamera{
+    90.0f,
+    1.0f,
+    65536.0f,
+    render::Camera::Viewport{0, 0, 1920, 1080},
+    vm::vec3f{bounds.min - vm::vec3d{64, 64, 64}},
+    vm::normalize(vm::vec3f{1, 1, 1}),
+    vm::normalize(vm::vec3f{-1, -1, 2})};
+
+  timeLambda(
+    [&]() {
+      auto hitCount = size_t(0);
+      for (const auto& handle : queryHandles)
+      {
+        auto pickResult = mdl::PickResult{};
+        manager.pick(vm::ray3d{camera.pickRay(vm::vec3f{handle})}, camera, pickResult);
+        hitCount += pickResult.size();
+      }
+      CHECK(hitCount >= NumQueries);
+    },
+    fmt::format("pick {} of {} vertex handles", NumQueries, handles.size()));
+
+  timeLambda(
+    [&]() {
+      manager.select(queryHandles.begin(), queryHandles.end());
+      manager.deselect(queryHandles.begin(), queryHandles.end());
+      CHECK_FALSE(manager.anySelected());
+    },
+    fmt::format(
+      "select and deselect {} of {} vertex handles", NumQueries, handles.size()));
+
+  timeLambda(
+    [&]() {
+      auto brushCount = size_t(0);
+      for (const auto& handle : queryHandles)
+      {
+        brushCount += manager.findIncidentBrushes(handle).size();
+      }
+      CHECK(brushCount == NumQueries);
+    },
+    fmt::format(
+      "find incident brushes of {} of {} vertex handles", NumQueries, handles.size()));
+
+  timeLambda(
+    [&]() {
+      const auto center = camera.defaultPoint(256.0f);
+      auto lasso = Lasso{camera, 256.0, vm::vec3d{center - 32.0f * camera.right()}};
+      lasso.update(vm::vec3d{center + 32.0f * camera.right() + 32.0f * camera.up()});
+
+      const auto candidates = manager.findHandles(
+        [&](const vm::bbox3d& cellBounds) { return lasso.intersects(cellBounds); });
+
+      auto selected = std::vector<vm::vec3d>{};
+      lasso.selected(
+        candidates.begin(), candidates.end(), std::back_inserter(selected));
+      CHECK_FALSE(selected.empty());
+    },
+    fmt::format("lasso select among {} vertex handles", handles.size()));
+
+  timeLambda(
+    [&]() {
+      for (const auto& brushNode : brushNodes)
+      {
+        manager.removeHandles(brushNode.get());
+      }
+      CHECK(manager.totalHandleCount() == 0u);
+    },
+    fmt::format("remove {} vertex handles", handles.size()));
+}
+
+} // namespace
+
+TEST_CASE("VertexHandleManagerBenchmark.benchVertexHandles")
+{
+  benchVertexHandleManager(10'000);
+  benchVertexHandleManager(100'000);
+  benchVertexHandleManager(1'000'000);
+}
+
+} // namespace tb::ui
@@ -128,6 +128,13 @@ private:
       }
     }
 
+    size_t observerCount() const
+    {
+      const auto pendingRemoveCount = std::ranges::count_if(
+        m_observers, [](const auto& observer) { return observer.pendingRemove; });
+      return m_observers.size() - size_t(pendingRemoveCount) + m_toAdd.size();
+    }
+
     void disconnect(const size_t id) override
     {
       if (const auto it = findObserver(m_toAdd, id); it != std::end(m_toAdd))
@@ -242,6 +249,11 @@ public:
     return NotifierConnection{m_state, id};
   }
 
+  /**
+   * Returns the number of observers that will be notified by the next notification.
+   */
+  size_t observerCount() const { return m_state->observerCount(); }
+
   /**
    * Notifies all observers of this notifier with the given arguments.
    *
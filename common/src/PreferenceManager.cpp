@@ -62,6 +62,16 @@ PreferenceManager& PreferenceManager::instance()
   return *m_instance;
 }
 
+uint64_t PreferenceManager::revision() const
+{
+  return m_revision;
+}
+
+void PreferenceManager::incRevision()
+{
+  ++m_revision;
+}
+
 namespace
 {
 bool shouldSaveInstantly()
@@ -289,6 +299,7 @@ void AppPreferenceManager::invalidatePreferences()
   // Force all currently known Preference<T> objects to deserialize from m_cache next
   // time they are accessed Note, because new Preference<T> objects can be created at
   // runtime, we need this sort of lazy loading system.
+  incRevision();
   for (auto* pref : Preferences::staticPreferences())
   {
     pref->setValid(false);
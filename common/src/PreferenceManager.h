@@ -37,6 +37,7 @@
 #include <fmt/format.h>
 #include <fmt/std.h>
 
+#include <cstdint>
 #include <filesystem>
 #include <map>
 #include <memory>
@@ -56,6 +57,8 @@ private:
   static std::unique_ptr<PreferenceManager> m_instance;
   static bool m_initialized;
 
+  uint64_t m_revision = 1;
+
 protected:
   std::map<std::filesystem::path, std::unique_ptr<PreferenceBase>> m_dynamicPreferences;
 
@@ -124,6 +127,7 @@ public:
 
     preference.setValue(value);
     preference.setValid(true);
+    incRevision();
 
     savePreference(preference);
     if (saveInstantly())
@@ -140,12 +144,21 @@ public:
     set(preference, preference.defaultValue());
   }
 
+  /**
+   * Returns a number that changes whenever the value of any preference may have
+   * changed. Allows to cache values that are derived from preferences.
+   */
+  uint64_t revision() const;
+
   virtual void initialize() = 0;
 
   virtual bool saveInstantly() const = 0;
   virtual void saveChanges() = 0;
   virtual void discardChanges() = 0;
 
+protected:
+  void incRevision();
+
 private:
   virtual void validatePreference(PreferenceBase&) = 0;
   virtual void savePreference(PreferenceBase&) = 0;
@@ -61,6 +61,10 @@ Preference<Color> PortalFileBorderColor(
 Preference<Color> PortalFileFillColor(
   "render/Colors/Portal file fill", Color(1.0f, 0.4f, 0.4f, 0.2f));
 Preference<bool> ShowFPS("render/Show FPS", false);
+Preference<bool> ShowRenderStatistics("render/Show render statistics", false);
+// if set, the render statistics of every frame are appended to this file as CSV
+Preference<std::filesystem::path> RenderStatisticsFile(
+  "render/Render statistics file", std::filesystem::path{});
 
 Preference<Color>& axisColor(vm::axis::type axis)
 {
@@ -185,7 +189,11 @@ Preference<Color> GridColor2D("Rendere/Grid/Color2D", Color(0.8f, 0.8f, 0.8f, 0.
 
 Preference<int> TextureMinFilter("render/Texture mode min filter", 0x2700);
 Preference<int> TextureMagFilter("render/Texture mode mag filter", 0x2600);
+// in megabytes, 0 disables the budget
+Preference<int> TextureResidencyBudget("render/Texture residency budget", 0);
 Preference<bool> EnableMSAA("render/Enable multisampling", true);
+Preference<bool> PackedBrushVertices("render/Packed brush vertices", false);
+Preference<bool> DeduplicateBrushEdges("render/Deduplicate brush edges", false);
 
 Preference<bool> AlignmentLock("Editor/Texture lock", true);
 Preference<bool> UVLock("Editor/UV lock", false);
@@ -328,6 +336,8 @@ const std::vector<PreferenceBase*>& staticPreferences()
     &PortalFileBorderColor,
     &PortalFileFillColor,
     &ShowFPS,
+    &ShowRenderStatistics,
+    &RenderStatisticsFile,
     &CompassBackgroundColor,
     &CompassBackgroundOutlineColor,
     &CompassAxisOutlineColor,
@@ -381,6 +391,9 @@ const std::vector<PreferenceBase*>& staticPreferences()
     &GridColor2D,
     &TextureMinFilter,
     &TextureMagFilter,
+    &TextureResidencyBudget,
+    &PackedBrushVertices,
+    &DeduplicateBrushEdges,
     &AlignmentLock,
     &UVLock,
     &RendererFontPath(),
@@ -56,6 +56,8 @@ extern Preference<Color> PointFileColor;
 extern Preference<Color> PortalFileBorderColor;
 extern Preference<Color> PortalFileFillColor;
 extern Preference<bool> ShowFPS;
+extern Preference<bool> ShowRenderStatistics;
+extern Preference<std::filesystem::path> RenderStatisticsFile;
 
 Preference<Color>& axisColor(vm::axis::type axis);
 
@@ -129,7 +131,10 @@ extern Preference<Color> GridColor2D;
 
 extern Preference<int> TextureMinFilter;
 extern Preference<int> TextureMagFilter;
+extern Preference<int> TextureResidencyBudget;
 extern Preference<bool> EnableMSAA;
+extern Preference<bool> PackedBrushVertices;
+extern Preference<bool> DeduplicateBrushEdges;
 
 extern Preference<bool> AlignmentLock;
 extern Preference<bool> UVLock;
@@ -53,6 +53,7 @@
 #include <fmt/format.h>
 #include <fmt/std.h>
 
+#include <optional>
 #include <string>
 
 namespace tb::io
@@ -336,6 +337,49 @@ mdl::ResourceLoader<mdl::Texture> makeTextureResourceLoader(
   };
 }
 
+/**
+ * Reads the header of the given texture file. Returns nullopt if the file has an unknown
+ * format or if its header cannot be read.
+ */
+std::optional<mdl::TextureHeader> readTextureHeader(
+  const std::filesystem::path& path, const FileSystem& fs)
+{
+  const auto readHeader = [&](const auto& readHeaderFromReader) {
+    return fs.openFile(path) | kdl::and_then([&](auto file) {
+             auto reader = file->reader();
+             return readHeaderFromReader(reader);
+           })
+           | kdl::transform([](auto textureHeader) {
+               return std::optional{std::move(textureHeader)};
+             })
+           | kdl::value_or(std::nullopt);
+  };
+
+  const auto extension = kdl::path_to_lower(path.extension());
+  if (extension == ".d" || extension == ".c")
+  {
+    return readHeader(readMipTextureHeader);
+  }
+  else if (extension == ".wal")
+  {
+    return readHeader(readWalTextureHeader);
+  }
+  else if (extension == ".m8")
+  {
+    return readHeader(readM8TextureHeader);
+  }
+  else if (extension == ".dds")
+  {
+    return readHeader(readDdsTextureHeader);
+  }
+  else if (isSupportedFreeImageExtension(extension))
+  {
+    return readHeader(readFreeImageTextureHeader);
+  }
+
+  return std::nullopt;
+}
+
 Result<mdl::Material> loadTextureMaterial(
   const std::filesystem::path& texturePath,
   const FileSystem& fs,
@@ -352,7 +396,16 @@ Result<mdl::Material> loadTextureMaterial(
   auto textureLoader = makeTextureResourceLoader(
     texturePath, name, materialConfig.extensions, fs, paletteResult);
   auto textureResource = createResource(std::move(textureLoader));
-  return mdl::Material{std::move(name), std::move(textureResource)};
+  auto material = mdl::Material{std::move(name), std::move(textureResource)};
+
+  // Reading the header is cheap and allows using the material's size and embedded
+  // defaults before its texture is loaded.
+  if (auto textureHeader = readTextureHeader(texturePath, fs))
+  {
+    material.setTextureHeader(std::move(*textureHeader));
+  }
+
+  return material;
 }
 
 std::string materialCollectionName(
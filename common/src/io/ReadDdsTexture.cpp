@@ -127,6 +127,34 @@ void readDdsMips(Reader& reader, mdl::TextureBufferList& buffers)
 
 } // namespace
 
+Result<mdl::TextureHeader> readDdsTextureHeader(Reader& reader)
+{
+  try
+  {
+    const auto ident = reader.readSize<uint32_t>();
+    if (ident != DdsLayout::Ident)
+    {
+      return Error{"Unknown Dds ident: " + std::to_string(ident)};
+    }
+
+    /*const auto size =*/reader.readSize<uint32_t>();
+    /*const auto flags =*/reader.readSize<uint32_t>();
+    const auto height = reader.readSize<uint32_t>();
+    const auto width = reader.readSize<uint32_t>();
+
+    if (!checkTextureDimensions(width, height))
+    {
+      return Error{fmt::format("Invalid texture dimensions: {}*{}", width, height)};
+    }
+
+    return mdl::TextureHeader{width, height, mdl::NoEmbeddedDefaults{}};
+  }
+  catch (const ReaderException& e)
+  {
+    return Error{e.what()};
+  }
+}
+
 Result<mdl::Texture> readDdsTexture(Reader& reader)
 {
   try
@@ -25,12 +25,18 @@
 namespace tb::mdl
 {
 class Texture;
-}
+struct TextureHeader;
+} // namespace tb::mdl
 
 namespace tb::io
 {
 class Reader;
 
+/**
+ * Reads the dimensions of a DDS texture without decoding its pixels.
+ */
+Result<mdl::TextureHeader> readDdsTextureHeader(Reader& reader);
+
 Result<mdl::Texture> readDdsTexture(Reader& reader);
 
 } // namespace tb::io
@@ -35,6 +35,7 @@
 
 #include <fmt/format.h>
 
+#include <algorithm>
 #include <cassert>
 #include <stdexcept>
 #include <string>
@@ -196,6 +197,59 @@ Result<mdl::Texture> readFreeImageTexture(Reader& reader)
   return readFreeImageTextureFromMemory(imageBegin, imageSize);
 }
 
+namespace
+{
+// large enough for the headers of common image files, e.g. PNG chunks that precede the
+// image data or JPEG markers that precede the scan data
+constexpr size_t MaxImageHeaderSize = 16 * 1024;
+} // namespace
+
+Result<mdl::TextureHeader> readFreeImageTextureHeader(Reader& reader)
+{
+  try
+  {
+    InitFreeImage::initialize();
+
+    // only read the beginning of the file, otherwise every image in a collection would be
+    // read in full while the collection is scanned
+    auto bufferedReader =
+      reader.subReaderFromBegin(0, std::min(reader.size(), MaxImageHeaderSize)).buffer();
+    const auto* begin = bufferedReader.begin();
+    const auto* end = bufferedReader.end();
+    const auto imageSize = size_t(end - begin);
+    auto* imageBegin = reinterpret_cast<BYTE*>(const_cast<char*>(begin));
+
+    auto imageMemory = kdl::resource{
+      FreeImage_OpenMemory(imageBegin, static_cast<DWORD>(imageSize)),
+      FreeImage_CloseMemory};
+
+    const auto imageFormat = FreeImage_GetFileTypeFromMemory(*imageMemory);
+    auto image = kdl::resource{
+      FreeImage_LoadFromMemory(imageFormat, *imageMemory, FIF_LOAD_NOPIXELS),
+      FreeImage_Unload};
+
+    if (!image)
+    {
+      return Error{"FreeImage could not load image header"};
+    }
+
+    const auto imageWidth = size_t(FreeImage_GetWidth(*image));
+    const auto imageHeight = size_t(FreeImage_GetHeight(*image));
+
+    if (!checkTextureDimensions(imageWidth, imageHeight))
+    {
+      return Error{
+        fmt::format("Invalid texture dimensions: {}*{}", imageWidth, imageHeight)};
+    }
+
+    return mdl::TextureHeader{imageWidth, imageHeight, mdl::NoEmbeddedDefaults{}};
+  }
+  catch (const std::exception& e)
+  {
+    return Error{e.what()};
+  }
+}
+
 namespace
 {
 std::vector<std::string> getSupportedFreeImageExtensions()
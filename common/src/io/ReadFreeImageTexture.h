@@ -29,6 +29,7 @@ namespace tb::mdl
 {
 class Texture;
 class TextureBuffer;
+struct TextureHeader;
 } // namespace tb::mdl
 
 namespace tb::io
@@ -42,6 +43,13 @@ Result<mdl::Texture> readFreeImageTextureFromMemory(const uint8_t* begin, size_t
 
 Result<mdl::Texture> readFreeImageTexture(Reader& reader);
 
+/**
+ * Reads the dimensions of an image without decoding its pixels. Only the beginning of
+ * the image is read, so an error is returned if the header does not fit into it. In that
+ * case, the dimensions are known once the image is decoded.
+ */
+Result<mdl::TextureHeader> readFreeImageTextureHeader(Reader& reader);
+
 bool isSupportedFreeImageExtension(const std::filesystem::path& extension);
 
 } // namespace tb::io
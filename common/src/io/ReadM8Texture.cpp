@@ -41,6 +41,29 @@ constexpr size_t PaletteSize = 768;
 } // namespace M8Layout
 
 
+Result<mdl::TextureHeader> readM8TextureHeader(Reader& reader)
+{
+  try
+  {
+    const auto version = reader.readInt<int32_t>();
+    if (version != M8Layout::Version)
+    {
+      return Error{"Unknown M8 texture version: " + std::to_string(version)};
+    }
+
+    reader.seekForward(M8Layout::TextureNameLength);
+    const auto width = reader.readSize<uint32_t>();
+    reader.seekForward((M8Layout::MipLevels - 1) * sizeof(uint32_t));
+    const auto height = reader.readSize<uint32_t>();
+
+    return mdl::TextureHeader{width, height, mdl::NoEmbeddedDefaults{}};
+  }
+  catch (const ReaderException& e)
+  {
+    return Error{e.what()};
+  }
+}
+
 Result<mdl::Texture> readM8Texture(Reader& reader)
 {
   try
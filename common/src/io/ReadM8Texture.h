@@ -24,12 +24,18 @@
 namespace tb::mdl
 {
 class Texture;
-}
+struct TextureHeader;
+} // namespace tb::mdl
 
 namespace tb::io
 {
 class Reader;
 
+/**
+ * Reads the dimensions of a Heretic 2 .m8 texture without decoding its pixels.
+ */
+Result<mdl::TextureHeader> readM8TextureHeader(Reader& reader);
+
 /**
  * Heretic 2 .m8 format
  */
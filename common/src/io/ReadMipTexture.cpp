@@ -140,6 +140,28 @@ std::string readMipTextureName(Reader& reader)
   }
 }
 
+Result<mdl::TextureHeader> readMipTextureHeader(Reader& reader)
+{
+  try
+  {
+    auto headerReader = reader.subReaderFromBegin(MipLayout::TextureNameLength);
+
+    const auto width = headerReader.readSize<int32_t>();
+    const auto height = headerReader.readSize<int32_t>();
+
+    if (!checkTextureDimensions(width, height))
+    {
+      return Error{fmt::format("Invalid texture dimensions: {}*{}", width, height)};
+    }
+
+    return mdl::TextureHeader{width, height, mdl::NoEmbeddedDefaults{}};
+  }
+  catch (const ReaderException& e)
+  {
+    return Error{e.what()};
+  }
+}
+
 Result<mdl::Texture> readIdMipTexture(
   Reader& reader, const mdl::Palette& palette, const mdl::TextureMask mask)
 {
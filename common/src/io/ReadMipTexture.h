@@ -28,6 +28,7 @@ namespace tb::mdl
 class Palette;
 class Texture;
 enum class TextureMask;
+struct TextureHeader;
 } // namespace tb::mdl
 
 namespace tb::io
@@ -36,6 +37,11 @@ class Reader;
 
 std::string readMipTextureName(Reader& reader);
 
+/**
+ * Reads the dimensions of a mip texture without decoding its pixels.
+ */
+Result<mdl::TextureHeader> readMipTextureHeader(Reader& reader);
+
 Result<mdl::Texture> readIdMipTexture(
   Reader& reader, const mdl::Palette& palette, mdl::TextureMask mask);
 
@@ -34,7 +34,10 @@ namespace tb::io
 namespace WalLayout
 {
 const size_t TextureNameLength = 32;
-}
+const size_t Q2MaxMipLevels = 4;
+const size_t DkMaxMipLevels = 9;
+const size_t DkPaletteSize = 3 * 256;
+} // namespace WalLayout
 
 namespace
 {
@@ -101,9 +104,55 @@ std::tuple<mdl::TextureBufferList, bool> readMips(
   return {std::move(buffers), hasTransparency};
 }
 
+Result<mdl::TextureHeader> readQ2WalHeader(Reader& reader)
+{
+  reader.seekForward(WalLayout::TextureNameLength);
+  const auto width = reader.readSize<uint32_t>();
+  const auto height = reader.readSize<uint32_t>();
+
+  if (!checkTextureDimensions(width, height))
+  {
+    return Error{fmt::format("Invalid texture dimensions: {}*{}", width, height)};
+  }
+
+  reader.seekForward(WalLayout::Q2MaxMipLevels * sizeof(uint32_t));
+  reader.seekForward(WalLayout::TextureNameLength);
+  const auto flags = reader.readInt<int32_t>();
+  const auto contents = reader.readInt<int32_t>();
+  const auto value = reader.readInt<int32_t>();
+
+  return mdl::TextureHeader{
+    width, height, mdl::Q2EmbeddedDefaults{flags, contents, value}};
+}
+
+Result<mdl::TextureHeader> readDkWalHeader(Reader& reader)
+{
+  reader.seekForward(1); // version
+  reader.seekForward(WalLayout::TextureNameLength);
+  reader.seekForward(3); // garbage
+
+  const auto width = reader.readSize<uint32_t>();
+  const auto height = reader.readSize<uint32_t>();
+
+  if (!checkTextureDimensions(width, height))
+  {
+    return Error{fmt::format("Invalid texture dimensions: {}*{}", width, height)};
+  }
+
+  reader.seekForward(WalLayout::DkMaxMipLevels * sizeof(uint32_t));
+  reader.seekForward(WalLayout::TextureNameLength);
+  const auto flags = reader.readInt<int32_t>();
+  const auto contents = reader.readInt<int32_t>();
+  reader.seekForward(WalLayout::DkPaletteSize);
+  const auto value = reader.readInt<int32_t>();
+
+  return mdl::TextureHeader{
+    width, height, mdl::Q2EmbeddedDefaults{flags, contents, value}};
+}
+
 Result<mdl::Texture> readQ2Wal(Reader& reader, const std::optional<mdl::Palette>& palette)
 {
-  static const auto MaxMipLevels = size_t(4);
+  static const auto MaxMipLevels = WalLayout::Q2MaxMipLevels;
   auto averageColor = Color{};
   size_t offsets[MaxMipLevels];
 
@@ -162,7 +211,7 @@ Result<mdl::Texture> readQ2Wal(Reader& reader, const std::optional<mdl::Palette>
 
 Result<mdl::Texture> readDkWal(Reader& reader)
 {
-  static const auto MaxMipLevels = size_t(9);
+  static const auto MaxMipLevels = WalLayout::DkMaxMipLevels;
   auto averageColor = Color{};
   size_t offsets[MaxMipLevels];
 
@@ -190,8 +239,8 @@ Result<mdl::Texture> readDkWal(Reader& reader)
     const auto flags = reader.readInt<int32_t>();
     const auto contents = reader.readInt<int32_t>();
 
-    auto paletteReader = reader.subReaderFromCurrent(3 * 256);
-    reader.seekForward(3 * 256); // seek past palette
+    auto paletteReader = reader.subReaderFromCurrent(WalLayout::DkPaletteSize);
+    reader.seekForward(WalLayout::DkPaletteSize); // seek past palette
     const auto value = reader.readInt<int32_t>();
     auto embeddedDefaults = mdl::Q2EmbeddedDefaults{flags, contents, value};
 
@@ -225,6 +274,22 @@ Result<mdl::Texture> readDkWal(Reader& reader)
 
 } // namespace
 
+Result<mdl::TextureHeader> readWalTextureHeader(Reader& reader)
+{
+  try
+  {
+    auto headerReader = reader.subReaderFromBegin(0);
+    const auto version = headerReader.readChar<char>();
+    headerReader.seekFromBegin(0);
+
+    return version == 3 ? readDkWalHeader(headerReader) : readQ2WalHeader(headerReader);
+  }
+  catch (const ReaderException& e)
+  {
+    return Error{e.what()};
+  }
+}
+
 Result<mdl::Texture> readWalTexture(
   Reader& reader, const std::optional<mdl::Palette>& palette)
 {
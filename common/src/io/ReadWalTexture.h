@@ -27,12 +27,19 @@
 namespace tb::mdl
 {
 class Texture;
+struct TextureHeader;
 } // namespace tb::mdl
 
 namespace tb::io
 {
 class Reader;
 
+/**
+ * Reads the dimensions and the embedded surface defaults of a wal texture without
+ * decoding its pixels.
+ */
+Result<mdl::TextureHeader> readWalTextureHeader(Reader& reader);
+
 Result<mdl::Texture> readWalTexture(
   Reader& reader, const std::optional<mdl::Palette>& palette);
 
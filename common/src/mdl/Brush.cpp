@@ -548,6 +548,24 @@ std::vector<const BrushFace*> Brush::incidentFaces(const BrushVertex* vertex) co
   return result;
 }
 
+void Brush::restoreVertexPositions(const std::vector<vm::vec3d>& positions)
+{
+  ensure(m_geometry != nullptr, "geometry is null");
+
+  for (const auto& position : positions)
+  {
+    if (
+      auto* vertex =
+        m_geometry->findClosestVertex(position, vm::Cd::point_status_epsilon()))
+    {
+      vertex->setPosition(position);
+    }
+  }
+
+  // the restored positions were corrected already, so this only updates the bounds
+  m_geometry->correctVertexPositions();
+}
+
 bool Brush::canMoveVertices(
   const vm::bbox3d& worldBounds,
   const std::vector<vm::vec3d>& vertices,
@@ -1098,6 +1116,15 @@ Result<void> Brush::updateFacesFromGeometry(
       auto& rightFace = newFaces.emplace_back(leftFace);
 
       rightFace.setGeometry(right);
+
+      // keep the points of faces whose vertices didn't change
+      if (
+        left->vertexCount() == right->vertexCount()
+        && left->hasVertexPositions(right->vertexPositions()))
+      {
+        return;
+      }
+
       rightFace.updatePointsFromVertices() | kdl::transform([&]() {
         if (uvLock)
         {
@@ -1177,9 +1204,81 @@ Result<void> Brush::transform(
     }
   }
 
+  if (transformGeometry(worldBounds, transformation))
+  {
+    return kdl::void_success;
+  }
+
   return updateGeometryFromFaces(worldBounds);
 }
 
+namespace
+{
+
+bool isRigid(const vm::mat4x4d& transformation)
+{
+  const auto linear = vm::strip_translation(transformation);
+  return vm::is_equal(
+    vm::transpose(linear) * linear, vm::mat4x4d::identity(), vm::Cd::almost_zero());
+}
+
+} // namespace
+
+bool Brush::transformGeometry(
+  const vm::bbox3d& worldBounds, const vm::mat4x4d& transformation)
+{
+  // A rigid transformation does not change the topology of the brush, so we can move
+  // the existing geometry instead of clipping a new one.
+  if (!m_geometry || !isRigid(transformation))
+  {
+    return false;
+  }
+
+  // Check the transformed vertices before touching the geometry so that it is still
+  // intact if we have to rebuild it from the faces instead.
+  for (const auto* vertex : m_geometry->vertices())
+  {
+    const auto position = vm::correct(transformation * vertex->position());
+    if (!worldBounds.contains(position))
+    {
+      return false;
+    }
+
+    const auto* firstEdge = vertex->leaving();
+    const auto* currentEdge = firstEdge;
+    do
+    {
+      const auto faceIndex = currentEdge->face()->payload();
+      assert(faceIndex);
+      const auto distance = m_faces[*faceIndex].boundary().point_distance(position);
+      if (vm::abs(distance) > vm::Cd::point_status_epsilon())
+      {
+        return false;
+      }
+      currentEdge = currentEdge->nextIncident();
+    } while (currentEdge != firstEdge);
+  }
+
+  m_geometry->transform(transformation);
+  m_geometry->correctVertexPositions();
+
+  for (auto& face : m_faces)
+  {
+    face.geometry()->setPlane(face.boundary());
+  }
+
+  // Keep the faces in the order in which they would have been added to a new geometry.
+  BrushFace::sortFaces(m_faces);
+  for (size_t i = 0u; i < m_faces.size(); ++i)
+  {
+    m_faces[i].geometry()->setPayload(i);
+  }
+
+  assert(checkFaceLinks());
+
+  return true;
+}
+
 bool Brush::contains(const vm::bbox3d& bounds) const
 {
   if (!this->bounds().contains(bounds))
@@ -170,6 +170,14 @@ public:
 
   std::vector<const BrushFace*> incidentFaces(const BrushVertex* vertex) const;
 
+  /**
+   * Moves the closest vertex of this brush to each of the given positions if it is
+   * within the point status epsilon of that position. This restores the exact vertex
+   * positions of a brush whose geometry was not computed from its faces, e.g. because it
+   * was transformed in place, after it has been recreated from its faces.
+   */
+  void restoreVertexPositions(const std::vector<vm::vec3d>& positions);
+
   // vertex operations
   bool canMoveVertices(
     const vm::bbox3d& worldBounds,
@@ -322,7 +330,13 @@ public:
   /**
    * Applies the given transformation to this brush.
    *
-   * If the brush becomes invalid, an error is returned.
+   * If the transformation is rigid, i.e. a rotation or a reflection followed by a
+   * translation, the existing geometry is transformed in place. The geometry is only
+   * rebuilt from the transformed face planes if the transformed vertices do not lie on
+   * their faces or if they leave the world bounds.
+   *
+   * If the brush becomes invalid, an error is returned. In that case, some of the faces
+   * may already have been transformed, so the caller must discard this brush.
    *
    * @param worldBounds the world bounds
    * @param transformation the transformation to apply
@@ -332,6 +346,10 @@ public:
   Result<void> transform(
     const vm::bbox3d& worldBounds, const vm::mat4x4d& transformation, bool lockMaterials);
 
+private:
+  bool transformGeometry(
+    const vm::bbox3d& worldBounds, const vm::mat4x4d& transformation);
+
 public:
   bool contains(const vm::bbox3d& bounds) const;
   bool contains(const Brush& brush) const;
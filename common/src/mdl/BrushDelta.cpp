@@ -0,0 +1,258 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BrushDelta.h"
+
+#include "mdl/Brush.h"
+
+#include "kdl/result.h"
+#include "kdl/vector_utils.h"
+
+#include <cassert>
+#include <unordered_map>
+#include <unordered_set>
+#include <variant>
+
+namespace tb::mdl
+{
+namespace
+{
+
+bool isSameFace(const BrushFace& lhs, const BrushFace& rhs)
+{
+  return lhs == rhs && lhs.uAxis() == rhs.uAxis() && lhs.vAxis() == rhs.vAxis();
+}
+
+template <typename T>
+std::vector<T> replaceValues(
+  const std::vector<T>& values,
+  const std::vector<std::pair<size_t, T>>& valuesToRemove,
+  const std::vector<std::pair<size_t, T>>& valuesToInsert)
+{
+  assert(values.size() >= valuesToRemove.size());
+
+  auto result = std::vector<T>{};
+  result.reserve(values.size() - valuesToRemove.size() + valuesToInsert.size());
+
+  auto removeIt = valuesToRemove.begin();
+  auto insertIt = valuesToInsert.begin();
+  for (size_t i = 0; i < values.size(); ++i)
+  {
+    if (removeIt != valuesToRemove.end() && removeIt->first == i)
+    {
+      ++removeIt;
+      continue;
+    }
+
+    while (insertIt != valuesToInsert.end() && insertIt->first == result.size())
+    {
+      result.push_back(insertIt->second);
+      ++insertIt;
+    }
+    result.push_back(values[i]);
+  }
+
+  for (; insertIt != valuesToInsert.end(); ++insertIt)
+  {
+    assert(insertIt->first == result.size());
+    result.push_back(insertIt->second);
+  }
+
+  assert(removeIt == valuesToRemove.end());
+  return result;
+}
+
+/**
+ * A face of a brush in a chain of deltas, either a face of the original brush that is
+ * only known by its index, or a face stored in one of the deltas.
+ */
+using FaceRef = std::variant<size_t, const BrushFace*>;
+
+auto toFaceRefs(const std::vector<std::pair<size_t, BrushFace>>& faces)
+{
+  return kdl::vec_transform(
+    faces, [](const auto& pair) { return std::pair{pair.first, FaceRef{&pair.second}}; });
+}
+
+} // namespace
+
+BrushDelta::BrushDelta(const size_t oldFaceCount, const size_t newFaceCount)
+  : m_oldFaceCount{oldFaceCount}
+  , m_newFaceCount{newFaceCount}
+{
+}
+
+BrushDelta::BrushDelta(
+  const std::vector<BrushFace>& oldFaces, const std::vector<BrushFace>& newFaces)
+  : BrushDelta{oldFaces.size(), newFaces.size()}
+{
+  auto matched = std::vector<bool>(newFaces.size(), false);
+
+  for (size_t i = 0; i < oldFaces.size(); ++i)
+  {
+    // most faces keep their position, so start searching there
+    auto found = false;
+    for (size_t k = 0; k < newFaces.size() && !found; ++k)
+    {
+      const auto j = (i + k) % newFaces.size();
+      if (!matched[j] && isSameFace(oldFaces[i], newFaces[j]))
+      {
+        matched[j] = true;
+        found = true;
+      }
+    }
+
+    if (!found)
+    {
+      m_oldFaces.emplace_back(i, oldFaces[i]);
+    }
+  }
+
+  for (size_t j = 0; j < newFaces.size(); ++j)
+  {
+    if (!matched[j])
+    {
+      m_newFaces.emplace_back(j, newFaces[j]);
+    }
+  }
+}
+
+BrushDelta::BrushDelta(const Brush& oldBrush, const Brush& newBrush)
+  : BrushDelta{oldBrush.faces(), newBrush.faces()}
+{
+  m_oldVertexPositions = oldBrush.vertexPositions();
+  m_newVertexPositions = newBrush.vertexPositions();
+}
+
+BrushDelta BrushDelta::compose(const BrushDelta& first, const BrushDelta& second)
+{
+  assert(first.m_newFaceCount == second.m_oldFaceCount);
+
+  // replay both deltas on references to the faces of the original brush
+  auto oldFaceRefs = std::vector<FaceRef>{};
+  oldFaceRefs.reserve(first.m_oldFaceCount);
+
+  auto oldFaceIt = first.m_oldFaces.begin();
+  for (size_t i = 0; i < first.m_oldFaceCount; ++i)
+  {
+    if (oldFaceIt != first.m_oldFaces.end() && oldFaceIt->first == i)
+    {
+      oldFaceRefs.emplace_back(&oldFaceIt->second);
+      ++oldFaceIt;
+    }
+    else
+    {
+      oldFaceRefs.emplace_back(i);
+    }
+  }
+
+  const auto midFaceRefs = replaceValues(
+    oldFaceRefs, toFaceRefs(first.m_oldFaces), toFaceRefs(first.m_newFaces));
+
+  // the second delta stores the original faces that it removes
+  auto removedOriginalFaces = std::unordered_map<size_t, const BrushFace*>{};
+  for (const auto& [j, face] : second.m_oldFaces)
+  {
+    if (const auto* i = std::get_if<size_t>(&midFaceRefs[j]))
+    {
+      removedOriginalFaces.emplace(*i, &face);
+    }
+  }
+
+  const auto newFaceRefs = replaceValues(
+    midFaceRefs, toFaceRefs(second.m_oldFaces), toFaceRefs(second.m_newFaces));
+
+  auto keptOriginalFaces = std::unordered_set<size_t>{};
+  for (const auto& faceRef : newFaceRefs)
+  {
+    if (const auto* i = std::get_if<size_t>(&faceRef))
+    {
+      keptOriginalFaces.insert(*i);
+    }
+  }
+
+  auto result = BrushDelta{first.m_oldFaceCount, second.m_newFaceCount};
+  result.m_oldVertexPositions = first.m_oldVertexPositions;
+  result.m_newVertexPositions = second.m_newVertexPositions;
+  for (size_t i = 0; i < oldFaceRefs.size(); ++i)
+  {
+    if (const auto* face = std::get_if<const BrushFace*>(&oldFaceRefs[i]))
+    {
+      result.m_oldFaces.emplace_back(i, **face);
+    }
+    else if (!keptOriginalFaces.contains(i))
+    {
+      result.m_oldFaces.emplace_back(i, *removedOriginalFaces.at(i));
+    }
+  }
+
+  for (size_t j = 0; j < newFaceRefs.size(); ++j)
+  {
+    if (const auto* face = std::get_if<const BrushFace*>(&newFaceRefs[j]))
+    {
+      result.m_newFaces.emplace_back(j, **face);
+    }
+  }
+
+  return result;
+}
+
+std::vector<BrushFace> BrushDelta::apply(const std::vector<BrushFace>& oldFaces) const
+{
+  assert(oldFaces.size() == m_oldFaceCount);
+  return replaceValues(oldFaces, m_oldFaces, m_newFaces);
+}
+
+Result<Brush> BrushDelta::apply(
+  const vm::bbox3d& worldBounds, const Brush& oldBrush) const
+{
+  return Brush::create(worldBounds, apply(oldBrush.faces()))
+         | kdl::transform([&](auto brush) {
+             brush.restoreVertexPositions(m_newVertexPositions);
+             return brush;
+           });
+}
+
+std::vector<BrushFace> BrushDelta::revert(const std::vector<BrushFace>& newFaces) const
+{
+  assert(newFaces.size() == m_newFaceCount);
+  return replaceValues(newFaces, m_newFaces, m_oldFaces);
+}
+
+Result<Brush> BrushDelta::revert(
+  const vm::bbox3d& worldBounds, const Brush& newBrush) const
+{
+  return Brush::create(worldBounds, revert(newBrush.faces()))
+         | kdl::transform([&](auto brush) {
+             brush.restoreVertexPositions(m_oldVertexPositions);
+             return brush;
+           });
+}
+
+size_t BrushDelta::faceCount() const
+{
+  return m_oldFaces.size() + m_newFaces.size();
+}
+
+size_t BrushDelta::vertexCount() const
+{
+  return m_oldVertexPositions.size() + m_newVertexPositions.size();
+}
+
+} // namespace tb::mdl
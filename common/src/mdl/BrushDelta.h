@@ -0,0 +1,93 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Result.h"
+#include "mdl/BrushFace.h"
+
+#include "vm/bbox.h"
+#include "vm/vec.h"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace tb::mdl
+{
+class Brush;
+
+/**
+ * The difference between two versions of a brush, stored as the faces that only occur in
+ * either version together with their positions in the respective face list. The faces
+ * that both versions share are not stored.
+ *
+ * Either version of the brush is recreated from its faces. Since the geometry of a brush
+ * is not always computed from its faces, e.g. when it was rotated in place, the vertex
+ * positions of both versions are stored as well and restored after the brush has been
+ * recreated, so that the vertex positions are restored exactly.
+ */
+class BrushDelta
+{
+private:
+  size_t m_oldFaceCount = 0;
+  size_t m_newFaceCount = 0;
+  std::vector<std::pair<size_t, BrushFace>> m_oldFaces;
+  std::vector<std::pair<size_t, BrushFace>> m_newFaces;
+  std::vector<vm::vec3d> m_oldVertexPositions;
+  std::vector<vm::vec3d> m_newVertexPositions;
+
+  BrushDelta(size_t oldFaceCount, size_t newFaceCount);
+
+public:
+  BrushDelta(
+    const std::vector<BrushFace>& oldFaces, const std::vector<BrushFace>& newFaces);
+  BrushDelta(const Brush& oldBrush, const Brush& newBrush);
+
+  /**
+   * Returns a delta that has the same effect as applying the given deltas one after the
+   * other. The new version of the first delta must be the old version of the second
+   * delta.
+   */
+  static BrushDelta compose(const BrushDelta& first, const BrushDelta& second);
+
+  /**
+   * Returns the faces of the new version given the faces of the old version.
+   */
+  std::vector<BrushFace> apply(const std::vector<BrushFace>& oldFaces) const;
+  Result<Brush> apply(const vm::bbox3d& worldBounds, const Brush& oldBrush) const;
+
+  /**
+   * Returns the faces of the old version given the faces of the new version.
+   */
+  std::vector<BrushFace> revert(const std::vector<BrushFace>& newFaces) const;
+  Result<Brush> revert(const vm::bbox3d& worldBounds, const Brush& newBrush) const;
+
+  /**
+   * Returns the number of faces stored in this delta.
+   */
+  size_t faceCount() const;
+
+  /**
+   * Returns the number of vertex positions stored in this delta.
+   */
+  size_t vertexCount() const;
+};
+
+} // namespace tb::mdl
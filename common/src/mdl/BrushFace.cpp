@@ -25,6 +25,7 @@
 #include "mdl/Material.h"
 #include "mdl/ParallelUVCoordSystem.h"
 #include "mdl/ParaxialUVCoordSystem.h"
+#include "mdl/TagManager.h"
 #include "mdl/TagMatcher.h"
 #include "mdl/TagVisitor.h"
 #include "mdl/Texture.h"
@@ -41,6 +42,7 @@
 #include "vm/util.h"
 #include "vm/vec_io.h" // IWYU pragma: keep
 
+#include <algorithm>
 #include <string>
 #include <utility>
 
@@ -233,7 +235,7 @@ void BrushFace::sortFaces(std::vector<BrushFace>& faces)
   // in which the faces are added to the brush, so I chose to just sort the faces by
   // their normals.
 
-  std::sort(std::begin(faces), std::end(faces), [](const auto& lhs, const auto& rhs) {
+  const auto compareFaces = [](const auto& lhs, const auto& rhs) {
     const auto& lhsBoundary = lhs.boundary();
     const auto& rhsBoundary = rhs.boundary();
 
@@ -251,7 +253,14 @@ void BrushFace::sortFaces(std::vector<BrushFace>& faces)
       // normal vectors are identical -- this should never happen
       return lhsBoundary.distance < rhsBoundary.distance;
     }
-  });
+  };
+
+  // Transforming a brush often keeps the order of its faces, and sorting already sorted
+  // faces would still move them around.
+  if (!std::is_sorted(std::begin(faces), std::end(faces), compareFaces))
+  {
+    std::sort(std::begin(faces), std::end(faces), compareFaces);
+  }
 }
 
 std::unique_ptr<UVCoordSystemSnapshot> BrushFace::takeUVCoordSystemSnapshot() const
@@ -437,9 +446,9 @@ struct SurfaceData
 
 SurfaceData getDefaultSurfaceData(const Material* material)
 {
-  if (const auto* texture = getTexture(material))
+  if (const auto textureHeader = getTextureHeader(material))
   {
-    const auto& defaults = texture->embeddedDefaults();
+    const auto& defaults = textureHeader->embeddedDefaults;
     if (const auto* q2Defaults = std::get_if<Q2EmbeddedDefaults>(&defaults))
     {
       return {
@@ -504,9 +513,12 @@ const Material* BrushFace::material() const
 
 vm::vec2f BrushFace::textureSize() const
 {
-  if (const auto* texture = getTexture(material()))
+  if (const auto textureHeader = getTextureHeader(material()))
   {
-    return vm::max(texture->sizef(), vm::vec2f{1, 1});
+    const auto size = vm::vec2f{
+      static_cast<float>(textureHeader->width),
+      static_cast<float>(textureHeader->height)};
+    return vm::max(size, vm::vec2f{1, 1});
   }
   return vm::vec2f{1, 1};
 }
@@ -861,6 +873,11 @@ bool BrushFace::isMarked() const
   return m_markedToRenderFace;
 }
 
+void BrushFace::updateTags(TagManager& tagManager)
+{
+  tagManager.updateFaceTags(*this);
+}
+
 void BrushFace::doAcceptTagVisitor(TagVisitor& visitor)
 {
   visitor.visit(*this);
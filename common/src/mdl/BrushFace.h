@@ -283,6 +283,14 @@ public: // brush renderer
   void setMarked(bool marked) const;
   bool isMarked() const;
 
+public: // tag management
+  /**
+   * Updates the tags of this face using the material tag cache of the given tag manager.
+   *
+   * @param tagManager the tag manager
+   */
+  void updateTags(TagManager& tagManager) override;
+
 private: // implement Taggable interface
   void doAcceptTagVisitor(TagVisitor& visitor) override;
   void doAcceptTagVisitor(ConstTagVisitor& visitor) const override;
@@ -124,6 +124,7 @@ void BrushNode::deselectFace(const size_t faceIndex)
 void BrushNode::updateFaceTags(const size_t faceIndex, TagManager& tagManager)
 {
   m_brush.face(faceIndex).updateTags(tagManager);
+  invalidateCachedEditorStates();
 }
 
 void BrushNode::setFaceMaterial(const size_t faceIndex, Material* material)
@@ -410,6 +411,7 @@ void BrushNode::initializeTags(TagManager& tagManager)
   {
     face.initializeTags(tagManager);
   }
+  invalidateCachedEditorStates();
 }
 
 void BrushNode::clearTags()
@@ -419,6 +421,7 @@ void BrushNode::clearTags()
     face.clearTags();
   }
   Taggable::clearTags();
+  invalidateCachedEditorStates();
 }
 
 void BrushNode::updateTags(TagManager& tagManager)
@@ -428,6 +431,7 @@ void BrushNode::updateTags(TagManager& tagManager)
     face.updateTags(tagManager);
   }
   Taggable::updateTags(tagManager);
+  invalidateCachedEditorStates();
 }
 
 bool BrushNode::allFacesHaveAnyTagInMask(TagType::Type tagMask) const
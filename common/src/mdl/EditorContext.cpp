@@ -33,8 +33,37 @@
 #include "mdl/PatchNode.h"
 #include "mdl/WorldNode.h"
 
+#include <atomic>
+
 namespace tb::mdl
 {
+namespace
+{
+
+/*
+ * Every property is stored in two bits of the cached state of a node, one indicating
+ * whether the value is known and one holding the value. The remaining bits hold the
+ * stamp.
+ */
+constexpr auto StampShift = 6;
+
+uint64_t nextStamp()
+{
+  static auto stamp = std::atomic<uint64_t>{0};
+  return ++stamp;
+}
+
+uint64_t knownBit(const auto property)
+{
+  return uint64_t(1) << (2 * static_cast<int>(property));
+}
+
+uint64_t valueBit(const auto property)
+{
+  return knownBit(property) << 1;
+}
+
+} // namespace
 
 EditorContext::EditorContext()
 {
@@ -47,6 +76,7 @@ void EditorContext::reset()
   m_hiddenEntityDefinitions.reset();
   m_blockSelection = false;
   m_currentGroup = nullptr;
+  invalidateCachedStates();
 }
 
 TagType::Type EditorContext::hiddenTags() const
@@ -59,6 +89,7 @@ void EditorContext::setHiddenTags(const TagType::Type hiddenTags)
   if (hiddenTags != m_hiddenTags)
   {
     m_hiddenTags = hiddenTags;
+    invalidateCachedStates();
     editorContextDidChangeNotifier();
   }
 }
@@ -79,6 +110,7 @@ void EditorContext::setEntityDefinitionHidden(
   if (definition && entityDefinitionHidden(definition) != hidden)
   {
     m_hiddenEntityDefinitions[definition->index()] = hidden;
+    invalidateCachedStates();
     editorContextDidChangeNotifier();
   }
 }
@@ -127,6 +159,61 @@ void EditorContext::popGroup()
   }
 }
 
+void EditorContext::invalidateCachedStates()
+{
+  m_stamp = nextStamp();
+}
+
+void EditorContext::validatePreferences() const
+{
+  const auto revision = PreferenceManager::instance().revision();
+  if (revision != m_preferenceRevision.load(std::memory_order_acquire))
+  {
+    const auto lock = std::lock_guard{m_preferenceMutex};
+    if (revision != m_preferenceRevision.load(std::memory_order_relaxed))
+    {
+      const auto showBrushes = pref(Preferences::ShowBrushes);
+      const auto showPointEntities = pref(Preferences::ShowPointEntities);
+      if (showBrushes != m_showBrushes || showPointEntities != m_showPointEntities)
+      {
+        m_showBrushes = showBrushes;
+        m_showPointEntities = showPointEntities;
+        m_stamp = nextStamp();
+      }
+      m_preferenceRevision.store(revision, std::memory_order_release);
+    }
+  }
+}
+
+template <typename T, typename F>
+bool EditorContext::cached(
+  const T* node, const CachedProperty property, const F& compute) const
+{
+  validatePreferences();
+
+  auto& state = node->cachedEditorState().value;
+  auto current = state.load(std::memory_order_relaxed);
+  if ((current >> StampShift) == m_stamp && (current & knownBit(property)) != 0)
+  {
+    return (current & valueBit(property)) != 0;
+  }
+
+  const auto value = compute(node);
+  const auto bits = knownBit(property) | (value ? valueBit(property) : 0);
+
+  // another thread may have cached other properties of the same node in the meantime
+  while (true)
+  {
+    const auto desired = (current >> StampShift) == m_stamp
+                           ? current | bits
+                           : (m_stamp << StampShift) | bits;
+    if (state.compare_exchange_weak(current, desired, std::memory_order_relaxed))
+    {
+      return value;
+    }
+  }
+}
+
 bool EditorContext::visible(const mdl::Node* node) const
 {
   return node->accept(kdl::overload(
@@ -149,6 +236,13 @@ bool EditorContext::visible(const mdl::LayerNode* layerNode) const
 }
 
 bool EditorContext::visible(const mdl::GroupNode* groupNode) const
+{
+  return cached(groupNode, CachedProperty::Visible, [&](const auto* node) {
+    return computeVisible(node);
+  });
+}
+
+bool EditorContext::computeVisible(const mdl::GroupNode* groupNode) const
 {
   if (groupNode->selected())
   {
@@ -162,6 +256,13 @@ bool EditorContext::visible(const mdl::GroupNode* groupNode) const
 }
 
 bool EditorContext::visible(const mdl::EntityNode* entityNode) const
+{
+  return cached(entityNode, CachedProperty::Visible, [&](const auto* node) {
+    return computeVisible(node);
+  });
+}
+
+bool EditorContext::computeVisible(const mdl::EntityNode* entityNode) const
 {
   if (entityNode->selected())
   {
@@ -178,7 +279,7 @@ bool EditorContext::visible(const mdl::EntityNode* entityNode) const
     return false;
   }
 
-  if (entityNode->entity().pointEntity() && !pref(Preferences::ShowPointEntities))
+  if (entityNode->entity().pointEntity() && !m_showPointEntities)
   {
     return false;
   }
@@ -192,13 +293,20 @@ bool EditorContext::visible(const mdl::EntityNode* entityNode) const
 }
 
 bool EditorContext::visible(const mdl::BrushNode* brushNode) const
+{
+  return cached(brushNode, CachedProperty::Visible, [&](const auto* node) {
+    return computeVisible(node);
+  });
+}
+
+bool EditorContext::computeVisible(const mdl::BrushNode* brushNode) const
 {
   if (brushNode->selected())
   {
     return true;
   }
 
-  if (!pref(Preferences::ShowBrushes))
+  if (!m_showBrushes)
   {
     return false;
   }
@@ -228,6 +336,13 @@ bool EditorContext::visible(
 }
 
 bool EditorContext::visible(const mdl::PatchNode* patchNode) const
+{
+  return cached(patchNode, CachedProperty::Visible, [&](const auto* node) {
+    return computeVisible(node);
+  });
+}
+
+bool EditorContext::computeVisible(const mdl::PatchNode* patchNode) const
 {
   if (patchNode->selected())
   {
@@ -251,7 +366,9 @@ bool EditorContext::anyChildVisible(const mdl::Node* node) const
 
 bool EditorContext::editable(const mdl::Node* node) const
 {
-  return node->editable();
+  return cached(node, CachedProperty::Editable, [](const auto* n) {
+    return n->editable();
+  });
 }
 
 bool EditorContext::editable(const mdl::BrushNode* brushNode, const mdl::BrushFace&) const
@@ -281,18 +398,39 @@ bool EditorContext::selectable(const mdl::LayerNode*) const
 }
 
 bool EditorContext::selectable(const mdl::GroupNode* groupNode) const
+{
+  return cached(groupNode, CachedProperty::Selectable, [&](const auto* node) {
+    return computeSelectable(node);
+  });
+}
+
+bool EditorContext::computeSelectable(const mdl::GroupNode* groupNode) const
 {
   return visible(groupNode) && editable(groupNode) && !groupNode->opened()
          && inOpenGroup(groupNode);
 }
 
 bool EditorContext::selectable(const mdl::EntityNode* entityNode) const
+{
+  return cached(entityNode, CachedProperty::Selectable, [&](const auto* node) {
+    return computeSelectable(node);
+  });
+}
+
+bool EditorContext::computeSelectable(const mdl::EntityNode* entityNode) const
 {
   return visible(entityNode) && editable(entityNode) && !entityNode->hasChildren()
          && inOpenGroup(entityNode);
 }
 
 bool EditorContext::selectable(const mdl::BrushNode* brushNode) const
+{
+  return cached(brushNode, CachedProperty::Selectable, [&](const auto* node) {
+    return computeSelectable(node);
+  });
+}
+
+bool EditorContext::computeSelectable(const mdl::BrushNode* brushNode) const
 {
   return visible(brushNode) && editable(brushNode) && inOpenGroup(brushNode);
 }
@@ -304,6 +442,13 @@ bool EditorContext::selectable(
 }
 
 bool EditorContext::selectable(const mdl::PatchNode* patchNode) const
+{
+  return cached(patchNode, CachedProperty::Selectable, [&](const auto* node) {
+    return computeSelectable(node);
+  });
+}
+
+bool EditorContext::computeSelectable(const mdl::PatchNode* patchNode) const
 {
   return visible(patchNode) && editable(patchNode) && inOpenGroup(patchNode);
 }
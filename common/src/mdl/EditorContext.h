@@ -24,6 +24,10 @@
 
 #include "kdl/dynamic_bitset.h"
 
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
 namespace tb::mdl
 {
 class EntityDefinition;
@@ -38,6 +42,24 @@ class Object;
 class PatchNode;
 class WorldNode;
 
+/**
+ * Decides whether nodes are visible, editable and selectable.
+ *
+ * These properties depend on the state of a node and of its ancestors and descendants,
+ * on its tags, on the settings of this context and on some preferences, and they are
+ * queried for every node in every frame. Therefore, they are cached in the nodes and
+ * stamped with the current stamp of the editor context that computed them.
+ *
+ * Every change to a node that can affect these properties resets the stamps of the node,
+ * its ancestors and its descendants, see Node::invalidateCachedEditorStates. When the
+ * settings of this context or the relevant preferences change, this context takes a new
+ * stamp, which invalidates the cached states of all nodes at once. The relevant
+ * preferences are only read again when the preference manager reports a new revision.
+ *
+ * Queries are thread safe as long as no nodes are modified and the settings of this
+ * context are not changed at the same time. Resetting the stamps of nodes is thread safe,
+ * too, so that nodes can be invalidated while their tags are updated in parallel.
+ */
 class EditorContext
 {
 private:
@@ -48,6 +70,12 @@ private:
 
   mdl::GroupNode* m_currentGroup;
 
+  mutable std::mutex m_preferenceMutex;
+  mutable std::atomic<uint64_t> m_preferenceRevision = 0;
+  mutable uint64_t m_stamp = 0;
+  mutable bool m_showBrushes = false;
+  mutable bool m_showPointEntities = false;
+
 public:
   Notifier<> editorContextDidChangeNotifier;
 
@@ -71,6 +99,20 @@ public:
   void pushGroup(mdl::GroupNode* groupNode);
   void popGroup();
 
+private:
+  enum class CachedProperty
+  {
+    Visible = 0,
+    Editable = 1,
+    Selectable = 2,
+  };
+
+  void invalidateCachedStates();
+  void validatePreferences() const;
+
+  template <typename T, typename F>
+  bool cached(const T* node, CachedProperty property, const F& compute) const;
+
 public:
   bool visible(const mdl::Node* node) const;
   bool visible(const mdl::WorldNode* worldNode) const;
@@ -82,6 +124,10 @@ public:
   bool visible(const mdl::PatchNode* patchNode) const;
 
 private:
+  bool computeVisible(const mdl::GroupNode* groupNode) const;
+  bool computeVisible(const mdl::EntityNode* entityNode) const;
+  bool computeVisible(const mdl::BrushNode* brushNode) const;
+  bool computeVisible(const mdl::PatchNode* patchNode) const;
   bool anyChildVisible(const mdl::Node* node) const;
 
 public:
@@ -97,6 +143,13 @@ public:
   bool selectable(const mdl::BrushNode* brushNode, const mdl::BrushFace& face) const;
   bool selectable(const mdl::PatchNode* patchNode) const;
 
+private:
+  bool computeSelectable(const mdl::GroupNode* groupNode) const;
+  bool computeSelectable(const mdl::EntityNode* entityNode) const;
+  bool computeSelectable(const mdl::BrushNode* brushNode) const;
+  bool computeSelectable(const mdl::PatchNode* patchNode) const;
+
+public:
   bool canChangeSelection() const;
   bool inOpenGroup(const mdl::Object* object) const;
 
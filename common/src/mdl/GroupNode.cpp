@@ -113,6 +113,7 @@ void GroupNode::setHasPendingChanges(const bool hasPendingChanges)
 void GroupNode::setEditState(const EditState editState)
 {
   m_editState = editState;
+  invalidateCachedEditorStates();
 }
 
 void GroupNode::setAncestorEditState(const EditState editState)
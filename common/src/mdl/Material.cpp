@@ -95,9 +95,13 @@ Material::Material(std::string name, std::shared_ptr<TextureResource> textureRes
   : m_name{std::move(name)}
   , m_textureResource{std::move(textureResource)}
 {
+  retainTextureHeaderOnEviction();
 }
 
-Material::~Material() = default;
+Material::~Material()
+{
+  releaseTextureResource();
+}
 
 Material::Material(Material&& other)
   : m_name{std::move(other.m_name)}
@@ -105,24 +109,30 @@ Material::Material(Material&& other)
   , m_absolutePath{std::move(other.m_absolutePath)}
   , m_relativePath{std::move(other.m_relativePath)}
   , m_textureResource{std::move(other.m_textureResource)}
+  , m_textureHeader{std::move(other.m_textureHeader)}
   , m_usageCount{static_cast<size_t>(other.m_usageCount)}
   , m_surfaceParms{std::move(other.m_surfaceParms)}
   , m_culling{std::move(other.m_culling)}
   , m_blendFunc{std::move(other.m_blendFunc)}
 {
+  retainTextureHeaderOnEviction();
 }
 
 Material& Material::operator=(Material&& other)
 {
+  releaseTextureResource();
+
   m_name = std::move(other.m_name);
   m_collectionName = std::move(other.m_collectionName);
   m_absolutePath = std::move(other.m_absolutePath);
   m_relativePath = std::move(other.m_relativePath);
   m_textureResource = std::move(other.m_textureResource);
+  m_textureHeader = std::move(other.m_textureHeader);
   m_usageCount = static_cast<size_t>(other.m_usageCount);
   m_surfaceParms = std::move(other.m_surfaceParms);
   m_culling = std::move(other.m_culling);
   m_blendFunc = std::move(other.m_blendFunc);
+  retainTextureHeaderOnEviction();
   return *this;
 }
 
@@ -176,6 +186,46 @@ const TextureResource& Material::textureResource() const
   return *m_textureResource;
 }
 
+const std::optional<TextureHeader>& Material::textureHeader() const
+{
+  return m_textureHeader;
+}
+
+void Material::setTextureHeader(TextureHeader textureHeader)
+{
+  m_textureHeader = std::move(textureHeader);
+}
+
+void Material::requestTexture(const LoadPriority loadPriority) const
+{
+  m_textureResource->requestLoad(loadPriority);
+}
+
+void Material::retainTextureHeaderOnEviction()
+{
+  if (m_textureResource)
+  {
+    // keep reporting the texture's size and embedded defaults while it is evicted, even
+    // if its header could not be read when the material was loaded
+    m_textureResource->setEvictionHandler([this](const Texture& texture) {
+      m_textureHeader =
+        TextureHeader{texture.width(), texture.height(), texture.embeddedDefaults()};
+    });
+  }
+}
+
+void Material::releaseTextureResource()
+{
+  if (m_textureResource)
+  {
+    m_textureResource->setEvictionHandler({});
+    for (size_t i = 0; i < m_usageCount; ++i)
+    {
+      m_textureResource->unpin();
+    }
+  }
+}
+
 const std::set<std::string>& Material::surfaceParms() const
 {
   return m_surfaceParms;
@@ -216,6 +266,8 @@ size_t Material::usageCount() const
 void Material::incUsageCount()
 {
   ++m_usageCount;
+  // the texture of a used material must not be evicted
+  m_textureResource->pin();
 }
 
 void Material::decUsageCount()
@@ -223,6 +275,7 @@ void Material::decUsageCount()
   const size_t previous = m_usageCount--;
   assert(previous > 0);
   unused(previous);
+  m_textureResource->unpin();
 }
 
 void Material::activate(const int minFilter, const int magFilter) const
@@ -301,4 +354,14 @@ Texture* getTexture(Material* material)
   return material ? material->texture() : nullptr;
 }
 
+std::optional<TextureHeader> getTextureHeader(const Material* material)
+{
+  if (const auto* texture = getTexture(material))
+  {
+    return TextureHeader{
+      texture->width(), texture->height(), texture->embeddedDefaults()};
+  }
+  return material ? material->textureHeader() : std::nullopt;
+}
+
 } // namespace tb::mdl
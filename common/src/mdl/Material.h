@@ -27,6 +27,7 @@
 #include <atomic>
 #include <filesystem>
 #include <memory>
+#include <optional>
 #include <set>
 #include <string>
 
@@ -91,6 +92,7 @@ private:
   std::filesystem::path m_relativePath;
 
   std::shared_ptr<TextureResource> m_textureResource;
+  std::optional<TextureHeader> m_textureHeader;
 
   std::atomic<size_t> m_usageCount = 0;
 
@@ -112,6 +114,7 @@ private:
     m_absolutePath,
     m_relativePath,
     m_textureResource,
+    m_textureHeader,
     m_usageCount,
     m_surfaceParms,
     m_culling,
@@ -150,6 +153,22 @@ public:
 
   const TextureResource& textureResource() const;
 
+  /**
+   * The texture header that was read when this material was loaded, if any. It allows
+   * querying the texture size and embedded defaults before the texture is loaded. When
+   * the texture is evicted, the header is replaced with that of the evicted texture.
+   */
+  const std::optional<TextureHeader>& textureHeader() const;
+  void setTextureHeader(TextureHeader textureHeader);
+
+  /**
+   * Requests that the texture is loaded if its loading was deferred. Must be called on
+   * the thread that processes the resources.
+   *
+   * Pass LoadPriority::High if the material is currently visible.
+   */
+  void requestTexture(LoadPriority loadPriority = LoadPriority::Normal) const;
+
   const std::set<std::string>& surfaceParms() const;
   void setSurfaceParms(std::set<std::string> surfaceParms);
 
@@ -160,14 +179,33 @@ public:
   void disableBlend();
 
   size_t usageCount() const;
+
+  /**
+   * A used material pins its texture resource so that the texture is not evicted.
+   */
   void incUsageCount();
   void decUsageCount();
 
   void activate(int minFilter, int magFilter) const;
   void deactivate() const;
+
+private:
+  void retainTextureHeaderOnEviction();
+  void releaseTextureResource();
 };
 
 const Texture* getTexture(const Material* material);
 Texture* getTexture(Material* material);
 
+/**
+ * Returns the header of the given material's texture. If the texture is loaded, the
+ * header is taken from it, otherwise the header read when the material was loaded is
+ * returned.
+ *
+ * Returns nullopt if the texture is not loaded and its header could not be read. Callers
+ * then use a placeholder size until the texture is loaded: brush faces compute UVs for a
+ * 1*1 texture and the material browser lays out a 64*64 cell.
+ */
+std::optional<TextureHeader> getTextureHeader(const Material* material);
+
 } // namespace tb::mdl
@@ -31,6 +31,7 @@
 #include "kdl/vector_utils.h"
 
 #include <algorithm>
+#include <chrono>
 #include <string>
 #include <unordered_set>
 #include <vector>
@@ -52,6 +53,8 @@ void MaterialManager::reload(
   kdl::task_manager& taskManager)
 {
   clear();
+
+  const auto startTime = std::chrono::high_resolution_clock::now();
   io::loadMaterialCollections(fs, materialConfig, createResource, taskManager, m_logger)
     | kdl::transform([&](auto materialCollections) {
         for (auto& collection : materialCollections)
@@ -59,6 +62,13 @@ void MaterialManager::reload(
           addMaterialCollection(std::move(collection));
         }
         updateMaterials();
+
+        const auto endTime = std::chrono::high_resolution_clock::now();
+        m_logger.debug() << "Scanned " << m_materials.size() << " materials in "
+                         << std::chrono::duration_cast<std::chrono::milliseconds>(
+                              endTime - startTime)
+                              .count()
+                         << "ms";
       })
     | kdl::transform_error([&](auto e) {
         m_logger.error() << "Could not reload material collections: " + e.msg;
@@ -24,6 +24,7 @@
 #include "mdl/BrushFaceHandle.h"
 #include "mdl/EditorContext.h"
 #include "mdl/NodeQueries.h"
+#include "mdl/ParallelTraversal.h"
 
 #include "kdl/vector_utils.h"
 
@@ -298,6 +299,44 @@ std::vector<Node*> collectSelectableNodes(
   return result;
 }
 
+std::vector<Node*> collectSelectableNodes(
+  const std::vector<Node*>& nodes,
+  const EditorContext& editorContext,
+  kdl::task_manager& taskManager)
+{
+  // Collect the candidates like the serial version, but defer checking whether brushes,
+  // patches and entities are selectable. Groups are still checked here because the
+  // children of selectable groups are skipped.
+  auto candidates = std::vector<Node*>{};
+
+  for (auto* node : nodes)
+  {
+    node->accept(kdl::overload(
+      [&](auto&& thisLambda, WorldNode* world) { world->visitChildren(thisLambda); },
+      [&](auto&& thisLambda, LayerNode* layer) { layer->visitChildren(thisLambda); },
+      [&](auto&& thisLambda, GroupNode* group) {
+        if (editorContext.selectable(group))
+        {
+          candidates.push_back(group);
+        }
+        else
+        {
+          group->visitChildren(thisLambda);
+        }
+      },
+      [&](auto&& thisLambda, EntityNode* entity) {
+        candidates.push_back(entity);
+        entity->visitChildren(thisLambda);
+      },
+      [&](BrushNode* brush) { candidates.push_back(brush); },
+      [&](PatchNode* patch) { candidates.push_back(patch); }));
+  }
+
+  return parallelFilter(candidates, taskManager, [&](const auto* node) {
+    return editorContext.selectable(node);
+  });
+}
+
 std::vector<BrushFaceHandle> collectSelectedBrushFaces(const std::vector<Node*>& nodes)
 {
   return collectBrushFaces(nodes, [](const BrushNode&, const BrushFace& brushFace) {
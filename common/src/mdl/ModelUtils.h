@@ -26,6 +26,11 @@
 #include <map>
 #include <vector>
 
+namespace kdl
+{
+class task_manager;
+}
+
 namespace tb::mdl
 {
 
@@ -68,6 +73,15 @@ std::vector<Node*> collectSelectedNodes(const std::vector<Node*>& nodes);
 std::vector<Node*> collectSelectableNodes(
   const std::vector<Node*>& nodes, const EditorContext& editorContext);
 
+/**
+ * Like collectSelectableNodes, but checks whether the nodes are selectable in parallel on
+ * the given task manager. The nodes are returned in the same order.
+ */
+std::vector<Node*> collectSelectableNodes(
+  const std::vector<Node*>& nodes,
+  const EditorContext& editorContext,
+  kdl::task_manager& taskManager);
+
 std::vector<BrushFaceHandle> collectSelectedBrushFaces(const std::vector<Node*>& nodes);
 std::vector<BrushFaceHandle> collectSelectableBrushFaces(
   const std::vector<Node*>& nodes, const EditorContext& editorContext);
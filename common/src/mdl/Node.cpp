@@ -39,6 +39,33 @@ namespace tb::mdl
 
 kdl_reflect_impl(NodePath);
 
+namespace
+{
+
+void invalidateCachedEditorState(const Node* node)
+{
+  node->cachedEditorState().value.store(0, std::memory_order_relaxed);
+}
+
+void invalidateCachedEditorStatesOfAncestors(const Node* node)
+{
+  for (const auto* ancestor = node->parent(); ancestor; ancestor = ancestor->parent())
+  {
+    invalidateCachedEditorState(ancestor);
+  }
+}
+
+void invalidateCachedEditorStatesOfDescendants(const Node* node)
+{
+  for (const auto* child : node->children())
+  {
+    invalidateCachedEditorState(child);
+    invalidateCachedEditorStatesOfDescendants(child);
+  }
+}
+
+} // namespace
+
 Node::Node() = default;
 
 Node::~Node()
@@ -426,9 +453,11 @@ void Node::setParent(Node* parent)
   assert(parent != this);
   if (parent != m_parent)
   {
+    invalidateCachedEditorStatesOfAncestors(this);
     parentWillChange();
     m_parent = parent;
     parentDidChange();
+    invalidateCachedEditorStates();
   }
 }
 
@@ -475,6 +504,7 @@ void Node::nodeWillChange()
 
 void Node::nodeDidChange()
 {
+  invalidateCachedEditorStates();
   if (m_parent)
   {
     m_parent->childDidChange(this);
@@ -571,6 +601,7 @@ void Node::select()
   {
     assert(!m_selected);
     m_selected = true;
+    invalidateCachedEditorStates();
     if (m_parent)
     {
       m_parent->childWasSelected();
@@ -584,6 +615,7 @@ void Node::deselect()
   {
     assert(m_selected);
     m_selected = false;
+    invalidateCachedEditorStates();
     if (m_parent)
     {
       m_parent->childWasDeselected();
@@ -719,6 +751,7 @@ bool Node::setVisibilityState(const VisibilityState visibility)
   if (visibility != m_visibilityState)
   {
     m_visibilityState = visibility;
+    invalidateCachedEditorStates();
     return true;
   }
   return false;
@@ -762,6 +795,7 @@ bool Node::setLockState(const LockState lockState)
   if (lockState != m_lockState)
   {
     m_lockState = lockState;
+    invalidateCachedEditorStates();
     return true;
   }
   return false;
@@ -774,7 +808,23 @@ bool Node::lockedByOtherSelection() const
 
 void Node::setLockedByOtherSelection(const bool lockedByOtherSelection)
 {
-  m_lockedByOtherSelection = lockedByOtherSelection;
+  if (lockedByOtherSelection != m_lockedByOtherSelection)
+  {
+    m_lockedByOtherSelection = lockedByOtherSelection;
+    invalidateCachedEditorStates();
+  }
+}
+
+CachedEditorState& Node::cachedEditorState() const
+{
+  return m_cachedEditorState;
+}
+
+void Node::invalidateCachedEditorStates() const
+{
+  invalidateCachedEditorState(this);
+  invalidateCachedEditorStatesOfAncestors(this);
+  invalidateCachedEditorStatesOfDescendants(this);
 }
 
 void Node::pick(
@@ -832,6 +882,7 @@ void Node::validateIssues(const std::vector<const Validator*>& validators)
 {
   if (!m_issuesValid)
   {
+    m_issues.clear();
     for (const auto* validator : validators)
     {
       validator->validate(*this, m_issues);
@@ -842,7 +893,6 @@ void Node::validateIssues(const std::vector<const Validator*>& validators)
 
 void Node::invalidateIssues() const
 {
-  m_issues.clear();
   m_issuesValid = false;
 }
 
@@ -879,6 +929,11 @@ void Node::removeFromIndex(
   doRemoveFromIndex(node, key, value);
 }
 
+void Node::doTagsDidChange()
+{
+  invalidateCachedEditorStates();
+}
+
 Node* Node::doCloneRecursively(const vm::bbox3d& worldBounds) const
 {
   auto* clone = Node::clone(worldBounds);
@@ -32,7 +32,10 @@
 #include "vm/util.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -56,6 +59,21 @@ struct NodePath
   kdl_reflect_decl(NodePath, indices);
 };
 
+/**
+ * The visibility, editability and selectability of a node as computed by an editor
+ * context. The lower bits hold the computed values and the upper bits hold the stamp of
+ * the editor context that computed them, see EditorContext. The state is reset to 0 when
+ * the node or one of its ancestors or descendants changes.
+ *
+ * The state is atomic so that editor contexts can be queried for different nodes in
+ * parallel, and so that nodes can be invalidated while their tags are updated in
+ * parallel.
+ */
+struct CachedEditorState
+{
+  std::atomic<uint64_t> value = 0;
+};
+
 class Node : public Taggable
 {
 private:
@@ -71,6 +89,8 @@ private:
   LockState m_lockState = LockState::Inherited;
   bool m_lockedByOtherSelection = false;
 
+  mutable CachedEditorState m_cachedEditorState;
+
   mutable size_t m_lineNumber = 0;
   mutable size_t m_lineCount = 0;
 
@@ -339,6 +359,18 @@ public: // visibility, locking
   bool lockedByOtherSelection() const;
   void setLockedByOtherSelection(bool lockedByOtherSelection);
 
+  /**
+   * Returns the state of this node that was cached by an editor context. Should only be
+   * used by EditorContext.
+   */
+  CachedEditorState& cachedEditorState() const;
+
+  /**
+   * Invalidates the states cached by editor contexts for this node, its ancestors and
+   * its descendants.
+   */
+  void invalidateCachedEditorStates() const;
+
 public: // picking
   void pick(const EditorContext& editorContext, const vm::ray3d& ray, PickResult& result);
   void findNodesContaining(const vm::vec3d& point, std::vector<Node*>& result);
@@ -355,6 +387,10 @@ public: // issue management
   void setIssueHidden(IssueType type, bool hidden);
 
 public: // should only be called from this and from the world
+  /**
+   * Marks the issues of this node as invalid. The issues are kept alive until the node is
+   * validated again, so observers that refer to them can still remove them safely.
+   */
   void invalidateIssues() const;
 
 private:
@@ -502,6 +538,9 @@ protected: // index management
   void removeFromIndex(
     EntityNodeBase* node, const std::string& key, const std::string& value);
 
+private: // implement Taggable interface
+  void doTagsDidChange() override;
+
 private: // subclassing interface
   virtual const std::string& doGetName() const = 0;
   virtual const vm::bbox3d& doGetLogicalBounds() const = 0;
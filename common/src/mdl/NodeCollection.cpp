@@ -31,7 +31,7 @@
 #include "kdl/overload.h"
 #include "kdl/reflection_impl.h"
 
-#include <algorithm>
+#include <unordered_set>
 #include <vector>
 
 namespace tb::mdl
@@ -51,6 +51,11 @@ bool NodeCollection::empty() const
   return m_nodes.empty();
 }
 
+bool NodeCollection::contains(const Node* node) const
+{
+  return m_nodeSet.contains(node);
+}
+
 size_t NodeCollection::nodeCount() const
 {
   return m_nodes.size();
@@ -183,6 +188,8 @@ const std::vector<PatchNode*>& NodeCollection::patches() const
 
 void NodeCollection::addNodes(const std::vector<Node*>& nodes)
 {
+  m_nodeSet.reserve(m_nodeSet.size() + nodes.size());
+  m_nodes.reserve(m_nodes.size() + nodes.size());
   for (auto* node : nodes)
   {
     addNode(node);
@@ -192,110 +199,61 @@ void NodeCollection::addNodes(const std::vector<Node*>& nodes)
 void NodeCollection::addNode(Node* node)
 {
   ensure(node != nullptr, "node is null");
-  node->accept(kdl::overload(
-    [](WorldNode*) {},
-    [&](LayerNode* layer) {
-      m_nodes.push_back(layer);
-      m_layers.push_back(layer);
-    },
-    [&](GroupNode* group) {
-      m_nodes.push_back(group);
-      m_groups.push_back(group);
-    },
-    [&](EntityNode* entity) {
-      m_nodes.push_back(entity);
-      m_entities.push_back(entity);
-    },
-    [&](BrushNode* brush) {
-      m_nodes.push_back(brush);
-      m_brushes.push_back(brush);
-    },
-    [&](PatchNode* patch) {
-      m_nodes.push_back(patch);
-      m_patches.push_back(patch);
-    }));
-}
-
-static const auto doRemoveNodes = [](
-                                    auto& nodes,
-                                    auto& layers,
-                                    auto& groups,
-                                    auto& entities,
-                                    auto& brushes,
-                                    auto& patches,
-                                    auto cur,
-                                    auto end) {
-  auto nodeEnd = std::end(nodes);
-  auto layerEnd = std::end(layers);
-  auto groupEnd = std::end(groups);
-  auto entityEnd = std::end(entities);
-  auto brushEnd = std::end(brushes);
-  auto patchEnd = std::end(patches);
-
-  while (cur != end)
+  if (contains(node))
   {
-    (*cur)->accept(kdl::overload(
-      [](WorldNode*) {},
-      [&](LayerNode* layer) {
-        nodeEnd = std::remove(std::begin(nodes), nodeEnd, layer);
-        layerEnd = std::remove(std::begin(layers), layerEnd, layer);
-      },
-      [&](GroupNode* group) {
-        nodeEnd = std::remove(std::begin(nodes), nodeEnd, group);
-        groupEnd = std::remove(std::begin(groups), groupEnd, group);
-      },
-      [&](EntityNode* entity) {
-        nodeEnd = std::remove(std::begin(nodes), nodeEnd, entity);
-        entityEnd = std::remove(std::begin(entities), entityEnd, entity);
-      },
-      [&](BrushNode* brush) {
-        nodeEnd = std::remove(std::begin(nodes), nodeEnd, brush);
-        brushEnd = std::remove(std::begin(brushes), brushEnd, brush);
-      },
-      [&](PatchNode* patch) {
-        nodeEnd = std::remove(std::begin(nodes), nodeEnd, patch);
-        patchEnd = std::remove(std::begin(patches), patchEnd, patch);
-      }));
-    ++cur;
+    return;
   }
 
-  nodes.erase(nodeEnd, std::end(nodes));
-  layers.erase(layerEnd, std::end(layers));
-  groups.erase(groupEnd, std::end(groups));
-  entities.erase(entityEnd, std::end(entities));
-  brushes.erase(brushEnd, std::end(brushes));
-  patches.erase(patchEnd, std::end(patches));
-};
+  const auto add = [&](auto* typedNode, auto& typedNodes) {
+    m_nodeSet.insert(typedNode);
+    m_nodes.push_back(typedNode);
+    typedNodes.push_back(typedNode);
+  };
+
+  node->accept(kdl::overload(
+    [](WorldNode*) {},
+    [&](LayerNode* layer) { add(layer, m_layers); },
+    [&](GroupNode* group) { add(group, m_groups); },
+    [&](EntityNode* entity) { add(entity, m_entities); },
+    [&](BrushNode* brush) { add(brush, m_brushes); },
+    [&](PatchNode* patch) { add(patch, m_patches); }));
+}
 
 void NodeCollection::removeNodes(const std::vector<Node*>& nodes)
 {
-  doRemoveNodes(
-    m_nodes,
-    m_layers,
-    m_groups,
-    m_entities,
-    m_brushes,
-    m_patches,
-    std::begin(nodes),
-    std::end(nodes));
+  auto nodesToRemove = std::unordered_set<const Node*>{};
+  nodesToRemove.reserve(nodes.size());
+
+  for (const auto* node : nodes)
+  {
+    if (m_nodeSet.erase(node) > 0)
+    {
+      nodesToRemove.insert(node);
+    }
+  }
+
+  if (!nodesToRemove.empty())
+  {
+    const auto isRemoved = [&](const auto* node) { return nodesToRemove.contains(node); };
+
+    std::erase_if(m_nodes, isRemoved);
+    std::erase_if(m_layers, isRemoved);
+    std::erase_if(m_groups, isRemoved);
+    std::erase_if(m_entities, isRemoved);
+    std::erase_if(m_brushes, isRemoved);
+    std::erase_if(m_patches, isRemoved);
+  }
 }
 
 void NodeCollection::removeNode(Node* node)
 {
   ensure(node != nullptr, "node is null");
-  doRemoveNodes(
-    m_nodes,
-    m_layers,
-    m_groups,
-    m_entities,
-    m_brushes,
-    m_patches,
-    &node,
-    std::next(&node));
+  removeNodes({node});
 }
 
 void NodeCollection::clear()
 {
+  m_nodeSet.clear();
   m_nodes.clear();
   m_layers.clear();
   m_groups.clear();
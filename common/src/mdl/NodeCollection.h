@@ -22,6 +22,7 @@
 #include "kdl/reflection_decl.h"
 
 #include <cstddef>
+#include <unordered_set>
 #include <vector>
 
 namespace tb::mdl
@@ -33,9 +34,19 @@ class LayerNode;
 class Node;
 class PatchNode;
 
+/**
+ * A collection of nodes that keeps the nodes in insertion order, both overall and per
+ * node type.
+ *
+ * Membership is tracked in a hash set, so adding nodes and checking whether a node is
+ * contained takes constant time, and removing k nodes from a collection of n nodes takes
+ * O(n + k) time regardless of the number of nodes removed. Adding a node that is already
+ * contained has no effect.
+ */
 class NodeCollection
 {
 private:
+  std::unordered_set<const Node*> m_nodeSet;
   std::vector<Node*> m_nodes;
   std::vector<LayerNode*> m_layers;
   std::vector<GroupNode*> m_groups;
@@ -51,6 +62,7 @@ public:
   explicit NodeCollection(const std::vector<Node*>& nodes);
 
   bool empty() const;
+  bool contains(const Node* node) const;
   size_t nodeCount() const;
   size_t layerCount() const;
   size_t groupCount() const;
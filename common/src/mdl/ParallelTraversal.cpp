@@ -0,0 +1,88 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ParallelTraversal.h"
+
+#include "kdl/task_manager.h"
+
+#include <algorithm>
+
+namespace tb::mdl::detail
+{
+namespace
+{
+
+void collectNodesAndDescendants(Node* node, std::vector<Node*>& result)
+{
+  result.push_back(node);
+  for (auto* child : node->children())
+  {
+    collectNodesAndDescendants(child, result);
+  }
+}
+
+} // namespace
+
+std::vector<Node*> collectNodesAndDescendants(const std::vector<Node*>& nodes)
+{
+  auto result = std::vector<Node*>{};
+  for (auto* node : nodes)
+  {
+    collectNodesAndDescendants(node, result);
+  }
+  return result;
+}
+
+size_t parallelTraversalBatchCount(const size_t nodeCount)
+{
+  return (nodeCount + ParallelTraversalBatchSize - 1) / ParallelTraversalBatchSize;
+}
+
+void runInParallelBatches(
+  const size_t nodeCount,
+  kdl::task_manager& taskManager,
+  const std::function<void(size_t, size_t, size_t)>& processBatch)
+{
+  const auto batchCount = parallelTraversalBatchCount(nodeCount);
+  if (batchCount == 0)
+  {
+    return;
+  }
+
+  if (batchCount == 1)
+  {
+    processBatch(0, 0, nodeCount);
+    return;
+  }
+
+  auto tasks = std::vector<std::function<bool()>>{};
+  tasks.reserve(batchCount);
+  for (size_t batchIndex = 0; batchIndex < batchCount; ++batchIndex)
+  {
+    tasks.emplace_back([&, batchIndex]() {
+      const auto first = batchIndex * ParallelTraversalBatchSize;
+      const auto last = std::min(first + ParallelTraversalBatchSize, nodeCount);
+      processBatch(batchIndex, first, last);
+      return true;
+    });
+  }
+  taskManager.run_tasks_and_wait(tasks);
+}
+
+} // namespace tb::mdl::detail
@@ -0,0 +1,185 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "mdl/Node.h"
+
+#include "kdl/overload.h"
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace kdl
+{
+class task_manager;
+}
+
+namespace tb::mdl
+{
+class BrushNode;
+class EntityNode;
+class GroupNode;
+class LayerNode;
+class PatchNode;
+class WorldNode;
+
+namespace detail
+{
+
+constexpr auto ParallelTraversalBatchSize = size_t(1024);
+
+/**
+ * Returns the given nodes and all of their descendants in depth first order.
+ */
+std::vector<Node*> collectNodesAndDescendants(const std::vector<Node*>& nodes);
+
+size_t parallelTraversalBatchCount(size_t nodeCount);
+
+/**
+ * Splits the range [0, nodeCount) into batches of at most ParallelTraversalBatchSize
+ * elements and calls the given function for each batch on the given task manager. The
+ * function is called with the index of the batch and the first and last (exclusive)
+ * index of the batch. If there is only one batch, it is processed on the calling thread.
+ */
+void runInParallelBatches(
+  size_t nodeCount,
+  kdl::task_manager& taskManager,
+  const std::function<void(size_t, size_t, size_t)>& processBatch);
+
+} // namespace detail
+
+/**
+ * Visits the given nodes and all of their descendants with the given lambda, distributing
+ * the nodes over the given task manager in batches of equal size.
+ *
+ * The tree is flattened before the lambda is called, so the lambda must not visit the
+ * children of the node it is passed. Since the lambda is called concurrently, it must
+ * only modify the node it is passed, and only in ways that don't affect other nodes,
+ * e.g. by changing the bounds of the node's parent.
+ */
+template <typename L>
+void parallelVisitAll(
+  const std::vector<Node*>& nodes, kdl::task_manager& taskManager, const L& lambda)
+{
+  const auto allNodes = detail::collectNodesAndDescendants(nodes);
+  detail::runInParallelBatches(
+    allNodes.size(),
+    taskManager,
+    [&](const size_t, const size_t first, const size_t last) {
+      for (auto i = first; i < last; ++i)
+      {
+        allNodes[i]->accept(lambda);
+      }
+    });
+}
+
+/**
+ * Visits the given nodes and all of their descendants like parallelVisitAll and reduces
+ * the results to a single value.
+ *
+ * Every batch of nodes starts with a copy of the given initial value, which is passed to
+ * the lambda together with each node of the batch. The values of the batches are then
+ * combined in the order of the nodes using the given combine function.
+ *
+ * @param nodes the nodes to visit
+ * @param taskManager the task manager to run the batches on
+ * @param init the initial value of every batch
+ * @param lambda a function `void(T&, N*)` that is called for every node, where N is the
+ * type of the node
+ * @param combine a function `T(T, T)` that combines the values of two batches
+ */
+template <typename T, typename L, typename C>
+T parallelVisitAllAndReduce(
+  const std::vector<Node*>& nodes,
+  kdl::task_manager& taskManager,
+  const T& init,
+  const L& lambda,
+  const C& combine)
+{
+  const auto allNodes = detail::collectNodesAndDescendants(nodes);
+  auto batchResults =
+    std::vector<T>(detail::parallelTraversalBatchCount(allNodes.size()), init);
+
+  detail::runInParallelBatches(
+    allNodes.size(),
+    taskManager,
+    [&](const size_t batchIndex, const size_t first, const size_t last) {
+      auto& batchResult = batchResults[batchIndex];
+      for (auto i = first; i < last; ++i)
+      {
+        allNodes[i]->accept(kdl::overload(
+          [&](WorldNode* worldNode) { lambda(batchResult, worldNode); },
+          [&](LayerNode* layerNode) { lambda(batchResult, layerNode); },
+          [&](GroupNode* groupNode) { lambda(batchResult, groupNode); },
+          [&](EntityNode* entityNode) { lambda(batchResult, entityNode); },
+          [&](BrushNode* brushNode) { lambda(batchResult, brushNode); },
+          [&](PatchNode* patchNode) { lambda(batchResult, patchNode); }));
+      }
+    });
+
+  auto result = init;
+  for (auto& batchResult : batchResults)
+  {
+    result = combine(std::move(result), std::move(batchResult));
+  }
+  return result;
+}
+
+/**
+ * Returns the given nodes for which the given predicate returns true in their original
+ * order. The predicate is evaluated in parallel like parallelVisitAll, but unlike
+ * parallelVisitAll, the descendants of the given nodes are not visited.
+ *
+ * @param nodes the nodes to filter
+ * @param taskManager the task manager to run the batches on
+ * @param predicate a function `bool(Node*)` that is called for every node
+ */
+template <typename P>
+std::vector<Node*> parallelFilter(
+  const std::vector<Node*>& nodes, kdl::task_manager& taskManager, const P& predicate)
+{
+  auto batchResults =
+    std::vector<std::vector<Node*>>(detail::parallelTraversalBatchCount(nodes.size()));
+
+  detail::runInParallelBatches(
+    nodes.size(),
+    taskManager,
+    [&](const size_t batchIndex, const size_t first, const size_t last) {
+      auto& batchResult = batchResults[batchIndex];
+      for (auto i = first; i < last; ++i)
+      {
+        if (predicate(nodes[i]))
+        {
+          batchResult.push_back(nodes[i]);
+        }
+      }
+    });
+
+  auto result = std::vector<Node*>{};
+  for (auto& batchResult : batchResults)
+  {
+    result.insert(result.end(), batchResult.begin(), batchResult.end());
+  }
+  return result;
+}
+
+} // namespace tb::mdl
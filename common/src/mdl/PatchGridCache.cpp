@@ -0,0 +1,152 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PatchGridCache.h"
+
+#include "mdl/PatchNode.h"
+
+#include "kdl/hash_utils.h"
+#include "kdl/task_manager.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace tb::mdl
+{
+namespace
+{
+
+constexpr auto RecentGridCount = size_t(256);
+constexpr auto MinPurgeThreshold = size_t(1024);
+
+} // namespace
+
+size_t PatchGridCache::KeyHash::operator()(const Key& key) const
+{
+  auto result =
+    kdl::hash(key.pointRowCount, key.pointColumnCount, key.subdivisionsPerSurface);
+  for (const auto& point : key.controlPoints)
+  {
+    for (size_t i = 0u; i < BezierPatch::Point::size; ++i)
+    {
+      result ^= kdl::hash(point[i]) + 0x9e3779b9u + (result << 6) + (result >> 2);
+    }
+  }
+  return result;
+}
+
+PatchGridCache::PatchGridCache()
+  : m_purgeThreshold{MinPurgeThreshold}
+{
+}
+
+std::shared_ptr<const PatchGrid> PatchGridCache::get(const BezierPatch& patch)
+{
+  const auto subdivisionsPerSurface = computeSubdivisionsPerSurface(patch);
+  auto key = Key{
+    patch.pointRowCount(),
+    patch.pointColumnCount(),
+    subdivisionsPerSurface,
+    patch.controlPoints()};
+
+  {
+    const auto lock = std::lock_guard{m_mutex};
+    if (const auto it = m_grids.find(key); it != m_grids.end())
+    {
+      if (auto grid = it->second.lock())
+      {
+        retain(grid);
+        return grid;
+      }
+    }
+  }
+
+  // tessellate without holding the lock
+  auto grid =
+    std::make_shared<const PatchGrid>(makePatchGrid(patch, subdivisionsPerSurface));
+
+  const auto lock = std::lock_guard{m_mutex};
+  auto& cachedGrid = m_grids[std::move(key)];
+  if (auto existingGrid = cachedGrid.lock())
+  {
+    // another thread tessellated the same patch in the meantime
+    retain(existingGrid);
+    return existingGrid;
+  }
+
+  cachedGrid = grid;
+  retain(grid);
+  purgeExpiredGrids();
+  return grid;
+}
+
+std::vector<std::shared_ptr<const PatchGrid>> PatchGridCache::get(
+  const std::vector<const BezierPatch*>& patches, kdl::task_manager& taskManager)
+{
+  constexpr auto PatchesPerTask = size_t(32);
+
+  auto result = std::vector<std::shared_ptr<const PatchGrid>>(patches.size());
+  if (patches.size() <= PatchesPerTask)
+  {
+    for (size_t i = 0; i < patches.size(); ++i)
+    {
+      result[i] = get(*patches[i]);
+    }
+    return result;
+  }
+
+  auto tasks = std::vector<std::function<bool()>>{};
+  for (size_t first = 0; first < patches.size(); first += PatchesPerTask)
+  {
+    tasks.emplace_back([&, first]() {
+      const auto last = std::min(first + PatchesPerTask, patches.size());
+      for (auto i = first; i < last; ++i)
+      {
+        result[i] = get(*patches[i]);
+      }
+      return true;
+    });
+  }
+  taskManager.run_tasks_and_wait(tasks);
+  return result;
+}
+
+void PatchGridCache::retain(std::shared_ptr<const PatchGrid> grid)
+{
+  if (m_recentGrids.size() < RecentGridCount)
+  {
+    m_recentGrids.push_back(std::move(grid));
+  }
+  else
+  {
+    m_recentGrids[m_nextRecentGrid] = std::move(grid);
+    m_nextRecentGrid = (m_nextRecentGrid + 1u) % RecentGridCount;
+  }
+}
+
+void PatchGridCache::purgeExpiredGrids()
+{
+  if (m_grids.size() >= m_purgeThreshold)
+  {
+    std::erase_if(m_grids, [](const auto& entry) { return entry.second.expired(); });
+    m_purgeThreshold = std::max(MinPurgeThreshold, 2u * m_grids.size());
+  }
+}
+
+} // namespace tb::mdl
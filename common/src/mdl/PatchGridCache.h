@@ -0,0 +1,96 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Macros.h"
+#include "mdl/BezierPatch.h"
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace kdl
+{
+class task_manager;
+}
+
+namespace tb::mdl
+{
+struct PatchGrid;
+
+/**
+ * Caches the grids of patches by their control points and number of subdivisions, so
+ * patches with identical control points share one grid. The document owns a cache and
+ * uses it to tessellate the patches that are restored by undo and redo.
+ *
+ * The cache only holds weak references to its grids, except for the most recently used
+ * ones. The cache is thread safe.
+ */
+class PatchGridCache
+{
+private:
+  struct Key
+  {
+    size_t pointRowCount;
+    size_t pointColumnCount;
+    size_t subdivisionsPerSurface;
+    std::vector<BezierPatch::Point> controlPoints;
+
+    bool operator==(const Key& other) const = default;
+  };
+
+  struct KeyHash
+  {
+    size_t operator()(const Key& key) const;
+  };
+
+  std::mutex m_mutex;
+  std::unordered_map<Key, std::weak_ptr<const PatchGrid>, KeyHash> m_grids;
+  // keeps the most recently used grids alive so that they survive undo and redo
+  std::vector<std::shared_ptr<const PatchGrid>> m_recentGrids;
+  size_t m_nextRecentGrid = 0u;
+  size_t m_purgeThreshold;
+
+public:
+  PatchGridCache();
+
+  /**
+   * Returns the grid for the given patch, subdivided according to
+   * computeSubdivisionsPerSurface. The grid is tessellated if it is not cached.
+   */
+  std::shared_ptr<const PatchGrid> get(const BezierPatch& patch);
+
+  /**
+   * Returns the grids for the given patches, tessellating the uncached ones in parallel.
+   * The returned grids remain in the cache at least as long as the caller holds on to
+   * them.
+   */
+  std::vector<std::shared_ptr<const PatchGrid>> get(
+    const std::vector<const BezierPatch*>& patches, kdl::task_manager& taskManager);
+
+private:
+  void retain(std::shared_ptr<const PatchGrid> grid);
+  void purgeExpiredGrids();
+
+  deleteCopyAndMove(PatchGridCache);
+};
+
+} // namespace tb::mdl
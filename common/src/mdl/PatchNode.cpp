@@ -39,13 +39,16 @@
 #include "vm/intersection.h"
 #include "vm/vec_io.h" // IWYU pragma: keep
 
+#include <algorithm>
 #include <cassert>
 #include <string>
 
 namespace tb::mdl
 {
 
-constexpr static size_t DefaultSubdivisionsPerSurface = 3u;
+constexpr static size_t MaxSubdivisionsPerSurface = 3u;
+constexpr static double MaxPositionDeviation = 0.5;
+constexpr static double MaxUVDeviation = 1.0 / 64.0;
 
 kdl_reflect_impl(PatchGrid::Point);
 
@@ -291,12 +294,166 @@ PatchGrid makePatchGrid(const BezierPatch& patch, const size_t subdivisionsPerSu
     gridPointRowCount, gridPointColumnCount, std::move(points), boundsBuilder.bounds()};
 }
 
+namespace
+{
+
+/**
+ * Returns the distance between the midpoint of the quadratic Bezier curve with the given
+ * control points and the midpoint of the line segment between its end points. This is the
+ * maximum deviation of the curve from the linear interpolation of its end points.
+ *
+ * Subdividing the curve into n segments reduces the deviation of each segment by a
+ * factor of n * n.
+ */
+template <size_t S>
+double curveDeviation(
+  const vm::vec<double, S>& p0,
+  const vm::vec<double, S>& p1,
+  const vm::vec<double, S>& p2)
+{
+  return vm::length(p0 - 2.0 * p1 + p2) / 4.0;
+}
+
+/**
+ * Returns the distance between the center of the bilinear surface spanned by the given
+ * corner points and the midpoint of either of its diagonals. This is the deviation of the
+ * two triangles of a quad from a twisted surface, even if its rows and columns are
+ * straight lines.
+ *
+ * Subdividing the surface into n * n quads reduces the twist of each quad by a factor of
+ * n * n.
+ */
+template <size_t S>
+double surfaceTwist(
+  const vm::vec<double, S>& p00,
+  const vm::vec<double, S>& p02,
+  const vm::vec<double, S>& p20,
+  const vm::vec<double, S>& p22)
+{
+  return vm::length(p00 - p02 - p20 + p22) / 4.0;
+}
+
+} // namespace
+
+size_t computeSubdivisionsPerSurface(const BezierPatch& patch)
+{
+  struct Deviation
+  {
+    double position = 0.0;
+    double uv = 0.0;
+  };
+
+  auto rowDeviation = Deviation{};
+  auto columnDeviation = Deviation{};
+  auto twist = Deviation{};
+
+  const auto updateDeviation =
+    [](Deviation& deviation, const auto& p0, const auto& p1, const auto& p2) {
+      deviation.position = std::max(
+        deviation.position,
+        curveDeviation(vm::slice<3>(p0, 0), vm::slice<3>(p1, 0), vm::slice<3>(p2, 0)));
+      deviation.uv = std::max(
+        deviation.uv,
+        curveDeviation(vm::slice<2>(p0, 3), vm::slice<2>(p1, 3), vm::slice<2>(p2, 3)));
+    };
+
+  const auto updateTwist =
+    [&](const auto& p00, const auto& p02, const auto& p20, const auto& p22) {
+      twist.position = std::max(
+        twist.position,
+        surfaceTwist(
+          vm::slice<3>(p00, 0),
+          vm::slice<3>(p02, 0),
+          vm::slice<3>(p20, 0),
+          vm::slice<3>(p22, 0)));
+      twist.uv = std::max(
+        twist.uv,
+        surfaceTwist(
+          vm::slice<2>(p00, 3),
+          vm::slice<2>(p02, 3),
+          vm::slice<2>(p20, 3),
+          vm::slice<2>(p22, 3)));
+    };
+
+  // every row and column of control points consists of quadratic curves
+  for (size_t row = 0u; row < patch.pointRowCount(); ++row)
+  {
+    for (size_t col = 0u; col + 2u < patch.pointColumnCount(); col += 2u)
+    {
+      updateDeviation(
+        rowDeviation,
+        patch.controlPoint(row, col),
+        patch.controlPoint(row, col + 1u),
+        patch.controlPoint(row, col + 2u));
+    }
+  }
+  for (size_t col = 0u; col < patch.pointColumnCount(); ++col)
+  {
+    for (size_t row = 0u; row + 2u < patch.pointRowCount(); row += 2u)
+    {
+      updateDeviation(
+        columnDeviation,
+        patch.controlPoint(row, col),
+        patch.controlPoint(row + 1u, col),
+        patch.controlPoint(row + 2u, col));
+    }
+  }
+
+  // the corners of every surface can be twisted against each other
+  for (size_t row = 0u; row + 2u < patch.pointRowCount(); row += 2u)
+  {
+    for (size_t col = 0u; col + 2u < patch.pointColumnCount(); col += 2u)
+    {
+      updateTwist(
+        patch.controlPoint(row, col),
+        patch.controlPoint(row, col + 2u),
+        patch.controlPoint(row + 2u, col),
+        patch.controlPoint(row + 2u, col + 2u));
+    }
+  }
+
+  // in the interior of a surface, the deviations along its rows and columns add up, and
+  // splitting its quads into triangles adds the twist
+  auto positionDeviation =
+    rowDeviation.position + columnDeviation.position + twist.position;
+  auto uvDeviation = rowDeviation.uv + columnDeviation.uv + twist.uv;
+
+  auto subdivisionsPerSurface = size_t(0);
+  while (subdivisionsPerSurface < MaxSubdivisionsPerSurface
+         && (positionDeviation > MaxPositionDeviation || uvDeviation > MaxUVDeviation))
+  {
+    // each subdivision halves the curve segments and quarters their deviation
+    positionDeviation /= 4.0;
+    uvDeviation /= 4.0;
+    ++subdivisionsPerSurface;
+  }
+  return subdivisionsPerSurface;
+}
+
+namespace
+{
+
+std::shared_ptr<const PatchGrid> tessellatePatch(const BezierPatch& patch)
+{
+  return std::make_shared<const PatchGrid>(
+    makePatchGrid(patch, computeSubdivisionsPerSurface(patch)));
+}
+
+} // namespace
+
 const HitType::Type PatchNode::PatchHitType = HitType::freeType();
 
 PatchNode::PatchNode(BezierPatch patch)
   : m_patch{std::move(patch)}
-  , m_grid{makePatchGrid(m_patch, DefaultSubdivisionsPerSurface)}
+  , m_grid{tessellatePatch(m_patch)}
+{
+}
+
+PatchNode::PatchNode(BezierPatch patch, std::shared_ptr<const PatchGrid> grid)
+  : m_patch{std::move(patch)}
+  , m_grid{std::move(grid)}
 {
+  assert(m_grid);
 }
 
 const EntityNodeBase* PatchNode::entity() const
@@ -336,7 +493,19 @@ BezierPatch PatchNode::setPatch(BezierPatch patch)
   const auto boundsChange = NotifyPhysicalBoundsChange{*this};
 
   auto previousPatch = std::exchange(m_patch, std::move(patch));
-  m_grid = makePatchGrid(m_patch, DefaultSubdivisionsPerSurface);
+  m_grid = tessellatePatch(m_patch);
+  return previousPatch;
+}
+
+BezierPatch PatchNode::setPatch(BezierPatch patch, std::shared_ptr<const PatchGrid> grid)
+{
+  assert(grid);
+
+  const auto nodeChange = NotifyNodeChange{*this};
+  const auto boundsChange = NotifyPhysicalBoundsChange{*this};
+
+  auto previousPatch = std::exchange(m_patch, std::move(patch));
+  m_grid = std::move(grid);
   return previousPatch;
 }
 
@@ -347,7 +516,7 @@ void PatchNode::setMaterial(Material* material)
 
 const PatchGrid& PatchNode::grid() const
 {
-  return m_grid;
+  return *m_grid;
 }
 
 const std::string& PatchNode::doGetName() const
@@ -363,7 +532,7 @@ const vm::bbox3d& PatchNode::doGetLogicalBounds() const
 
 const vm::bbox3d& PatchNode::doGetPhysicalBounds() const
 {
-  return m_grid.bounds;
+  return m_grid->bounds;
 }
 
 double PatchNode::doGetProjectedArea(const vm::axis::type axis) const
@@ -385,7 +554,8 @@ double PatchNode::doGetProjectedArea(const vm::axis::type axis) const
 
 Node* PatchNode::doClone(const vm::bbox3d&) const
 {
-  auto result = std::make_unique<PatchNode>(m_patch);
+  // the clone has the same control points, so it can share the grid
+  auto result = std::make_unique<PatchNode>(m_patch, m_grid);
   cloneLinkId(*result);
   return result.release();
 }
@@ -432,14 +602,14 @@ void PatchNode::doPick(
     return false;
   };
 
-  for (size_t row = 0u; row < m_grid.pointRowCount - 1u; ++row)
+  for (size_t row = 0u; row < m_grid->pointRowCount - 1u; ++row)
   {
-    for (size_t col = 0u; col < m_grid.pointColumnCount - 1u; ++col)
+    for (size_t col = 0u; col < m_grid->pointColumnCount - 1u; ++col)
     {
-      const auto v0 = m_grid.point(row, col).position;
-      const auto v1 = m_grid.point(row, col + 1u).position;
-      const auto v2 = m_grid.point(row + 1u, col + 1u).position;
-      const auto v3 = m_grid.point(row + 1u, col).position;
+      const auto v0 = m_grid->point(row, col).position;
+      const auto v1 = m_grid->point(row, col + 1u).position;
+      const auto v2 = m_grid->point(row + 1u, col + 1u).position;
+      const auto v3 = m_grid->point(row + 1u, col).position;
 
       if (pickTriangle(v0, v1, v2) || pickTriangle(v2, v3, v0))
       {
@@ -29,6 +29,9 @@
 #include "vm/bbox.h"
 #include "vm/vec.h"
 
+#include <memory>
+#include <vector>
+
 namespace tb::mdl
 {
 class EntityNodeBase;
@@ -67,6 +70,19 @@ std::vector<vm::vec3d> computeGridNormals(
 // public for testing
 PatchGrid makePatchGrid(const BezierPatch& patch, size_t subdivisionsPerSurface);
 
+/**
+ * Computes the number of subdivisions per surface that are necessary to approximate the
+ * given patch by a grid of quads.
+ *
+ * The subdivisions are chosen such that the grid deviates from the curved patch by at
+ * most half a unit and such that the UV coordinates deviate by at most 1/64. Flat patches
+ * with linearly interpolated UV coordinates are therefore represented by one quad per
+ * surface, while strongly curved patches are subdivided up to three times. The deviation
+ * is bounded by the sum of the curvature of the rows of control points, the curvature of
+ * the columns of control points and the twist of the corners of each surface.
+ */
+size_t computeSubdivisionsPerSurface(const BezierPatch& patch);
+
 class PatchNode : public Node, public Object
 {
 public:
@@ -74,16 +90,26 @@ public:
 
 private:
   BezierPatch m_patch;
-  PatchGrid m_grid;
+  std::shared_ptr<const PatchGrid> m_grid;
 
 public:
+  /**
+   * Creates a patch node and tessellates the given patch.
+   */
   explicit PatchNode(BezierPatch patch);
 
+  /**
+   * Creates a patch node with the given grid, which must have been tessellated from the
+   * given patch, e.g. by a PatchGridCache.
+   */
+  PatchNode(BezierPatch patch, std::shared_ptr<const PatchGrid> grid);
+
   EntityNodeBase* entity();
   const EntityNodeBase* entity() const;
 
   const BezierPatch& patch() const;
   BezierPatch setPatch(BezierPatch patch);
+  BezierPatch setPatch(BezierPatch patch, std::shared_ptr<const PatchGrid> grid);
 
   void setMaterial(Material* material);
 
@@ -22,6 +22,7 @@
 #include "kdl/intrusive_circular_list.h"
 
 #include "vm/bbox.h"
+#include "vm/mat.h"
 #include "vm/plane.h"
 #include "vm/ray.h"
 #include "vm/segment.h"
@@ -1596,6 +1597,19 @@ public: // Vertex correction and edge healing
   void correctVertexPositions(
     std::size_t decimals = 0, T epsilon = vm::constants<T>::correct_epsilon());
 
+  /**
+   * Applies the given transformation to the position of every vertex and to the plane of
+   * every face. The topology of this polyhedron is left unchanged, so the transformation
+   * must preserve the convexity of the faces, e.g. a rotation or a reflection followed by
+   * a translation. If the transformation is a reflection, the half edges of every face
+   * are reversed so that the faces keep their counter clockwise winding order.
+   *
+   * Updates the bounds of this polyhedron afterwards.
+   *
+   * @param transformation the transformation to apply
+   */
+  void transform(const vm::mat<T, 4, 4>& transformation);
+
   /**
    * Heals short edges by removing all edges shorter than the given minimum length. If
    * removing an edge leads to degenerate faces, these degenerate faces are removed, too.
@@ -24,6 +24,8 @@
 #include "kdl/range_utils.h"
 
 #include "vm/bbox.h"
+#include "vm/mat.h"
+#include "vm/mat_ext.h"
 #include "vm/plane.h"
 #include "vm/ray.h"
 #include "vm/scalar.h"
@@ -766,6 +768,42 @@ void Polyhedron<T, FP, VP>::correctVertexPositions(const size_t decimals, const
   updateBounds();
 }
 
+template <typename T, typename FP, typename VP>
+void Polyhedron<T, FP, VP>::transform(const vm::mat<T, 4, 4>& transformation)
+{
+  for (auto* vertex : m_vertices)
+  {
+    vertex->setPosition(transformation * vertex->position());
+  }
+
+  // A reflection inverts the winding order of every face. To restore it, every half edge
+  // is moved to the opposite end of its edge and every face boundary is reversed.
+  const auto invertsOrientation =
+    vm::compute_determinant(vm::strip_translation(transformation)) < T(0);
+  if (invertsOrientation)
+  {
+    for (auto* edge : m_edges)
+    {
+      auto* firstEdge = edge->firstEdge();
+      auto* secondEdge = edge->secondEdge();
+      auto* firstOrigin = firstEdge->origin();
+      firstEdge->setOrigin(secondEdge->origin());
+      secondEdge->setOrigin(firstOrigin);
+    }
+  }
+
+  for (auto* face : m_faces)
+  {
+    const auto plane = face->plane().transform(transformation);
+    if (invertsOrientation)
+    {
+      face->flip();
+    }
+    face->setPlane(plane);
+  }
+  updateBounds();
+}
+
 template <typename T, typename FP, typename VP>
 bool Polyhedron<T, FP, VP>::healEdges(const T minLength)
 {
@@ -27,10 +27,15 @@
 #include "kdl/reflection_impl.h"
 #include "kdl/result.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <exception>
 #include <functional>
 #include <future>
 #include <iostream>
 #include <memory>
+#include <utility>
 #include <variant>
 
 namespace tb::mdl
@@ -50,6 +55,7 @@ template <typename T>
 using ResourceLoader = std::function<Result<T>()>;
 
 using ErrorHandler = std::function<void(const ResourceId&, const std::string&)>;
+using ProcessingRequestHandler = std::function<void(const ResourceId&)>;
 
 struct ProcessContext
 {
@@ -79,6 +85,14 @@ public:
 using Task = std::function<std::unique_ptr<TaskResult>()>;
 using TaskRunner = std::function<std::future<std::unique_ptr<TaskResult>>(Task)>;
 
+template <typename T>
+struct ResourceDeferred
+{
+  ResourceLoader<T> loader;
+
+  kdl_reflect_inline_empty(ResourceDeferred);
+};
+
 template <typename T>
 struct ResourceUnloaded
 {
@@ -133,6 +147,7 @@ struct ResourceFailed
 
 template <typename T>
 using ResourceState = std::variant<
+  ResourceDeferred<T>,
   ResourceUnloaded<T>,
   ResourceLoading<T>,
   ResourceLoaded<T>,
@@ -148,9 +163,57 @@ std::ostream& operator<<(std::ostream& lhs, const ResourceState<T>& rhs)
   return lhs;
 }
 
+/**
+ * Controls when a resource that was created with a loader starts loading.
+ */
+enum class LoadPolicy
+{
+  /**
+   * The resource starts loading when it is processed for the first time.
+   */
+  Immediate,
+  /**
+   * The resource starts loading only after it was requested by calling
+   * Resource::requestLoad.
+   */
+  OnDemand,
+};
+
+/**
+ * Determines the order in which the resource manager starts loading resources. Resources
+ * with a higher priority are loaded first.
+ */
+enum class LoadPriority
+{
+  Normal,
+  /**
+   * For resources that are needed to display something that is currently visible.
+   */
+  High,
+};
+
 namespace detail
 {
 
+template <typename T>
+ResourceState<T> makeInitialState(ResourceLoader<T> loader, const LoadPolicy loadPolicy)
+{
+  switch (loadPolicy)
+  {
+  case LoadPolicy::Immediate:
+    return ResourceUnloaded<T>{std::move(loader)};
+  case LoadPolicy::OnDemand:
+    return ResourceDeferred<T>{std::move(loader)};
+    switchDefault();
+  }
+}
+
+template <typename T>
+ResourceState<T> requestLoad(ResourceDeferred<T> state)
+{
+  return ResourceUnloaded<T>{std::move(state.loader)};
+}
+
 template <typename T>
 ResourceState<T> triggerLoading(ResourceUnloaded<T> state, TaskRunner taskRunner)
 {
@@ -170,7 +233,20 @@ ResourceState<T> finishLoading(ResourceLoading<T> state)
       return ResourceFailed{"Invalid future"};
     }
 
-    auto taskResult = state.future.get();
+    auto taskResult = std::unique_ptr<TaskResult>{};
+    try
+    {
+      taskResult = state.future.get();
+    }
+    catch (const std::exception& e)
+    {
+      // the loader task threw an exception
+      return ResourceFailed{e.what()};
+    }
+    catch (...)
+    {
+      return ResourceFailed{"Unknown error while loading resource"};
+    }
     auto loaderTaskResult = static_cast<LoaderTaskResult<T>*>(taskResult.get());
 
     return std::move(loaderTaskResult->get())
@@ -212,6 +288,20 @@ ResourceState<T> drop(ResourceDropping<T> state, const bool glContextAvailable)
   return ResourceDropped{};
 }
 
+template <typename T>
+ResourceState<T> evict(ResourceLoaded<T>, ResourceLoader<T> loader)
+{
+  return ResourceDeferred<T>{std::move(loader)};
+}
+
+template <typename T>
+ResourceState<T> evict(
+  ResourceReady<T> state, ResourceLoader<T> loader, const bool glContextAvailable)
+{
+  state.resource.drop(glContextAvailable);
+  return ResourceDeferred<T>{std::move(loader)};
+}
+
 } // namespace detail
 
 /**
@@ -221,26 +311,43 @@ ResourceState<T> drop(ResourceDropping<T> state, const bool glContextAvailable)
  *
  * | State          | Transition       | New state       |
  * |----------------|------------------|-----------------|
+ * | Deferred       | requestLoad      | Unloaded        |
  * | Unloaded       | process          | Loading         |
  * | Loading        | process          | Loaded or Failed|
  * | Loaded         | process          | Ready           |
+ * | Loaded         | evict            | Deferred        |
  * | Ready          | drop             | Dropping        |
+ * | Ready          | evict            | Deferred        |
  * | Dropping       | process          | Dropped         |
  * | Dropped        | -                | -               |
  * | Failed         | -                | -               |
+ *
+ * A resource created with LoadPolicy::OnDemand starts in the Deferred state and is not
+ * loaded until requestLoad is called. Such a resource keeps its loader and can be
+ * evicted, which releases the loaded data and returns it to the Deferred state.
  */
 template <typename T>
 class Resource
 {
 private:
   ResourceId m_id;
+  ResourceLoader<T> m_loader;
+  LoadPolicy m_loadPolicy = LoadPolicy::Immediate;
+  bool m_requested = false;
+  std::atomic<size_t> m_pinCount = 0;
+  LoadPriority m_loadPriority = LoadPriority::Normal;
+  ProcessingRequestHandler m_processingRequestHandler;
+  std::function<void(const T&)> m_evictionHandler;
   ResourceState<T> m_state;
 
   kdl_reflect_inline(Resource, m_state);
 
 public:
-  explicit Resource(ResourceLoader<T> loader)
-    : m_state(ResourceUnloaded<T>{std::move(loader)})
+  explicit Resource(
+    ResourceLoader<T> loader, const LoadPolicy loadPolicy = LoadPolicy::Immediate)
+    : m_loader{loadPolicy == LoadPolicy::OnDemand ? loader : ResourceLoader<T>{}}
+    , m_loadPolicy{loadPolicy}
+    , m_state(detail::makeInitialState(std::move(loader), loadPolicy))
   {
   }
 
@@ -249,7 +356,7 @@ public:
   {
   }
 
-  moveOnly(Resource);
+  deleteCopyAndMove(Resource);
 
   const ResourceId& id() const { return m_id; }
 
@@ -277,12 +384,117 @@ public:
 
   bool isDropped() const { return std::holds_alternative<ResourceDropped>(m_state); }
 
+  bool isDeferred() const
+  {
+    return std::holds_alternative<ResourceDeferred<T>>(m_state);
+  }
+
+  bool isUnloaded() const
+  {
+    return std::holds_alternative<ResourceUnloaded<T>>(m_state);
+  }
+
+  bool isLoading() const { return std::holds_alternative<ResourceLoading<T>>(m_state); }
+
   bool needsProcessing() const
   {
-    return !std::holds_alternative<ResourceReady<T>>(m_state)
+    return !std::holds_alternative<ResourceDeferred<T>>(m_state)
+           && !std::holds_alternative<ResourceReady<T>>(m_state)
            && !std::holds_alternative<ResourceFailed>(m_state);
   }
 
+  /**
+   * Indicates whether this resource was created with LoadPolicy::OnDemand, is not pinned,
+   * and currently holds loaded data that can be released by calling evict.
+   */
+  bool isEvictable() const
+  {
+    return m_loadPolicy == LoadPolicy::OnDemand && !isPinned()
+           && (std::holds_alternative<ResourceLoaded<T>>(m_state)
+               || std::holds_alternative<ResourceReady<T>>(m_state));
+  }
+
+  bool isPinned() const { return m_pinCount > 0; }
+
+  /**
+   * Prevents this resource from being evicted until unpin has been called as many times
+   * as pin. Pinning and unpinning are thread safe. The processing request handler is
+   * called when the resource becomes pinned or unpinned so that the resource manager can
+   * update its eviction order.
+   */
+  void pin()
+  {
+    if (m_pinCount++ == 0 && m_processingRequestHandler)
+    {
+      m_processingRequestHandler(m_id);
+    }
+  }
+
+  void unpin()
+  {
+    const auto previousPinCount = m_pinCount--;
+    assert(previousPinCount > 0);
+    if (previousPinCount == 1 && m_processingRequestHandler)
+    {
+      m_processingRequestHandler(m_id);
+    }
+  }
+
+  /**
+   * Returns whether requestLoad was called since the last call to this function.
+   */
+  bool takeRequested() { return std::exchange(m_requested, false); }
+
+  LoadPriority loadPriority() const { return m_loadPriority; }
+
+  /**
+   * Allows a deferred resource to start loading the next time it is processed. Has no
+   * effect on the state if the resource is not deferred.
+   *
+   * The resource's load priority is raised to the given priority if it is higher.
+   */
+  void requestLoad(const LoadPriority loadPriority = LoadPriority::Normal)
+  {
+    const auto wasRequested = std::exchange(m_requested, true);
+    const auto previousLoadPriority =
+      std::exchange(m_loadPriority, std::max(m_loadPriority, loadPriority));
+    if (auto* deferredState = std::get_if<ResourceDeferred<T>>(&m_state))
+    {
+      m_state = detail::requestLoad(std::move(*deferredState));
+      requestProcessing();
+    }
+    else if (
+      ((!wasRequested && !isLoading()) || m_loadPriority != previousLoadPriority)
+      && !isDropped() && m_processingRequestHandler)
+    {
+      // let the handler record the request or the raised priority; a loading resource
+      // will be processed again anyway once its loader task completes
+      m_processingRequestHandler(m_id);
+    }
+  }
+
+  /**
+   * Sets a function that is called whenever this resource enters a state that needs
+   * processing outside of a call to process, e.g. when it is requested or dropped. The
+   * function is also called when the resource is requested for the first time since the
+   * last call to takeRequested, unless it is loading, and when its load priority is
+   * raised.
+   */
+  void setProcessingRequestHandler(ProcessingRequestHandler processingRequestHandler)
+  {
+    m_processingRequestHandler = std::move(processingRequestHandler);
+  }
+
+  /**
+   * Sets a function that is called with the loaded data right before evict releases it,
+   * e.g. to retain information that must remain available while the resource is
+   * deferred.
+   */
+  void setEvictionHandler(std::function<void(const T&)> evictionHandler)
+  {
+    m_evictionHandler = std::move(evictionHandler);
+  }
+
   bool process(TaskRunner taskRunner, const ProcessContext& context)
   {
     const auto previousStateIndex = m_state.index();
@@ -326,10 +538,40 @@ public:
         [&](ResourceDropping<T> state) -> ResourceState<T> { return state; },
         [](auto) -> ResourceState<T> { return ResourceDropped{}; }),
       std::move(m_state));
+    requestProcessing();
+  }
+
+  /**
+   * Releases the loaded data and returns the resource to the Deferred state. Has no
+   * effect if the resource is not evictable.
+   */
+  void evict(const bool glContextAvailable)
+  {
+    if (!isEvictable())
+    {
+      return;
+    }
+
+    if (m_evictionHandler)
+    {
+      m_evictionHandler(*get());
+    }
+
+    m_state = std::visit(
+      kdl::overload(
+        [&](ResourceLoaded<T> state) -> ResourceState<T> {
+          return detail::evict(std::move(state), m_loader);
+        },
+        [&](ResourceReady<T> state) -> ResourceState<T> {
+          return detail::evict(std::move(state), m_loader, glContextAvailable);
+        },
+        [](auto state) -> ResourceState<T> { return state; }),
+      std::move(m_state));
   }
 
   void loadSync()
   {
+    requestLoad();
     m_state = std::visit(
       kdl::overload(
         [&](ResourceUnloaded<T> state) -> ResourceState<T> {
@@ -343,6 +585,7 @@ public:
         },
         [](auto state) -> ResourceState<T> { return state; }),
       std::move(m_state));
+    requestProcessing();
   }
 
   void uploadSync(const bool glContextAvailable)
@@ -369,6 +612,15 @@ public:
         [](auto) -> ResourceState<T> { return ResourceDropped{}; }),
       std::move(m_state));
   }
+
+private:
+  void requestProcessing()
+  {
+    if (m_processingRequestHandler && needsProcessing() && !isDropped())
+    {
+      m_processingRequestHandler(m_id);
+    }
+  }
 };
 
 template <typename T>
@@ -0,0 +1,473 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ResourceManager.h"
+
+#include "kdl/invoke.h"
+#include "kdl/vector_utils.h"
+
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <thread>
+
+namespace tb::mdl
+{
+size_t defaultMaxConcurrentLoads(const size_t workerCount)
+{
+  // leave a worker and a core to the parallel tasks that the UI thread waits for, since
+  // they would otherwise queue up behind the loader tasks
+  const auto hardwareConcurrency =
+    std::max(size_t(1), size_t(std::thread::hardware_concurrency()));
+  const auto availableWorkers = std::min(workerCount, hardwareConcurrency);
+  return availableWorkers > 1 ? availableWorkers - 1 : 1;
+}
+
+void ResourceQueue::push(ResourceId resourceId)
+{
+  auto lock = std::lock_guard{m_mutex};
+  m_resourceIds.push_back(std::move(resourceId));
+}
+
+void ResourceQueue::pushUnreferenced(ResourceId resourceId)
+{
+  auto lock = std::lock_guard{m_mutex};
+  m_unreferencedResourceIds.push_back(std::move(resourceId));
+}
+
+std::vector<ResourceId> ResourceQueue::takeAll()
+{
+  auto lock = std::lock_guard{m_mutex};
+  return std::exchange(m_resourceIds, {});
+}
+
+std::vector<ResourceId> ResourceQueue::takeUnreferenced()
+{
+  auto lock = std::lock_guard{m_mutex};
+  return std::exchange(m_unreferencedResourceIds, {});
+}
+
+bool ResourceQueue::empty() const
+{
+  auto lock = std::lock_guard{m_mutex};
+  return m_resourceIds.empty() && m_unreferencedResourceIds.empty();
+}
+
+LoadScheduler::LoadScheduler(
+  std::shared_ptr<ResourceQueue> readyQueue, const size_t maxConcurrentLoads)
+  : m_readyQueue{std::move(readyQueue)}
+  , m_maxConcurrentLoads{std::max(size_t(1), maxConcurrentLoads)}
+{
+}
+
+bool LoadScheduler::LoadOrder::operator<(const LoadOrder& other) const
+{
+  return loadPriority != other.loadPriority ? loadPriority > other.loadPriority
+                                            : sequenceNumber < other.sequenceNumber;
+}
+
+std::future<std::unique_ptr<TaskResult>> LoadScheduler::schedule(
+  ResourceId resourceId,
+  const LoadPriority loadPriority,
+  const size_t sequenceNumber,
+  Task task,
+  TaskRunner taskRunner,
+  std::shared_ptr<std::atomic<bool>> cancelled)
+{
+  auto promise = std::make_shared<std::promise<std::unique_ptr<TaskResult>>>();
+  auto future = promise->get_future();
+
+  const auto loadOrder = LoadOrder{loadPriority, sequenceNumber};
+
+  auto lock = std::lock_guard{m_mutex};
+  m_pendingLoadOrders.emplace(resourceId, loadOrder);
+  m_pendingLoads.emplace(
+    loadOrder,
+    PendingLoad{
+      std::move(resourceId),
+      std::move(task),
+      std::move(taskRunner),
+      std::move(promise),
+      std::move(cancelled)});
+
+  return future;
+}
+
+void LoadScheduler::raiseLoadPriority(
+  const ResourceId& resourceId, const LoadPriority loadPriority)
+{
+  auto lock = std::lock_guard{m_mutex};
+  if (const auto iLoadOrder = m_pendingLoadOrders.find(resourceId);
+      iLoadOrder != m_pendingLoadOrders.end()
+      && loadPriority > iLoadOrder->second.loadPriority)
+  {
+    auto node = m_pendingLoads.extract(iLoadOrder->second);
+    iLoadOrder->second.loadPriority = loadPriority;
+    node.key() = iLoadOrder->second;
+    m_pendingLoads.insert(std::move(node));
+  }
+}
+
+void LoadScheduler::dispatch()
+{
+  auto lock = std::unique_lock{m_mutex};
+  if (m_dispatching)
+  {
+    // the dispatching thread will start the next loader task, this prevents recursion
+    // if the task runner runs the tasks synchronously
+    return;
+  }
+
+  m_dispatching = true;
+  while (m_runningLoads < m_maxConcurrentLoads && !m_pendingLoads.empty())
+  {
+    auto nextLoad = std::move(m_pendingLoads.extract(m_pendingLoads.begin()).mapped());
+    m_pendingLoadOrders.erase(nextLoad.resourceId);
+
+    if (*nextLoad.cancelled)
+    {
+      // the resource was dropped and will not read the result
+      continue;
+    }
+
+    ++m_runningLoads;
+    lock.unlock();
+
+    auto taskRunner = nextLoad.taskRunner;
+    taskRunner([self = shared_from_this(), nextLoad = std::move(nextLoad)]() {
+      self->run(nextLoad);
+      return std::unique_ptr<TaskResult>{};
+    });
+
+    lock.lock();
+  }
+  m_dispatching = false;
+}
+
+void LoadScheduler::run(const PendingLoad& pendingLoad)
+{
+  // release the slot and start the next loader task even if this one throws, otherwise
+  // every failed loader task would permanently reduce the number of concurrent loads
+  const auto finishLoad = kdl::invoke_later{[&]() {
+    {
+      auto lock = std::lock_guard{m_mutex};
+      --m_runningLoads;
+    }
+    dispatch();
+  }};
+
+  if (!*pendingLoad.cancelled)
+  {
+    try
+    {
+      pendingLoad.promise->set_value(pendingLoad.task());
+    }
+    catch (...)
+    {
+      // the resource receives the exception when it finishes loading
+      pendingLoad.promise->set_exception(std::current_exception());
+    }
+    m_readyQueue->push(pendingLoad.resourceId);
+  }
+}
+
+ResourceManager::ResourceManager(const size_t maxConcurrentLoads)
+  : m_readyQueue{std::make_shared<ResourceQueue>()}
+  , m_loadScheduler{std::make_shared<LoadScheduler>(m_readyQueue, maxConcurrentLoads)}
+{
+}
+
+ResourceManager::~ResourceManager() = default;
+
+bool ResourceManager::needsProcessing() const
+{
+  return !m_readyQueue->empty() || !m_loadingTasks.empty()
+         || !m_unreferencedResources.empty();
+}
+
+std::vector<const ResourceWrapperBase*> ResourceManager::resources() const
+{
+  return kdl::vec_transform(m_resources, [](const auto& resourceWrapper) {
+    return static_cast<const ResourceWrapperBase*>(resourceWrapper.get());
+  });
+}
+
+const std::optional<ResidencyBudget>& ResourceManager::residencyBudget() const
+{
+  return m_residencyBudget;
+}
+
+void ResourceManager::setResidencyBudget(std::optional<ResidencyBudget> residencyBudget)
+{
+  m_residencyBudget = std::move(residencyBudget);
+}
+
+size_t ResourceManager::residentBytes() const
+{
+  return m_residentBytes;
+}
+
+std::vector<ResourceId> ResourceManager::process(
+  TaskRunner taskRunner,
+  const ProcessContext& processContext,
+  std::optional<std::chrono::milliseconds> timeout)
+{
+  const auto checkTimeout =
+    timeout ? std::function{[timeout_ = *timeout,
+                             startTime = std::chrono::steady_clock::now()]() {
+      return std::chrono::steady_clock::now() - startTime < timeout_;
+    }}
+            : std::function{[]() { return true; }};
+
+  auto result = std::vector<ResourceId>{};
+  ++m_currentTick;
+
+  dropUnreferencedResources();
+
+  const auto readyResources = takeReadyResources();
+  auto it = readyResources.begin();
+  for (; it != readyResources.end() && checkTimeout(); ++it)
+  {
+    processResource(*it, taskRunner, processContext, result);
+  }
+
+  // requeue the resources that could not be processed before the timeout
+  for (; it != readyResources.end(); ++it)
+  {
+    m_readyQueue->push(it->resourceWrapper->id());
+  }
+
+  // start loading once all resources that became ready have been scheduled so that the
+  // resources with the highest priority are loaded first
+  m_loadScheduler->dispatch();
+
+  eraseDroppedResources();
+
+  evictIfOverBudget(processContext, result);
+
+  return result;
+}
+
+void ResourceManager::processResource(
+  const Entry& entry,
+  const TaskRunner& taskRunner,
+  const ProcessContext& processContext,
+  std::vector<ResourceId>& processedResources)
+{
+  auto& resourceWrapper = *entry.resourceWrapper;
+  const auto residentBytesBefore = resourceWrapper.residentBytes();
+  const auto wasLoading = resourceWrapper.isLoading();
+  auto cancelled = std::make_shared<std::atomic<bool>>(false);
+
+  if (
+    resourceWrapper.needsProcessing()
+    && resourceWrapper.process(
+      makeSchedulingTaskRunner(taskRunner, entry, cancelled), processContext))
+  {
+    processedResources.push_back(resourceWrapper.id());
+  }
+
+  m_residentBytes =
+    m_residentBytes - residentBytesBefore + resourceWrapper.residentBytes();
+  updateEvictionOrder(resourceWrapper, false);
+
+  if (resourceWrapper.isLoading())
+  {
+    if (!wasLoading)
+    {
+      m_loadingTasks.emplace(resourceWrapper.id(), std::move(cancelled));
+    }
+  }
+  else
+  {
+    m_loadingTasks.erase(resourceWrapper.id());
+    if (resourceWrapper.needsProcessing() && !resourceWrapper.isDropped())
+    {
+      m_readyQueue->push(resourceWrapper.id());
+    }
+  }
+}
+
+void ResourceManager::dropUnreferencedResources()
+{
+  for (const auto& resourceId : m_readyQueue->takeUnreferenced())
+  {
+    const auto iEntry = m_resourcesById.find(resourceId);
+    if (iEntry == m_resourcesById.end())
+    {
+      continue;
+    }
+
+    auto& resourceWrapper = *iEntry->second.resourceWrapper;
+    if (const auto iLoadingTask = m_loadingTasks.find(resourceId);
+        iLoadingTask != m_loadingTasks.end())
+    {
+      *iLoadingTask->second = true;
+      m_loadingTasks.erase(iLoadingTask);
+    }
+
+    const auto residentBytesBefore = resourceWrapper.residentBytes();
+    resourceWrapper.drop();
+    m_residentBytes =
+      m_residentBytes - residentBytesBefore + resourceWrapper.residentBytes();
+    updateEvictionOrder(resourceWrapper, false);
+
+    m_unreferencedResources.push_back(&resourceWrapper);
+  }
+}
+
+std::vector<ResourceManager::Entry> ResourceManager::takeReadyResources()
+{
+  auto readyEntries = std::vector<Entry>{};
+  for (const auto& resourceId : m_readyQueue->takeAll())
+  {
+    if (const auto iEntry = m_resourcesById.find(resourceId);
+        iEntry != m_resourcesById.end())
+    {
+      // resources are also queued when they are requested
+      auto& resourceWrapper = *iEntry->second.resourceWrapper;
+      if (resourceWrapper.updateLastUse(m_currentTick))
+      {
+        updateEvictionOrder(resourceWrapper, true);
+      }
+      if (resourceWrapper.isLoading())
+      {
+        m_loadScheduler->raiseLoadPriority(resourceId, resourceWrapper.loadPriority());
+      }
+      readyEntries.push_back(iEntry->second);
+    }
+  }
+
+  // process the resources in the order in which they were added
+  std::ranges::sort(readyEntries, std::less<>{}, &Entry::sequenceNumber);
+  const auto [first, last] =
+    std::ranges::unique(readyEntries, std::equal_to<>{}, &Entry::sequenceNumber);
+  readyEntries.erase(first, last);
+
+  return readyEntries;
+}
+
+TaskRunner ResourceManager::makeSchedulingTaskRunner(
+  TaskRunner taskRunner,
+  const Entry& entry,
+  std::shared_ptr<std::atomic<bool>> cancelled) const
+{
+  return [loadScheduler = m_loadScheduler,
+          taskRunner = std::move(taskRunner),
+          resourceId = entry.resourceWrapper->id(),
+          loadPriority = entry.resourceWrapper->loadPriority(),
+          sequenceNumber = entry.sequenceNumber,
+          cancelled = std::move(cancelled)](Task task) {
+    return loadScheduler->schedule(
+      resourceId, loadPriority, sequenceNumber, std::move(task), taskRunner, cancelled);
+  };
+}
+
+void ResourceManager::eraseDroppedResources()
+{
+  // unreferenced resources that are still being dropped remain until the next call
+  auto droppedResources = std::vector<ResourceWrapperBase*>{};
+  std::erase_if(m_unreferencedResources, [&](auto* resourceWrapper) {
+    if (resourceWrapper->isDropped())
+    {
+      droppedResources.push_back(resourceWrapper);
+      return true;
+    }
+    return false;
+  });
+
+  if (droppedResources.empty())
+  {
+    return;
+  }
+
+  for (auto* resourceWrapper : droppedResources)
+  {
+    m_loadingTasks.erase(resourceWrapper->id());
+    m_resourcesById.erase(resourceWrapper->id());
+  }
+
+  std::ranges::sort(droppedResources);
+  std::erase_if(m_resources, [&](const auto& resourceWrapper) {
+    return std::ranges::binary_search(droppedResources, resourceWrapper.get());
+  });
+}
+
+void ResourceManager::updateEvictionOrder(
+  ResourceWrapperBase& resourceWrapper, const bool requested)
+{
+  const auto iPosition = m_evictionPositions.find(&resourceWrapper);
+  if (resourceWrapper.isEvictable())
+  {
+    if (iPosition == m_evictionPositions.end())
+    {
+      const auto position =
+        m_evictionOrder.insert(m_evictionOrder.end(), &resourceWrapper);
+      m_evictionPositions.emplace(&resourceWrapper, position);
+    }
+    else if (requested)
+    {
+      m_evictionOrder.splice(m_evictionOrder.end(), m_evictionOrder, iPosition->second);
+    }
+  }
+  else if (iPosition != m_evictionPositions.end())
+  {
+    m_evictionOrder.erase(iPosition->second);
+    m_evictionPositions.erase(iPosition);
+  }
+}
+
+void ResourceManager::evictIfOverBudget(
+  const ProcessContext& processContext, std::vector<ResourceId>& processedResources)
+{
+  if (!m_residencyBudget)
+  {
+    return;
+  }
+
+  auto it = m_evictionOrder.begin();
+  while (it != m_evictionOrder.end() && m_residentBytes > m_residencyBudget->maxBytes)
+  {
+    auto* resourceWrapper = *it;
+    if (m_currentTick - resourceWrapper->lastUse() < m_residencyBudget->minIdleTicks)
+    {
+      // all remaining resources were requested even more recently
+      break;
+    }
+
+    if (!resourceWrapper->isEvictable())
+    {
+      // the resource was pinned after it was last processed
+      m_evictionPositions.erase(resourceWrapper);
+      it = m_evictionOrder.erase(it);
+      continue;
+    }
+
+    const auto residentBytesBefore = resourceWrapper->residentBytes();
+    resourceWrapper->evict(processContext.glContextAvailable);
+    m_residentBytes =
+      m_residentBytes - residentBytesBefore + resourceWrapper->residentBytes();
+    processedResources.push_back(resourceWrapper->id());
+
+    m_evictionPositions.erase(resourceWrapper);
+    it = m_evictionOrder.erase(it);
+  }
+}
+
+} // namespace tb::mdl
@@ -21,12 +21,17 @@
 
 #include "mdl/Resource.h"
 
-#include "kdl/collection_utils.h"
 #include "kdl/reflection_impl.h"
-#include "kdl/vector_utils.h"
 
+#include <atomic>
 #include <chrono>
+#include <future>
+#include <list>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
 #include <vector>
 
 namespace tb::mdl
@@ -39,12 +44,32 @@ public:
 
   virtual const ResourceId& id() const = 0;
 
-  virtual long useCount() const = 0;
-
   virtual bool isDropped() const = 0;
+  virtual bool isUnloaded() const = 0;
+  virtual bool isLoading() const = 0;
+  virtual LoadPriority loadPriority() const = 0;
   virtual bool needsProcessing() const = 0;
+  virtual bool isEvictable() const = 0;
+
+  /**
+   * Returns the number of bytes occupied by the resource's loaded data, or 0 if the
+   * resource type does not report its size.
+   */
+  virtual size_t residentBytes() const = 0;
+
+  /**
+   * Returns the tick at which the resource was last requested.
+   */
+  virtual size_t lastUse() const = 0;
+
+  /**
+   * Sets the last use to the given tick if the resource was requested since the last
+   * call. Returns true if the resource was requested.
+   */
+  virtual bool updateLastUse(size_t currentTick) = 0;
 
   virtual void drop() = 0;
+  virtual void evict(bool glContextAvailable) = 0;
   virtual bool process(TaskRunner taskRunner, const ProcessContext& processContext) = 0;
 };
 
@@ -53,20 +78,56 @@ class ResourceWrapper : public ResourceWrapperBase
 {
 private:
   std::shared_ptr<Resource<T>> m_resource;
+  size_t m_lastUse;
 
   kdl_reflect_inline(ResourceWrapper, m_resource);
 
 public:
-  explicit ResourceWrapper(std::shared_ptr<Resource<T>> resource)
+  explicit ResourceWrapper(
+    std::shared_ptr<Resource<T>> resource, const size_t currentTick = 0)
     : m_resource{std::move(resource)}
+    , m_lastUse{currentTick}
   {
   }
 
   const ResourceId& id() const override { return m_resource->id(); }
-  long useCount() const override { return m_resource.use_count(); }
   bool isDropped() const override { return m_resource->isDropped(); }
+  bool isUnloaded() const override { return m_resource->isUnloaded(); }
+  bool isLoading() const override { return m_resource->isLoading(); }
+  LoadPriority loadPriority() const override { return m_resource->loadPriority(); }
   bool needsProcessing() const override { return m_resource->needsProcessing(); }
+  bool isEvictable() const override { return m_resource->isEvictable(); }
+
+  size_t residentBytes() const override
+  {
+    if constexpr (requires(const T& t) { t.byteSize(); })
+    {
+      const auto* resource = m_resource->get();
+      return resource ? resource->byteSize() : 0;
+    }
+    else
+    {
+      return 0;
+    }
+  }
+
+  size_t lastUse() const override { return m_lastUse; }
+
+  bool updateLastUse(const size_t currentTick) override
+  {
+    if (m_resource->takeRequested())
+    {
+      m_lastUse = currentTick;
+      return true;
+    }
+    return false;
+  }
+
   void drop() override { m_resource->drop(); }
+  void evict(const bool glContextAvailable) override
+  {
+    m_resource->evict(glContextAvailable);
+  }
   bool process(TaskRunner taskRunner, const ProcessContext& processContext) override
   {
     return m_resource->process(taskRunner, processContext);
@@ -81,70 +142,238 @@ public:
   };
 };
 
-class ResourceManager
+/**
+ * A thread safe queue of the IDs of resources that need to be processed, that were
+ * requested, or that are no longer referenced outside of the resource manager.
+ */
+class ResourceQueue
 {
 private:
-  std::vector<std::unique_ptr<ResourceWrapperBase>> m_resources;
+  mutable std::mutex m_mutex;
+  std::vector<ResourceId> m_resourceIds;
+  std::vector<ResourceId> m_unreferencedResourceIds;
 
 public:
-  bool needsProcessing() const
-  {
-    return kdl::any_of(m_resources, [](const auto& resourceWrapper) {
-      return resourceWrapper->useCount() == 1 || resourceWrapper->needsProcessing();
-    });
-  }
+  void push(ResourceId resourceId);
+  void pushUnreferenced(ResourceId resourceId);
+  std::vector<ResourceId> takeAll();
+  std::vector<ResourceId> takeUnreferenced();
+  bool empty() const;
+};
 
-  std::vector<const ResourceWrapperBase*> resources() const
+/**
+ * Runs the loader tasks of resources in the order of their load priority, and then in
+ * the order in which the resources were added. At most maxConcurrentLoads loader tasks
+ * run at the same time. When a loader task completes, the next pending loader task is
+ * started right away by the thread that ran the completed one, so loading does not wait
+ * for the next call to ResourceManager::process.
+ *
+ * If a loader task throws, the exception is stored in the future of its result and the
+ * next pending loader task is started as usual. The loader task of a resource that was
+ * dropped is skipped. This class is thread safe.
+ */
+class LoadScheduler : public std::enable_shared_from_this<LoadScheduler>
+{
+private:
+  struct PendingLoad
   {
-    return kdl::vec_transform(m_resources, [](const auto& resourceWrapper) {
-      return static_cast<const ResourceWrapperBase*>(resourceWrapper.get());
-    });
-  }
+    ResourceId resourceId;
+    Task task;
+    TaskRunner taskRunner;
+    std::shared_ptr<std::promise<std::unique_ptr<TaskResult>>> promise;
+    std::shared_ptr<std::atomic<bool>> cancelled;
+  };
 
-  template <typename ResourceT>
-  void addResource(std::shared_ptr<Resource<ResourceT>> resource)
+  // orders pending loads by descending priority, then by ascending sequence number
+  struct LoadOrder
   {
-    m_resources.push_back(
-      std::make_unique<ResourceWrapper<ResourceT>>(std::move(resource)));
-  }
+    LoadPriority loadPriority;
+    size_t sequenceNumber;
 
-  std::vector<ResourceId> process(
+    bool operator<(const LoadOrder& other) const;
+  };
+
+  std::shared_ptr<ResourceQueue> m_readyQueue;
+  size_t m_maxConcurrentLoads;
+
+  mutable std::mutex m_mutex;
+  std::map<LoadOrder, PendingLoad> m_pendingLoads;
+  std::unordered_map<ResourceId, LoadOrder> m_pendingLoadOrders;
+  size_t m_runningLoads = 0;
+  bool m_dispatching = false;
+
+public:
+  LoadScheduler(std::shared_ptr<ResourceQueue> readyQueue, size_t maxConcurrentLoads);
+
+  /**
+   * Schedules the given loader task and returns a future for its result. The task is
+   * started by a call to dispatch. Once it has completed, the resource is pushed onto
+   * the ready queue.
+   */
+  std::future<std::unique_ptr<TaskResult>> schedule(
+    ResourceId resourceId,
+    LoadPriority loadPriority,
+    size_t sequenceNumber,
+    Task task,
     TaskRunner taskRunner,
-    const ProcessContext& processContext,
-    std::optional<std::chrono::milliseconds> timeout = std::nullopt)
+    std::shared_ptr<std::atomic<bool>> cancelled);
+
+  /**
+   * Raises the priority of the given resource's loader task if it has not started yet.
+   */
+  void raiseLoadPriority(const ResourceId& resourceId, LoadPriority loadPriority);
+
+  /**
+   * Starts the pending loader tasks with the highest priority while fewer than
+   * maxConcurrentLoads tasks are running.
+   */
+  void dispatch();
+
+private:
+  void run(const PendingLoad& pendingLoad);
+};
+
+/**
+ * Returns the number of loader tasks that may run at the same time when they are run by
+ * a task manager with the given number of workers. One worker is left for other tasks,
+ * and the result never exceeds the number of hardware threads minus one.
+ */
+size_t defaultMaxConcurrentLoads(size_t workerCount);
+
+/**
+ * Limits the amount of memory occupied by evictable resources. When the resident size
+ * of all resources exceeds maxBytes, the least recently requested evictable resources
+ * are evicted until the limit is met again, but only if they have not been requested
+ * during the last minIdleTicks calls to ResourceManager::process.
+ *
+ * The manager keeps the evictable resources in the order of their last request, so
+ * eviction only visits the resources that it evicts and the first resource that was
+ * requested too recently. Pinned resources are not evictable and are removed from the
+ * order when they are processed after being pinned.
+ */
+struct ResidencyBudget
+{
+  size_t maxBytes;
+  size_t minIdleTicks = 0;
+
+  kdl_reflect_inline(ResidencyBudget, maxBytes, minIdleTicks);
+};
+
+/**
+ * Manages the lifecycle of resources. Instead of inspecting every resource when it is
+ * processed, the manager keeps a queue of the resources that need processing. A
+ * resource is queued when it is added, when it requests processing itself (e.g. when it
+ * is requested or dropped), when its loader task completes, or when it still needs
+ * processing after it was processed.
+ *
+ * Resources that are no longer referenced are detected through the handles returned by
+ * addResource: when the last copy of a handle is destroyed, the resource is queued to be
+ * dropped. The manager never scans all resources when it is processed.
+ *
+ * Loader tasks are started by a LoadScheduler, which limits the number of concurrently
+ * running loader tasks so that resources with a high load priority do not have to wait
+ * for the loader tasks of all resources that were queued before them. Loading a
+ * resource that is dropped before its loader task has started is cancelled.
+ */
+class ResourceManager
+{
+private:
+  struct Entry
+  {
+    size_t sequenceNumber;
+    ResourceWrapperBase* resourceWrapper;
+  };
+
+  std::vector<std::unique_ptr<ResourceWrapperBase>> m_resources;
+  std::unordered_map<ResourceId, Entry> m_resourcesById;
+  std::shared_ptr<ResourceQueue> m_readyQueue;
+  std::shared_ptr<LoadScheduler> m_loadScheduler;
+  std::unordered_map<ResourceId, std::shared_ptr<std::atomic<bool>>> m_loadingTasks;
+  std::vector<ResourceWrapperBase*> m_unreferencedResources;
+  size_t m_nextSequenceNumber = 0;
+
+  std::optional<ResidencyBudget> m_residencyBudget;
+  size_t m_residentBytes = 0;
+
+  // the evictable resources, ordered from least to most recently requested
+  using EvictionOrder = std::list<ResourceWrapperBase*>;
+  EvictionOrder m_evictionOrder;
+  std::unordered_map<const ResourceWrapperBase*, EvictionOrder::iterator>
+    m_evictionPositions;
+  size_t m_currentTick = 0;
+
+public:
+  explicit ResourceManager(size_t maxConcurrentLoads);
+  ~ResourceManager();
+
+  bool needsProcessing() const;
+
+  std::vector<const ResourceWrapperBase*> resources() const;
+
+  const std::optional<ResidencyBudget>& residencyBudget() const;
+  void setResidencyBudget(std::optional<ResidencyBudget> residencyBudget);
+
+  /**
+   * Returns the number of bytes occupied by the loaded data of all managed resources.
+   */
+  size_t residentBytes() const;
+
+  /**
+   * Adds the given resource and returns a handle to it. The resource is dropped once all
+   * copies of the returned handle have been destroyed, so callers must only share the
+   * handle and not the given pointer.
+   */
+  template <typename ResourceT>
+  std::shared_ptr<Resource<ResourceT>> addResource(
+    std::shared_ptr<Resource<ResourceT>> resource)
   {
-    const auto checkTimeout =
-      timeout ? std::function{[timeout_ = *timeout,
-                               startTime = std::chrono::steady_clock::now()]() {
-        return std::chrono::steady_clock::now() - startTime < timeout_;
-      }}
-              : std::function{[]() { return true; }};
+    resource->setProcessingRequestHandler(
+      [readyQueue = m_readyQueue](const auto& resourceId) {
+        readyQueue->push(resourceId);
+      });
+
+    // the handle keeps the resource alive in case it outlives the resource manager
+    auto handle = std::shared_ptr<Resource<ResourceT>>{
+      resource.get(), [readyQueue = m_readyQueue, resource](const auto*) {
+        readyQueue->pushUnreferenced(resource->id());
+      }};
 
-    auto result = std::vector<ResourceId>{};
+    auto resourceWrapper =
+      std::make_unique<ResourceWrapper<ResourceT>>(std::move(resource), m_currentTick);
+    m_resourcesById.emplace(
+      resourceWrapper->id(), Entry{m_nextSequenceNumber++, resourceWrapper.get()});
+    m_residentBytes += resourceWrapper->residentBytes();
 
-    for (auto it = m_resources.begin(); it != m_resources.end() && checkTimeout();)
+    if (resourceWrapper->needsProcessing())
     {
-      auto& resourceWrapper = *it;
-      if (resourceWrapper->useCount() == 1 && !resourceWrapper->isDropped())
-      {
-        resourceWrapper->drop();
-      }
-
-      if (resourceWrapper->needsProcessing())
-      {
-        if (resourceWrapper->process(taskRunner, processContext))
-        {
-          result.push_back(resourceWrapper->id());
-        }
-      }
-
-      it = resourceWrapper->useCount() == 1 && resourceWrapper->isDropped()
-             ? m_resources.erase(it)
-             : std::next(it);
+      m_readyQueue->push(resourceWrapper->id());
     }
+    m_resources.push_back(std::move(resourceWrapper));
 
-    return result;
+    return handle;
   }
+
+  std::vector<ResourceId> process(
+    TaskRunner taskRunner,
+    const ProcessContext& processContext,
+    std::optional<std::chrono::milliseconds> timeout = std::nullopt);
+
+private:
+  void dropUnreferencedResources();
+  void processResource(
+    const Entry& entry,
+    const TaskRunner& taskRunner,
+    const ProcessContext& processContext,
+    std::vector<ResourceId>& processedResources);
+  std::vector<Entry> takeReadyResources();
+  TaskRunner makeSchedulingTaskRunner(
+    TaskRunner taskRunner,
+    const Entry& entry,
+    std::shared_ptr<std::atomic<bool>> cancelled) const;
+  void eraseDroppedResources();
+  void updateEvictionOrder(ResourceWrapperBase& resourceWrapper, bool requested);
+  void evictIfOverBudget(
+    const ProcessContext& processContext, std::vector<ResourceId>& processedResources);
 };
 
 } // namespace tb::mdl
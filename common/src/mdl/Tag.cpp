@@ -26,6 +26,7 @@
 #include <cassert>
 #include <ostream>
 #include <string>
+#include <string_view>
 #include <utility>
 
 namespace tb::mdl
@@ -159,6 +160,7 @@ bool Taggable::addTag(const Tag& tag)
     m_tags.emplace(tag);
 
     updateAttributeMask();
+    doTagsDidChange();
     return true;
   }
   return false;
@@ -173,6 +175,7 @@ bool Taggable::removeTag(const Tag& tag)
     assert(!hasTag(tag));
 
     updateAttributeMask();
+    doTagsDidChange();
     return true;
   }
 
@@ -193,9 +196,15 @@ void Taggable::updateTags(TagManager& tagManager)
 
 void Taggable::clearTags()
 {
+  const auto hadTags = m_tagMask != 0;
   m_tagMask = 0;
   m_tags.clear();
   updateAttributeMask();
+
+  if (hadTags)
+  {
+    doTagsDidChange();
+  }
 }
 
 bool Taggable::hasAttribute(const TagAttribute& attribute) const
@@ -226,10 +235,23 @@ void Taggable::updateAttributeMask()
   }
 }
 
+void Taggable::doTagsDidChange() {}
+
 TagMatcherCallback::~TagMatcherCallback() = default;
 
 TagMatcher::~TagMatcher() = default;
 
+bool TagMatcher::isMaterialMatcher() const
+{
+  return false;
+}
+
+bool TagMatcher::matchesFaceMaterial(
+  std::string_view /* materialName */, const Material* /* material */) const
+{
+  return false;
+}
+
 void TagMatcher::enable(TagMatcherCallback& /* callback */, MapFacade& /* facade */) const
 {
 }
@@ -285,6 +307,17 @@ bool SmartTag::matches(const Taggable& taggable) const
   return m_matcher->matches(taggable);
 }
 
+bool SmartTag::isMaterialTag() const
+{
+  return m_matcher->isMaterialMatcher();
+}
+
+bool SmartTag::matchesFaceMaterial(
+  const std::string_view materialName, const Material* material) const
+{
+  return m_matcher->matchesFaceMaterial(materialName, material);
+}
+
 void SmartTag::update(Taggable& taggable) const
 {
   if (matches(taggable))
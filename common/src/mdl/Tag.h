@@ -28,11 +28,13 @@
 #include <iosfwd>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace tb::mdl
 {
 class ConstTagVisitor;
+class Material;
 class TagManager;
 class TagVisitor;
 
@@ -256,6 +258,12 @@ private:
 private:
   virtual void doAcceptTagVisitor(TagVisitor& visitor) = 0;
   virtual void doAcceptTagVisitor(ConstTagVisitor& visitor) const = 0;
+
+  /**
+   * Called after a tag was added to or removed from this object. May be called
+   * concurrently for different objects.
+   */
+  virtual void doTagsDidChange();
 };
 
 class MapFacade;
@@ -288,6 +296,27 @@ public:
    */
   virtual bool matches(const Taggable& taggable) const = 0;
 
+  /**
+   * Indicates whether this tag matcher matches brush faces by their material alone. The
+   * result of such a matcher can be computed once per material and then be reused for
+   * every face that uses the same material.
+   *
+   * @return true if this matcher only depends on the material of a brush face and false
+   * otherwise
+   */
+  virtual bool isMaterialMatcher() const;
+
+  /**
+   * Evaluates this tag matcher against a brush face with the given material name and
+   * material. Only called if this is a material matcher.
+   *
+   * @param materialName the name of the material of the brush face
+   * @param material the material of the brush face, may be null
+   * @return true if this matcher matches a brush face with the given material
+   */
+  virtual bool matchesFaceMaterial(
+    std::string_view materialName, const Material* material) const;
+
   /**
    * Modifies the current selection so that this tag matcher would match it.
    *
@@ -367,6 +396,21 @@ public:
    */
   bool matches(const Taggable& taggable) const;
 
+  /**
+   * Indicates whether this smart tag matches brush faces by their material alone.
+   */
+  bool isMaterialTag() const;
+
+  /**
+   * Indicates whether this smart tag matches a brush face with the given material name
+   * and material. Only valid if this is a material tag.
+   *
+   * @param materialName the name of the material of the brush face
+   * @param material the material of the brush face, may be null
+   * @return true if this smart tag matches a brush face with the given material
+   */
+  bool matchesFaceMaterial(std::string_view materialName, const Material* material) const;
+
   /**
    * Updates the given tag depending on whether or not the matcher matches against it.
    *
@@ -20,12 +20,14 @@
 #include "TagManager.h"
 
 #include "Ensure.h"
+#include "mdl/BrushFace.h"
 #include "mdl/Tag.h"
 #include "mdl/TagType.h"
 
 #include <fmt/format.h>
 
 #include <algorithm>
+#include <mutex>
 #include <stdexcept>
 #include <string>
 
@@ -104,11 +106,14 @@ void TagManager::registerSmartTags(const std::vector<SmartTag>& tags)
 
     it->setIndex(nextIndex);
   }
+
+  clearMaterialTags();
 }
 
 void TagManager::clearSmartTags()
 {
   m_smartTags.clear();
+  clearMaterialTags();
 }
 
 void TagManager::updateTags(Taggable& taggable) const
@@ -119,6 +124,65 @@ void TagManager::updateTags(Taggable& taggable) const
   }
 }
 
+void TagManager::updateFaceTags(BrushFace& face) const
+{
+  const auto materialTags =
+    materialTagMask(face.attributes().materialName(), face.material());
+
+  for (const auto& tag : m_smartTags)
+  {
+    if (tag.isMaterialTag())
+    {
+      if ((materialTags & tag.type()) != 0)
+      {
+        face.addTag(tag);
+      }
+      else
+      {
+        face.removeTag(tag);
+      }
+    }
+    else
+    {
+      tag.update(face);
+    }
+  }
+}
+
+void TagManager::clearMaterialTags()
+{
+  auto lock = std::unique_lock{m_materialTagsMutex};
+  m_materialTags.clear();
+}
+
+TagType::Type TagManager::materialTagMask(
+  const std::string& materialName, const Material* material) const
+{
+  {
+    auto lock = std::shared_lock{m_materialTagsMutex};
+    if (const auto it = m_materialTags.find(materialName);
+        it != m_materialTags.end() && it->second.material == material)
+    {
+      return it->second.tagMask;
+    }
+  }
+
+  auto tagMask = TagType::Type(0);
+  for (const auto& tag : m_smartTags)
+  {
+    if (tag.isMaterialTag() && tag.matchesFaceMaterial(materialName, material))
+    {
+      tagMask |= tag.type();
+    }
+  }
+
+  // a face has no material until its material has been loaded, so an entry is only
+  // reused if the material matches
+  auto lock = std::unique_lock{m_materialTagsMutex};
+  m_materialTags.insert_or_assign(materialName, MaterialTags{material, tagMask});
+  return tagMask;
+}
+
 size_t TagManager::freeTagIndex()
 {
   static const size_t Bits = (sizeof(TagType::Type) * 8);
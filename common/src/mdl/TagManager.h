@@ -20,16 +20,26 @@
 #pragma once
 
 #include "mdl/Tag.h"
+#include "mdl/TagType.h"
 
 #include "kdl/vector_set.h"
 
+#include <shared_mutex>
 #include <string>
+#include <unordered_map>
 
 namespace tb::mdl
 {
+class BrushFace;
+class Material;
 
 /**
  * Manages the tags used in a document and updates smart tags on taggable objects.
+ *
+ * The material tags of a brush face only depend on its material, so the manager caches a
+ * tag mask per material name. Updating the tags of a face then amounts to a lookup and
+ * the evaluation of the remaining tags, such as the flags tags. The cache is thread safe
+ * so that the tags of many faces can be updated in parallel.
  */
 class TagManager
 {
@@ -42,8 +52,17 @@ private:
     bool operator()(const std::string& lhs, const std::string& rhs) const;
   };
 
+  struct MaterialTags
+  {
+    const Material* material;
+    TagType::Type tagMask;
+  };
+
   kdl::vector_set<SmartTag, TagCmp> m_smartTags;
 
+  mutable std::shared_mutex m_materialTagsMutex;
+  mutable std::unordered_map<std::string, MaterialTags> m_materialTags;
+
 public:
   /**
    * Returns a vector containing all smart tags registered with this manager.
@@ -113,7 +132,23 @@ public:
    */
   void updateTags(Taggable& taggable) const;
 
+  /**
+   * Update the smart tags of the given brush face. The material tags are taken from the
+   * material tag cache.
+   *
+   * @param face the face to update
+   */
+  void updateFaceTags(BrushFace& face) const;
+
+  /**
+   * Clears the cached material tags. Must be called when the materials were reloaded or
+   * their properties changed.
+   */
+  void clearMaterialTags();
+
 private:
+  TagType::Type materialTagMask(
+    const std::string& materialName, const Material* material) const;
   size_t freeTagIndex();
 };
 
@@ -145,6 +145,11 @@ void MaterialTagMatcher::enable(TagMatcherCallback& callback, MapFacade& facade)
   facade.setFaceAttributes(request);
 }
 
+bool MaterialTagMatcher::isMaterialMatcher() const
+{
+  return true;
+}
+
 bool MaterialTagMatcher::canEnable() const
 {
   return true;
@@ -168,13 +173,19 @@ std::unique_ptr<TagMatcher> MaterialNameTagMatcher::clone() const
 bool MaterialNameTagMatcher::matches(const Taggable& taggable) const
 {
   auto visitor = BrushFaceMatchVisitor{[&](const auto& face) {
-    return matchesMaterialName(face.attributes().materialName());
+    return matchesFaceMaterial(face.attributes().materialName(), face.material());
   }};
 
   taggable.accept(visitor);
   return visitor.matches();
 }
 
+bool MaterialNameTagMatcher::matchesFaceMaterial(
+  const std::string_view materialName, const Material* /* material */) const
+{
+  return matchesMaterialName(materialName);
+}
+
 void MaterialNameTagMatcher::appendToStream(std::ostream& str) const
 {
   kdl::struct_stream{str} << "MaterialNameTagMatcher"
@@ -219,13 +230,20 @@ std::unique_ptr<TagMatcher> SurfaceParmTagMatcher::clone() const
 
 bool SurfaceParmTagMatcher::matches(const Taggable& taggable) const
 {
-  auto visitor = BrushFaceMatchVisitor{
-    [&](const auto& face) { return matchesMaterial(face.material()); }};
+  auto visitor = BrushFaceMatchVisitor{[&](const auto& face) {
+    return matchesFaceMaterial(face.attributes().materialName(), face.material());
+  }};
 
   taggable.accept(visitor);
   return visitor.matches();
 }
 
+bool SurfaceParmTagMatcher::matchesFaceMaterial(
+  const std::string_view /* materialName */, const Material* material) const
+{
+  return matchesMaterial(material);
+}
+
 void SurfaceParmTagMatcher::appendToStream(std::ostream& str) const
 {
   kdl::struct_stream{str} << "SurfaceParmTagMatcher"
@@ -43,6 +43,7 @@ class MapFacade;
 class MaterialTagMatcher : public TagMatcher
 {
 public:
+  bool isMaterialMatcher() const override;
   void enable(TagMatcherCallback& callback, MapFacade& facade) const override;
   bool canEnable() const override;
   void appendToStream(std::ostream& str) const override;
@@ -60,6 +61,8 @@ public:
   explicit MaterialNameTagMatcher(std::string pattern);
   std::unique_ptr<TagMatcher> clone() const override;
   bool matches(const Taggable& taggable) const override;
+  bool matchesFaceMaterial(
+    std::string_view materialName, const Material* material) const override;
   void appendToStream(std::ostream& str) const override;
 
 private:
@@ -77,6 +80,8 @@ public:
   explicit SurfaceParmTagMatcher(kdl::vector_set<std::string> parameters);
   std::unique_ptr<TagMatcher> clone() const override;
   bool matches(const Taggable& taggable) const override;
+  bool matchesFaceMaterial(
+    std::string_view materialName, const Material* material) const override;
   void appendToStream(std::ostream& str) const override;
 
 private:
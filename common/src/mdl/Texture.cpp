@@ -57,6 +57,16 @@ auto makeTextureLoadedState(
   return TextureLoadedState{std::move(buffers)};
 }
 
+size_t totalByteSize(const std::vector<TextureBuffer>& buffers)
+{
+  auto result = size_t(0);
+  for (const auto& buffer : buffers)
+  {
+    result += buffer.size();
+  }
+  return result;
+}
+
 auto uploadTexture(
   const GLenum format,
   const TextureMask mask,
@@ -170,6 +180,8 @@ std::ostream& operator<<(std::ostream& lhs, const EmbeddedDefaults& rhs)
 kdl_reflect_impl(NoEmbeddedDefaults);
 kdl_reflect_impl(Q2EmbeddedDefaults);
 
+kdl_reflect_impl(TextureHeader);
+
 kdl_reflect_impl(TextureLoadedState);
 kdl_reflect_impl(TextureReadyState);
 kdl_reflect_impl(TextureDroppedState);
@@ -190,6 +202,7 @@ Texture::Texture(
   , m_format{format}
   , m_mask{mask}
   , m_embeddedDefaults{std::move(embeddedDefaults)}
+  , m_byteSize{totalByteSize(buffers)}
   , m_state{makeTextureLoadedState(m_width, m_height, m_format, std::move(buffers))}
 {
   assert(m_width > 0);
@@ -267,6 +280,11 @@ const EmbeddedDefaults& Texture::embeddedDefaults() const
   return m_embeddedDefaults;
 }
 
+size_t Texture::byteSize() const
+{
+  return m_byteSize;
+}
+
 bool Texture::isReady() const
 {
   return std::holds_alternative<TextureReadyState>(m_state);
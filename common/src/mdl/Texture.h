@@ -60,6 +60,18 @@ using EmbeddedDefaults = std::variant<NoEmbeddedDefaults, Q2EmbeddedDefaults>;
 
 std::ostream& operator<<(std::ostream& lhs, const EmbeddedDefaults& rhs);
 
+/**
+ * The information that can be read from a texture file without decoding its pixels.
+ */
+struct TextureHeader
+{
+  size_t width;
+  size_t height;
+  EmbeddedDefaults embeddedDefaults;
+
+  kdl_reflect_decl(TextureHeader, width, height, embeddedDefaults);
+};
+
 struct TextureLoadedState
 {
   std::vector<TextureBuffer> buffers;
@@ -94,6 +106,7 @@ private:
 
   EmbeddedDefaults m_embeddedDefaults;
 
+  size_t m_byteSize;
   mutable TextureState m_state;
 
   kdl_reflect_decl(
@@ -147,6 +160,13 @@ public:
 
   const EmbeddedDefaults& embeddedDefaults() const;
 
+  /**
+   * Returns the number of bytes of image data this texture was created with. This is
+   * an estimate of the memory the texture occupies regardless of whether it resides in
+   * main memory or has been uploaded.
+   */
+  size_t byteSize() const;
+
   bool isReady() const;
 
   bool activate(int minFilter, int magFilter) const;
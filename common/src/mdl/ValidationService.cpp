@@ -0,0 +1,268 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ValidationService.h"
+
+#include "mdl/BrushFaceHandle.h"
+#include "mdl/BrushNode.h"
+#include "mdl/EntityNode.h"
+#include "mdl/GroupNode.h"
+#include "mdl/Issue.h"
+#include "mdl/LayerNode.h"
+#include "mdl/PatchNode.h"
+#include "mdl/WorldNode.h"
+
+#include "kdl/task_manager.h"
+#include "kdl/vector_utils.h"
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+namespace tb::mdl
+{
+
+ValidationService::ValidationService(kdl::task_manager& taskManager)
+  : m_taskManager{taskManager}
+{
+}
+
+void ValidationService::reset(WorldNode* world)
+{
+  m_world = world;
+  m_dirtyNodes.clear();
+  m_issues.clear();
+  m_removedIssues.clear();
+
+  invalidateAll();
+  m_removedIssues.clear();
+}
+
+IssueDelta ValidationService::invalidateAll()
+{
+  if (m_world)
+  {
+    invalidateNodeAndDescendants(m_world);
+  }
+  return takeRemovedIssues();
+}
+
+IssueDelta ValidationService::nodesWereAdded(const std::vector<Node*>& nodes)
+{
+  for (auto* node : nodes)
+  {
+    invalidateNodeAndDescendants(node);
+    invalidateNode(node->parent());
+    invalidateLinkedNodes(node);
+  }
+  return takeRemovedIssues();
+}
+
+IssueDelta ValidationService::nodesWillBeRemoved(const std::vector<Node*>& nodes)
+{
+  for (auto* node : nodes)
+  {
+    invalidateNode(node->parent());
+    invalidateLinkedNodes(node);
+  }
+  return takeRemovedIssues();
+}
+
+IssueDelta ValidationService::nodesWereRemoved(const std::vector<Node*>& nodes)
+{
+  for (auto* node : nodes)
+  {
+    forgetNodeAndDescendants(node);
+  }
+  return takeRemovedIssues();
+}
+
+IssueDelta ValidationService::nodesWillChange(const std::vector<Node*>& nodes)
+{
+  for (auto* node : nodes)
+  {
+    invalidateLinkedNodes(node);
+  }
+  return takeRemovedIssues();
+}
+
+IssueDelta ValidationService::nodesDidChange(const std::vector<Node*>& nodes)
+{
+  for (auto* node : nodes)
+  {
+    if (node == m_world)
+    {
+      // world properties such as the soft map bounds affect every node
+      return invalidateAll();
+    }
+
+    invalidateNode(node);
+    invalidateLinkedNodes(node);
+  }
+  return takeRemovedIssues();
+}
+
+IssueDelta ValidationService::brushFacesDidChange(
+  const std::vector<BrushFaceHandle>& faceHandles)
+{
+  for (const auto& faceHandle : faceHandles)
+  {
+    invalidateNode(faceHandle.node());
+  }
+  return takeRemovedIssues();
+}
+
+bool ValidationService::needsValidation() const
+{
+  return !m_dirtyNodes.empty();
+}
+
+IssueDelta ValidationService::validate()
+{
+  constexpr auto NodesPerTask = size_t(256);
+
+  auto delta = IssueDelta{};
+  if (!m_world || m_dirtyNodes.empty())
+  {
+    return delta;
+  }
+
+  const auto validators = m_world->registeredValidators();
+  const auto nodes = std::vector<Node*>{m_dirtyNodes.begin(), m_dirtyNodes.end()};
+  m_dirtyNodes.clear();
+
+  for (auto* node : nodes)
+  {
+    // the bounds are cached lazily and a group computes them from its children, so we
+    // compute them here to avoid doing so concurrently
+    node->logicalBounds();
+    node->invalidateIssues();
+  }
+
+  auto nodeIssues = std::vector<std::vector<const Issue*>>(nodes.size());
+  if (nodes.size() <= NodesPerTask)
+  {
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+      nodeIssues[i] = nodes[i]->issues(validators);
+    }
+  }
+  else
+  {
+    auto tasks = std::vector<std::function<bool()>>{};
+    for (size_t first = 0; first < nodes.size(); first += NodesPerTask)
+    {
+      tasks.emplace_back([&, first]() {
+        const auto last = std::min(first + NodesPerTask, nodes.size());
+        for (auto i = first; i < last; ++i)
+        {
+          nodeIssues[i] = nodes[i]->issues(validators);
+        }
+        return true;
+      });
+    }
+    m_taskManager.run_tasks_and_wait(tasks);
+  }
+
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    if (!nodeIssues[i].empty())
+    {
+      delta.addedIssues = kdl::vec_concat(std::move(delta.addedIssues), nodeIssues[i]);
+      m_issues[nodes[i]] = std::move(nodeIssues[i]);
+    }
+  }
+
+  return delta;
+}
+
+std::vector<const Issue*> ValidationService::issues() const
+{
+  auto result = std::vector<const Issue*>{};
+  for (const auto& [node, issues] : m_issues)
+  {
+    result = kdl::vec_concat(std::move(result), issues);
+  }
+  return result;
+}
+
+void ValidationService::invalidateNode(Node* node)
+{
+  if (node)
+  {
+    m_dirtyNodes.insert(node);
+    removeIssues(node);
+  }
+}
+
+void ValidationService::invalidateNodeAndDescendants(Node* node)
+{
+  node->accept([&](auto&& thisLambda, Node* descendant) {
+    invalidateNode(descendant);
+    descendant->visitChildren(thisLambda);
+  });
+}
+
+void ValidationService::invalidateLinkedNodes(Node* node)
+{
+  if (const auto* entityNode = dynamic_cast<const EntityNodeBase*>(node))
+  {
+    for (auto* linkedNode : entityNode->linkSources())
+    {
+      invalidateNode(linkedNode);
+    }
+    for (auto* linkedNode : entityNode->linkTargets())
+    {
+      invalidateNode(linkedNode);
+    }
+    for (auto* linkedNode : entityNode->killSources())
+    {
+      invalidateNode(linkedNode);
+    }
+    for (auto* linkedNode : entityNode->killTargets())
+    {
+      invalidateNode(linkedNode);
+    }
+  }
+}
+
+void ValidationService::forgetNodeAndDescendants(Node* node)
+{
+  node->accept([&](auto&& thisLambda, Node* descendant) {
+    m_dirtyNodes.erase(descendant);
+    removeIssues(descendant);
+    descendant->visitChildren(thisLambda);
+  });
+}
+
+void ValidationService::removeIssues(const Node* node)
+{
+  if (const auto it = m_issues.find(node); it != m_issues.end())
+  {
+    m_removedIssues = kdl::vec_concat(std::move(m_removedIssues), std::move(it->second));
+    m_issues.erase(it);
+  }
+}
+
+IssueDelta ValidationService::takeRemovedIssues()
+{
+  return IssueDelta{std::exchange(m_removedIssues, {}), {}};
+}
+
+} // namespace tb::mdl
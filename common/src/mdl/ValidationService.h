@@ -0,0 +1,124 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace kdl
+{
+class task_manager;
+}
+
+namespace tb::mdl
+{
+class BrushFaceHandle;
+class Issue;
+class Node;
+class WorldNode;
+
+/**
+ * The issues that were added and removed by the validation service. Removed issues must
+ * be removed from any list of issues before the added issues are added.
+ */
+struct IssueDelta
+{
+  std::vector<const Issue*> removedIssues;
+  std::vector<const Issue*> addedIssues;
+};
+
+/**
+ * Keeps track of the issues of the nodes of a world and validates only the nodes that
+ * were invalidated since the last validation.
+ *
+ * The service is fed with node change notifications. Besides the changed nodes
+ * themselves, it invalidates the nodes whose issues depend on them: the parents of added
+ * and removed nodes, since some validators check whether a node has children, and the
+ * link sources and targets of changed entities, since the link validators check whether
+ * the links of an entity can be resolved. Changes to the world node or to the entity
+ * definitions and mods affect all nodes and require calling invalidateAll.
+ *
+ * The functions that invalidate nodes return the issues of these nodes as removed issues,
+ * since they may refer to state of the node that no longer exists. They must be removed
+ * from any list of issues right away.
+ *
+ * Dirty nodes are validated in parallel batches. Validators only read the node they
+ * validate and the links and children of that node, and each node is validated by
+ * exactly one task.
+ */
+class ValidationService
+{
+private:
+  kdl::task_manager& m_taskManager;
+  WorldNode* m_world = nullptr;
+
+  std::unordered_set<Node*> m_dirtyNodes;
+  std::unordered_map<const Node*, std::vector<const Issue*>> m_issues;
+  std::vector<const Issue*> m_removedIssues;
+
+public:
+  explicit ValidationService(kdl::task_manager& taskManager);
+
+  /**
+   * Forgets all issues and marks all nodes of the given world as dirty.
+   */
+  void reset(WorldNode* world);
+
+  /**
+   * Marks all nodes of the world as dirty.
+   */
+  IssueDelta invalidateAll();
+
+  IssueDelta nodesWereAdded(const std::vector<Node*>& nodes);
+  IssueDelta nodesWillBeRemoved(const std::vector<Node*>& nodes);
+
+  /**
+   * Forgets the given nodes and their descendants, since they may be destroyed before
+   * the next validation.
+   */
+  IssueDelta nodesWereRemoved(const std::vector<Node*>& nodes);
+
+  IssueDelta nodesWillChange(const std::vector<Node*>& nodes);
+  IssueDelta nodesDidChange(const std::vector<Node*>& nodes);
+  IssueDelta brushFacesDidChange(const std::vector<BrushFaceHandle>& faceHandles);
+
+  bool needsValidation() const;
+
+  /**
+   * Validates all dirty nodes and returns their issues as added issues.
+   */
+  IssueDelta validate();
+
+  /**
+   * Returns all issues that were found by the previous validations.
+   */
+  std::vector<const Issue*> issues() const;
+
+private:
+  void invalidateNode(Node* node);
+  void invalidateNodeAndDescendants(Node* node);
+  void invalidateLinkedNodes(Node* node);
+  void forgetNodeAndDescendants(Node* node);
+  void removeIssues(const Node* node);
+  IssueDelta takeRemovedIssues();
+};
+
+} // namespace tb::mdl
@@ -32,6 +32,7 @@
 #include "vm/scalar.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cmath>
 #include <cstdint>
@@ -91,6 +92,12 @@ node_address get_root(const node_address& address);
 
 node_address get_container(const node_address& address1, const node_address& address2);
 
+inline size_t next_revision()
+{
+  static auto revision = std::atomic<size_t>{0};
+  return ++revision;
+}
+
 template <typename T>
 node_address get_container(const vm::bbox<T, 3>& bounds, const T min_size)
 {
@@ -367,6 +374,7 @@ private:
   std::optional<node> m_root;
   T m_min_size;
   std::unordered_map<U, detail::node_address> m_node_address_for_data;
+  size_t m_revision = detail::next_revision();
 
 public:
   explicit octree(const T min_size)
@@ -419,6 +427,7 @@ public:
       throw NodeTreeException("Data already in tree");
     }
 
+    m_revision = detail::next_revision();
     const auto address = detail::get_container(bounds, m_min_size);
     if (is_root(address))
     {
@@ -465,6 +474,7 @@ public:
       return false;
     }
 
+    m_revision = detail::next_revision();
     remove_from_node(*m_root, i_address->second, data);
     m_node_address_for_data.erase(data);
 
@@ -500,6 +510,7 @@ public:
    */
   void clear()
   {
+    m_revision = detail::next_revision();
     m_node_address_for_data.clear();
     m_root = std::nullopt;
   }
@@ -511,6 +522,51 @@ public:
    */
   bool empty() const { return m_root == std::nullopt; }
 
+  /**
+   * Returns the number of data items stored in this tree.
+   */
+  size_t size() const { return m_node_address_for_data.size(); }
+
+  /**
+   * Returns a number that changes whenever data is inserted into or removed from this
+   * tree. Revisions are unique across all trees, so a node of this tree that was
+   * obtained from root() or children() remains valid as long as the revision is
+   * unchanged.
+   */
+  size_t revision() const { return m_revision; }
+
+  /**
+   * Returns the root node of this tree or nullptr if this tree is empty.
+   */
+  const node* root() const { return m_root ? &*m_root : nullptr; }
+
+  /**
+   * Returns the bounds of the given node of this tree. The bounds of every data item
+   * stored in the node or in one of its descendants are contained in these bounds.
+   */
+  vm::bbox<T, 3> bounds(const node& node_) const
+  {
+    return get_address(node_).to_bounds(m_min_size);
+  }
+
+  /**
+   * Returns the data items stored in the given node, excluding its descendants.
+   */
+  static const std::vector<U>& data(const node& node_) { return get_data(node_); }
+
+  /**
+   * Returns the children of the given node. Leaf nodes have no children.
+   */
+  static const std::vector<node>& children(const node& node_)
+  {
+    static const auto no_children = std::vector<node>{};
+    return std::visit(
+      kdl::overload(
+        [](const inner_node& i) -> const std::vector<node>& { return i.children; },
+        [](const leaf_node&) -> const std::vector<node>& { return no_children; }),
+      node_);
+  }
+
   /**
    * Finds every data item in this tree whose bounding box intersects with the given ray
    * and returns a list of those items.
@@ -630,6 +686,35 @@ public:
     }
   }
 
+  /**
+   * Finds every data item in this tree that is stored in a node whose bounds satisfy the
+   * given predicate and appends it to the given output iterator.
+   *
+   * The children of a node are only tested if the node satisfies the predicate, so the
+   * predicate must not accept a node's child bounds if it rejects the node's bounds.
+   *
+   * @tparam P the predicate type, must accept a const vm::bbox<T, 3>&
+   * @tparam O the output iterator type
+   * @param predicate the predicate to test the node bounds with
+   * @param out the output iterator to append to
+   */
+  template <typename P, typename O>
+  void find_if(const P& predicate, O out) const
+  {
+    if (m_root)
+    {
+      visit_node_if(
+        *m_root,
+        [&](const auto& node) {
+          const auto& data = get_data(node);
+          std::copy(data.begin(), data.end(), out);
+        },
+        [&](const auto& node) {
+          return predicate(get_address(node).to_bounds(m_min_size));
+        });
+    }
+  }
+
   kdl_reflect_inline(octree, m_root, m_min_size, m_node_address_for_data);
 
 private:
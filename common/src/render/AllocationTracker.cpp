@@ -49,6 +49,8 @@ static std::vector<AllocationTracker::Block*>::iterator findFirstLargerOrEqualBi
 void AllocationTracker::unlinkFromBinList(Block* block)
 {
   assert(block->free);
+  assert(m_freeBlockCount > 0);
+  --m_freeBlockCount;
 
   if (block->prevOfSameSize == nullptr)
   {
@@ -103,6 +105,8 @@ void AllocationTracker::linkToBinList(Block* block)
   assert(block->prevOfSameSize == nullptr);
   assert(block->nextOfSameSize == nullptr);
 
+  ++m_freeBlockCount;
+
   auto it = findFirstLargerOrEqualBin(m_freeBlockSizeBins, block->size);
 
   if (it == m_freeBlockSizeBins.end())
@@ -174,6 +178,7 @@ AllocationTracker::Block* AllocationTracker::allocate(const size_t needed)
   assert(block != nullptr);
   assert(block->free);
   assert(block->prevOfSameSize == nullptr);
+  --m_freeBlockCount;
   {
     Block* blockAfter = block->nextOfSameSize;
     if (blockAfter == nullptr)
@@ -190,6 +195,9 @@ AllocationTracker::Block* AllocationTracker::allocate(const size_t needed)
   block->nextOfSameSize = nullptr;
   block->prevOfSameSize = nullptr;
 
+  m_usedSize += needed;
+  ++m_usedBlockCount;
+
   if (block->size == needed)
   {
     // lucky case: exact size. we're done
@@ -243,6 +251,9 @@ void AllocationTracker::free(Block* block)
   assert(block->prevOfSameSize == nullptr);
   assert(block->nextOfSameSize == nullptr);
 
+  m_usedSize -= block->size;
+  --m_usedBlockCount;
+
   Block* left = block->left;
   Block* right = block->right;
 
@@ -351,6 +362,9 @@ AllocationTracker::AllocationTracker(const Index initial_capacity)
   , m_leftmostBlock(nullptr)
   , m_rightmostBlock(nullptr)
   , m_recycledBlockList(nullptr)
+  , m_freeBlockCount(0)
+  , m_usedSize(0)
+  , m_usedBlockCount(0)
 {
   if (initial_capacity > 0)
   {
@@ -364,6 +378,9 @@ AllocationTracker::AllocationTracker()
   , m_leftmostBlock(nullptr)
   , m_rightmostBlock(nullptr)
   , m_recycledBlockList(nullptr)
+  , m_freeBlockCount(0)
+  , m_usedSize(0)
+  , m_usedBlockCount(0)
 {
 }
 
@@ -458,6 +475,40 @@ void AllocationTracker::expand(const Index newCapacity)
   checkInvariants();
 }
 
+void AllocationTracker::shrink(const Index newCapacity)
+{
+  checkInvariants();
+
+  assert(newCapacity > 0);
+  assert(newCapacity >= usedEnd());
+  assert(newCapacity < m_capacity);
+
+  // the range past usedEnd() is covered by the rightmost block, which must be free
+  Block* lastBlock = m_rightmostBlock;
+  assert(lastBlock->free);
+
+  unlinkFromBinList(lastBlock);
+  if (lastBlock->pos == newCapacity)
+  {
+    // newCapacity > 0, so there is a used block to the left
+    Block* newLastBlock = lastBlock->left;
+    assert(newLastBlock != nullptr);
+
+    newLastBlock->right = nullptr;
+    m_rightmostBlock = newLastBlock;
+    recycle(lastBlock);
+  }
+  else
+  {
+    lastBlock->size = newCapacity - lastBlock->pos;
+    linkToBinList(lastBlock);
+  }
+
+  m_capacity = newCapacity;
+
+  checkInvariants();
+}
+
 bool AllocationTracker::hasAllocations() const
 {
   // NOTE: this loop should execute at most 2 iterations, because adjacent free blocks are
@@ -472,6 +523,133 @@ bool AllocationTracker::hasAllocations() const
   return false;
 }
 
+AllocationTracker::Index AllocationTracker::usedEnd() const
+{
+  if (m_rightmostBlock == nullptr)
+  {
+    return 0;
+  }
+  if (m_rightmostBlock->free)
+  {
+    // the block to the left is used because adjacent free blocks are always merged
+    return m_rightmostBlock->pos;
+  }
+  return m_capacity;
+}
+
+AllocationTracker::Index AllocationTracker::wastedSize() const
+{
+  return usedEnd() - m_usedSize;
+}
+
+std::vector<AllocationTracker::Move> AllocationTracker::compact(const Index maxMovedSize)
+{
+  checkInvariants();
+
+  auto moves = std::vector<Move>{};
+  if (!fragmented())
+  {
+    return moves;
+  }
+
+  Block* freeBlock = m_leftmostBlock;
+  while (freeBlock != nullptr && !freeBlock->free)
+  {
+    freeBlock = freeBlock->right;
+  }
+
+  auto movedSize = Index(0);
+  while (freeBlock != nullptr && freeBlock->right != nullptr && movedSize < maxMovedSize)
+  {
+    // the block to the right of a free block is always used, so we swap the two
+    Block* usedBlock = freeBlock->right;
+    assert(!usedBlock->free);
+
+    Block* left = freeBlock->left;
+    Block* right = usedBlock->right;
+
+    unlinkFromBinList(freeBlock);
+
+    moves.push_back(Move{usedBlock, usedBlock->pos});
+    movedSize += usedBlock->size;
+
+    usedBlock->pos = freeBlock->pos;
+    freeBlock->pos = usedBlock->pos + usedBlock->size;
+
+    usedBlock->left = left;
+    usedBlock->right = freeBlock;
+    freeBlock->left = usedBlock;
+    freeBlock->right = right;
+
+    if (left != nullptr)
+    {
+      left->right = usedBlock;
+    }
+    else
+    {
+      m_leftmostBlock = usedBlock;
+    }
+
+    if (right != nullptr)
+    {
+      right->left = freeBlock;
+    }
+    else
+    {
+      m_rightmostBlock = freeBlock;
+    }
+
+    // merge with the free block that was to the right of the used block
+    if (right != nullptr && right->free)
+    {
+      unlinkFromBinList(right);
+
+      freeBlock->size += right->size;
+      freeBlock->right = right->right;
+
+      if (right->right != nullptr)
+      {
+        right->right->left = freeBlock;
+      }
+      else
+      {
+        m_rightmostBlock = freeBlock;
+      }
+
+      recycle(right);
+    }
+
+    linkToBinList(freeBlock);
+  }
+
+  checkInvariants();
+  return moves;
+}
+
+bool AllocationTracker::fragmented() const
+{
+  // adjacent free blocks are always merged, so a single free block can only be followed
+  // by a used block if it isn't the rightmost block
+  return m_freeBlockCount > 1 || (m_freeBlockCount == 1 && !m_rightmostBlock->free);
+}
+
+double AllocationTracker::FragmentationStats::fragmentation() const
+{
+  const auto freeSize = capacity - usedSize;
+  return freeSize > 0 ? 1.0 - double(largestFreeBlock) / double(freeSize) : 0.0;
+}
+
+AllocationTracker::FragmentationStats AllocationTracker::fragmentationStats() const
+{
+  auto stats = FragmentationStats{};
+  stats.capacity = m_capacity;
+  stats.usedSize = m_usedSize;
+  stats.usedBlockCount = m_usedBlockCount;
+  stats.freeBlockCount = m_freeBlockCount;
+  stats.largestFreeBlock = largestPossibleAllocation();
+  return stats;
+}
+
 // Testing / debugging
 
 std::vector<AllocationTracker::Range> AllocationTracker::freeBlocks() const
@@ -526,10 +704,17 @@ void AllocationTracker::checkInvariants() const
 
   // check the left/right pointers, size, pos
   size_t totalSize = 0;
+  size_t usedSize = 0;
+  size_t usedBlockCount = 0;
   for (Block* block = m_leftmostBlock; block != nullptr; block = block->right)
   {
     assert(block->size != 0);
     totalSize += block->size;
+    if (!block->free)
+    {
+      usedSize += block->size;
+      ++usedBlockCount;
+    }
 
     if (block->right != nullptr)
     {
@@ -550,8 +735,11 @@ void AllocationTracker::checkInvariants() const
     }
   }
   assert(m_capacity == totalSize);
+  assert(m_usedSize == usedSize);
+  assert(m_usedBlockCount == usedBlockCount);
 
   // check the size map
+  size_t freeBlockCount = 0;
   for (const auto& headBlock : m_freeBlockSizeBins)
   {
     assert(headBlock != nullptr);
@@ -562,6 +750,7 @@ void AllocationTracker::checkInvariants() const
     {
       assert(block->free);
       assert(block->size == headBlock->size);
+      ++freeBlockCount;
 
       if (block->nextOfSameSize != nullptr)
       {
@@ -570,6 +759,8 @@ void AllocationTracker::checkInvariants() const
     }
   }
 
+  assert(freeBlockCount == m_freeBlockCount);
+
   // ensure the size bins are sorted
   for (size_t i = 0; (i + 1) < m_freeBlockSizeBins.size(); ++i)
   {
@@ -66,6 +66,37 @@ public:
     Block* nextRecycledBlock;
   };
 
+  /**
+   * Records that a used block was moved by compact(). The block's new position is
+   * `block->pos`.
+   */
+  struct Move
+  {
+    Block* block;
+    Index oldPos;
+  };
+
+  /**
+   * Describes how fragmented the free space managed by an AllocationTracker is.
+   */
+  struct FragmentationStats
+  {
+    Index capacity = 0;
+    Index usedSize = 0;
+    size_t usedBlockCount = 0;
+    size_t freeBlockCount = 0;
+    Index largestFreeBlock = 0;
+
+    /**
+     * The fraction of free space that is not part of the largest free block. This is 0 if
+     * all free space is contiguous and approaches 1 as the free space gets scattered over
+     * many small blocks.
+     */
+    double fragmentation() const;
+
+    bool operator==(const FragmentationStats& other) const = default;
+  };
+
 private:
   /**
    * Size of memory managed by this AllocationTracker.
@@ -97,6 +128,17 @@ private:
    */
   std::vector<Block*> m_freeBlockSizeBins;
 
+  /**
+   * The number of Blocks in m_freeBlockSizeBins.
+   */
+  size_t m_freeBlockCount;
+
+  /**
+   * The combined size and the number of the used Blocks.
+   */
+  Index m_usedSize;
+  size_t m_usedBlockCount;
+
   /**
    * Unlinks a Block from m_freeBlockSizeBins. Must be called before modifying
    * Block::size.
@@ -126,6 +168,11 @@ public:
   void free(Block* block);
   size_t capacity() const;
   void expand(Index newCapacity);
+  /**
+   * Reduces the capacity by removing free space from the end of the managed range.
+   * `newCapacity` must not be less than usedEnd() and must be greater than 0.
+   */
+  void shrink(Index newCapacity);
   /**
    * @return whether there are any allocations. i.e. returns false iff the whole range
    * managed by the allocation tracker is free. Returns false if `capacity() == 0`.
@@ -133,6 +180,45 @@ public:
    */
   bool hasAllocations() const;
 
+  /**
+   * Returns the end of the rightmost used block, or 0 if there are no allocations. The
+   * range past this position is free.
+   */
+  Index usedEnd() const;
+
+  /**
+   * Returns the size of the free space before usedEnd(), i.e. the space that compact()
+   * can reclaim. Constant time.
+   */
+  Index wastedSize() const;
+
+  /**
+   * Moves used blocks towards the start of the managed range, one block at a time,
+   * merging the free space they leave behind. Compaction stops as soon as the combined
+   * size of the moved blocks reaches `maxMovedSize`, so that it can be spread over
+   * several calls. Block objects keep their identity; only their `pos` changes. Each
+   * block is moved at most once per call.
+   *
+   * The caller is responsible for moving the corresponding data. The moves must be
+   * applied in the order in which they are returned, since a block may be moved into the
+   * range that an earlier block was moved out of.
+   *
+   * @return the moves that were performed, or an empty vector if the used blocks are
+   * already contiguous
+   */
+  std::vector<Move> compact(Index maxMovedSize);
+
+  /**
+   * Returns whether compact() would move any blocks, i.e. whether there is a free block
+   * that is followed by a used block. Constant time.
+   */
+  bool fragmented() const;
+
+  /**
+   * Constant time.
+   */
+  FragmentationStats fragmentationStats() const;
+
   // Testing / debugging
 
   class Range
@@ -0,0 +1,271 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BrushEdgeTable.h"
+
+#include "Ensure.h"
+#include "render/PrimType.h"
+#include "render/RenderStatistics.h"
+#include "render/ShaderManager.h"
+#include "render/Vbo.h"
+#include "render/VboManager.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <functional>
+
+namespace tb::render
+{
+namespace
+{
+
+// the edge endpoints are quantized to 1/1024 units before they are compared
+constexpr auto QuantizationScale = 1024.0;
+
+std::array<int64_t, 3> quantize(const vm::vec3f& position)
+{
+  return {
+    std::llround(double(position.x()) * QuantizationScale),
+    std::llround(double(position.y()) * QuantizationScale),
+    std::llround(double(position.z()) * QuantizationScale),
+  };
+}
+
+} // namespace
+
+size_t BrushEdgeTable::KeyHash::operator()(const Key& key) const
+{
+  auto result = size_t(0);
+  for (const auto value : key)
+  {
+    result ^= std::hash<int64_t>{}(value) + 0x9e3779b9 + (result << 6) + (result >> 2);
+  }
+  return result;
+}
+
+BrushEdgeTable::BrushEdgeTable() = default;
+
+BrushEdgeTable::~BrushEdgeTable()
+{
+  if (m_vbo)
+  {
+    m_vboManager->destroyVbo(m_vbo);
+  }
+}
+
+void BrushEdgeTable::addBrush(
+  const mdl::BrushNode* brushNode, const std::vector<vm::vec3f>& positions)
+{
+  assert(positions.size() % 2 == 0);
+
+  auto [it, inserted] = m_brushEdges.try_emplace(brushNode);
+  ensure(inserted, "brush was not added before");
+
+  auto& keys = it->second;
+  keys.reserve(positions.size() / 2);
+  for (size_t i = 0; i + 1 < positions.size(); i += 2)
+  {
+    addEdge(positions[i], positions[i + 1], keys);
+  }
+}
+
+void BrushEdgeTable::removeBrush(const mdl::BrushNode* brushNode)
+{
+  if (const auto it = m_brushEdges.find(brushNode); it != m_brushEdges.end())
+  {
+    for (const auto& key : it->second)
+    {
+      removeEdge(key);
+    }
+    m_brushEdges.erase(it);
+  }
+}
+
+void BrushEdgeTable::clear()
+{
+  m_entries.clear();
+  m_brushEdges.clear();
+  m_vertices.clear();
+  m_slotKeys.clear();
+  m_dirtySlots.clear();
+  m_referenceCount = 0;
+}
+
+size_t BrushEdgeTable::edgeCount() const
+{
+  return m_slotKeys.size();
+}
+
+size_t BrushEdgeTable::referenceCount() const
+{
+  return m_referenceCount;
+}
+
+const std::vector<BrushEdgeTable::Vertex>& BrushEdgeTable::vertices() const
+{
+  return m_vertices;
+}
+
+std::vector<BrushEdgeTable::SlotRange> BrushEdgeTable::takeDirtySlotRanges()
+{
+  std::sort(m_dirtySlots.begin(), m_dirtySlots.end());
+  m_dirtySlots.erase(
+    std::unique(m_dirtySlots.begin(), m_dirtySlots.end()), m_dirtySlots.end());
+
+  auto result = std::vector<SlotRange>{};
+  const auto slotCount = m_slotKeys.size();
+  for (const auto slot : m_dirtySlots)
+  {
+    if (slot >= slotCount)
+    {
+      break;
+    }
+
+    if (!result.empty() && result.back().first + result.back().count == slot)
+    {
+      ++result.back().count;
+    }
+    else
+    {
+      result.push_back(SlotRange{slot, 1});
+    }
+  }
+
+  m_dirtySlots.clear();
+  return result;
+}
+
+bool BrushEdgeTable::prepared() const
+{
+  return m_vertices.empty()
+         || (m_vbo && m_dirtySlots.empty()
+             && m_vbo->capacity() >= m_vertices.size() * sizeof(Vertex));
+}
+
+void BrushEdgeTable::prepare(VboManager& vboManager)
+{
+  if (m_vertices.empty())
+  {
+    m_dirtySlots.clear();
+    return;
+  }
+
+  if (!m_vbo || m_vbo->capacity() < m_vertices.size() * sizeof(Vertex))
+  {
+    if (m_vbo)
+    {
+      m_vboManager->destroyVbo(m_vbo);
+    }
+
+    m_vboManager = &vboManager;
+    m_vbo = m_vboManager->allocateVbo(
+      VboType::ArrayBuffer,
+      m_vertices.capacity() * sizeof(Vertex),
+      VboUsage::DynamicDraw);
+    m_vbo->writeElements(0, m_vertices);
+    m_dirtySlots.clear();
+    return;
+  }
+
+  for (const auto& range : takeDirtySlotRanges())
+  {
+    m_vbo->writeArray(
+      2 * range.first * sizeof(Vertex),
+      m_vertices.data() + 2 * range.first,
+      2 * range.count);
+  }
+}
+
+void BrushEdgeTable::render()
+{
+  assert(prepared());
+  if (m_vertices.empty())
+  {
+    return;
+  }
+
+  m_vbo->bind();
+  Vertex::Type::setup(m_vboManager->shaderManager().currentProgram(), m_vbo->offset());
+
+  const auto count = m_vertices.size();
+  glAssert(glDrawArrays(toGL(PrimType::Lines), 0, GLsizei(count)));
+  countDrawCall(count, 0);
+
+  Vertex::Type::cleanup(m_vboManager->shaderManager().currentProgram());
+  m_vbo->unbind();
+}
+
+void BrushEdgeTable::addEdge(
+  const vm::vec3f& start, const vm::vec3f& end, std::vector<Key>& keys)
+{
+  auto quantizedStart = quantize(start);
+  auto quantizedEnd = quantize(end);
+  if (quantizedEnd < quantizedStart)
+  {
+    std::swap(quantizedStart, quantizedEnd);
+  }
+
+  auto key = Key{};
+  std::copy(quantizedStart.begin(), quantizedStart.end(), key.begin());
+  std::copy(quantizedEnd.begin(), quantizedEnd.end(), key.begin() + 3);
+
+  auto [it, inserted] = m_entries.try_emplace(key, Entry{m_slotKeys.size(), 0});
+  if (inserted)
+  {
+    m_vertices.emplace_back(start);
+    m_vertices.emplace_back(end);
+    m_dirtySlots.push_back(m_slotKeys.size());
+    m_slotKeys.push_back(key);
+  }
+
+  ++it->second.referenceCount;
+  ++m_referenceCount;
+  keys.push_back(key);
+}
+
+void BrushEdgeTable::removeEdge(const Key& key)
+{
+  const auto it = m_entries.find(key);
+  assert(it != m_entries.end());
+
+  --m_referenceCount;
+  if (--it->second.referenceCount > 0)
+  {
+    return;
+  }
+
+  // move the last edge into the slot of the removed edge to keep the vertices compact
+  const auto slot = it->second.slot;
+  const auto lastSlot = m_slotKeys.size() - 1;
+  if (slot != lastSlot)
+  {
+    m_vertices[2 * slot] = m_vertices[2 * lastSlot];
+    m_vertices[2 * slot + 1] = m_vertices[2 * lastSlot + 1];
+    m_slotKeys[slot] = m_slotKeys[lastSlot];
+    m_entries.at(m_slotKeys[slot]).slot = slot;
+    m_dirtySlots.push_back(slot);
+  }
+
+  m_vertices.resize(2 * lastSlot);
+  m_slotKeys.pop_back();
+  m_entries.erase(it);
+}
+
+} // namespace tb::render
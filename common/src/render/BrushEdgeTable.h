@@ -0,0 +1,157 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Macros.h"
+#include "render/GLVertexType.h"
+
+#include "vm/vec.h"
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace tb::mdl
+{
+class BrushNode;
+}
+
+namespace tb::render
+{
+class Vbo;
+class VboManager;
+
+/**
+ * A table of the edges of a set of brushes in which identical edges are only stored
+ * once. Adjacent brushes often share edges, particularly on grid aligned geometry, and
+ * rendering from this table draws each shared edge only once.
+ *
+ * Two edges are identical if their endpoints are identical after quantizing them to a
+ * fine grid, regardless of their direction. Each edge is reference counted so that
+ * brushes can be added and removed incrementally.
+ *
+ * Every unique edge occupies a slot of two vertices, and the table keeps its own VBO of
+ * these slots. Only the slots that were filled or refilled since the last upload are
+ * written to the VBO, so adding or removing a brush does not upload the entire table.
+ */
+class BrushEdgeTable
+{
+public:
+  using Vertex = GLVertexTypes::P3::Vertex;
+
+  struct SlotRange
+  {
+    size_t first;
+    size_t count;
+
+    friend bool operator==(const SlotRange& lhs, const SlotRange& rhs) = default;
+  };
+
+private:
+  using Key = std::array<int64_t, 6>;
+
+  struct KeyHash
+  {
+    size_t operator()(const Key& key) const;
+  };
+
+  struct Entry
+  {
+    size_t slot;
+    size_t referenceCount;
+  };
+
+  std::unordered_map<Key, Entry, KeyHash> m_entries;
+  std::unordered_map<const mdl::BrushNode*, std::vector<Key>> m_brushEdges;
+
+  // the vertices of each unique edge, two per slot, and the key of each slot
+  std::vector<Vertex> m_vertices;
+  std::vector<Key> m_slotKeys;
+
+  // the slots whose vertices changed since the last upload
+  std::vector<size_t> m_dirtySlots;
+
+  size_t m_referenceCount = 0;
+
+  VboManager* m_vboManager = nullptr;
+  Vbo* m_vbo = nullptr;
+
+public:
+  BrushEdgeTable();
+  ~BrushEdgeTable();
+
+  /**
+   * Adds the edges of the given brush. Every two consecutive positions form an edge.
+   * Calling this with a brush that was already added is not allowed.
+   */
+  void addBrush(const mdl::BrushNode* brushNode, const std::vector<vm::vec3f>& positions);
+
+  /**
+   * Removes the edges of the given brush. Calling this with an unknown brush is allowed,
+   * but ignored.
+   */
+  void removeBrush(const mdl::BrushNode* brushNode);
+
+  void clear();
+
+  /**
+   * The number of unique edges in this table.
+   */
+  size_t edgeCount() const;
+
+  /**
+   * The number of edges that were added, including duplicates.
+   */
+  size_t referenceCount() const;
+
+  /**
+   * The vertices of the unique edges, suitable for rendering as lines.
+   */
+  const std::vector<Vertex>& vertices() const;
+
+  /**
+   * Returns the slots that changed since the last call as sorted runs of consecutive
+   * slots, and marks all slots as clean. Slots that were filled and then removed again
+   * are omitted. Called by prepare() to determine what to upload.
+   */
+  std::vector<SlotRange> takeDirtySlotRanges();
+
+  bool prepared() const;
+
+  /**
+   * Uploads the slots that changed since the last call. If the VBO is too small, it is
+   * reallocated with the capacity of the vertex vector and all vertices are uploaded.
+   */
+  void prepare(VboManager& vboManager);
+
+  /**
+   * Renders the unique edges as lines. Must be prepared.
+   */
+  void render();
+
+private:
+  void addEdge(const vm::vec3f& start, const vm::vec3f& end, std::vector<Key>& keys);
+  void removeEdge(const Key& key);
+
+  deleteCopyAndMove(BrushEdgeTable);
+};
+
+} // namespace tb::render
@@ -29,10 +29,17 @@
 #include "mdl/TagAttribute.h"
 #include "render/BrushRendererArrays.h"
 #include "render/BrushRendererBrushCache.h"
+#include "render/FrustumCulling.h"
 #include "render/RenderContext.h"
+#include "render/RenderStatistics.h"
+#include "render/VertexPacking.h"
 
+#include "kdl/task_manager.h"
+
+#include <algorithm>
 #include <cassert>
 #include <cstring>
+#include <functional>
 #include <vector>
 
 namespace tb::render
@@ -230,10 +237,11 @@ bool BrushRenderer::valid() const
 void BrushRenderer::clear()
 {
   m_brushInfo.clear();
+  m_brushesByVertexKey.clear();
   m_allBrushes.clear();
   m_invalidBrushes.clear();
 
-  m_vertexArray = std::make_shared<BrushVertexArray>();
+  m_vertexArray = std::make_shared<BrushVertexArray>(m_vertexLayout);
   m_edgeIndices = std::make_shared<BrushIndexArray>();
   m_transparentFaces = std::make_shared<MaterialToBrushIndicesMap>();
   m_opaqueFaces = std::make_shared<MaterialToBrushIndicesMap>();
@@ -242,6 +250,13 @@ void BrushRenderer::clear()
   m_transparentFaceRenderer =
     FaceRenderer{m_vertexArray, m_transparentFaces, m_faceColor};
   m_edgeRenderer = IndexedEdgeRenderer{m_vertexArray, m_edgeIndices};
+  m_visibleRanges = std::nullopt;
+  m_compactionPending = false;
+
+  if (m_edgeTable)
+  {
+    m_edgeTable->clear();
+  }
 }
 
 void BrushRenderer::setFaceColor(const Color& faceColor)
@@ -302,6 +317,45 @@ void BrushRenderer::setTransparencyAlpha(const float transparencyAlpha)
   }
 }
 
+void BrushRenderer::setTaskManager(kdl::task_manager& taskManager)
+{
+  m_taskManager = &taskManager;
+}
+
+void BrushRenderer::setVertexLayout(const BrushVertexLayout vertexLayout)
+{
+  if (vertexLayout != m_vertexLayout)
+  {
+    invalidate();
+    m_vertexLayout = vertexLayout;
+
+    m_vertexArray = std::make_shared<BrushVertexArray>(m_vertexLayout);
+    m_edgeIndices = std::make_shared<BrushIndexArray>();
+
+    m_opaqueFaceRenderer = FaceRenderer{m_vertexArray, m_opaqueFaces, m_faceColor};
+    m_transparentFaceRenderer =
+      FaceRenderer{m_vertexArray, m_transparentFaces, m_faceColor};
+    m_edgeRenderer = IndexedEdgeRenderer{m_vertexArray, m_edgeIndices};
+    m_visibleRanges = std::nullopt;
+    m_compactionPending = false;
+  }
+}
+
+void BrushRenderer::setDeduplicateEdges(const bool deduplicateEdges)
+{
+  if (deduplicateEdges != (m_edgeTable != nullptr))
+  {
+    invalidate();
+    m_edgeTable = deduplicateEdges ? std::make_shared<BrushEdgeTable>() : nullptr;
+    m_edgeTableRenderer = EdgeTableRenderer{m_edgeTable};
+  }
+}
+
+const BrushEdgeTable* BrushRenderer::edgeTable() const
+{
+  return m_edgeTable.get();
+}
+
 void BrushRenderer::setShowHiddenBrushes(const bool showHiddenBrushes)
 {
   if (showHiddenBrushes != m_showHiddenBrushes)
@@ -317,6 +371,11 @@ void BrushRenderer::render(RenderContext& renderContext, RenderBatch& renderBatc
   renderTransparent(renderContext, renderBatch);
 }
 
+/**
+ * The maximum number of elements that each VBO moves per frame while compacting.
+ */
+static constexpr auto CompactionElementsPerFrame = size_t(1) << 16;
+
 void BrushRenderer::renderOpaque(RenderContext& renderContext, RenderBatch& renderBatch)
 {
   if (!m_allBrushes.empty())
@@ -325,13 +384,18 @@ void BrushRenderer::renderOpaque(RenderContext& renderContext, RenderBatch& rend
     {
       validate();
     }
+    if (m_compactionPending)
+    {
+      m_compactionPending = compact(CompactionElementsPerFrame);
+    }
+    updateVisibleRanges(renderContext);
     if (renderContext.showFaces())
     {
       renderOpaqueFaces(renderBatch);
     }
     if (renderContext.showEdges() || m_showEdges)
     {
-      renderEdges(renderBatch);
+      renderEdges(renderContext, renderBatch);
     }
   }
 }
@@ -345,6 +409,7 @@ void BrushRenderer::renderTransparent(
     {
       validate();
     }
+    updateVisibleRanges(renderContext);
     if (renderContext.showFaces())
     {
       renderTransparentFaces(renderBatch);
@@ -352,6 +417,132 @@ void BrushRenderer::renderTransparent(
   }
 }
 
+static void addIndexRange(
+  std::vector<IndexRange>& ranges, const AllocationTracker::Block& block)
+{
+  ranges.push_back(IndexRange{block.pos, block.size});
+}
+
+/**
+ * Sorts the given ranges and merges ranges that are separated by small gaps. Rendering
+ * the indices in such a gap is cheaper than issuing another draw call. The indices in a
+ * gap are either zeroed or belong to culled brushes, so rendering them is harmless.
+ */
+static void mergeIndexRanges(std::vector<IndexRange>& ranges)
+{
+  constexpr auto MaxGap = size_t(64);
+
+  std::sort(ranges.begin(), ranges.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.offset < rhs.offset;
+  });
+
+  auto merged = std::vector<IndexRange>{};
+  merged.reserve(ranges.size());
+  for (const auto& range : ranges)
+  {
+    if (!merged.empty())
+    {
+      auto& last = merged.back();
+      if (range.offset <= last.offset + last.count + MaxGap)
+      {
+        last.count = range.offset + range.count - last.offset;
+        continue;
+      }
+    }
+    merged.push_back(range);
+  }
+  ranges = std::move(merged);
+}
+
+void BrushRenderer::updateVisibleRanges(const RenderContext& renderContext)
+{
+  if (const auto* visibleSet = renderContext.visibleSet())
+  {
+    if (!m_visibleRanges || m_visibleRanges->generation != visibleSet->generation())
+    {
+      m_visibleRanges = computeVisibleRanges(*visibleSet);
+    }
+    m_opaqueFaceRenderer.setVisibleRanges(m_visibleRanges->opaqueFaces);
+    m_transparentFaceRenderer.setVisibleRanges(m_visibleRanges->transparentFaces);
+    m_edgeRenderer.setVisibleRanges(m_visibleRanges->edges);
+  }
+  else
+  {
+    m_opaqueFaceRenderer.setVisibleRanges(nullptr);
+    m_transparentFaceRenderer.setVisibleRanges(nullptr);
+    m_edgeRenderer.setVisibleRanges(nullptr);
+  }
+}
+
+BrushRenderer::VisibleRanges BrushRenderer::computeVisibleRanges(
+  const VisibleSet& visibleSet) const
+{
+  auto opaqueFaces = std::make_shared<FaceRenderer::MaterialToIndexRangesMap>();
+  auto transparentFaces = std::make_shared<FaceRenderer::MaterialToIndexRangesMap>();
+  auto edges = std::make_shared<std::vector<IndexRange>>();
+  auto visibleCount = size_t(0);
+
+  const auto addBrush = [&](const BrushInfo& info) {
+    if (info.edgeIndicesKey)
+    {
+      addIndexRange(*edges, *info.edgeIndicesKey);
+    }
+    for (const auto& [material, key] : info.opaqueFaceIndicesKeys)
+    {
+      addIndexRange((*opaqueFaces)[material], *key);
+    }
+    for (const auto& [material, key] : info.transparentFaceIndicesKeys)
+    {
+      addIndexRange((*transparentFaces)[material], *key);
+    }
+    ++visibleCount;
+  };
+
+  // iterate over the smaller of the two collections
+  if (visibleSet.brushes().size() < m_brushInfo.size())
+  {
+    for (const auto* brushNode : visibleSet.brushes())
+    {
+      if (const auto it = m_brushInfo.find(brushNode); it != m_brushInfo.end())
+      {
+        addBrush(it->second);
+      }
+    }
+  }
+  else
+  {
+    for (const auto& [brushNode, info] : m_brushInfo)
+    {
+      if (visibleSet.contains(brushNode))
+      {
+        addBrush(info);
+      }
+    }
+  }
+
+  if (visibleCount == m_brushInfo.size())
+  {
+    // nothing was culled, so render the index arrays in one go
+    return VisibleRanges{visibleSet.generation(), nullptr, nullptr, nullptr};
+  }
+
+  mergeIndexRanges(*edges);
+  for (auto& [material, ranges] : *opaqueFaces)
+  {
+    mergeIndexRanges(ranges);
+  }
+  for (auto& [material, ranges] : *transparentFaces)
+  {
+    mergeIndexRanges(ranges);
+  }
+
+  return VisibleRanges{
+    visibleSet.generation(),
+    std::move(opaqueFaces),
+    std::move(transparentFaces),
+    std::move(edges)};
+}
+
 void BrushRenderer::renderOpaqueFaces(RenderBatch& renderBatch)
 {
   m_opaqueFaceRenderer.setGrayscale(m_grayscale);
@@ -369,30 +560,184 @@ void BrushRenderer::renderTransparentFaces(RenderBatch& renderBatch)
   m_transparentFaceRenderer.render(renderBatch);
 }
 
-void BrushRenderer::renderEdges(RenderBatch& renderBatch)
+void BrushRenderer::renderEdges(
+  const RenderContext& renderContext, RenderBatch& renderBatch)
 {
+  // the edge table cannot be culled against a visible set
+  auto& edgeRenderer = m_edgeTable && !renderContext.visibleSet()
+                         ? static_cast<EdgeRenderer&>(m_edgeTableRenderer)
+                         : m_edgeRenderer;
+
   if (m_showOccludedEdges)
   {
-    m_edgeRenderer.renderOnTop(renderBatch, m_occludedEdgeColor);
+    edgeRenderer.renderOnTop(renderBatch, m_occludedEdgeColor);
   }
-  m_edgeRenderer.render(renderBatch, m_edgeColor);
+  edgeRenderer.render(renderBatch, m_edgeColor);
 }
 
+struct BrushRenderer::IndexSegment
+{
+  const mdl::Material* material;
+  size_t offset;
+  size_t count;
+};
+
+struct BrushRenderer::BrushRenderData
+{
+  const mdl::BrushNode* brushNode;
+  Filter::EdgeRenderPolicy edgePolicy;
+
+  /**
+   * The edge indices followed by the face indices, relative to the brush's first vertex.
+   */
+  std::vector<GLuint> indices = {};
+  size_t edgeIndexCount = 0;
+  std::vector<IndexSegment> opaqueFaceSegments = {};
+  std::vector<IndexSegment> transparentFaceSegments = {};
+
+  /**
+   * The brush's vertices, only set if the VBO uses the packed vertex layout.
+   */
+  std::vector<BrushVertexArray::PackedVertex> packedVertices = {};
+};
+
 void BrushRenderer::validate()
 {
   assert(!valid());
 
-  for (auto* brushNode : m_invalidBrushes)
+  const auto timer = ScopedRenderTimer{RenderCategory::Brushes, RenderPhase::Validate};
+
+  // Evaluate the filter once per brush. This must happen on this thread because the
+  // filters may access the preferences.
+  const auto wrapper = FilterWrapper{*m_filter, m_showHiddenBrushes};
+
+  auto renderData = std::vector<BrushRenderData>{};
+  renderData.reserve(m_invalidBrushes.size());
+  for (const auto* brushNode : m_invalidBrushes)
   {
-    validateBrush(*brushNode);
+    assert(m_allBrushes.find(brushNode) != std::end(m_allBrushes));
+    assert(m_brushInfo.find(brushNode) == std::end(m_brushInfo));
+
+    const auto [facePolicy, edgePolicy] = wrapper.markFaces(*brushNode);
+    if (
+      facePolicy != Filter::FaceRenderPolicy::RenderNone
+      || edgePolicy != Filter::EdgeRenderPolicy::RenderNone)
+    {
+      renderData.push_back(BrushRenderData{brushNode, edgePolicy});
+    }
   }
   m_invalidBrushes.clear();
   assert(valid());
 
+  // Build the vertices and indices of each brush, possibly in parallel, and then copy
+  // them into the VBOs.
+  buildRenderData(renderData);
+  for (const auto& data : renderData)
+  {
+    uploadRenderData(data);
+  }
+
   m_opaqueFaceRenderer = FaceRenderer{m_vertexArray, m_opaqueFaces, m_faceColor};
   m_transparentFaceRenderer =
     FaceRenderer{m_vertexArray, m_transparentFaces, m_faceColor};
   m_edgeRenderer = IndexedEdgeRenderer{m_vertexArray, m_edgeIndices};
+  m_visibleRanges = std::nullopt;
+}
+
+bool BrushRenderer::compact(const size_t maxMovedSize)
+{
+  auto moved = false;
+
+  const auto vertexMoves = m_vertexArray->compact(maxMovedSize);
+  if (!vertexMoves.empty())
+  {
+    // the indices refer to vertices by their absolute position in the vertex VBO, so they
+    // must follow the moved vertices
+    for (const auto& move : vertexMoves)
+    {
+      const auto offset = std::ptrdiff_t(move.block->pos) - std::ptrdiff_t(move.oldPos);
+      const auto& info = m_brushInfo.at(m_brushesByVertexKey.at(move.block));
+      if (info.edgeIndicesKey != nullptr)
+      {
+        m_edgeIndices->offsetElementsWithKey(info.edgeIndicesKey, offset);
+      }
+      for (const auto& [material, key] : info.opaqueFaceIndicesKeys)
+      {
+        m_opaqueFaces->at(material)->offsetElementsWithKey(key, offset);
+      }
+      for (const auto& [material, key] : info.transparentFaceIndicesKeys)
+      {
+        m_transparentFaces->at(material)->offsetElementsWithKey(key, offset);
+      }
+    }
+    moved = true;
+  }
+
+  moved = m_edgeIndices->compact(maxMovedSize) || moved;
+  for (auto& [material, indices] : *m_opaqueFaces)
+  {
+    moved = indices->compact(maxMovedSize) || moved;
+  }
+  for (auto& [material, indices] : *m_transparentFaces)
+  {
+    moved = indices->compact(maxMovedSize) || moved;
+  }
+
+  if (moved)
+  {
+    m_visibleRanges = std::nullopt;
+  }
+  else
+  {
+    // the used elements are contiguous now, so the free space at the end can be released
+    m_vertexArray->shrinkToFit();
+    m_edgeIndices->shrinkToFit();
+    for (auto& [material, indices] : *m_opaqueFaces)
+    {
+      indices->shrinkToFit();
+    }
+    for (auto& [material, indices] : *m_transparentFaces)
+    {
+      indices->shrinkToFit();
+    }
+  }
+  return moved;
+}
+
+bool BrushRenderer::compactionPending() const
+{
+  return m_compactionPending;
+}
+
+AllocationTracker::FragmentationStats BrushRenderer::vertexFragmentationStats() const
+{
+  return m_vertexArray->fragmentationStats();
+}
+
+size_t BrushRenderer::vertexSize() const
+{
+  return m_vertexArray->vertexSize();
+}
+
+static void packVertices(
+  const BrushRendererBrushCache& brushCache,
+  std::vector<BrushVertexArray::PackedVertex>& packedVertices)
+{
+  const auto& vertices = brushCache.cachedVertices();
+  packedVertices.resize(vertices.size());
+
+  for (const auto& cachedFace : brushCache.cachedFacesSortedByMaterial())
+  {
+    const auto first = cachedFace.indexOfFirstVertexRelativeToBrush;
+    const auto normal = encodeOctahedralNormal(vertices[first].rest.attr);
+
+    for (size_t i = first; i < first + cachedFace.vertexCount; ++i)
+    {
+      const auto& vertex = vertices[i];
+      packedVertices[i] =
+        BrushVertexArray::PackedVertex{vertex.attr, vertex.rest.rest.attr, normal};
+    }
+  }
 }
 
 static size_t triIndicesCountForPolygon(const size_t vertexCount)
@@ -508,64 +853,65 @@ bool BrushRenderer::shouldDrawFaceInTransparentPass(
   return false;
 }
 
-void BrushRenderer::validateBrush(const mdl::BrushNode& brushNode)
+void BrushRenderer::buildRenderData(std::vector<BrushRenderData>& renderData) const
 {
-  assert(m_allBrushes.find(&brushNode) != std::end(m_allBrushes));
-  assert(m_invalidBrushes.find(&brushNode) != std::end(m_invalidBrushes));
-  assert(m_brushInfo.find(&brushNode) == std::end(m_brushInfo));
+  constexpr auto BrushesPerTask = size_t(256);
 
-  const auto wrapper = FilterWrapper{*m_filter, m_showHiddenBrushes};
-
-  // evaluate filter. only evaluate the filter once per brush.
-  const auto settings = wrapper.markFaces(brushNode);
-  const auto [facePolicy, edgePolicy] = settings;
-
-  if (
-    facePolicy == Filter::FaceRenderPolicy::RenderNone
-    && edgePolicy == Filter::EdgeRenderPolicy::RenderNone)
+  if (!m_taskManager || renderData.size() <= BrushesPerTask)
   {
-    // NOTE: this skips inserting the brush into m_brushInfo
+    for (auto& data : renderData)
+    {
+      buildRenderData(data);
+    }
     return;
   }
 
-  BrushInfo& info = m_brushInfo[&brushNode];
+  auto tasks = std::vector<std::function<bool()>>{};
+  for (size_t first = 0; first < renderData.size(); first += BrushesPerTask)
+  {
+    tasks.emplace_back([&, first]() {
+      const auto last = std::min(first + BrushesPerTask, renderData.size());
+      for (auto i = first; i < last; ++i)
+      {
+        buildRenderData(renderData[i]);
+      }
+      return true;
+    });
+  }
+  m_taskManager->run_tasks_and_wait(tasks);
+}
+
+void BrushRenderer::buildRenderData(BrushRenderData& data) const
+{
+  const auto& brushNode = *data.brushNode;
 
-  // collect vertices
   auto& brushCache = brushNode.brushRendererBrushCache();
   brushCache.validateVertexCache(brushNode);
-  const auto& cachedVertices = brushCache.cachedVertices();
-  ensure(!cachedVertices.empty(), "Brush must have cached vertices");
+  ensure(!brushCache.cachedVertices().empty(), "Brush must have cached vertices");
 
-  assert(m_vertexArray != nullptr);
-  auto [vertBlock, dest] =
-    m_vertexArray->getPointerToInsertVerticesAt(cachedVertices.size());
-  std::memcpy(dest, cachedVertices.data(), cachedVertices.size() * sizeof(*dest));
-  info.vertexHolderKey = vertBlock;
+  if (m_vertexLayout == BrushVertexLayout::Packed)
+  {
+    packVertices(brushCache, data.packedVertices);
+  }
 
-  const auto brushVerticesStartIndex = static_cast<GLuint>(vertBlock->pos);
+  const auto& facesSortedByMaterial = brushCache.cachedFacesSortedByMaterial();
 
-  // insert edge indices into VBO
+  // edge indices
+  data.edgeIndexCount = countMarkedEdgeIndices(brushNode, data.edgePolicy);
+
+  auto indexCount = data.edgeIndexCount;
+  for (const auto& cache : facesSortedByMaterial)
   {
-    const auto edgeIndexCount = countMarkedEdgeIndices(brushNode, edgePolicy);
-    if (edgeIndexCount > 0)
+    if (cache.face->isMarked())
     {
-      auto [key, insertDest] =
-        m_edgeIndices->getPointerToInsertElementsAt(edgeIndexCount);
-      info.edgeIndicesKey = key;
-      getMarkedEdgeIndices(brushNode, edgePolicy, brushVerticesStartIndex, insertDest);
-    }
-    else
-    {
-      // it's possible to have no edges to render
-      // e.g. select all faces of a brush, and the unselected brush renderer
-      // will hit this branch.
-      ensure(info.edgeIndicesKey == nullptr, "BrushInfo not initialized");
+      indexCount += triIndicesCountForPolygon(cache.vertexCount);
     }
   }
+  data.indices.reserve(indexCount);
+  data.indices.resize(data.edgeIndexCount);
+  getMarkedEdgeIndices(brushNode, data.edgePolicy, 0, data.indices.data());
 
-  // insert face indices
-
-  auto& facesSortedByMaterial = brushCache.cachedFacesSortedByMaterial();
+  // face indices
   const auto facesSortedByMaterialCount = facesSortedByMaterial.size();
 
   size_t nextI;
@@ -573,9 +919,6 @@ void BrushRenderer::validateBrush(const mdl::BrushNode& brushNode)
   {
     const auto* material = facesSortedByMaterial[i].material;
 
-    size_t opaqueIndexCount = 0;
-    size_t transparentIndexCount = 0;
-
     // find the i value for the next material
     for (nextI = i + 1; nextI < facesSortedByMaterialCount
                         && facesSortedByMaterial[nextI].material == material;
@@ -584,91 +927,123 @@ void BrushRenderer::validateBrush(const mdl::BrushNode& brushNode)
     }
 
     // process all faces with this material (they'll be consecutive)
-    for (size_t j = i; j < nextI; ++j)
-    {
-      const auto& cache = facesSortedByMaterial[j];
-      if (cache.face->isMarked())
-      {
-        assert(cache.material == material);
-        if (shouldDrawFaceInTransparentPass(brushNode, *cache.face))
-        {
-          transparentIndexCount += triIndicesCountForPolygon(cache.vertexCount);
-        }
-        else
-        {
-          opaqueIndexCount += triIndicesCountForPolygon(cache.vertexCount);
-        }
-      }
-    }
-
-    if (transparentIndexCount > 0)
-    {
-      auto& faceVboMap = *m_transparentFaces;
-      auto& holderPtr = faceVboMap[material];
-      if (holderPtr == nullptr)
-      {
-        // inserts into map!
-        holderPtr = std::make_shared<BrushIndexArray>();
-      }
-
-      auto [key, insertDest] =
-        holderPtr->getPointerToInsertElementsAt(transparentIndexCount);
-      info.transparentFaceIndicesKeys.emplace_back(material, key);
-
-      // process all faces with this material (they'll be consecutive)
-      auto* currentDest = insertDest;
+    const auto addFaceIndices = [&](auto& segments, const bool transparent) {
+      const auto offset = data.indices.size();
       for (size_t j = i; j < nextI; ++j)
       {
         const auto& cache = facesSortedByMaterial[j];
         if (
           cache.face->isMarked()
-          && shouldDrawFaceInTransparentPass(brushNode, *cache.face))
+          && shouldDrawFaceInTransparentPass(brushNode, *cache.face) == transparent)
         {
+          assert(cache.material == material);
+
+          const auto faceOffset = data.indices.size();
+          data.indices.resize(faceOffset + triIndicesCountForPolygon(cache.vertexCount));
           addTriIndicesForPolygon(
-            currentDest,
-            static_cast<GLuint>(
-              brushVerticesStartIndex + cache.indexOfFirstVertexRelativeToBrush),
+            data.indices.data() + faceOffset,
+            static_cast<GLuint>(cache.indexOfFirstVertexRelativeToBrush),
             cache.vertexCount);
-
-          currentDest += triIndicesCountForPolygon(cache.vertexCount);
         }
       }
-      assert(currentDest == (insertDest + transparentIndexCount));
+
+      if (data.indices.size() > offset)
+      {
+        segments.push_back(IndexSegment{material, offset, data.indices.size() - offset});
+      }
+    };
+
+    addFaceIndices(data.transparentFaceSegments, true);
+    addFaceIndices(data.opaqueFaceSegments, false);
+  }
+}
+
+void BrushRenderer::uploadRenderData(const BrushRenderData& data)
+{
+  assert(m_brushInfo.find(data.brushNode) == std::end(m_brushInfo));
+
+  BrushInfo& info = m_brushInfo[data.brushNode];
+
+  // insert vertices into VBO
+  assert(m_vertexArray != nullptr);
+  AllocationTracker::Block* vertBlock = nullptr;
+  if (m_vertexLayout == BrushVertexLayout::Packed)
+  {
+    const auto& packedVertices = data.packedVertices;
+    auto [block, dest] =
+      m_vertexArray->getPointerToInsertPackedVerticesAt(packedVertices.size());
+    std::memcpy(dest, packedVertices.data(), packedVertices.size() * sizeof(*dest));
+    vertBlock = block;
+  }
+  else
+  {
+    const auto& cachedVertices =
+      data.brushNode->brushRendererBrushCache().cachedVertices();
+    auto [block, dest] =
+      m_vertexArray->getPointerToInsertVerticesAt(cachedVertices.size());
+    std::memcpy(dest, cachedVertices.data(), cachedVertices.size() * sizeof(*dest));
+    vertBlock = block;
+  }
+  info.vertexHolderKey = vertBlock;
+  m_brushesByVertexKey.emplace(vertBlock, data.brushNode);
+
+  const auto brushVerticesStartIndex = static_cast<GLuint>(vertBlock->pos);
+  const auto copyIndices = [&](const size_t offset, const size_t count, GLuint* out) {
+    for (size_t i = 0; i < count; ++i)
+    {
+      out[i] = brushVerticesStartIndex + data.indices[offset + i];
     }
+  };
+
+  // insert edge indices into VBO
+  // it's possible to have no edges to render, e.g. select all faces of a brush, and the
+  // unselected brush renderer will skip this.
+  if (data.edgeIndexCount > 0)
+  {
+    auto [key, insertDest] =
+      m_edgeIndices->getPointerToInsertElementsAt(data.edgeIndexCount);
+    info.edgeIndicesKey = key;
+    copyIndices(0, data.edgeIndexCount, insertDest);
 
-    if (opaqueIndexCount > 0)
+    if (m_edgeTable)
     {
-      auto& faceVboMap = *m_opaqueFaces;
-      auto& holderPtr = faceVboMap[material];
+      const auto& cachedVertices =
+        data.brushNode->brushRendererBrushCache().cachedVertices();
+
+      auto positions = std::vector<vm::vec3f>{};
+      positions.reserve(data.edgeIndexCount);
+      for (size_t i = 0; i < data.edgeIndexCount; ++i)
+      {
+        positions.push_back(getVertexComponent<0>(cachedVertices[data.indices[i]]));
+      }
+      m_edgeTable->addBrush(data.brushNode, positions);
+    }
+  }
+
+  // insert face indices into VBO
+  const auto insertFaceIndices =
+    [&](MaterialToBrushIndicesMap& faceVboMap, const IndexSegment& segment) {
+      auto& holderPtr = faceVboMap[segment.material];
       if (holderPtr == nullptr)
       {
         // inserts into map!
         holderPtr = std::make_shared<BrushIndexArray>();
       }
 
-      auto [key, insertDest] = holderPtr->getPointerToInsertElementsAt(opaqueIndexCount);
-      info.opaqueFaceIndicesKeys.emplace_back(material, key);
+      auto [key, insertDest] = holderPtr->getPointerToInsertElementsAt(segment.count);
+      copyIndices(segment.offset, segment.count, insertDest);
+      return key;
+    };
 
-      // process all faces with this material (they'll be consecutive)
-      auto* currentDest = insertDest;
-      for (size_t j = i; j < nextI; ++j)
-      {
-        const auto& cache = facesSortedByMaterial[j];
-        if (
-          cache.face->isMarked()
-          && !shouldDrawFaceInTransparentPass(brushNode, *cache.face))
-        {
-          addTriIndicesForPolygon(
-            currentDest,
-            static_cast<GLuint>(
-              brushVerticesStartIndex + cache.indexOfFirstVertexRelativeToBrush),
-            cache.vertexCount);
-
-          currentDest += triIndicesCountForPolygon(cache.vertexCount);
-        }
-      }
-      assert(currentDest == (insertDest + opaqueIndexCount));
-    }
+  for (const auto& segment : data.transparentFaceSegments)
+  {
+    info.transparentFaceIndicesKeys.emplace_back(
+      segment.material, insertFaceIndices(*m_transparentFaces, segment));
+  }
+  for (const auto& segment : data.opaqueFaceSegments)
+  {
+    info.opaqueFaceIndicesKeys.emplace_back(
+      segment.material, insertFaceIndices(*m_opaqueFaces, segment));
   }
 }
 
@@ -704,24 +1079,34 @@ void BrushRenderer::removeBrushFromVbo(const mdl::BrushNode& brushNode)
 
   if (it == std::end(m_brushInfo))
   {
-    // This means BrushRenderer::validateBrush skipped rendering the brush, so it was
+    // This means BrushRenderer::validate skipped rendering the brush, so it was
     // never uploaded to the VBO's
     return;
   }
 
   const auto& info = it->second;
+  m_visibleRanges = std::nullopt;
 
   // update Vbo's
+  m_brushesByVertexKey.erase(info.vertexHolderKey);
   m_vertexArray->deleteVerticesWithKey(info.vertexHolderKey);
+  m_compactionPending = m_compactionPending || m_vertexArray->needsCompaction();
   if (info.edgeIndicesKey != nullptr)
   {
     m_edgeIndices->zeroElementsWithKey(info.edgeIndicesKey);
+    m_compactionPending = m_compactionPending || m_edgeIndices->needsCompaction();
+
+    if (m_edgeTable)
+    {
+      m_edgeTable->removeBrush(&brushNode);
+    }
   }
 
   for (const auto& [material, opaqueKey] : info.opaqueFaceIndicesKeys)
   {
     auto faceIndexHolder = m_opaqueFaces->at(material);
     faceIndexHolder->zeroElementsWithKey(opaqueKey);
+    m_compactionPending = m_compactionPending || faceIndexHolder->needsCompaction();
 
     if (!faceIndexHolder->hasValidIndices())
     {
@@ -734,6 +1119,7 @@ void BrushRenderer::removeBrushFromVbo(const mdl::BrushNode& brushNode)
   {
     auto faceIndexHolder = m_transparentFaces->at(material);
     faceIndexHolder->zeroElementsWithKey(transparentKey);
+    m_compactionPending = m_compactionPending || faceIndexHolder->needsCompaction();
 
     if (!faceIndexHolder->hasValidIndices())
     {
@@ -23,15 +23,23 @@
 #include "Macros.h"
 #include "mdl/BrushGeometry.h"
 #include "render/AllocationTracker.h"
+#include "render/BrushEdgeTable.h"
+#include "render/BrushVertexLayout.h"
 #include "render/EdgeRenderer.h"
 #include "render/FaceRenderer.h"
 
 #include <memory>
+#include <optional>
 #include <tuple>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
+namespace kdl
+{
+class task_manager;
+}
+
 namespace tb::mdl
 {
 class BrushNode;
@@ -41,6 +49,7 @@ class EditorContext;
 
 namespace tb::render
 {
+class VisibleSet;
 
 class BrushRenderer
 {
@@ -133,6 +142,12 @@ private:
    * remove them from the VBO later.
    */
   std::unordered_map<const mdl::BrushNode*, BrushInfo> m_brushInfo;
+  /**
+   * Maps the vertex allocation of each brush in m_brushInfo back to the brush. Used to
+   * find the indices that must be updated when vertices are moved during compaction.
+   */
+  std::unordered_map<const AllocationTracker::Block*, const mdl::BrushNode*>
+    m_brushesByVertexKey;
 
   /**
    * If a brush is in the VBO, it's always valid.
@@ -151,6 +166,35 @@ private:
   std::shared_ptr<MaterialToBrushIndicesMap> m_transparentFaces;
   std::shared_ptr<MaterialToBrushIndicesMap> m_opaqueFaces;
 
+  struct VisibleRanges
+  {
+    size_t generation;
+    std::shared_ptr<const FaceRenderer::MaterialToIndexRangesMap> opaqueFaces;
+    std::shared_ptr<const FaceRenderer::MaterialToIndexRangesMap> transparentFaces;
+    std::shared_ptr<const std::vector<IndexRange>> edges;
+  };
+  /**
+   * The index ranges of the brushes in the visible set that was last used for
+   * rendering. Reset whenever brushes are added to or removed from the VBO.
+   */
+  std::optional<VisibleRanges> m_visibleRanges;
+
+  /**
+   * Set when removing brushes from the VBOs leaves gaps behind that are worth closing,
+   * see BrushVertexArray::needsCompaction(). While set, each frame moves a limited number
+   * of elements to close these gaps. Once the gaps are closed, the VBOs are shrunk.
+   */
+  bool m_compactionPending = false;
+
+  BrushVertexLayout m_vertexLayout = BrushVertexLayout::Full;
+
+  /**
+   * If set, the edges of all brushes in the VBO are also added to this table, and views
+   * without a visible set render the deduplicated edges from it.
+   */
+  std::shared_ptr<BrushEdgeTable> m_edgeTable;
+  EdgeTableRenderer m_edgeTableRenderer;
+
   FaceRenderer m_opaqueFaceRenderer;
   FaceRenderer m_transparentFaceRenderer;
   IndexedEdgeRenderer m_edgeRenderer;
@@ -168,6 +212,8 @@ private:
 
   bool m_showHiddenBrushes = false;
 
+  kdl::task_manager* m_taskManager = nullptr;
+
 public:
   template <typename FilterT>
   explicit BrushRenderer(FilterT filter)
@@ -270,15 +316,44 @@ public:
    */
   void setShowHiddenBrushes(bool showHiddenBrushes);
 
+  /**
+   * Specifies a task manager to build the vertices and indices of invalid brushes in
+   * parallel. If no task manager is set, brushes are validated on the calling thread.
+   */
+  void setTaskManager(kdl::task_manager& taskManager);
+
+  /**
+   * Specifies the layout of the vertices in the VBO. Changing the layout removes all
+   * brushes from the VBO and adds them again with the new layout when they are validated.
+   */
+  void setVertexLayout(BrushVertexLayout vertexLayout);
+
+  /**
+   * Specifies whether edges shared by several brushes should be rendered only once in
+   * views that do not cull against a visible set, i.e. the 2D views. Changing this
+   * invalidates all brushes.
+   */
+  void setDeduplicateEdges(bool deduplicateEdges);
+
+  /**
+   * Returns the table of deduplicated edges, or null if edges are not deduplicated.
+   *
+   * Only exposed for benchmarking.
+   */
+  const BrushEdgeTable* edgeTable() const;
+
 public: // rendering
   void render(RenderContext& renderContext, RenderBatch& renderBatch);
   void renderOpaque(RenderContext& renderContext, RenderBatch& renderBatch);
   void renderTransparent(RenderContext& renderContext, RenderBatch& renderBatch);
 
 private:
+  void updateVisibleRanges(const RenderContext& renderContext);
+  VisibleRanges computeVisibleRanges(const VisibleSet& visibleSet) const;
+
   void renderOpaqueFaces(RenderBatch& renderBatch);
   void renderTransparentFaces(RenderBatch& renderBatch);
-  void renderEdges(RenderBatch& renderBatch);
+  void renderEdges(const RenderContext& renderContext, RenderBatch& renderBatch);
 
 public:
   /**
@@ -286,10 +361,42 @@ public:
    */
   void validate();
 
+  /**
+   * Moves brushes towards the start of the vertex and index VBOs, closing the gaps left
+   * by removed brushes. Each VBO moves at most `maxMovedSize` elements, so that
+   * compaction can be spread over several frames. The moved ranges are uploaded when the
+   * VBOs are prepared for the next time.
+   *
+   * If no brushes were moved, the VBOs are shrunk if they are mostly empty.
+   *
+   * Only exposed for benchmarking.
+   *
+   * @return true if any brushes were moved
+   */
+  bool compact(size_t maxMovedSize);
+
+  /**
+   * Whether removing brushes left enough gaps in the VBOs to compact them while
+   * rendering. Only exposed for testing.
+   */
+  bool compactionPending() const;
+
+  AllocationTracker::FragmentationStats vertexFragmentationStats() const;
+
+  /**
+   * The size of a single vertex in bytes for the current vertex layout.
+   */
+  size_t vertexSize() const;
+
 private:
   bool shouldDrawFaceInTransparentPass(
     const mdl::BrushNode& brushNode, const mdl::BrushFace& face) const;
-  void validateBrush(const mdl::BrushNode& brushNode);
+
+  struct IndexSegment;
+  struct BrushRenderData;
+  void buildRenderData(std::vector<BrushRenderData>& renderData) const;
+  void buildRenderData(BrushRenderData& data) const;
+  void uploadRenderData(const BrushRenderData& data);
 
 public:
   /**
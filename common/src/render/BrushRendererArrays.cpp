@@ -19,9 +19,12 @@
 
 #include "render/BrushRendererArrays.h"
 
+#include "render/RenderStatistics.h"
+
 #include <algorithm>
 #include <cassert>
 #include <cstring>
+#include <optional>
 #include <stdexcept>
 
 // BrushIndexArray
@@ -50,6 +53,18 @@ void DirtyRangeTracker::expand(const size_t newcap)
   markDirty(oldcap, newcap - oldcap);
 }
 
+void DirtyRangeTracker::shrink(const size_t newcap)
+{
+  if (newcap >= m_capacity)
+  {
+    throw std::invalid_argument{"new capacity must be less"};
+  }
+
+  m_capacity = newcap;
+  m_dirtyPos = 0;
+  m_dirtySize = newcap;
+}
+
 size_t DirtyRangeTracker::capacity() const
 {
   return m_capacity;
@@ -75,6 +90,40 @@ bool DirtyRangeTracker::clean() const
   return m_dirtySize == 0;
 }
 
+namespace
+{
+
+/**
+ * Gaps smaller than this number of elements are not worth compacting unless there are
+ * very many of them.
+ */
+constexpr auto MinWastedSize = size_t(1) << 12;
+constexpr auto MaxFreeBlockCount = size_t(1) << 10;
+
+bool needsCompaction(const AllocationTracker& allocationTracker)
+{
+  const auto wastedSize = allocationTracker.wastedSize();
+  return (wastedSize >= MinWastedSize && 4 * wastedSize >= allocationTracker.usedEnd())
+         || allocationTracker.fragmentationStats().freeBlockCount > MaxFreeBlockCount;
+}
+
+/**
+ * Returns the capacity to shrink the given tracker to, or nullopt if it should not be
+ * shrunk. Arrays grow by doubling, so an array is only shrunk if less than a quarter is
+ * used, and it keeps twice the used size to avoid growing again right away.
+ */
+std::optional<size_t> shrunkCapacity(const AllocationTracker& allocationTracker)
+{
+  const auto usedEnd = allocationTracker.usedEnd();
+  if (usedEnd > 0 && 4 * usedEnd < allocationTracker.capacity())
+  {
+    return 2 * usedEnd;
+  }
+  return std::nullopt;
+}
+
+} // namespace
+
 // IndexHolder
 
 IndexHolder::IndexHolder()
@@ -100,6 +149,7 @@ void IndexHolder::render(const PrimType primType, const size_t offset, size_t co
     reinterpret_cast<GLvoid*>(m_vbo->offset() + sizeof(Index) * offset);
 
   glAssert(glDrawElements(toGL(primType), renderCount, glType<Index>(), renderOffset));
+  countDrawCall(0, count);
 }
 
 std::shared_ptr<IndexHolder> IndexHolder::swap(std::vector<IndexHolder::Index>& elements)
@@ -151,10 +201,65 @@ void BrushIndexArray::zeroElementsWithKey(AllocationTracker::Block* key)
   m_indexHolder.zeroRange(pos, size);
 }
 
+void BrushIndexArray::offsetElementsWithKey(
+  AllocationTracker::Block* key, const std::ptrdiff_t offset)
+{
+  auto* dest = m_indexHolder.getPointerToWriteElementsTo(key->pos, key->size);
+  for (size_t i = 0; i < key->size; ++i)
+  {
+    dest[i] = GLuint(std::ptrdiff_t(dest[i]) + offset);
+  }
+}
+
+bool BrushIndexArray::compact(const size_t maxMovedSize)
+{
+  const auto moves = m_allocationTracker.compact(maxMovedSize);
+  for (const auto& move : moves)
+  {
+    const auto newPos = move.block->pos;
+    const auto size = move.block->size;
+    m_indexHolder.moveElements(move.oldPos, newPos, size);
+
+    // zero the part of the old range that is not covered by the new range
+    const auto zeroPos = std::max(move.oldPos, newPos + size);
+    m_indexHolder.zeroRange(zeroPos, move.oldPos + size - zeroPos);
+  }
+  return !moves.empty();
+}
+
+bool BrushIndexArray::needsCompaction() const
+{
+  return render::needsCompaction(m_allocationTracker);
+}
+
+void BrushIndexArray::shrinkToFit()
+{
+  if (const auto newCapacity = shrunkCapacity(m_allocationTracker))
+  {
+    m_allocationTracker.shrink(*newCapacity);
+    m_indexHolder.shrink(*newCapacity);
+  }
+}
+
+AllocationTracker::FragmentationStats BrushIndexArray::fragmentationStats() const
+{
+  return m_allocationTracker.fragmentationStats();
+}
+
 void BrushIndexArray::render(const PrimType primType) const
 {
   assert(m_indexHolder.prepared());
-  m_indexHolder.render(primType, 0, m_indexHolder.size());
+  m_indexHolder.render(primType, 0, m_allocationTracker.usedEnd());
+}
+
+void BrushIndexArray::render(
+  const PrimType primType, const std::vector<IndexRange>& ranges) const
+{
+  assert(m_indexHolder.prepared());
+  for (const auto& range : ranges)
+  {
+    m_indexHolder.render(primType, range.offset, range.count);
+  }
 }
 
 bool BrushIndexArray::prepared() const
@@ -180,32 +285,74 @@ void BrushIndexArray::cleanupIndices()
 
 // BrushVertexArray
 
-BrushVertexArray::BrushVertexArray() = default;
+namespace
+{
 
-std::pair<AllocationTracker::Block*, BrushVertexArray::Vertex*> BrushVertexArray::
-  getPointerToInsertVerticesAt(const size_t vertexCount)
+template <typename V>
+std::pair<AllocationTracker::Block*, V*> insertVertices(
+  AllocationTracker& allocationTracker,
+  VertexHolder<V>& vertexHolder,
+  const size_t vertexCount)
 {
-  auto block = m_allocationTracker.allocate(vertexCount);
+  auto block = allocationTracker.allocate(vertexCount);
   if (block != nullptr)
   {
-    auto* dest = m_vertexHolder.getPointerToWriteElementsTo(block->pos, vertexCount);
+    auto* dest = vertexHolder.getPointerToWriteElementsTo(block->pos, vertexCount);
     return {block, dest};
   }
 
   // retry
   const auto newSize = std::max(
-    2 * m_allocationTracker.capacity(), m_allocationTracker.capacity() + vertexCount);
-  m_allocationTracker.expand(newSize);
-  m_vertexHolder.resize(newSize);
+    2 * allocationTracker.capacity(), allocationTracker.capacity() + vertexCount);
+  allocationTracker.expand(newSize);
+  vertexHolder.resize(newSize);
 
   // insert again
-  block = m_allocationTracker.allocate(vertexCount);
+  block = allocationTracker.allocate(vertexCount);
   assert(block != nullptr);
 
-  auto* dest = m_vertexHolder.getPointerToWriteElementsTo(block->pos, vertexCount);
+  auto* dest = vertexHolder.getPointerToWriteElementsTo(block->pos, vertexCount);
   return {block, dest};
 }
 
+} // namespace
+
+BrushVertexArray::BrushVertexArray(const BrushVertexLayout layout)
+{
+  if (layout == BrushVertexLayout::Packed)
+  {
+    m_vertexHolder.emplace<VertexHolder<PackedVertex>>();
+  }
+}
+
+BrushVertexLayout BrushVertexArray::layout() const
+{
+  return std::holds_alternative<VertexHolder<PackedVertex>>(m_vertexHolder)
+           ? BrushVertexLayout::Packed
+           : BrushVertexLayout::Full;
+}
+
+size_t BrushVertexArray::vertexSize() const
+{
+  return layout() == BrushVertexLayout::Packed ? sizeof(PackedVertex) : sizeof(Vertex);
+}
+
+std::pair<AllocationTracker::Block*, BrushVertexArray::Vertex*> BrushVertexArray::
+  getPointerToInsertVerticesAt(const size_t vertexCount)
+{
+  return insertVertices(
+    m_allocationTracker, std::get<VertexHolder<Vertex>>(m_vertexHolder), vertexCount);
+}
+
+std::pair<AllocationTracker::Block*, BrushVertexArray::PackedVertex*> BrushVertexArray::
+  getPointerToInsertPackedVerticesAt(const size_t vertexCount)
+{
+  return insertVertices(
+    m_allocationTracker,
+    std::get<VertexHolder<PackedVertex>>(m_vertexHolder),
+    vertexCount);
+}
+
 void BrushVertexArray::deleteVerticesWithKey(AllocationTracker::Block* key)
 {
   m_allocationTracker.free(key);
@@ -216,25 +363,66 @@ void BrushVertexArray::deleteVerticesWithKey(AllocationTracker::Block* key)
   // us to re-use the space later
 }
 
+std::vector<AllocationTracker::Move> BrushVertexArray::compact(
+  const size_t maxMovedSize)
+{
+  auto moves = m_allocationTracker.compact(maxMovedSize);
+  for (const auto& move : moves)
+  {
+    std::visit(
+      [&](auto& vertexHolder) {
+        vertexHolder.moveElements(move.oldPos, move.block->pos, move.block->size);
+      },
+      m_vertexHolder);
+  }
+  return moves;
+}
+
+bool BrushVertexArray::needsCompaction() const
+{
+  return render::needsCompaction(m_allocationTracker);
+}
+
+void BrushVertexArray::shrinkToFit()
+{
+  if (const auto newCapacity = shrunkCapacity(m_allocationTracker))
+  {
+    m_allocationTracker.shrink(*newCapacity);
+    std::visit(
+      [&](auto& vertexHolder) { vertexHolder.shrink(*newCapacity); }, m_vertexHolder);
+  }
+}
+
+AllocationTracker::FragmentationStats BrushVertexArray::fragmentationStats() const
+{
+  return m_allocationTracker.fragmentationStats();
+}
+
 bool BrushVertexArray::setupVertices()
 {
-  return m_vertexHolder.setupVertices();
+  return std::visit(
+    [](auto& vertexHolder) { return vertexHolder.setupVertices(); }, m_vertexHolder);
 }
 
 void BrushVertexArray::cleanupVertices()
 {
-  m_vertexHolder.cleanupVertices();
+  std::visit([](auto& vertexHolder) { vertexHolder.cleanupVertices(); }, m_vertexHolder);
 }
 
 bool BrushVertexArray::prepared() const
 {
-  return m_vertexHolder.prepared();
+  return std::visit(
+    [](const auto& vertexHolder) { return vertexHolder.prepared(); }, m_vertexHolder);
 }
 
 void BrushVertexArray::prepare(VboManager& vboManager)
 {
-  m_vertexHolder.prepare(vboManager);
-  assert(m_vertexHolder.prepared());
+  std::visit(
+    [&](auto& vertexHolder) {
+      vertexHolder.prepare(vboManager);
+      assert(vertexHolder.prepared());
+    },
+    m_vertexHolder);
 }
 
 } // namespace tb::render
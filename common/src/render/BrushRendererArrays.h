@@ -21,6 +21,7 @@
 
 #include "Ensure.h"
 #include "render/AllocationTracker.h"
+#include "render/BrushVertexLayout.h"
 #include "render/GL.h"
 #include "render/GLVertexType.h"
 #include "render/PrimType.h"
@@ -28,8 +29,11 @@
 #include "render/Vbo.h"
 #include "render/VboManager.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <memory>
+#include <variant>
 #include <vector>
 
 namespace tb::render
@@ -50,6 +54,11 @@ struct DirtyRangeTracker
    * Expanding marks the new range as dirty.
    */
   void expand(size_t newcap);
+  /**
+   * Shrinking marks the entire remaining range as dirty, since the VBO must be
+   * reallocated.
+   */
+  void shrink(size_t newcap);
   size_t capacity() const;
   void markDirty(size_t pos, size_t size);
   bool clean() const;
@@ -155,6 +164,13 @@ public:
     m_dirtyRange.expand(newSize);
   }
 
+  void shrink(const size_t newSize)
+  {
+    m_snapshot.resize(newSize);
+    m_snapshot.shrink_to_fit();
+    m_dirtyRange.shrink(newSize);
+  }
+
   T* getPointerToWriteElementsTo(
     const size_t offsetWithinBlock, const size_t elementCount)
   {
@@ -166,6 +182,26 @@ public:
     return m_snapshot.data() + offsetWithinBlock;
   }
 
+  /**
+   * Moves `elementCount` elements from `fromOffset` to `toOffset` and marks the affected
+   * range as dirty. The source and destination ranges may overlap.
+   */
+  void moveElements(
+    const size_t fromOffset, const size_t toOffset, const size_t elementCount)
+  {
+    assert(fromOffset + elementCount <= m_snapshot.size());
+    assert(toOffset + elementCount <= m_snapshot.size());
+
+    std::memmove(
+      m_snapshot.data() + toOffset,
+      m_snapshot.data() + fromOffset,
+      elementCount * sizeof(T));
+
+    const auto pos = std::min(fromOffset, toOffset);
+    const auto end = std::max(fromOffset, toOffset) + elementCount;
+    m_dirtyRange.markDirty(pos, end - pos);
+  }
+
   bool prepared() const
   {
     // NOTE: this returns true if the capacity is 0
@@ -241,6 +277,15 @@ public:
   static std::shared_ptr<IndexHolder> swap(std::vector<Index>& elements);
 };
 
+/**
+ * A contiguous range of indices in a BrushIndexArray.
+ */
+struct IndexRange
+{
+  size_t offset;
+  size_t count;
+};
+
 /**
  * VboBlock handle that supports dynamically allocating ranges of indices, grows as
  * needed, and also supports freeing allocations and zeroing the corresponding indicies so
@@ -278,7 +323,43 @@ public:
    */
   void zeroElementsWithKey(AllocationTracker::Block* key);
 
+  /**
+   * Adds the given offset to the indices of the given allocation. Used to follow the
+   * vertices they refer to when those are moved by BrushVertexArray::compact().
+   */
+  void offsetElementsWithKey(AllocationTracker::Block* key, std::ptrdiff_t offset);
+
+  /**
+   * Moves allocations towards the start of the array until at most `maxMovedSize` indices
+   * were moved, and zeroes the indices left behind. Allocation keys remain valid.
+   *
+   * @return true if any allocations were moved
+   */
+  bool compact(size_t maxMovedSize);
+
+  /**
+   * See BrushVertexArray::needsCompaction().
+   */
+  bool needsCompaction() const;
+
+  /**
+   * See BrushVertexArray::shrinkToFit().
+   */
+  void shrinkToFit();
+
+  AllocationTracker::FragmentationStats fragmentationStats() const;
+
+  /**
+   * Renders all indices up to the end of the last allocation.
+   */
   void render(PrimType primType) const;
+
+  /**
+   * Renders only the given ranges of indices. The ranges must be sorted by offset and
+   * must not overlap.
+   */
+  void render(PrimType primType, const std::vector<IndexRange>& ranges) const;
+
   bool prepared() const;
   void prepare(VboManager& vboManager);
 
@@ -346,14 +427,26 @@ public:
  */
 class BrushVertexArray
 {
-private:
-  using Vertex = render::GLVertexTypes::P3NT2::Vertex;
+public:
+  using Vertex = GLVertexTypes::P3NT2::Vertex;
+  using PackedVertex = GLVertexType<
+    GLVertexAttributeTypes::P3,
+    GLVertexAttributeTypes::UV02,
+    GLVertexAttributeTypes::UV12S>::Vertex;
 
-  VertexHolder<Vertex> m_vertexHolder;
+private:
+  std::variant<VertexHolder<Vertex>, VertexHolder<PackedVertex>> m_vertexHolder;
   AllocationTracker m_allocationTracker;
 
 public:
-  BrushVertexArray();
+  explicit BrushVertexArray(BrushVertexLayout layout = BrushVertexLayout::Full);
+
+  BrushVertexLayout layout() const;
+
+  /**
+   * The size of a single vertex in bytes.
+   */
+  size_t vertexSize() const;
 
   /**
    * Call this to request writing the given number of vertices.
@@ -367,8 +460,39 @@ public:
   std::pair<AllocationTracker::Block*, Vertex*> getPointerToInsertVerticesAt(
     size_t vertexCount);
 
+  /**
+   * Same as getPointerToInsertVerticesAt, but for an array with the packed layout.
+   */
+  std::pair<AllocationTracker::Block*, PackedVertex*> getPointerToInsertPackedVerticesAt(
+    size_t vertexCount);
+
   void deleteVerticesWithKey(AllocationTracker::Block* key);
 
+  /**
+   * Moves allocations towards the start of the array until at most `maxMovedSize`
+   * vertices were moved. Allocation keys remain valid, but the indices referring to the
+   * moved vertices must be offset by the caller.
+   *
+   * @return the moves that were performed
+   */
+  std::vector<AllocationTracker::Move> compact(size_t maxMovedSize);
+
+  /**
+   * Returns whether the gaps left by deleted allocations waste enough space, or are
+   * numerous enough, to be worth compacting. A gap that is small compared to the array
+   * is ignored, since it is likely to be reused by the next allocation.
+   */
+  bool needsCompaction() const;
+
+  /**
+   * Releases most of the free space at the end of the array if it makes up the larger
+   * part of the array, e.g. after compacting the array once many allocations were
+   * deleted.
+   */
+  void shrinkToFit();
+
+  AllocationTracker::FragmentationStats fragmentationStats() const;
+
   // setting up GL attributes
   bool setupVertices();
   void cleanupVertices();
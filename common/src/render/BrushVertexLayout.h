@@ -0,0 +1,46 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+namespace tb::render
+{
+
+/**
+ * The layout of the vertices stored in a BrushVertexArray.
+ */
+enum class BrushVertexLayout
+{
+  /**
+   * Float positions, normals and UV coordinates (32 bytes per vertex).
+   */
+  Full,
+  /**
+   * Float positions and UV coordinates and an octahedral encoded normal that is passed as
+   * the second UV coordinate (24 bytes per vertex). Must be rendered with a shader that
+   * decodes the normal.
+   *
+   * The UV coordinates are not stored as half floats: these require GL 3.0 or
+   * ARB_half_float_vertex, and their precision degrades to less than a texel on faces
+   * that span more than a few repetitions of a material.
+   */
+  Packed,
+};
+
+} // namespace tb::render
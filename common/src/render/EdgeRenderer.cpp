@@ -22,6 +22,7 @@
 #include "PreferenceManager.h"
 #include "Preferences.h"
 #include "render/ActiveShader.h"
+#include "render/BrushEdgeTable.h"
 #include "render/BrushRendererArrays.h"
 #include "render/PrimType.h"
 #include "render/RenderBatch.h"
@@ -226,10 +227,12 @@ void DirectEdgeRenderer::doRender(
 IndexedEdgeRenderer::Render::Render(
   const EdgeRenderer::Params& params,
   std::shared_ptr<BrushVertexArray> vertexArray,
-  std::shared_ptr<BrushIndexArray> indexArray)
+  std::shared_ptr<BrushIndexArray> indexArray,
+  std::shared_ptr<const std::vector<IndexRange>> visibleRanges)
   : RenderBase{params}
   , m_vertexArray{std::move(vertexArray)}
   , m_indexArray{std::move(indexArray)}
+  , m_visibleRanges{std::move(visibleRanges)}
 {
 }
 
@@ -251,7 +254,14 @@ void IndexedEdgeRenderer::Render::doRenderVertices(RenderContext&)
 {
   m_vertexArray->setupVertices();
   m_indexArray->setupIndices();
-  m_indexArray->render(PrimType::Lines);
+  if (m_visibleRanges)
+  {
+    m_indexArray->render(PrimType::Lines, *m_visibleRanges);
+  }
+  else
+  {
+    m_indexArray->render(PrimType::Lines);
+  }
   m_vertexArray->cleanupVertices();
   m_indexArray->cleanupIndices();
 }
@@ -268,10 +278,59 @@ IndexedEdgeRenderer::IndexedEdgeRenderer(
 {
 }
 
+void IndexedEdgeRenderer::setVisibleRanges(
+  std::shared_ptr<const std::vector<IndexRange>> visibleRanges)
+{
+  m_visibleRanges = std::move(visibleRanges);
+}
+
 void IndexedEdgeRenderer::doRender(
   RenderBatch& renderBatch, const EdgeRenderer::Params& params)
 {
-  renderBatch.addOneShot(new Render{params, m_vertexArray, m_indexArray});
+  renderBatch.addOneShot(
+    new Render{params, m_vertexArray, m_indexArray, m_visibleRanges});
+}
+
+// EdgeTableRenderer::Render
+
+EdgeTableRenderer::Render::Render(
+  const EdgeRenderer::Params& params, std::shared_ptr<BrushEdgeTable> edgeTable)
+  : RenderBase{params}
+  , m_edgeTable{std::move(edgeTable)}
+{
+}
+
+void EdgeTableRenderer::Render::doPrepareVertices(VboManager& vboManager)
+{
+  m_edgeTable->prepare(vboManager);
+}
+
+void EdgeTableRenderer::Render::doRender(RenderContext& renderContext)
+{
+  if (m_edgeTable->edgeCount() > 0)
+  {
+    renderEdges(renderContext);
+  }
+}
+
+void EdgeTableRenderer::Render::doRenderVertices(RenderContext&)
+{
+  m_edgeTable->render();
+}
+
+// EdgeTableRenderer
+
+EdgeTableRenderer::EdgeTableRenderer() = default;
+
+EdgeTableRenderer::EdgeTableRenderer(std::shared_ptr<BrushEdgeTable> edgeTable)
+  : m_edgeTable{std::move(edgeTable)}
+{
+}
+
+void EdgeTableRenderer::doRender(
+  RenderBatch& renderBatch, const EdgeRenderer::Params& params)
+{
+  renderBatch.addOneShot(new Render{params, m_edgeTable});
 }
 
 } // namespace tb::render
@@ -25,12 +25,15 @@
 #include "render/VertexArray.h"
 
 #include <memory>
+#include <vector>
 
 namespace tb::render
 {
+class BrushEdgeTable;
 class BrushIndexArray;
 class BrushVertexArray;
 class RenderBatch;
+struct IndexRange;
 
 class EdgeRenderer
 {
@@ -147,12 +150,14 @@ private:
   private:
     std::shared_ptr<BrushVertexArray> m_vertexArray;
     std::shared_ptr<BrushIndexArray> m_indexArray;
+    std::shared_ptr<const std::vector<IndexRange>> m_visibleRanges;
 
   public:
     Render(
       const Params& params,
       std::shared_ptr<BrushVertexArray> vertexArray,
-      std::shared_ptr<BrushIndexArray> indexArray);
+      std::shared_ptr<BrushIndexArray> indexArray,
+      std::shared_ptr<const std::vector<IndexRange>> visibleRanges);
 
   private:
     void prepareVerticesAndIndices(VboManager& vboManager) override;
@@ -163,6 +168,7 @@ private:
 private:
   std::shared_ptr<BrushVertexArray> m_vertexArray;
   std::shared_ptr<BrushIndexArray> m_indexArray;
+  std::shared_ptr<const std::vector<IndexRange>> m_visibleRanges;
 
 public:
   IndexedEdgeRenderer();
@@ -170,6 +176,44 @@ public:
     std::shared_ptr<BrushVertexArray> vertexArray,
     std::shared_ptr<BrushIndexArray> indexArray);
 
+  /**
+   * Restricts rendering to the given index ranges. If the given ranges are null, all
+   * indices are rendered.
+   */
+  void setVisibleRanges(std::shared_ptr<const std::vector<IndexRange>> visibleRanges);
+
+private:
+  void doRender(RenderBatch& renderBatch, const EdgeRenderer::Params& params) override;
+};
+
+/**
+ * Renders the unique edges of a BrushEdgeTable. The table is shared with its owner, which
+ * keeps adding and removing edges; only the changed slots are uploaded before rendering.
+ */
+class EdgeTableRenderer : public EdgeRenderer
+{
+private:
+  class Render : public RenderBase, public DirectRenderable
+  {
+  private:
+    std::shared_ptr<BrushEdgeTable> m_edgeTable;
+
+  public:
+    Render(const Params& params, std::shared_ptr<BrushEdgeTable> edgeTable);
+
+  private:
+    void doPrepareVertices(VboManager& vboManager) override;
+    void doRender(RenderContext& renderContext) override;
+    void doRenderVertices(RenderContext& renderContext) override;
+  };
+
+private:
+  std::shared_ptr<BrushEdgeTable> m_edgeTable;
+
+public:
+  EdgeTableRenderer();
+  explicit EdgeTableRenderer(std::shared_ptr<BrushEdgeTable> edgeTable);
+
 private:
   void doRender(RenderBatch& renderBatch, const EdgeRenderer::Params& params) override;
 };
@@ -31,14 +31,18 @@
 #include "mdl/Texture.h"
 #include "mdl/UVCoordSystem.h"
 #include "mdl/WorldNode.h"
+#include "render/RenderStatistics.h"
 #include "ui/MapDocument.h"
 
 #include "kdl/memory_utils.h"
 #include "kdl/overload.h"
+#include "kdl/task_manager.h"
 
 #include "vm/intersection.h"
 
+#include <algorithm>
 #include <cstring>
+#include <functional>
 
 namespace tb::render
 {
@@ -142,8 +146,57 @@ std::vector<Vertex> createDecalBrushFace(
   });
 }
 
+void createDecalGeometry(
+  const mdl::EntityNode* entityNode,
+  const std::vector<const mdl::BrushNode*>& brushes,
+  const mdl::Material& material,
+  std::vector<Vertex>& vertices,
+  std::vector<size_t>& indices)
+{
+  // `bbox` and methods in the veclib library perform inclusive intersection tests - that
+  // is, if two polygons share an edge, plane, or vertex, then they are considered to be
+  // intersecting. We need the opposite behaviour when placing decals: when the entity's
+  // bounding box 'touches' but doesn't actually intersect through a face, we do not want
+  // to place a decal on it. To achieve this logic, we shrink the bounds just a tiny bit
+  // so adjacent faces that don't actually breach the entity's bounding box are excluded.
+  const auto shrunkBounds = entityNode->physicalBounds().expand(-vm::Cd::almost_zero());
+
+  for (const auto& brush : brushes)
+  {
+    for (const auto& face : brush->brush().faces())
+    {
+      // see if this decal can be projected onto this face
+      const auto facePolygon = face.geometry()->vertexPositions();
+      if (vm::intersect_bbox_polygon(
+            shrunkBounds, facePolygon.begin(), facePolygon.end()))
+      {
+        const auto decalPolygon = createDecalBrushFace(entityNode, brush, face, material);
+        if (!decalPolygon.empty())
+        {
+          // add the geometry to be uploaded into the VBO
+          const auto vertexOffset = vertices.size();
+
+          vertices.insert(vertices.end(), decalPolygon.begin(), decalPolygon.end());
+          for (size_t i = 0; i < decalPolygon.size() - 2; ++i)
+          {
+            indices.push_back(vertexOffset);
+            indices.push_back(vertexOffset + i + 1);
+            indices.push_back(vertexOffset + i + 2);
+          }
+        }
+      }
+    }
+  }
+}
+
 } // namespace
 
+struct EntityDecalRenderer::DecalGeometry
+{
+  std::vector<Vertex> vertices;
+  std::vector<size_t> indices;
+};
+
 EntityDecalRenderer::EntityDecalRenderer(std::weak_ptr<ui::MapDocument> document)
   : m_document{std::move(document)}
 {
@@ -152,15 +205,17 @@ EntityDecalRenderer::EntityDecalRenderer(std::weak_ptr<ui::MapDocument> document
 
 void EntityDecalRenderer::invalidate()
 {
-  for (auto& [ent, data] : m_entities)
+  for (auto& [entityNode, data] : m_entities)
   {
-    invalidateDecalData(data);
+    invalidateDecalData(entityNode, data);
   }
 }
 
 void EntityDecalRenderer::clear()
 {
   m_entities.clear();
+  m_entitiesByBrush.clear();
+  m_invalidEntities.clear();
   m_vertexArray = std::make_shared<BrushVertexArray>();
   m_faces = std::make_shared<MaterialToBrushIndicesMap>();
   m_faceRenderer = FaceRenderer{m_vertexArray, m_faces, m_faceColor};
@@ -203,7 +258,7 @@ void EntityDecalRenderer::updateEntity(const mdl::EntityNode* entityNode)
   if (isTracking && spec)
   {
     // entity is being tracked and has a decal specification, invalidate it
-    invalidateDecalData(entity->second);
+    invalidateDecalData(entityNode, entity->second);
   }
   else if (isTracking)
   {
@@ -214,6 +269,7 @@ void EntityDecalRenderer::updateEntity(const mdl::EntityNode* entityNode)
   {
     // entity is not being tracked and has a decal specification, start tracking it
     m_entities.insert({entityNode, EntityDecalData{}});
+    m_invalidEntities.insert(entityNode);
   }
 }
 
@@ -222,60 +278,64 @@ void EntityDecalRenderer::removeEntity(const mdl::EntityNode* entityNode)
   if (const auto it = m_entities.find(entityNode); it != std::end(m_entities))
   {
     // make sure the entity data is cleaned up
-    invalidateDecalData(it->second);
+    invalidateDecalData(entityNode, it->second);
+    untrackBrushes(entityNode, it->second);
     m_entities.erase(it);
+    m_invalidEntities.erase(entityNode);
   }
 }
 
 void EntityDecalRenderer::updateBrush(const mdl::BrushNode* brushNode)
 {
-  // invalidate any entities that intersect this brush or are tracking this brush
-  for (auto& [ent, data] : m_entities)
+  // invalidate the entities that were tracking this brush before it changed
+  if (const auto it = m_entitiesByBrush.find(brushNode); it != m_entitiesByBrush.end())
   {
-    // skip entities that are going to be recomputed anyway
-    if (!data.validated)
+    for (const auto* entityNode : it->second)
     {
-      continue;
+      invalidateDecalData(entityNode, m_entities.at(entityNode));
     }
+  }
 
-    // if the brush is not visible, then it doesn't (currently) intersect
-    const auto& editorContext = kdl::mem_lock(m_document)->editorContext();
-    const auto intersects =
-      editorContext.visible(brushNode) && brushNode->intersects(ent);
-    const auto tracked = std::find(data.brushes.begin(), data.brushes.end(), brushNode)
-                         != data.brushes.end();
+  // if the brush is not visible, then it doesn't (currently) intersect
+  const auto& document = kdl::mem_lock(m_document);
+  const auto* world = document->world();
+  if (!world || !document->editorContext().visible(brushNode))
+  {
+    return;
+  }
 
-    // if this brush is tracked by this entity or intersects, we'll need to
-    // recalculate the geometry
-    if (intersects || tracked)
+  // invalidate the entities that intersect the brush now
+  const auto intersectors =
+    world->nodeTree().find_intersectors(brushNode->physicalBounds());
+  for (const auto* node : intersectors)
+  {
+    if (const auto* entityNode = dynamic_cast<const mdl::EntityNode*>(node))
     {
-      invalidateDecalData(data);
+      if (const auto it = m_entities.find(entityNode);
+          it != m_entities.end() && it->second.validated
+          && brushNode->intersects(entityNode))
+      {
+        invalidateDecalData(entityNode, it->second);
+      }
     }
   }
 }
 
 void EntityDecalRenderer::removeBrush(const mdl::BrushNode* brushNode)
 {
-  // invalidate any entities that are tracking this brush
-  for (auto& [ent, data] : m_entities)
+  // invalidate any entities that are tracking this brush, the brush will be untracked
+  // when they are validated again
+  if (const auto it = m_entitiesByBrush.find(brushNode); it != m_entitiesByBrush.end())
   {
-    // skip entities that are going to be recomputed anyway
-    if (!data.validated)
-    {
-      continue;
-    }
-
-    // if this brush is tracked by this entity, remove it and recalculate
-    const auto tracked = std::find(data.brushes.begin(), data.brushes.end(), brushNode)
-                         != data.brushes.end();
-    if (tracked)
+    for (const auto* entityNode : it->second)
     {
-      invalidateDecalData(data);
+      invalidateDecalData(entityNode, m_entities.at(entityNode));
     }
   }
 }
 
-void EntityDecalRenderer::invalidateDecalData(EntityDecalData& data) const
+void EntityDecalRenderer::invalidateDecalData(
+  const mdl::EntityNode* entityNode, EntityDecalData& data)
 {
   // do nothing if the brush data is already marked as invalidated
   if (!data.validated)
@@ -284,6 +344,7 @@ void EntityDecalRenderer::invalidateDecalData(EntityDecalData& data) const
   }
 
   data.validated = false;
+  m_invalidEntities.insert(entityNode);
 
   // if the material doesn't exist, do nothing
   // also do nothing if the VBO storage fields are null, but it shouldn't happen
@@ -308,86 +369,133 @@ void EntityDecalRenderer::invalidateDecalData(EntityDecalData& data) const
   data.faceIndicesKey = nullptr;
 }
 
-void EntityDecalRenderer::validateDecalData(
-  const mdl::EntityNode* entityNode, EntityDecalData& data) const
+void EntityDecalRenderer::trackBrushes(
+  const mdl::EntityNode* entityNode, EntityDecalData& data)
+{
+  for (const auto* brushNode : data.brushes)
+  {
+    m_entitiesByBrush[brushNode].push_back(entityNode);
+  }
+}
+
+void EntityDecalRenderer::untrackBrushes(
+  const mdl::EntityNode* entityNode, EntityDecalData& data)
+{
+  for (const auto* brushNode : data.brushes)
+  {
+    if (const auto it = m_entitiesByBrush.find(brushNode); it != m_entitiesByBrush.end())
+    {
+      std::erase(it->second, entityNode);
+      if (it->second.empty())
+      {
+        m_entitiesByBrush.erase(it);
+      }
+    }
+  }
+  data.brushes.clear();
+}
+
+void EntityDecalRenderer::validateDecalData()
 {
-  if (data.validated)
+  constexpr auto EntitiesPerTask = size_t(16);
+
+  const auto timer = ScopedRenderTimer{RenderCategory::Entities, RenderPhase::Validate};
+
+  if (m_invalidEntities.empty())
   {
-    // already validated, no need to check again
     return;
   }
 
-  const auto spec = getDecalSpecification(entityNode);
-  ensure(spec, "entity has a decal specification");
+  auto invalidEntities =
+    std::vector<std::pair<const mdl::EntityNode*, EntityDecalData*>>{};
+  invalidEntities.reserve(m_invalidEntities.size());
+  for (const auto* entityNode : m_invalidEntities)
+  {
+    invalidEntities.emplace_back(entityNode, &m_entities.at(entityNode));
+  }
+  m_invalidEntities.clear();
 
   const auto& document = kdl::mem_lock(m_document);
   const auto& editorContext = document->editorContext();
   const auto* world = document->world();
 
-  // collect all the brush nodes that touch the entity's bbox
-  const auto entityBounds = entityNode->physicalBounds();
-  const auto intersectors = world->nodeTree().find_intersectors(entityBounds);
-
-  // track them in the entity
-  data.brushes.clear();
-  for (const auto* node : intersectors)
+  for (auto& [entityNode, data] : invalidEntities)
   {
-    const auto* brushNode = dynamic_cast<const mdl::BrushNode*>(node);
-    if (brushNode && editorContext.visible(brushNode))
+    const auto spec = getDecalSpecification(entityNode);
+    ensure(spec, "entity has a decal specification");
+
+    // collect all the brush nodes that touch the entity's bbox and track them
+    untrackBrushes(entityNode, *data);
+    const auto intersectors =
+      world->nodeTree().find_intersectors(entityNode->physicalBounds());
+    for (const auto* node : intersectors)
     {
-      data.brushes.push_back(brushNode);
+      const auto* brushNode = dynamic_cast<const mdl::BrushNode*>(node);
+      if (brushNode && editorContext.visible(brushNode))
+      {
+        data->brushes.push_back(brushNode);
+      }
     }
-  }
+    trackBrushes(entityNode, *data);
 
-  data.material = document->materialManager().material(spec->materialName);
-  if (!data.material)
-  {
-    // no decal material was found, don't generate any geometry
-    data.validated = true;
-    return;
+    // if no decal material is found, no geometry is generated
+    data->material = document->materialManager().material(spec->materialName);
+    if (data->material)
+    {
+      data->material->requestTexture(mdl::LoadPriority::High);
+    }
   }
 
-  // `bbox` and methods in the veclib library perform inclusive intersection tests - that
-  // is, if two polygons share an edge, plane, or vertex, then they are considered to be
-  // intersecting. We need the opposite behaviour when placing decals: when the entity's
-  // bounding box 'touches' but doesn't actually intersect through a face, we do not want
-  // to place a decal on it. To achieve this logic, we shrink the bounds just a tiny bit
-  // so adjacent faces that don't actually breach the entity's bounding box are excluded.
-  const auto shrunkBounds = entityBounds.expand(-vm::Cd::almost_zero());
-
-  // create geometry for the decal
-  auto vertices = std::vector<Vertex>{};
-  auto indices = std::vector<size_t>{};
+  // create the geometry for the decals
+  auto geometries = std::vector<DecalGeometry>(invalidEntities.size());
+  const auto createGeometry = [&](const size_t i) {
+    const auto& [entityNode, data] = invalidEntities[i];
+    if (data->material)
+    {
+      auto& geometry = geometries[i];
+      createDecalGeometry(
+        entityNode, data->brushes, *data->material, geometry.vertices, geometry.indices);
+    }
+  };
 
-  for (const auto& brush : data.brushes)
+  if (invalidEntities.size() <= EntitiesPerTask)
   {
-    for (const auto& face : brush->brush().faces())
+    for (size_t i = 0; i < invalidEntities.size(); ++i)
     {
-      // see if this decal can be projected onto this face
-      const auto facePolygon = face.geometry()->vertexPositions();
-      if (vm::intersect_bbox_polygon(
-            shrunkBounds, facePolygon.begin(), facePolygon.end()))
-      {
-        assert(data.material);
-        const auto decalPolygon =
-          createDecalBrushFace(entityNode, brush, face, *data.material);
-        if (!decalPolygon.empty())
+      createGeometry(i);
+    }
+  }
+  else
+  {
+    auto tasks = std::vector<std::function<bool()>>{};
+    for (size_t first = 0; first < invalidEntities.size(); first += EntitiesPerTask)
+    {
+      tasks.emplace_back([&, first]() {
+        const auto last = std::min(first + EntitiesPerTask, invalidEntities.size());
+        for (auto i = first; i < last; ++i)
         {
-          // add the geometry to be uploaded into the VBO
-          const auto vertexOffset = vertices.size();
-
-          vertices.insert(vertices.end(), decalPolygon.begin(), decalPolygon.end());
-          for (size_t i = 0; i < decalPolygon.size() - 2; ++i)
-          {
-            indices.push_back(vertexOffset);
-            indices.push_back(vertexOffset + i + 1);
-            indices.push_back(vertexOffset + i + 2);
-          }
+          createGeometry(i);
         }
-      }
+        return true;
+      });
     }
+    document->taskManager().run_tasks_and_wait(tasks);
   }
 
+  for (size_t i = 0; i < invalidEntities.size(); ++i)
+  {
+    auto& data = *invalidEntities[i].second;
+    uploadDecalGeometry(data, geometries[i]);
+    data.validated = true;
+  }
+}
+
+void EntityDecalRenderer::uploadDecalGeometry(
+  EntityDecalData& data, const DecalGeometry& geometry) const
+{
+  const auto& vertices = geometry.vertices;
+  const auto& indices = geometry.indices;
+
   if (!vertices.empty() && !indices.empty())
   {
     // upload the geometry into the VBO
@@ -415,17 +523,12 @@ void EntityDecalRenderer::validateDecalData(
     }
     data.faceIndicesKey = indexBlock;
   }
-
-  data.validated = true;
 }
 
 void EntityDecalRenderer::render(RenderContext&, RenderBatch& renderBatch)
 {
   // update any invalidated entities if required
-  for (auto& [ent, data] : m_entities)
-  {
-    validateDecalData(ent, data);
-  }
+  validateDecalData();
 
   m_faceRenderer.render(renderBatch);
 }
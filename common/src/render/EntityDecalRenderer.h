@@ -28,6 +28,7 @@
 
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace tb::mdl
@@ -65,12 +66,21 @@ private:
     AllocationTracker::Block* faceIndicesKey = nullptr;
   };
 
+  struct DecalGeometry;
+
   using EntityWithDependenciesMap =
     std::unordered_map<const mdl::EntityNode*, EntityDecalData>;
 
   std::weak_ptr<ui::MapDocument> m_document;
   EntityWithDependenciesMap m_entities;
 
+  // the reverse of EntityDecalData::brushes
+  std::unordered_map<const mdl::BrushNode*, std::vector<const mdl::EntityNode*>>
+    m_entitiesByBrush;
+
+  // the entities in m_entities whose decal data is not validated
+  std::unordered_set<const mdl::EntityNode*> m_invalidEntities;
+
   using Vertex = render::GLVertexTypes::P3NT2::Vertex;
   using MaterialToBrushIndicesMap =
     std::unordered_map<const mdl::Material*, std::shared_ptr<BrushIndexArray>>;
@@ -109,9 +119,18 @@ private:
   void updateBrush(const mdl::BrushNode* brushNode);
   void removeBrush(const mdl::BrushNode* brushNode);
 
-  void invalidateDecalData(EntityDecalData& data) const;
+  void invalidateDecalData(const mdl::EntityNode* entityNode, EntityDecalData& data);
 
-  void validateDecalData(const mdl::EntityNode* entityNode, EntityDecalData& data) const;
+  void trackBrushes(const mdl::EntityNode* entityNode, EntityDecalData& data);
+  void untrackBrushes(const mdl::EntityNode* entityNode, EntityDecalData& data);
+
+  /**
+   * Validates the decal data of all invalidated entities. The decal geometry is built on
+   * the document's worker threads and then uploaded into the VBOs. Only the entities in
+   * m_invalidEntities are visited, so this does nothing if no entity was invalidated.
+   */
+  void validateDecalData();
+  void uploadDecalGeometry(EntityDecalData& data, const DecalGeometry& geometry) const;
 
 public: // rendering
   void render(RenderContext& renderContext, RenderBatch& renderBatch);
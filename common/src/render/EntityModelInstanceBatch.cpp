@@ -0,0 +1,83 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "EntityModelInstanceBatch.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace tb::render
+{
+
+void EntityModelInstanceBatch::add(
+  MaterialRenderer& renderer,
+  const mdl::Orientation orientation,
+  const vm::mat4x4f& transformation)
+{
+  const auto [it, inserted] = m_groupIndices.try_emplace(&renderer, m_groups.size());
+  if (inserted)
+  {
+    m_groups.push_back(EntityModelInstances{&renderer, orientation, {}});
+  }
+  m_groups[it->second].transformations.push_back(transformation);
+}
+
+void EntityModelInstanceBatch::clear()
+{
+  m_groups.clear();
+  m_groupIndices.clear();
+}
+
+bool EntityModelInstanceBatch::empty() const
+{
+  return m_groups.empty();
+}
+
+size_t EntityModelInstanceBatch::instanceCount() const
+{
+  auto result = size_t(0);
+  for (const auto& group : m_groups)
+  {
+    result += group.transformations.size();
+  }
+  return result;
+}
+
+const std::vector<EntityModelInstances>& EntityModelInstanceBatch::groups() const
+{
+  return m_groups;
+}
+
+std::vector<EntityModelInstanceBatch::InstanceVertex> EntityModelInstanceBatch::
+  packTransformations(const EntityModelInstances& instances)
+{
+  auto result = std::vector<InstanceVertex>{};
+  result.reserve(instances.transformations.size());
+  std::transform(
+    instances.transformations.begin(),
+    instances.transformations.end(),
+    std::back_inserter(result),
+    [](const auto& transformation) {
+      return InstanceVertex{
+        transformation[0], transformation[1], transformation[2], transformation[3]};
+    });
+  return result;
+}
+
+} // namespace tb::render
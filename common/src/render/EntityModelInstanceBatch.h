@@ -0,0 +1,112 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "mdl/EntityModel.h"
+#include "render/GLVertexAttributeType.h"
+#include "render/GLVertexType.h"
+
+#include "vm/mat.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tb::render
+{
+class MaterialRenderer;
+
+/**
+ * The instances of an entity model that are rendered with one instanced draw call.
+ */
+struct EntityModelInstances
+{
+  MaterialRenderer* renderer = nullptr;
+  mdl::Orientation orientation = mdl::Orientation::Oriented;
+  std::vector<vm::mat4x4f> transformations;
+
+  bool operator==(const EntityModelInstances& other) const = default;
+};
+
+/**
+ * Groups the entities to render by their model renderer. The entity model manager creates
+ * one renderer per model, frame and skin, so all entities in a group can be rendered with
+ * the same vertices and materials, and only their model transformations differ.
+ *
+ * The groups are stored in the order in which they were first added to.
+ */
+class EntityModelInstanceBatch
+{
+public:
+  struct ModelMatrixColumn0Name
+  {
+    static inline const auto name = std::string{"ModelMatrixColumn0"};
+  };
+
+  struct ModelMatrixColumn1Name
+  {
+    static inline const auto name = std::string{"ModelMatrixColumn1"};
+  };
+
+  struct ModelMatrixColumn2Name
+  {
+    static inline const auto name = std::string{"ModelMatrixColumn2"};
+  };
+
+  struct ModelMatrixColumn3Name
+  {
+    static inline const auto name = std::string{"ModelMatrixColumn3"};
+  };
+
+  /**
+   * The per instance vertex type, made up of the columns of the model matrix.
+   */
+  using InstanceVertex = GLVertexType<
+    GLVertexAttributeInstance<ModelMatrixColumn0Name, GL_FLOAT, 4>,
+    GLVertexAttributeInstance<ModelMatrixColumn1Name, GL_FLOAT, 4>,
+    GLVertexAttributeInstance<ModelMatrixColumn2Name, GL_FLOAT, 4>,
+    GLVertexAttributeInstance<ModelMatrixColumn3Name, GL_FLOAT, 4>>::Vertex;
+
+private:
+  std::vector<EntityModelInstances> m_groups;
+  std::unordered_map<const MaterialRenderer*, size_t> m_groupIndices;
+
+public:
+  void add(
+    MaterialRenderer& renderer,
+    mdl::Orientation orientation,
+    const vm::mat4x4f& transformation);
+  void clear();
+
+  bool empty() const;
+  size_t instanceCount() const;
+  const std::vector<EntityModelInstances>& groups() const;
+
+  /**
+   * Packs the transformations of the given group into per instance vertices, one vertex
+   * per transformation.
+   */
+  static std::vector<InstanceVertex> packTransformations(
+    const EntityModelInstances& instances);
+
+  bool operator==(const EntityModelInstanceBatch& other) const = default;
+};
+
+} // namespace tb::render
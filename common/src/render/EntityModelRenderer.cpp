@@ -30,9 +30,11 @@
 #include "mdl/EntityNode.h"
 #include "render/ActiveShader.h"
 #include "render/Camera.h"
+#include "render/FrustumCulling.h"
 #include "render/MaterialIndexRangeRenderer.h"
 #include "render/RenderBatch.h"
 #include "render/RenderContext.h"
+#include "render/RenderStatistics.h"
 #include "render/RenderUtils.h"
 #include "render/Shaders.h"
 #include "render/Transformation.h"
@@ -113,6 +115,9 @@ void EntityModelRenderer::updateEntity(const mdl::EntityNode* entityNode)
 void EntityModelRenderer::clear()
 {
   m_entities.clear();
+  m_instanceBatch.clear();
+  m_instanceArrays.clear();
+  m_instanceArraysValid = false;
 }
 
 bool EntityModelRenderer::applyTinting() const
@@ -145,26 +150,96 @@ void EntityModelRenderer::setShowHiddenEntities(const bool showHiddenEntities)
   m_showHiddenEntities = showHiddenEntities;
 }
 
-void EntityModelRenderer::render(RenderBatch& renderBatch)
+void EntityModelRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch)
 {
+  const auto timer =
+    ScopedRenderTimer{RenderCategory::EntityModels, RenderPhase::Validate};
+  if (auto instanceBatch = collectInstances(renderContext);
+      instanceBatch != m_instanceBatch)
+  {
+    m_instanceBatch = std::move(instanceBatch);
+    m_instanceArraysValid = false;
+  }
+
   renderBatch.add(this);
 }
 
+EntityModelInstanceBatch EntityModelRenderer::collectInstances(
+  const RenderContext& renderContext) const
+{
+  auto result = EntityModelInstanceBatch{};
+  if (m_entities.empty())
+  {
+    return result;
+  }
+
+  const auto& propertyConfig = m_entities.begin()->first->entityPropertyConfig();
+  const auto& defaultModelScaleExpression = propertyConfig.defaultModelScaleExpression;
+  const auto* visibleSet = renderContext.visibleSet();
+
+  for (const auto& [entityNode, renderer] : m_entities)
+  {
+    if (!m_showHiddenEntities && !m_editorContext.visible(entityNode))
+    {
+      continue;
+    }
+
+    if (visibleSet && !visibleSet->contains(entityNode))
+    {
+      continue;
+    }
+
+    const auto* model = entityNode->entity().model();
+    const auto* modelData = model ? model->data() : nullptr;
+    if (!modelData)
+    {
+      continue;
+    }
+
+    result.add(
+      *renderer,
+      modelData->orientation(),
+      vm::mat4x4f{entityNode->entity().modelTransformation(defaultModelScaleExpression)});
+  }
+
+  return result;
+}
+
 void EntityModelRenderer::doPrepareVertices(VboManager& vboManager)
 {
   m_entityModelManager.prepare(vboManager);
+
+  if (!m_instanceArraysValid)
+  {
+    m_instanceArrays.clear();
+    if (glSupportsInstancing())
+    {
+      for (const auto& instances : m_instanceBatch.groups())
+      {
+        m_instanceArrays.push_back(
+          VertexArray::move(EntityModelInstanceBatch::packTransformations(instances)));
+        m_instanceArrays.back().prepare(vboManager);
+      }
+    }
+    m_instanceArraysValid = true;
+  }
 }
 
 void EntityModelRenderer::doRender(RenderContext& renderContext)
 {
-  if (!m_entities.empty())
+  if (!m_instanceBatch.empty())
   {
     auto& prefs = PreferenceManager::instance();
 
     glAssert(glEnable(GL_TEXTURE_2D));
     glAssert(glActiveTexture(GL_TEXTURE0));
 
-    auto shader = ActiveShader{renderContext.shaderManager(), Shaders::EntityModelShader};
+    // the instance arrays are only created if instancing is supported
+    const auto instanced = !m_instanceArrays.empty();
+
+    auto shader = ActiveShader{
+      renderContext.shaderManager(),
+      instanced ? Shaders::EntityModelInstancedShader : Shaders::EntityModelShader};
     shader.set("Brightness", prefs.get(Preferences::Brightness));
     shader.set("ApplyTinting", m_applyTinting);
     shader.set("TintColor", m_tintColor);
@@ -187,35 +262,36 @@ void EntityModelRenderer::doRender(RenderContext& renderContext)
     shader.set("CameraUp", renderContext.camera().up());
     shader.set("ViewMatrix", renderContext.camera().viewMatrix());
 
-    const auto& propertyConfig = m_entities.begin()->first->entityPropertyConfig();
-    const auto& defaultModelScaleExpression = propertyConfig.defaultModelScaleExpression;
+    auto renderFunc = DefaultMaterialRenderFunc{
+      renderContext.minFilterMode(), renderContext.magFilterMode()};
 
-    for (const auto& [entityNode, renderer] : m_entities)
+    const auto& groups = m_instanceBatch.groups();
+    for (size_t i = 0; i < groups.size(); ++i)
     {
-      if (!m_showHiddenEntities && !m_editorContext.visible(entityNode))
+      const auto& instances = groups[i];
+      shader.set("Orientation", static_cast<int>(instances.orientation));
+
+      if (instanced)
       {
-        continue;
+        auto& instanceArray = m_instanceArrays[i];
+        if (instanceArray.setup())
+        {
+          instances.renderer->renderInstanced(
+            renderFunc, instances.transformations.size());
+          instanceArray.cleanup();
+        }
       }
-
-      const auto* model = entityNode->entity().model();
-      const auto* modelData = model ? model->data() : nullptr;
-      if (!modelData)
+      else
       {
-        continue;
+        for (const auto& transformation : instances.transformations)
+        {
+          const auto multMatrix =
+            MultiplyModelMatrix{renderContext.transformation(), transformation};
+
+          shader.set("ModelMatrix", transformation);
+          instances.renderer->render(renderFunc);
+        }
       }
-
-      shader.set("Orientation", static_cast<int>(modelData->orientation()));
-
-      const auto transformation = vm::mat4x4f{
-        entityNode->entity().modelTransformation(defaultModelScaleExpression)};
-      const auto multMatrix =
-        MultiplyModelMatrix{renderContext.transformation(), transformation};
-
-      shader.set("ModelMatrix", transformation);
-
-      auto renderFunc = DefaultMaterialRenderFunc{
-        renderContext.minFilterMode(), renderContext.magFilterMode()};
-      renderer->render(renderFunc);
     }
   }
 }
@@ -20,9 +20,12 @@
 #pragma once
 
 #include "Color.h"
+#include "render/EntityModelInstanceBatch.h"
 #include "render/Renderable.h"
+#include "render/VertexArray.h"
 
 #include <unordered_map>
+#include <vector>
 
 namespace tb
 {
@@ -39,6 +42,7 @@ class EntityNode;
 namespace tb::render
 {
 class RenderBatch;
+class RenderContext;
 struct ShaderConfig;
 class MaterialRenderer;
 
@@ -52,6 +56,10 @@ private:
 
   std::unordered_map<const mdl::EntityNode*, MaterialRenderer*> m_entities;
 
+  EntityModelInstanceBatch m_instanceBatch;
+  std::vector<VertexArray> m_instanceArrays;
+  bool m_instanceArraysValid = false;
+
   bool m_applyTinting = false;
   Color m_tintColor;
 
@@ -104,9 +112,11 @@ public:
   bool showHiddenEntities() const;
   void setShowHiddenEntities(bool showHiddenEntities);
 
-  void render(RenderBatch& renderBatch);
+  void render(RenderContext& renderContext, RenderBatch& renderBatch);
 
 private:
+  EntityModelInstanceBatch collectInstances(const RenderContext& renderContext) const;
+
   void doPrepareVertices(VboManager& vboManager) override;
   void doRender(RenderContext& renderContext) override;
 };
@@ -26,11 +26,13 @@
 #include "mdl/EntityModelManager.h"
 #include "mdl/EntityNode.h"
 #include "render/Camera.h"
+#include "render/FrustumCulling.h"
 #include "render/GLVertexType.h"
 #include "render/PrimType.h"
 #include "render/RenderBatch.h"
 #include "render/RenderContext.h"
 #include "render/RenderService.h"
+#include "render/RenderStatistics.h"
 #include "render/TextAnchor.h"
 
 #include "vm/mat.h"
@@ -81,6 +83,7 @@ void EntityRenderer::invalidate()
 {
   invalidateBounds();
   reloadModels();
+  m_entityStrings.clear();
 }
 
 void EntityRenderer::clear()
@@ -90,6 +93,7 @@ void EntityRenderer::clear()
   m_brushEntityWireframeBoundsRenderer = DirectEdgeRenderer();
   m_solidBoundsRenderer = TriangleRenderer();
   m_modelRenderer.clear();
+  m_entityStrings.clear();
 }
 
 void EntityRenderer::reloadModels()
@@ -112,6 +116,7 @@ void EntityRenderer::removeEntity(const mdl::EntityNode* entity)
   {
     m_entities.erase(it);
     m_modelRenderer.removeEntity(entity);
+    m_entityStrings.erase(entity);
     invalidateBounds();
   }
 }
@@ -119,6 +124,7 @@ void EntityRenderer::removeEntity(const mdl::EntityNode* entity)
 void EntityRenderer::invalidateEntity(const mdl::EntityNode* entity)
 {
   m_modelRenderer.updateEntity(entity);
+  m_entityStrings.erase(entity);
   invalidateBounds();
 }
 
@@ -275,7 +281,9 @@ void EntityRenderer::renderModels(RenderContext& renderContext, RenderBatch& ren
     m_modelRenderer.setApplyTinting(m_tint);
     m_modelRenderer.setTintColor(m_tintColor);
     m_modelRenderer.setShowHiddenEntities(m_showHiddenEntities);
-    m_modelRenderer.render(renderBatch);
+
+    const auto setCategory = SetRenderCategory{renderBatch, RenderCategory::EntityModels};
+    m_modelRenderer.render(renderContext, renderBatch);
   }
 }
 
@@ -284,12 +292,22 @@ void EntityRenderer::renderClassnames(
 {
   if (m_showOverlays && renderContext.showEntityClassnames())
   {
+    // the render service adds its renderables to the batch when it is destroyed
+    const auto setCategory = SetRenderCategory{renderBatch, RenderCategory::Text};
+    const auto timer = ScopedRenderTimer{RenderCategory::Text, RenderPhase::Validate};
+
     auto renderService = render::RenderService{renderContext, renderBatch};
     renderService.setForegroundColor(m_overlayTextColor);
     renderService.setBackgroundColor(m_overlayBackgroundColor);
 
+    const auto* visibleSet = renderContext.visibleSet();
     for (const auto* entity : m_entities)
     {
+      if (visibleSet && !visibleSet->contains(entity))
+      {
+        continue;
+      }
+
       if (m_showHiddenEntities || m_editorContext.visible(entity))
       {
         if (
@@ -305,7 +323,8 @@ void EntityRenderer::renderClassnames(
             renderService.setHideOccludedObjects();
           }
 
-          renderService.renderString(entityString(entity), EntityClassnameAnchor{entity});
+          renderService.renderString(
+            cachedEntityString(entity), EntityClassnameAnchor{entity});
         }
       }
     }
@@ -423,6 +442,8 @@ auto makeColoredSolidBoundsVertexBuilder(
 
 void EntityRenderer::validateBounds()
 {
+  const auto timer = ScopedRenderTimer{RenderCategory::Entities, RenderPhase::Validate};
+
   auto solidVertices = std::vector<GLVertexTypes::P3NC4::Vertex>{};
   solidVertices.reserve(36 * m_entities.size());
 
@@ -513,6 +534,16 @@ void EntityRenderer::validateBounds()
   m_boundsValid = true;
 }
 
+const AttrString& EntityRenderer::cachedEntityString(const mdl::EntityNode* entityNode)
+{
+  auto it = m_entityStrings.find(entityNode);
+  if (it == m_entityStrings.end())
+  {
+    it = m_entityStrings.emplace(entityNode, entityString(entityNode)).first;
+  }
+  return it->second;
+}
+
 AttrString EntityRenderer::entityString(const mdl::EntityNode* entityNode) const
 {
   const auto& classname = entityNode->entity().classname();
@@ -20,6 +20,7 @@
 #pragma once
 
 #include "Color.h"
+#include "render/AttrString.h"
 #include "render/EdgeRenderer.h"
 #include "render/EntityModelRenderer.h"
 #include "render/Renderable.h"
@@ -27,6 +28,7 @@
 
 #include "kdl/vector_set.h"
 
+#include <unordered_map>
 #include <vector>
 
 namespace tb
@@ -44,7 +46,6 @@ class EntityNode;
 
 namespace tb::render
 {
-class AttrString;
 
 class EntityRenderer
 {
@@ -60,6 +61,9 @@ private:
   EntityModelRenderer m_modelRenderer;
   bool m_boundsValid = false;
 
+  // the classname overlay strings, built when an entity's overlay is first rendered
+  std::unordered_map<const mdl::EntityNode*, AttrString> m_entityStrings;
+
   bool m_showOverlays = true;
   Color m_overlayTextColor;
   Color m_overlayBackgroundColor;
@@ -146,6 +150,7 @@ private:
   void invalidateBounds();
   void validateBounds();
 
+  const AttrString& cachedEntityString(const mdl::EntityNode* entityNode);
   AttrString entityString(const mdl::EntityNode* entityNode) const;
   const Color& boundsColor(const mdl::EntityNode* entityNode) const;
 };
@@ -120,6 +120,12 @@ void FaceRenderer::setAlpha(const float alpha)
   m_alpha = alpha;
 }
 
+void FaceRenderer::setVisibleRanges(
+  std::shared_ptr<const MaterialToIndexRangesMap> visibleRanges)
+{
+  m_visibleRanges = std::move(visibleRanges);
+}
+
 void FaceRenderer::render(RenderBatch& renderBatch)
 {
   renderBatch.add(this);
@@ -140,7 +146,10 @@ void FaceRenderer::doRender(RenderContext& context)
   if (!m_indexArrayMap->empty() && m_vertexArray->setupVertices())
   {
     auto& shaderManager = context.shaderManager();
-    auto shader = ActiveShader{shaderManager, Shaders::FaceShader};
+    auto shader = ActiveShader{
+      shaderManager,
+      m_vertexArray->layout() == BrushVertexLayout::Packed ? Shaders::FacePackedShader
+                                                           : Shaders::FaceShader};
     auto& prefs = PreferenceManager::instance();
 
     const auto applyMaterial = context.showMaterials();
@@ -186,8 +195,26 @@ void FaceRenderer::doRender(RenderContext& context)
     }
     for (const auto& [material, brushIndexHolderPtr] : *m_indexArrayMap)
     {
+      const std::vector<IndexRange>* visibleRanges = nullptr;
+      if (m_visibleRanges)
+      {
+        const auto it = m_visibleRanges->find(material);
+        if (it == m_visibleRanges->end())
+        {
+          // none of the brushes using this material are visible
+          continue;
+        }
+        visibleRanges = &it->second;
+      }
+
       if (brushIndexHolderPtr->hasValidIndices())
       {
+        if (material)
+        {
+          // loads visible textures first and reloads them if they were evicted
+          material->requestTexture(mdl::LoadPriority::High);
+        }
+
         const auto* texture = getTexture(material);
         const auto enableMasked = texture && texture->mask() == mdl::TextureMask::On;
 
@@ -197,7 +224,14 @@ void FaceRenderer::doRender(RenderContext& context)
 
         func.before(material);
         brushIndexHolderPtr->setupIndices();
-        brushIndexHolderPtr->render(PrimType::Triangles);
+        if (visibleRanges)
+        {
+          brushIndexHolderPtr->render(PrimType::Triangles, *visibleRanges);
+        }
+        else
+        {
+          brushIndexHolderPtr->render(PrimType::Triangles);
+        }
         brushIndexHolderPtr->cleanupIndices();
         func.after(material);
       }
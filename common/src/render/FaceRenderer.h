@@ -24,6 +24,7 @@
 
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 namespace tb::mdl
 {
@@ -35,9 +36,14 @@ namespace tb::render
 class BrushIndexArray;
 class BrushVertexArray;
 class RenderBatch;
+struct IndexRange;
 
 class FaceRenderer : public IndexedRenderable
 {
+public:
+  using MaterialToIndexRangesMap =
+    std::unordered_map<const mdl::Material*, std::vector<IndexRange>>;
+
 private:
   using MaterialToBrushIndicesMap =
     const std::unordered_map<const mdl::Material*, std::shared_ptr<BrushIndexArray>>;
@@ -49,6 +55,7 @@ private:
   bool m_tint = false;
   Color m_tintColor;
   float m_alpha = 1.0;
+  std::shared_ptr<const MaterialToIndexRangesMap> m_visibleRanges;
 
 public:
   FaceRenderer();
@@ -62,6 +69,12 @@ public:
   void setTintColor(const Color& color);
   void setAlpha(float alpha);
 
+  /**
+   * Restricts rendering to the given index ranges per material. Materials without an
+   * entry are skipped. If the given map is null, all indices are rendered.
+   */
+  void setVisibleRanges(std::shared_ptr<const MaterialToIndexRangesMap> visibleRanges);
+
   void render(RenderBatch& renderBatch);
 
 private:
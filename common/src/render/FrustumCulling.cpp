@@ -0,0 +1,247 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FrustumCulling.h"
+
+#include "mdl/BrushNode.h"
+#include "mdl/EntityNode.h"
+#include "mdl/GroupNode.h"
+#include "mdl/LayerNode.h"
+#include "mdl/PatchNode.h"
+#include "mdl/WorldNode.h"
+#include "render/Camera.h"
+
+#include "kdl/overload.h"
+#include "kdl/reflection_impl.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace tb::render
+{
+namespace
+{
+
+size_t nextGeneration()
+{
+  static auto generation = size_t(0);
+  return ++generation;
+}
+
+} // namespace
+
+ViewFrustum::ViewFrustum(std::vector<vm::plane3d> planes)
+  : m_planes{std::move(planes)}
+{
+}
+
+ViewFrustum ViewFrustum::fromCamera(const Camera& camera)
+{
+  auto top = vm::plane3f{};
+  auto right = vm::plane3f{};
+  auto bottom = vm::plane3f{};
+  auto left = vm::plane3f{};
+  camera.frustumPlanes(top, right, bottom, left);
+
+  auto planes = std::vector<vm::plane3d>{
+    vm::plane3d{top}, vm::plane3d{right}, vm::plane3d{bottom}, vm::plane3d{left}};
+  if (camera.perspectiveProjection())
+  {
+    planes.emplace_back(
+      vm::vec3d{camera.position() + camera.farPlane() * camera.direction()},
+      vm::vec3d{camera.direction()});
+  }
+  return ViewFrustum{std::move(planes)};
+}
+
+bool ViewFrustum::intersects(const vm::bbox3d& bounds) const
+{
+  return std::none_of(m_planes.begin(), m_planes.end(), [&](const auto& plane) {
+    // the corner of the bounds that lies furthest behind the plane
+    const auto corner = vm::vec3d{
+      plane.normal.x() > 0.0 ? bounds.min.x() : bounds.max.x(),
+      plane.normal.y() > 0.0 ? bounds.min.y() : bounds.max.y(),
+      plane.normal.z() > 0.0 ? bounds.min.z() : bounds.max.z()};
+    return plane.point_distance(corner) > 0.0;
+  });
+}
+
+FrustumContainment ViewFrustum::classify(const vm::bbox3d& bounds) const
+{
+  auto result = FrustumContainment::Inside;
+  for (const auto& plane : m_planes)
+  {
+    // the corners of the bounds that lie furthest behind and furthest in front of the
+    // plane
+    const auto back = vm::vec3d{
+      plane.normal.x() > 0.0 ? bounds.min.x() : bounds.max.x(),
+      plane.normal.y() > 0.0 ? bounds.min.y() : bounds.max.y(),
+      plane.normal.z() > 0.0 ? bounds.min.z() : bounds.max.z()};
+    if (plane.point_distance(back) > 0.0)
+    {
+      return FrustumContainment::Outside;
+    }
+
+    const auto front = vm::vec3d{
+      plane.normal.x() > 0.0 ? bounds.max.x() : bounds.min.x(),
+      plane.normal.y() > 0.0 ? bounds.max.y() : bounds.min.y(),
+      plane.normal.z() > 0.0 ? bounds.max.z() : bounds.min.z()};
+    if (plane.point_distance(front) > 0.0)
+    {
+      result = FrustumContainment::Intersecting;
+    }
+  }
+  return result;
+}
+
+kdl_reflect_impl(CullingStats);
+
+bool VisibleSet::update(const NodeTree& nodeTree, const ViewFrustum& frustum)
+{
+  auto changed = false;
+  if (nodeTree.revision() != m_nodeTreeRevision)
+  {
+    // the tree nodes may have been replaced and the sets may refer to removed nodes
+    auto previousBrushes = std::exchange(m_brushes, {});
+    auto previousEntities = std::exchange(m_entities, {});
+    auto previousPatches = std::exchange(m_patches, {});
+    m_containment.clear();
+    m_nodeTreeRevision = nodeTree.revision();
+
+    if (const auto* root = nodeTree.root())
+    {
+      updateTreeNode(nodeTree, *root, frustum, FrustumContainment::Outside);
+    }
+
+    changed = m_brushes != previousBrushes || m_entities != previousEntities
+              || m_patches != previousPatches;
+  }
+  else if (const auto* root = nodeTree.root())
+  {
+    changed = updateTreeNode(nodeTree, *root, frustum, FrustumContainment::Outside);
+  }
+
+  const auto submitted = m_brushes.size() + m_entities.size() + m_patches.size();
+  m_stats = CullingStats{submitted, nodeTree.size() - submitted};
+
+  if (changed)
+  {
+    m_generation = nextGeneration();
+  }
+  return changed;
+}
+
+bool VisibleSet::updateTreeNode(
+  const NodeTree& nodeTree,
+  const NodeTree::node& treeNode,
+  const ViewFrustum& frustum,
+  const FrustumContainment parentContainment)
+{
+  const auto iPrevious = m_containment.find(&treeNode);
+  const auto previous =
+    iPrevious != m_containment.end() ? iPrevious->second : parentContainment;
+  const auto current = frustum.classify(nodeTree.bounds(treeNode));
+
+  if (current == FrustumContainment::Intersecting)
+  {
+    m_containment.insert_or_assign(&treeNode, current);
+
+    auto changed = false;
+    for (const auto* node : NodeTree::data(treeNode))
+    {
+      changed |= setVisible(node, frustum.intersects(node->physicalBounds()));
+    }
+    for (const auto& child : NodeTree::children(treeNode))
+    {
+      changed |= updateTreeNode(nodeTree, child, frustum, previous);
+    }
+    return changed;
+  }
+
+  if (current == previous)
+  {
+    return false;
+  }
+
+  m_containment.insert_or_assign(&treeNode, current);
+  return setSubtreeVisible(treeNode, current == FrustumContainment::Inside);
+}
+
+bool VisibleSet::setSubtreeVisible(const NodeTree::node& treeNode, const bool visible)
+{
+  auto changed = false;
+  for (const auto* node : NodeTree::data(treeNode))
+  {
+    changed |= setVisible(node, visible);
+  }
+  for (const auto& child : NodeTree::children(treeNode))
+  {
+    // the children now share the classification of their ancestor
+    m_containment.erase(&child);
+    changed |= setSubtreeVisible(child, visible);
+  }
+  return changed;
+}
+
+bool VisibleSet::setVisible(const mdl::Node* node, const bool visible)
+{
+  const auto updateSet = [&](auto& set, const auto* element) {
+    return visible ? set.insert(element).second : set.erase(element) > 0;
+  };
+
+  return node->accept(kdl::overload(
+    [](const mdl::WorldNode*) { return false; },
+    [](const mdl::LayerNode*) { return false; },
+    [](const mdl::GroupNode*) { return false; },
+    [&](const mdl::EntityNode* entityNode) { return updateSet(m_entities, entityNode); },
+    [&](const mdl::BrushNode* brushNode) { return updateSet(m_brushes, brushNode); },
+    [&](const mdl::PatchNode* patchNode) { return updateSet(m_patches, patchNode); }));
+}
+
+bool VisibleSet::contains(const mdl::BrushNode* brushNode) const
+{
+  return m_brushes.contains(brushNode);
+}
+
+bool VisibleSet::contains(const mdl::EntityNode* entityNode) const
+{
+  return m_entities.contains(entityNode);
+}
+
+bool VisibleSet::contains(const mdl::PatchNode* patchNode) const
+{
+  return m_patches.contains(patchNode);
+}
+
+const std::unordered_set<const mdl::BrushNode*>& VisibleSet::brushes() const
+{
+  return m_brushes;
+}
+
+const CullingStats& VisibleSet::stats() const
+{
+  return m_stats;
+}
+
+size_t VisibleSet::generation() const
+{
+  return m_generation;
+}
+
+} // namespace tb::render
@@ -0,0 +1,152 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "octree.h"
+
+#include "kdl/reflection_decl.h"
+
+#include "vm/bbox.h"
+#include "vm/plane.h"
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace tb::mdl
+{
+class BrushNode;
+class EntityNode;
+class Node;
+class PatchNode;
+} // namespace tb::mdl
+
+namespace tb::render
+{
+class Camera;
+
+enum class FrustumContainment
+{
+  Outside,
+  Intersecting,
+  Inside,
+};
+
+/**
+ * The volume that is visible through a camera. It is bounded by planes whose normals
+ * point out of the volume.
+ */
+class ViewFrustum
+{
+private:
+  std::vector<vm::plane3d> m_planes;
+
+public:
+  explicit ViewFrustum(std::vector<vm::plane3d> planes);
+
+  /**
+   * Returns the frustum of the given camera. The frustum of a perspective camera is
+   * bounded by the far plane, but not by the near plane.
+   */
+  static ViewFrustum fromCamera(const Camera& camera);
+
+  /**
+   * Tests whether the given bounds intersect this frustum. The test is conservative: it
+   * may return true for bounds that lie outside of the frustum near one of its edges.
+   */
+  bool intersects(const vm::bbox3d& bounds) const;
+
+  /**
+   * Classifies the given bounds as lying outside of, intersecting or inside of this
+   * frustum. The test is conservative in the same way as intersects(): bounds that are
+   * classified as Outside or Inside are guaranteed to be outside or inside.
+   */
+  FrustumContainment classify(const vm::bbox3d& bounds) const;
+};
+
+struct CullingStats
+{
+  size_t submitted = 0;
+  size_t culled = 0;
+
+  kdl_reflect_decl(CullingStats, submitted, culled);
+};
+
+/**
+ * The brushes, entities and patches of a node tree that intersect a view frustum.
+ *
+ * The set remembers how the tree's nodes were classified against the previous frustum.
+ * Tree nodes that remain entirely inside or outside of the frustum are skipped together
+ * with their descendants, so only the items of tree nodes that intersect the frustum or
+ * whose classification changed are visited.
+ */
+class VisibleSet
+{
+private:
+  using NodeTree = octree<double, mdl::Node*>;
+
+  std::unordered_set<const mdl::BrushNode*> m_brushes;
+  std::unordered_set<const mdl::EntityNode*> m_entities;
+  std::unordered_set<const mdl::PatchNode*> m_patches;
+  CullingStats m_stats;
+  size_t m_generation = 0;
+
+  /**
+   * The classification of the tree nodes against the previous frustum. Descendants of
+   * tree nodes that were inside or outside of the frustum are not recorded, they share
+   * their ancestor's classification.
+   */
+  std::unordered_map<const NodeTree::node*, FrustumContainment> m_containment;
+  size_t m_nodeTreeRevision = 0;
+
+public:
+  /**
+   * Culls the nodes of the given tree against the given frustum.
+   *
+   * If the visible nodes changed, a new generation number is assigned to this set. The
+   * generation numbers are unique across all visible sets.
+   *
+   * If the tree was modified since the previous update, all of its nodes are culled
+   * again.
+   *
+   * @return true if the visible nodes changed and false otherwise
+   */
+  bool update(const NodeTree& nodeTree, const ViewFrustum& frustum);
+
+  bool contains(const mdl::BrushNode* brushNode) const;
+  bool contains(const mdl::EntityNode* entityNode) const;
+  bool contains(const mdl::PatchNode* patchNode) const;
+
+  const std::unordered_set<const mdl::BrushNode*>& brushes() const;
+
+  const CullingStats& stats() const;
+  size_t generation() const;
+
+private:
+  bool updateTreeNode(
+    const NodeTree& nodeTree,
+    const NodeTree::node& treeNode,
+    const ViewFrustum& frustum,
+    FrustumContainment parentContainment);
+  bool setSubtreeVisible(const NodeTree::node& treeNode, bool visible);
+  bool setVisible(const mdl::Node* node, bool visible);
+};
+
+} // namespace tb::render
@@ -141,4 +141,10 @@ std::string glGetEnumName(const GLenum enum_)
     return "Unknown OpenGL enum";
   }
 }
+
+bool glSupportsInstancing()
+{
+  return GLEW_ARB_instanced_arrays && GLEW_ARB_draw_instanced;
+}
+
 } // namespace tb
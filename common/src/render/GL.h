@@ -36,6 +36,12 @@ std::string glGetErrorMessage(GLenum code);
 GLenum glGetEnum(const std::string& name);
 std::string glGetEnumName(GLenum _enum);
 
+/**
+ * Indicates whether the current context supports instanced draw calls with per instance
+ * vertex attributes.
+ */
+bool glSupportsInstancing();
+
 // #define GL_DEBUG 1
 // #define GL_LOG 1
 
@@ -79,6 +79,44 @@ public:
   deleteCopyAndMove(GLVertexAttributeUser);
 };
 
+/**
+ * User defined vertex attribute types that advance once per instance instead of once per
+ * vertex when used with instanced draw calls.
+ *
+ * @tparam A class containing the attribute name, see GLVertexAttributeUser
+ * @tparam D the vertex component type
+ * @tparam S the number of components
+ */
+template <class A, GLenum D, size_t S>
+class GLVertexAttributeInstance
+{
+public:
+  using ComponentType = typename GLType<D>::Type;
+  using ElementType = vm::vec<ComponentType, S>;
+  static const size_t Size = sizeof(ElementType);
+
+  static void setup(
+    ShaderProgram* program, const size_t index, const size_t stride, const size_t offset)
+  {
+    GLVertexAttributeUser<A, D, S, false>::setup(program, index, stride, offset);
+
+    const auto attributeIndex = program->findAttributeLocation(A::name);
+    glAssert(glVertexAttribDivisorARB(static_cast<GLuint>(attributeIndex), 1));
+  }
+
+  static void cleanup(ShaderProgram* program, const size_t index)
+  {
+    const auto attributeIndex = program->findAttributeLocation(A::name);
+    glAssert(glVertexAttribDivisorARB(static_cast<GLuint>(attributeIndex), 0));
+
+    GLVertexAttributeUser<A, D, S, false>::cleanup(program, index);
+  }
+
+  // Non-instantiable
+  GLVertexAttributeInstance() = delete;
+  deleteCopyAndMove(GLVertexAttributeInstance);
+};
+
 /**
  * Vertex position attribute types.
  *
@@ -231,12 +269,55 @@ public:
   deleteCopyAndMove(GLVertexAttributeUVCoord0);
 };
 
+/**
+ * Vertex UV coordinate (1) attribute types.
+ *
+ * @tparam D the vertex component type
+ * @tparam S the number of components
+ */
+template <GLenum D, size_t S>
+class GLVertexAttributeUVCoord1
+{
+public:
+  using ComponentType = typename GLType<D>::Type;
+  using ElementType = vm::vec<ComponentType, S>;
+  static const size_t Size = sizeof(ElementType);
+
+  static void setup(
+    ShaderProgram* /* program */,
+    const size_t /* index */,
+    const size_t stride,
+    const size_t offset)
+  {
+    glAssert(glClientActiveTexture(GL_TEXTURE1));
+    glAssert(glEnableClientState(GL_TEXTURE_COORD_ARRAY));
+    glAssert(glTexCoordPointer(
+      static_cast<GLint>(S),
+      D,
+      static_cast<GLsizei>(stride),
+      reinterpret_cast<GLvoid*>(offset)));
+    glAssert(glClientActiveTexture(GL_TEXTURE0));
+  }
+
+  static void cleanup(ShaderProgram* /* program */, const size_t /* index */)
+  {
+    glAssert(glClientActiveTexture(GL_TEXTURE1));
+    glAssert(glDisableClientState(GL_TEXTURE_COORD_ARRAY));
+    glAssert(glClientActiveTexture(GL_TEXTURE0));
+  }
+
+  // Non-instantiable
+  GLVertexAttributeUVCoord1() = delete;
+  deleteCopyAndMove(GLVertexAttributeUVCoord1);
+};
+
 namespace GLVertexAttributeTypes
 {
 using P2 = GLVertexAttributePosition<GL_FLOAT, 2>;
 using P3 = GLVertexAttributePosition<GL_FLOAT, 3>;
 using N = GLVertexAttributeNormal<GL_FLOAT, 3>;
 using UV02 = GLVertexAttributeUVCoord0<GL_FLOAT, 2>;
+using UV12S = GLVertexAttributeUVCoord1<GL_SHORT, 2>;
 using C4 = GLVertexAttributeColor<GL_FLOAT, 4>;
 } // namespace GLVertexAttributeTypes
 
@@ -166,6 +166,7 @@ std::unique_ptr<ObjectRenderer> createDefaultRenderer(
     *kdl::mem_lock(document),
     kdl::mem_lock(document)->entityModelManager(),
     kdl::mem_lock(document)->editorContext(),
+    kdl::mem_lock(document)->taskManager(),
     UnselectedBrushRendererFilter{kdl::mem_lock(document)->editorContext()});
 }
 
@@ -176,6 +177,7 @@ std::unique_ptr<ObjectRenderer> createSelectionRenderer(
     *kdl::mem_lock(document),
     kdl::mem_lock(document)->entityModelManager(),
     kdl::mem_lock(document)->editorContext(),
+    kdl::mem_lock(document)->taskManager(),
     SelectedBrushRendererFilter{kdl::mem_lock(document)->editorContext()});
 }
 
@@ -186,6 +188,7 @@ std::unique_ptr<ObjectRenderer> createLockRenderer(
     *kdl::mem_lock(document),
     kdl::mem_lock(document)->entityModelManager(),
     kdl::mem_lock(document)->editorContext(),
+    kdl::mem_lock(document)->taskManager(),
     LockedBrushRendererFilter{kdl::mem_lock(document)->editorContext()});
 }
 
@@ -195,6 +198,12 @@ std::unique_ptr<EntityDecalRenderer> createEntityDecalRenderer(
   return std::make_unique<EntityDecalRenderer>(document);
 }
 
+BrushVertexLayout brushVertexLayout()
+{
+  return pref(Preferences::PackedBrushVertices) ? BrushVertexLayout::Packed
+                                                : BrushVertexLayout::Full;
+}
+
 } // namespace
 
 MapRenderer::MapRenderer(std::weak_ptr<ui::MapDocument> document)
@@ -234,6 +243,7 @@ void MapRenderer::restoreSelectionColors()
 
 void MapRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch)
 {
+  updateVisibleSet(renderContext);
   setupGL(renderBatch);
   renderEntityDecals(renderContext, renderBatch);
   renderEntityLinks(renderContext, renderBatch);
@@ -248,6 +258,19 @@ void MapRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch)
   renderSelectionTransparent(renderContext, renderBatch);
 }
 
+void MapRenderer::updateVisibleSet(RenderContext& renderContext)
+{
+  if (renderContext.render3D())
+  {
+    if (const auto* worldNode = kdl::mem_lock(m_document)->world())
+    {
+      m_visibleSet.update(
+        worldNode->nodeTree(), ViewFrustum::fromCamera(renderContext.camera()));
+      renderContext.setVisibleSet(&m_visibleSet);
+    }
+  }
+}
+
 void MapRenderer::clear()
 {
   m_defaultRenderer->clear();
@@ -329,6 +352,7 @@ void MapRenderer::renderEntityDecals(
   // only render decals in the 3D view
   if (renderContext.render3D())
   {
+    const auto setCategory = SetRenderCategory{renderBatch, RenderCategory::Entities};
     m_entityDecalRenderer->render(renderContext, renderBatch);
   }
 }
@@ -336,6 +360,7 @@ void MapRenderer::renderEntityDecals(
 void MapRenderer::renderEntityLinks(
   RenderContext& renderContext, RenderBatch& renderBatch)
 {
+  const auto setCategory = SetRenderCategory{renderBatch, RenderCategory::Entities};
   m_entityLinkRenderer->render(renderContext, renderBatch);
 }
 
@@ -364,6 +389,8 @@ void MapRenderer::setupDefaultRenderer(ObjectRenderer& renderer)
 
   renderer.setBrushFaceColor(pref(Preferences::FaceColor));
   renderer.setBrushEdgeColor(pref(Preferences::EdgeColor));
+  renderer.setBrushVertexLayout(brushVertexLayout());
+  renderer.setDeduplicateBrushEdges(pref(Preferences::DeduplicateBrushEdges));
 }
 
 void MapRenderer::setupSelectionRenderer(ObjectRenderer& renderer)
@@ -389,6 +416,8 @@ void MapRenderer::setupSelectionRenderer(ObjectRenderer& renderer)
 
   renderer.setBrushFaceColor(pref(Preferences::FaceColor));
   renderer.setBrushEdgeColor(pref(Preferences::SelectedEdgeColor));
+  renderer.setBrushVertexLayout(brushVertexLayout());
+  renderer.setDeduplicateBrushEdges(pref(Preferences::DeduplicateBrushEdges));
 }
 
 void MapRenderer::setupLockedRenderer(ObjectRenderer& renderer)
@@ -410,6 +439,8 @@ void MapRenderer::setupLockedRenderer(ObjectRenderer& renderer)
 
   renderer.setBrushFaceColor(pref(Preferences::FaceColor));
   renderer.setBrushEdgeColor(pref(Preferences::LockedEdgeColor));
+  renderer.setBrushVertexLayout(brushVertexLayout());
+  renderer.setDeduplicateBrushEdges(pref(Preferences::DeduplicateBrushEdges));
 }
 
 static bool selected(const mdl::Node* node)
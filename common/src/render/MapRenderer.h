@@ -21,6 +21,7 @@
 
 #include "Macros.h"
 #include "NotifierConnection.h"
+#include "render/FrustumCulling.h"
 
 #include <filesystem>
 #include <memory>
@@ -70,6 +71,8 @@ private:
   std::unique_ptr<EntityLinkRenderer> m_entityLinkRenderer;
   std::unique_ptr<GroupLinkRenderer> m_groupLinkRenderer;
 
+  VisibleSet m_visibleSet;
+
   enum class Renderer
   {
     Default = 1,
@@ -97,6 +100,7 @@ public: // rendering
 
 private:
   void clear();
+  void updateVisibleSet(RenderContext& renderContext);
   void setupGL(RenderBatch& renderBatch);
   void renderDefaultOpaque(RenderContext& renderContext, RenderBatch& renderBatch);
   void renderDefaultTransparent(RenderContext& renderContext, RenderBatch& renderBatch);
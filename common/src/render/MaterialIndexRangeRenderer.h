@@ -44,6 +44,12 @@ public:
 
   virtual void prepare(VboManager& vboManager) = 0;
   virtual void render(MaterialRenderFunc& func) = 0;
+
+  /**
+   * Renders the given number of instances of this renderer's primitives. The per
+   * instance vertex attributes must have been set up by the caller.
+   */
+  virtual void renderInstanced(MaterialRenderFunc& func, size_t instanceCount) = 0;
 };
 
 class MaterialIndexRangeRenderer : public MaterialRenderer
@@ -63,6 +69,7 @@ public:
 
   void prepare(VboManager& vboManager) override;
   void render(MaterialRenderFunc& func) override;
+  void renderInstanced(MaterialRenderFunc& func, size_t instanceCount) override;
 };
 
 class MultiMaterialIndexRangeRenderer : public MaterialRenderer
@@ -79,6 +86,7 @@ public:
 
   void prepare(VboManager& vboManager) override;
   void render(MaterialRenderFunc& func) override;
+  void renderInstanced(MaterialRenderFunc& func, size_t instanceCount) override;
 };
 
 } // namespace tb::render
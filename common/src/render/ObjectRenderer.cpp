@@ -20,6 +20,7 @@
 #include "ObjectRenderer.h"
 
 #include "mdl/GroupNode.h"
+#include "render/RenderBatch.h"
 
 #include "kdl/overload.h"
 
@@ -201,6 +202,16 @@ void ObjectRenderer::setBrushEdgeColor(const Color& brushEdgeColor)
   m_patchRenderer.setEdgeColor(brushEdgeColor);
 }
 
+void ObjectRenderer::setBrushVertexLayout(const BrushVertexLayout brushVertexLayout)
+{
+  m_brushRenderer.setVertexLayout(brushVertexLayout);
+}
+
+void ObjectRenderer::setDeduplicateBrushEdges(const bool deduplicateBrushEdges)
+{
+  m_brushRenderer.setDeduplicateEdges(deduplicateBrushEdges);
+}
+
 void ObjectRenderer::setShowHiddenObjects(const bool showHiddenObjects)
 {
   m_entityRenderer.setShowHiddenEntities(showHiddenObjects);
@@ -209,8 +220,13 @@ void ObjectRenderer::setShowHiddenObjects(const bool showHiddenObjects)
 
 void ObjectRenderer::renderOpaque(RenderContext& renderContext, RenderBatch& renderBatch)
 {
-  m_brushRenderer.renderOpaque(renderContext, renderBatch);
-  m_patchRenderer.render(renderContext, renderBatch);
+  {
+    const auto setCategory = SetRenderCategory{renderBatch, RenderCategory::Brushes};
+    m_brushRenderer.renderOpaque(renderContext, renderBatch);
+    m_patchRenderer.render(renderContext, renderBatch);
+  }
+
+  const auto setCategory = SetRenderCategory{renderBatch, RenderCategory::Entities};
   m_entityRenderer.render(renderContext, renderBatch);
   m_groupRenderer.render(renderContext, renderBatch);
 }
@@ -218,6 +234,7 @@ void ObjectRenderer::renderOpaque(RenderContext& renderContext, RenderBatch& ren
 void ObjectRenderer::renderTransparent(
   RenderContext& renderContext, RenderBatch& renderBatch)
 {
+  const auto setCategory = SetRenderCategory{renderBatch, RenderCategory::Brushes};
   m_brushRenderer.renderTransparent(renderContext, renderBatch);
 }
 
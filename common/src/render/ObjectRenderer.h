@@ -27,6 +27,11 @@
 
 #include <vector>
 
+namespace kdl
+{
+class task_manager;
+}
+
 namespace tb
 {
 class Color;
@@ -64,12 +69,14 @@ public:
     Logger& logger,
     mdl::EntityModelManager& entityModelManager,
     const mdl::EditorContext& editorContext,
+    kdl::task_manager& taskManager,
     const BrushFilterT& brushFilter)
     : m_groupRenderer{editorContext}
     , m_entityRenderer{logger, entityModelManager, editorContext}
     , m_brushRenderer{brushFilter}
     , m_patchRenderer{editorContext}
   {
+    m_brushRenderer.setTaskManager(taskManager);
   }
 
 public: // object management
@@ -108,6 +115,8 @@ public: // configuration
   void setShowBrushEdges(bool showBrushEdges);
   void setBrushFaceColor(const Color& brushFaceColor);
   void setBrushEdgeColor(const Color& brushEdgeColor);
+  void setBrushVertexLayout(BrushVertexLayout brushVertexLayout);
+  void setDeduplicateBrushEdges(bool deduplicateBrushEdges);
 
   void setShowHiddenObjects(bool showHiddenObjects);
 
@@ -75,6 +75,7 @@ void RenderBatch::add(DirectRenderable* renderable)
 {
   doAdd(renderable);
   m_directRenderables.push_back(renderable);
+  m_directCategories.push_back(m_category);
 }
 
 void RenderBatch::add(IndexedRenderable* renderable)
@@ -82,6 +83,7 @@ void RenderBatch::add(IndexedRenderable* renderable)
   auto* wrapper = new IndexedRenderableWrapper{m_vboManager, *renderable};
   doAdd(wrapper);
   m_indexedRenderables.push_back(wrapper);
+  m_indexedCategories.push_back(m_category);
 }
 
 void RenderBatch::addOneShot(Renderable* renderable)
@@ -94,6 +96,7 @@ void RenderBatch::addOneShot(DirectRenderable* renderable)
 {
   doAdd(renderable);
   m_directRenderables.push_back(renderable);
+  m_directCategories.push_back(m_category);
   m_oneshots.push_back(renderable);
 }
 
@@ -102,9 +105,17 @@ void RenderBatch::addOneShot(IndexedRenderable* renderable)
   auto* wrapper = new IndexedRenderableWrapper{m_vboManager, *renderable};
   doAdd(wrapper);
   m_indexedRenderables.push_back(wrapper);
+  m_indexedCategories.push_back(m_category);
   m_oneshots.push_back(renderable);
 }
 
+RenderCategory RenderBatch::setCategory(const RenderCategory category)
+{
+  const auto previous = m_category;
+  m_category = category;
+  return previous;
+}
+
 void RenderBatch::render(RenderContext& renderContext)
 {
   prepareRenderables();
@@ -115,26 +126,42 @@ void RenderBatch::doAdd(Renderable* renderable)
 {
   ensure(renderable != nullptr, "renderable is null");
   m_batch.push_back(renderable);
+  m_batchCategories.push_back(m_category);
 }
 
 void RenderBatch::prepareRenderables()
 {
-  for (auto* renderable : m_directRenderables)
+  for (size_t i = 0; i < m_directRenderables.size(); ++i)
   {
-    renderable->prepareVertices(m_vboManager);
+    const auto timer = ScopedRenderTimer{m_directCategories[i], RenderPhase::Prepare};
+    m_directRenderables[i]->prepareVertices(m_vboManager);
   }
-  for (auto* renderable : m_indexedRenderables)
+  for (size_t i = 0; i < m_indexedRenderables.size(); ++i)
   {
-    renderable->prepareVerticesAndIndices(m_vboManager);
+    const auto timer = ScopedRenderTimer{m_indexedCategories[i], RenderPhase::Prepare};
+    m_indexedRenderables[i]->prepareVerticesAndIndices(m_vboManager);
   }
 }
 
 void RenderBatch::renderRenderables(RenderContext& renderContext)
 {
-  for (auto* renderable : m_batch)
+  for (size_t i = 0; i < m_batch.size(); ++i)
   {
-    renderable->render(renderContext);
+    const auto timer = ScopedRenderTimer{m_batchCategories[i], RenderPhase::Render};
+    m_batch[i]->render(renderContext);
   }
 }
 
+SetRenderCategory::SetRenderCategory(
+  RenderBatch& renderBatch, const RenderCategory category)
+  : m_renderBatch{renderBatch}
+  , m_previous{m_renderBatch.setCategory(category)}
+{
+}
+
+SetRenderCategory::~SetRenderCategory()
+{
+  m_renderBatch.setCategory(m_previous);
+}
+
 } // namespace tb::render
@@ -19,6 +19,8 @@
 
 #pragma once
 
+#include "render/RenderStatistics.h"
+
 #include <vector>
 
 namespace tb::render
@@ -44,6 +46,12 @@ private:
   RenderableList m_batch;
   RenderableList m_oneshots;
 
+  // the render category of each renderable, for collecting render statistics
+  RenderCategory m_category = RenderCategory::Guides;
+  std::vector<RenderCategory> m_directCategories;
+  std::vector<RenderCategory> m_indexedCategories;
+  std::vector<RenderCategory> m_batchCategories;
+
 public:
   explicit RenderBatch(VboManager& vboManager);
   ~RenderBatch();
@@ -60,6 +68,12 @@ public:
   void addOneShot(DirectRenderable* renderable);
   void addOneShot(IndexedRenderable* renderable);
 
+  /**
+   * Sets the category that renderables added after this call are attributed to in the
+   * render statistics and returns the previous category.
+   */
+  RenderCategory setCategory(RenderCategory category);
+
   void render(RenderContext& renderContext);
 
 private:
@@ -70,4 +84,21 @@ private:
   void renderRenderables(RenderContext& renderContext);
 };
 
+/**
+ * Sets the category of a render batch for the lifetime of this object.
+ */
+class SetRenderCategory
+{
+private:
+  RenderBatch& m_renderBatch;
+  RenderCategory m_previous;
+
+public:
+  SetRenderCategory(RenderBatch& renderBatch, RenderCategory category);
+  ~SetRenderCategory();
+
+  SetRenderCategory(const SetRenderCategory&) = delete;
+  SetRenderCategory& operator=(const SetRenderCategory&) = delete;
+};
+
 } // namespace tb::render
@@ -279,6 +279,16 @@ void RenderContext::setForceHideSelectionGuide()
   setShowSelectionGuide(ShowSelectionGuide::ForceHide);
 }
 
+const VisibleSet* RenderContext::visibleSet() const
+{
+  return m_visibleSet;
+}
+
+void RenderContext::setVisibleSet(const VisibleSet* visibleSet)
+{
+  m_visibleSet = visibleSet;
+}
+
 void RenderContext::setShowSelectionGuide(const ShowSelectionGuide showSelectionGuide)
 {
   switch (showSelectionGuide)
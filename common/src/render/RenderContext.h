@@ -30,6 +30,7 @@ namespace tb::render
 class Camera;
 class FontManager;
 class ShaderManager;
+class VisibleSet;
 
 enum class RenderMode
 {
@@ -84,6 +85,8 @@ private:
   ShowSelectionGuide m_showSelectionGuide = ShowSelectionGuide::Hide;
   vm::bbox3f m_softMapBounds;
 
+  const VisibleSet* m_visibleSet = nullptr;
+
 public:
   RenderContext(
     RenderMode renderMode,
@@ -162,6 +165,13 @@ public:
   void setForceShowSelectionGuide();
   void setForceHideSelectionGuide();
 
+  /**
+   * Returns the nodes that intersect the view frustum, or nullptr if no culling was
+   * performed, in which case all nodes are considered visible.
+   */
+  const VisibleSet* visibleSet() const;
+  void setVisibleSet(const VisibleSet* visibleSet);
+
 private:
   void setShowSelectionGuide(ShowSelectionGuide showSelectionGuide);
 };
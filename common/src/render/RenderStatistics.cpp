@@ -0,0 +1,252 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "RenderStatistics.h"
+
+#include "Macros.h"
+
+#include "kdl/reflection_impl.h"
+
+#include <fmt/format.h>
+
+#include <cassert>
+#include <ostream>
+
+namespace tb::render
+{
+namespace
+{
+
+constexpr auto AllCategories = std::array<RenderCategory, RenderCategoryCount>{
+  RenderCategory::Brushes,
+  RenderCategory::Entities,
+  RenderCategory::EntityModels,
+  RenderCategory::Text,
+  RenderCategory::Guides,
+};
+
+} // namespace
+
+std::string_view renderCategoryName(const RenderCategory category)
+{
+  switch (category)
+  {
+  case RenderCategory::Brushes:
+    return "brushes";
+  case RenderCategory::Entities:
+    return "entities";
+  case RenderCategory::EntityModels:
+    return "models";
+  case RenderCategory::Text:
+    return "text";
+  case RenderCategory::Guides:
+    return "guides";
+    switchDefault();
+  }
+}
+
+RenderCategoryStats& RenderCategoryStats::operator+=(const RenderCategoryStats& other)
+{
+  validateMs += other.validateMs;
+  prepareMs += other.prepareMs;
+  renderMs += other.renderMs;
+  vertices += other.vertices;
+  indices += other.indices;
+  bytesUploaded += other.bytesUploaded;
+  drawCalls += other.drawCalls;
+  return *this;
+}
+
+kdl_reflect_impl(RenderCategoryStats);
+
+void RenderStatistics::beginFrame()
+{
+  m_currentFrame = {};
+  m_category = RenderCategory::Guides;
+}
+
+void RenderStatistics::endFrame()
+{
+  m_lastFrame = m_currentFrame;
+  ++m_frameCount;
+}
+
+RenderCategory RenderStatistics::category() const
+{
+  return m_category;
+}
+
+RenderCategory RenderStatistics::setCategory(const RenderCategory category)
+{
+  const auto previous = m_category;
+  m_category = category;
+  return previous;
+}
+
+void RenderStatistics::addTime(
+  const RenderCategory category, const RenderPhase phase, const double ms)
+{
+  auto& stats = m_currentFrame[size_t(category)];
+  switch (phase)
+  {
+  case RenderPhase::Validate:
+    stats.validateMs += ms;
+    break;
+  case RenderPhase::Prepare:
+    stats.prepareMs += ms;
+    break;
+  case RenderPhase::Render:
+    stats.renderMs += ms;
+    break;
+    switchDefault();
+  }
+}
+
+void RenderStatistics::addDrawCall(const size_t vertices, const size_t indices)
+{
+  auto& stats = m_currentFrame[size_t(m_category)];
+  stats.vertices += vertices;
+  stats.indices += indices;
+  ++stats.drawCalls;
+}
+
+void RenderStatistics::addUpload(const size_t bytes)
+{
+  m_currentFrame[size_t(m_category)].bytesUploaded += bytes;
+}
+
+size_t RenderStatistics::frameCount() const
+{
+  return m_frameCount;
+}
+
+const RenderCategoryStats& RenderStatistics::lastFrame(
+  const RenderCategory category) const
+{
+  return m_lastFrame[size_t(category)];
+}
+
+RenderCategoryStats RenderStatistics::lastFrameTotal() const
+{
+  auto total = RenderCategoryStats{};
+  for (const auto& stats : m_lastFrame)
+  {
+    total += stats;
+  }
+  return total;
+}
+
+std::vector<std::string> RenderStatistics::summary() const
+{
+  const auto formatLine = [](const auto& name, const RenderCategoryStats& stats) {
+    return fmt::format(
+      "{:<8} validate {:6.2f}ms prepare {:6.2f}ms render {:6.2f}ms | {} draws, {} "
+      "vertices, {} indices, {} KiB uploaded",
+      name,
+      stats.validateMs,
+      stats.prepareMs,
+      stats.renderMs,
+      stats.drawCalls,
+      stats.vertices,
+      stats.indices,
+      stats.bytesUploaded / 1024u);
+  };
+
+  auto result = std::vector<std::string>{};
+  for (const auto category : AllCategories)
+  {
+    result.push_back(formatLine(renderCategoryName(category), lastFrame(category)));
+  }
+  result.push_back(formatLine("total", lastFrameTotal()));
+  return result;
+}
+
+void RenderStatistics::writeCsvHeader(std::ostream& str)
+{
+  str << "frame,category,validate_ms,prepare_ms,render_ms,draw_calls,vertices,indices,"
+         "bytes_uploaded\n";
+}
+
+void RenderStatistics::writeCsvRows(std::ostream& str) const
+{
+  assert(m_frameCount > 0);
+
+  for (const auto category : AllCategories)
+  {
+    const auto& stats = lastFrame(category);
+    str << fmt::format(
+      "{},{},{:.3f},{:.3f},{:.3f},{},{},{},{}\n",
+      m_frameCount - 1,
+      renderCategoryName(category),
+      stats.validateMs,
+      stats.prepareMs,
+      stats.renderMs,
+      stats.drawCalls,
+      stats.vertices,
+      stats.indices,
+      stats.bytesUploaded);
+  }
+}
+
+ActivateRenderStatistics::ActivateRenderStatistics(RenderStatistics* statistics)
+  : m_statistics{statistics}
+  , m_previous{RenderStatistics::s_active}
+{
+  RenderStatistics::s_active = m_statistics;
+  if (m_statistics)
+  {
+    m_statistics->beginFrame();
+  }
+}
+
+ActivateRenderStatistics::~ActivateRenderStatistics()
+{
+  if (m_statistics)
+  {
+    m_statistics->endFrame();
+  }
+  RenderStatistics::s_active = m_previous;
+}
+
+ScopedRenderTimer::ScopedRenderTimer(
+  const RenderCategory category, const RenderPhase phase)
+  : m_statistics{RenderStatistics::active()}
+  , m_category{category}
+  , m_phase{phase}
+  , m_previousCategory{category}
+{
+  if (m_statistics)
+  {
+    m_previousCategory = m_statistics->setCategory(m_category);
+    m_start = Clock::now();
+  }
+}
+
+ScopedRenderTimer::~ScopedRenderTimer()
+{
+  if (m_statistics)
+  {
+    const auto elapsed =
+      std::chrono::duration<double, std::milli>{Clock::now() - m_start}.count();
+    m_statistics->addTime(m_category, m_phase, elapsed);
+    m_statistics->setCategory(m_previousCategory);
+  }
+}
+
+} // namespace tb::render
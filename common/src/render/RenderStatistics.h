@@ -0,0 +1,201 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "kdl/reflection_decl.h"
+
+#include <array>
+#include <chrono>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tb::render
+{
+
+/**
+ * The renderers that render statistics are collected for. Everything that is not
+ * attributed to one of the map renderers is counted as a guide.
+ */
+enum class RenderCategory
+{
+  Brushes,
+  Entities,
+  EntityModels,
+  Text,
+  Guides,
+};
+
+inline constexpr auto RenderCategoryCount = size_t(5);
+
+std::string_view renderCategoryName(RenderCategory category);
+
+enum class RenderPhase
+{
+  Validate,
+  Prepare,
+  Render,
+};
+
+struct RenderCategoryStats
+{
+  double validateMs = 0.0;
+  double prepareMs = 0.0;
+  double renderMs = 0.0;
+  size_t vertices = 0;
+  size_t indices = 0;
+  size_t bytesUploaded = 0;
+  size_t drawCalls = 0;
+
+  RenderCategoryStats& operator+=(const RenderCategoryStats& other);
+
+  kdl_reflect_decl(
+    RenderCategoryStats,
+    validateMs,
+    prepareMs,
+    renderMs,
+    vertices,
+    indices,
+    bytesUploaded,
+    drawCalls);
+};
+
+/**
+ * Collects per frame statistics for each render category.
+ *
+ * Statistics are only collected while an instance is active, see
+ * ActivateRenderStatistics. If no instance is active, the counting functions below and
+ * ScopedRenderTimer do nothing but check a pointer.
+ */
+class RenderStatistics
+{
+private:
+  static inline RenderStatistics* s_active = nullptr;
+
+  std::array<RenderCategoryStats, RenderCategoryCount> m_currentFrame;
+  std::array<RenderCategoryStats, RenderCategoryCount> m_lastFrame;
+  RenderCategory m_category = RenderCategory::Guides;
+  size_t m_frameCount = 0;
+
+public:
+  /**
+   * Returns the instance that is currently collecting statistics or null if statistics
+   * are disabled.
+   */
+  static RenderStatistics* active() { return s_active; }
+
+  void beginFrame();
+  void endFrame();
+
+  RenderCategory category() const;
+
+  /**
+   * Sets the category that subsequent draw calls and uploads are attributed to and
+   * returns the previous category.
+   */
+  RenderCategory setCategory(RenderCategory category);
+
+  void addTime(RenderCategory category, RenderPhase phase, double ms);
+  void addDrawCall(size_t vertices, size_t indices);
+  void addUpload(size_t bytes);
+
+  /**
+   * The number of frames that were completed by calling endFrame.
+   */
+  size_t frameCount() const;
+
+  const RenderCategoryStats& lastFrame(RenderCategory category) const;
+  RenderCategoryStats lastFrameTotal() const;
+
+  /**
+   * Returns one human readable line per category for the last frame.
+   */
+  std::vector<std::string> summary() const;
+
+  static void writeCsvHeader(std::ostream& str);
+
+  /**
+   * Writes one row per category for the last frame.
+   */
+  void writeCsvRows(std::ostream& str) const;
+
+  friend class ActivateRenderStatistics;
+};
+
+/**
+ * Makes the given statistics active for the lifetime of this object and brackets a
+ * frame. Passing null disables statistics collection.
+ */
+class ActivateRenderStatistics
+{
+private:
+  RenderStatistics* m_statistics;
+  RenderStatistics* m_previous;
+
+public:
+  explicit ActivateRenderStatistics(RenderStatistics* statistics);
+  ~ActivateRenderStatistics();
+
+  ActivateRenderStatistics(const ActivateRenderStatistics&) = delete;
+  ActivateRenderStatistics& operator=(const ActivateRenderStatistics&) = delete;
+};
+
+/**
+ * Measures the CPU time of its own lifetime and adds it to the given category and phase
+ * of the active statistics. Draw calls and uploads during its lifetime are attributed to
+ * the given category.
+ */
+class ScopedRenderTimer
+{
+private:
+  using Clock = std::chrono::steady_clock;
+
+  RenderStatistics* m_statistics;
+  RenderCategory m_category;
+  RenderPhase m_phase;
+  RenderCategory m_previousCategory;
+  Clock::time_point m_start;
+
+public:
+  ScopedRenderTimer(RenderCategory category, RenderPhase phase);
+  ~ScopedRenderTimer();
+
+  ScopedRenderTimer(const ScopedRenderTimer&) = delete;
+  ScopedRenderTimer& operator=(const ScopedRenderTimer&) = delete;
+};
+
+inline void countDrawCall(const size_t vertices, const size_t indices)
+{
+  if (auto* statistics = RenderStatistics::active())
+  {
+    statistics->addDrawCall(vertices, indices);
+  }
+}
+
+inline void countUpload(const size_t bytes)
+{
+  if (auto* statistics = RenderStatistics::active())
+  {
+    statistics->addUpload(bytes);
+  }
+}
+
+} // namespace tb::render
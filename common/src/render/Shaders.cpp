@@ -52,12 +52,24 @@ const ShaderConfig EntityModelShader = ShaderConfig{
   {"MapBounds.fragsh", "EntityModel.fragsh"},
 };
 
+const ShaderConfig EntityModelInstancedShader = ShaderConfig{
+  "Entity Model (instanced)",
+  {"EntityModelInstanced.vertsh"},
+  {"MapBounds.fragsh", "EntityModel.fragsh"},
+};
+
 const ShaderConfig FaceShader = ShaderConfig{
   "Face",
   {"Face.vertsh"},
   {"Grid.fragsh", "MapBounds.fragsh", "Face.fragsh"},
 };
 
+const ShaderConfig FacePackedShader = ShaderConfig{
+  "Face (packed vertices)",
+  {"FacePacked.vertsh"},
+  {"Grid.fragsh", "MapBounds.fragsh", "Face.fragsh"},
+};
+
 const ShaderConfig PatchShader = ShaderConfig{
   "Patch",
   {"Face.vertsh"},
@@ -29,7 +29,9 @@ extern const ShaderConfig VaryingPCShader;
 extern const ShaderConfig VaryingPUniformCShader;
 extern const ShaderConfig MiniMapEdgeShader;
 extern const ShaderConfig EntityModelShader;
+extern const ShaderConfig EntityModelInstancedShader;
 extern const ShaderConfig FaceShader;
+extern const ShaderConfig FacePackedShader;
 extern const ShaderConfig PatchShader;
 extern const ShaderConfig EdgeShader;
 extern const ShaderConfig ColoredTextShader;
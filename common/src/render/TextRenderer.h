@@ -27,6 +27,7 @@
 
 #include "vm/vec.h"
 
+#include <memory>
 #include <vector>
 
 namespace tb::render
@@ -34,6 +35,7 @@ namespace tb::render
 class AttrString;
 class RenderContext;
 class TextAnchor;
+struct TextLayout;
 
 class TextRenderer : public DirectRenderable
 {
@@ -46,8 +48,7 @@ private:
 
   struct Entry
   {
-    std::vector<vm::vec2f> vertices;
-    vm::vec2f size;
+    std::shared_ptr<const TextLayout> layout;
     vm::vec3f offset;
     Color textColor;
     Color backgroundColor;
@@ -103,17 +104,15 @@ private:
     const TextAnchor& position,
     bool onTop);
 
-  bool isVisible(
-    RenderContext& renderContext,
-    const AttrString& string,
-    const TextAnchor& position,
-    float distance,
-    bool onTop) const;
+  bool isInViewRange(
+    const RenderContext& renderContext, float distance, bool onTop) const;
+  bool isInViewport(
+    const RenderContext& renderContext,
+    const vm::vec2f& size,
+    const TextAnchor& position) const;
   float computeAlphaFactor(
     const RenderContext& renderContext, float distance, bool onTop) const;
-  void addEntry(EntryCollection& collection, const Entry& entry);
-
-  vm::vec2f stringSize(RenderContext& renderContext, const AttrString& string) const;
+  void addEntry(EntryCollection& collection, Entry entry);
 
 private:
   void doPrepareVertices(VboManager& vboManager) override;
@@ -31,6 +31,12 @@
 
 namespace tb::render
 {
+namespace
+{
+
+constexpr auto MaxCachedLayouts = size_t(4096);
+
+} // namespace
 
 TextureFont::TextureFont(
   std::unique_ptr<FontTexture> texture,
@@ -266,6 +272,30 @@ vm::vec2f TextureFont::measure(const std::string& string) const
   return result;
 }
 
+std::shared_ptr<const TextLayout> TextureFont::layout(const AttrString& string) const
+{
+  if (const auto it = m_layoutCache.find(string); it != m_layoutCache.end())
+  {
+    auto& cachedLayout = it->second;
+    m_layoutCacheUseOrder.splice(
+      m_layoutCacheUseOrder.end(), m_layoutCacheUseOrder, cachedLayout.usePosition);
+    return cachedLayout.layout;
+  }
+
+  if (m_layoutCache.size() >= MaxCachedLayouts)
+  {
+    m_layoutCache.erase(*m_layoutCacheUseOrder.front());
+    m_layoutCacheUseOrder.pop_front();
+  }
+
+  auto layout =
+    std::make_shared<const TextLayout>(TextLayout{quads(string, true), measure(string)});
+  const auto it = m_layoutCache.emplace(string, CachedLayout{layout, {}}).first;
+  it->second.usePosition =
+    m_layoutCacheUseOrder.insert(m_layoutCacheUseOrder.end(), &it->first);
+  return layout;
+}
+
 void TextureFont::activate()
 {
   m_texture->activate();
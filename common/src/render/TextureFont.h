@@ -20,19 +20,31 @@
 #pragma once
 
 #include "Macros.h"
+#include "render/AttrString.h"
 
 #include "vm/vec.h"
 
+#include <list>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
 
 namespace tb::render
 {
-class AttrString;
 class FontGlyph;
 class FontTexture;
 
+/**
+ * The clockwise glyph quads of a string and its size, see TextureFont::quads and
+ * TextureFont::measure.
+ */
+struct TextLayout
+{
+  std::vector<vm::vec2f> quads;
+  vm::vec2f size;
+};
+
 class TextureFont
 {
 private:
@@ -45,6 +57,19 @@ private:
   unsigned char m_firstChar;
   unsigned char m_charCount;
 
+  struct CachedLayout
+  {
+    std::shared_ptr<const TextLayout> layout;
+    std::list<const AttrString*>::iterator usePosition;
+  };
+
+  mutable std::map<AttrString, CachedLayout> m_layoutCache;
+
+  /**
+   * The keys of m_layoutCache, ordered from the least to the most recently used.
+   */
+  mutable std::list<const AttrString*> m_layoutCacheUseOrder;
+
 public:
   TextureFont(
     std::unique_ptr<FontTexture> texture,
@@ -74,6 +99,14 @@ public:
     const vm::vec2f& offset = vm::vec2f{0, 0}) const;
   vm::vec2f measure(const std::string& string) const;
 
+  /**
+   * Returns the layout of the given string. Layouts are cached by string, so that labels
+   * that are drawn every frame are only laid out once. If the cache holds more than a
+   * fixed number of strings, the least recently used layout is evicted, so transient
+   * strings do not displace labels that are drawn every frame.
+   */
+  std::shared_ptr<const TextLayout> layout(const AttrString& string) const;
+
   void activate();
   void deactivate();
 };
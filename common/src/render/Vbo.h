@@ -20,6 +20,7 @@
 #pragma once
 
 #include "render/GL.h"
+#include "render/RenderStatistics.h"
 #include "render/VboManager.h"
 
 #include <cassert>
@@ -103,6 +104,7 @@ public:
     const auto sizei = static_cast<GLsizeiptr>(size);
     glAssert(glBindBuffer(m_type, m_bufferId));
     glAssert(glBufferSubData(m_type, offset, sizei, ptr));
+    countUpload(size);
 
     return size;
   }
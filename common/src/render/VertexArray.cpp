@@ -20,11 +20,26 @@
 #include "VertexArray.h"
 
 #include "render/PrimType.h"
+#include "render/RenderStatistics.h"
 
 #include <cassert>
 
 namespace tb::render
 {
+namespace
+{
+
+size_t countVertices(const GLCounts& counts, const GLint primCount)
+{
+  auto result = size_t(0);
+  for (GLint i = 0; i < primCount; ++i)
+  {
+    result += size_t(counts[size_t(i)]);
+  }
+  return result;
+}
+
+} // namespace
 
 VertexArray::BaseHolder::~BaseHolder() = default;
 
@@ -95,12 +110,14 @@ void VertexArray::render(const PrimType primType, const GLint index, const GLsiz
     if (setup())
     {
       glAssert(glDrawArrays(toGL(primType), index, count));
+      countDrawCall(size_t(count), 0);
       cleanup();
     }
   }
   else
   {
     glAssert(glDrawArrays(toGL(primType), index, count));
+    countDrawCall(size_t(count), 0);
   }
 }
 
@@ -118,6 +135,7 @@ void VertexArray::render(
       const auto* indexArray = indices.data();
       const auto* countArray = counts.data();
       glAssert(glMultiDrawArrays(toGL(primType), indexArray, countArray, primCount));
+      countDrawCall(countVertices(counts, primCount), 0);
       cleanup();
     }
   }
@@ -126,6 +144,7 @@ void VertexArray::render(
     const auto* indexArray = indices.data();
     const auto* countArray = counts.data();
     glAssert(glMultiDrawArrays(toGL(primType), indexArray, countArray, primCount));
+    countDrawCall(countVertices(counts, primCount), 0);
   }
 }
 
@@ -139,6 +158,7 @@ void VertexArray::render(
     {
       const auto* indexArray = indices.data();
       glAssert(glDrawElements(toGL(primType), count, GL_UNSIGNED_INT, indexArray));
+      countDrawCall(0, size_t(count));
       cleanup();
     }
   }
@@ -146,6 +166,39 @@ void VertexArray::render(
   {
     const auto* indexArray = indices.data();
     glAssert(glDrawElements(toGL(primType), count, GL_UNSIGNED_INT, indexArray));
+    countDrawCall(0, size_t(count));
+  }
+}
+
+void VertexArray::renderInstanced(
+  const PrimType primType,
+  const GLIndices& indices,
+  const GLCounts& counts,
+  const GLint primCount,
+  const GLsizei instanceCount)
+{
+  assert(prepared());
+
+  const auto doRender = [&]() {
+    for (GLint i = 0; i < primCount; ++i)
+    {
+      glAssert(glDrawArraysInstancedARB(
+        toGL(primType), indices[size_t(i)], counts[size_t(i)], instanceCount));
+      countDrawCall(size_t(counts[size_t(i)]) * size_t(instanceCount), 0);
+    }
+  };
+
+  if (!m_setup)
+  {
+    if (setup())
+    {
+      doRender();
+      cleanup();
+    }
+  }
+  else
+  {
+    doRender();
   }
 }
 
@@ -322,6 +322,24 @@ public:
    * @param count the number of vertices to render
    */
   void render(PrimType primType, const GLIndices& indices, GLsizei count);
+
+  /**
+   * Renders the given number of instances of a number of sub ranges of this vertex array.
+   * The ranges are specified like in the render method above. Requires instancing
+   * support, see glSupportsInstancing.
+   *
+   * @param primType the primitive type to render
+   * @param indices the start indices of the ranges to render
+   * @param counts the lengths of the ranges to render
+   * @param primCount the number of ranges to render
+   * @param instanceCount the number of instances to render
+   */
+  void renderInstanced(
+    PrimType primType,
+    const GLIndices& indices,
+    const GLCounts& counts,
+    GLint primCount,
+    GLsizei instanceCount);
   void cleanup();
 
 private:
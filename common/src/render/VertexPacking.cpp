@@ -0,0 +1,78 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "VertexPacking.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace tb::render
+{
+namespace
+{
+
+float signNotZero(const float value)
+{
+  return value >= 0.0f ? 1.0f : -1.0f;
+}
+
+GLshort quantize(const float value)
+{
+  return static_cast<GLshort>(std::round(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+}
+
+} // namespace
+
+vm::vec<GLshort, 2> encodeOctahedralNormal(const vm::vec3f& normal)
+{
+  const auto l1Norm =
+    std::abs(normal.x()) + std::abs(normal.y()) + std::abs(normal.z());
+  auto x = normal.x() / l1Norm;
+  auto y = normal.y() / l1Norm;
+
+  if (normal.z() < 0.0f)
+  {
+    // fold the lower hemisphere over the diagonals
+    const auto foldedX = (1.0f - std::abs(y)) * signNotZero(x);
+    const auto foldedY = (1.0f - std::abs(x)) * signNotZero(y);
+    x = foldedX;
+    y = foldedY;
+  }
+
+  return {quantize(x), quantize(y)};
+}
+
+vm::vec3f decodeOctahedralNormal(const vm::vec<GLshort, 2>& encoded)
+{
+  auto x = float(encoded.x()) / 32767.0f;
+  auto y = float(encoded.y()) / 32767.0f;
+  const auto z = 1.0f - std::abs(x) - std::abs(y);
+
+  if (z < 0.0f)
+  {
+    const auto unfoldedX = (1.0f - std::abs(y)) * signNotZero(x);
+    const auto unfoldedY = (1.0f - std::abs(x)) * signNotZero(y);
+    x = unfoldedX;
+    y = unfoldedY;
+  }
+
+  return vm::normalize(vm::vec3f{x, y, z});
+}
+
+} // namespace tb::render
@@ -0,0 +1,41 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "render/GL.h"
+
+#include "vm/vec.h"
+
+namespace tb::render
+{
+
+/**
+ * Encodes the given unit vector by projecting it onto an octahedron and unfolding the
+ * octahedron into a square. The resulting coordinates are quantized to 16 bit signed
+ * integers, where 32767 represents 1.
+ */
+vm::vec<GLshort, 2> encodeOctahedralNormal(const vm::vec3f& normal);
+
+/**
+ * Decodes a unit vector encoded with encodeOctahedralNormal.
+ */
+vm::vec3f decodeOctahedralNormal(const vm::vec<GLshort, 2>& encoded);
+
+} // namespace tb::render
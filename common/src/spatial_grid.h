@@ -0,0 +1,318 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "vm/bbox.h"
+#include "vm/vec.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace tb
+{
+namespace detail
+{
+
+using cell_address = vm::vec<int64_t, 3>;
+
+struct cell_address_hash
+{
+  size_t operator()(const cell_address& address) const
+  {
+    auto result = std::hash<int64_t>{}(address.x());
+    result = result * 31u + std::hash<int64_t>{}(address.y());
+    result = result * 31u + std::hash<int64_t>{}(address.z());
+    return result;
+  }
+};
+
+inline int64_t floor_div(const int64_t a, const int64_t b)
+{
+  return a >= 0 ? a / b : (a - b + 1) / b;
+}
+
+} // namespace detail
+
+/**
+ * A sparse uniform grid that maps points to data items. Only occupied cells are stored.
+ * The cells are grouped into cubic blocks so that queries can reject entire blocks
+ * before looking at their cells.
+ *
+ * Every data item is stored at a point and can have an extent, which is the maximum
+ * distance from its point that the item covers. Queries that are interested in the
+ * shape of the items rather than just their points must take the extent into account.
+ *
+ * Unlike octree, the grid does not treat items that lie on the coordinate planes
+ * specially, which makes it suitable for indexing points with integer coordinates.
+ *
+ * @tparam T the floating point type
+ * @tparam U the data to store in the cells, must be equality comparable
+ */
+template <typename T, typename U>
+class spatial_grid
+{
+private:
+  static constexpr int64_t block_size = 8;
+
+  struct entry
+  {
+    vm::vec<T, 3> point;
+    U data;
+  };
+
+  struct grid_cell
+  {
+    std::vector<entry> entries;
+    T max_extent = T(0);
+  };
+
+  struct grid_block
+  {
+    std::vector<detail::cell_address> cells;
+    T max_extent = T(0);
+  };
+
+  using cell_map =
+    std::unordered_map<detail::cell_address, grid_cell, detail::cell_address_hash>;
+  using block_map =
+    std::unordered_map<detail::cell_address, grid_block, detail::cell_address_hash>;
+
+  T m_cell_size;
+  cell_map m_cells;
+  block_map m_blocks;
+  size_t m_size = 0;
+
+public:
+  /**
+   * Creates a new empty grid with the given cell size.
+   *
+   * @param cell_size the edge length of the grid cells, must be positive
+   */
+  explicit spatial_grid(const T cell_size)
+    : m_cell_size{cell_size}
+  {
+    assert(m_cell_size > T(0));
+  }
+
+  /**
+   * Inserts the given data item at the given point.
+   *
+   * @param point the point at which to insert the data item
+   * @param extent the extent of the data item
+   * @param data the data item
+   */
+  void insert(const vm::vec<T, 3>& point, const T extent, U data)
+  {
+    const auto address = get_address(point);
+    auto& cell = m_cells[address];
+    auto& block = m_blocks[get_block_address(address)];
+    if (cell.entries.empty())
+    {
+      block.cells.push_back(address);
+    }
+
+    cell.entries.push_back(entry{point, std::move(data)});
+    cell.max_extent = std::max(cell.max_extent, extent);
+    block.max_extent = std::max(block.max_extent, extent);
+
+    ++m_size;
+  }
+
+  /**
+   * Removes the given data item, which must have been inserted at the given point.
+   *
+   * @param point the point at which the data item was inserted
+   * @param data the data item to remove
+   * @return true if the data item was removed, and false otherwise
+   */
+  bool remove(const vm::vec<T, 3>& point, const U& data)
+  {
+    const auto address = get_address(point);
+    const auto i_cell = m_cells.find(address);
+    if (i_cell == m_cells.end())
+    {
+      return false;
+    }
+
+    auto& entries = i_cell->second.entries;
+    const auto i_entry = std::find_if(
+      entries.begin(), entries.end(), [&](const auto& e) { return e.data == data; });
+    if (i_entry == entries.end())
+    {
+      return false;
+    }
+
+    *i_entry = std::move(entries.back());
+    entries.pop_back();
+    --m_size;
+
+    if (entries.empty())
+    {
+      m_cells.erase(i_cell);
+
+      const auto i_block = m_blocks.find(get_block_address(address));
+      assert(i_block != m_blocks.end());
+
+      auto& cells = i_block->second.cells;
+      const auto i_address = std::find(cells.begin(), cells.end(), address);
+      assert(i_address != cells.end());
+
+      *i_address = cells.back();
+      cells.pop_back();
+
+      if (cells.empty())
+      {
+        m_blocks.erase(i_block);
+      }
+    }
+
+    return true;
+  }
+
+  /**
+   * Removes all data items from this grid.
+   */
+  void clear()
+  {
+    m_cells.clear();
+    m_blocks.clear();
+    m_size = 0;
+  }
+
+  /**
+   * Indicates whether this grid is empty.
+   */
+  bool empty() const { return m_size == 0; }
+
+  /**
+   * Returns the number of data items stored in this grid.
+   */
+  size_t size() const { return m_size; }
+
+  /**
+   * Finds every data item whose point is within the given epsilon of the given point in
+   * every component and appends it to the given output iterator.
+   *
+   * @tparam O the output iterator type
+   * @param point the point to search at
+   * @param epsilon the maximum distance per component
+   * @param out the output iterator to append to
+   */
+  template <typename O>
+  void find_near(const vm::vec<T, 3>& point, const T epsilon, O out) const
+  {
+    const auto bounds = vm::bbox<T, 3>{point, point}.expand(epsilon);
+    const auto min = get_address(bounds.min);
+    const auto max = get_address(bounds.max);
+
+    for (auto x = min.x(); x <= max.x(); ++x)
+    {
+      for (auto y = min.y(); y <= max.y(); ++y)
+      {
+        for (auto z = min.z(); z <= max.z(); ++z)
+        {
+          if (const auto i_cell = m_cells.find({x, y, z}); i_cell != m_cells.end())
+          {
+            for (const auto& e : i_cell->second.entries)
+            {
+              if (bounds.contains(e.point))
+              {
+                out++ = e.data;
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * Finds every data item in a cell that satisfies the given predicate and appends it to
+   * the given output iterator.
+   *
+   * The predicate is called with the bounds of a block or cell and the largest extent of
+   * the data items stored in it. The cells of a block are only tested if the block
+   * satisfies the predicate, so the predicate must not accept a cell if it rejects the
+   * block containing it.
+   *
+   * @tparam P the predicate type, must accept a const vm::bbox<T, 3>& and a T
+   * @tparam O the output iterator type
+   * @param predicate the predicate to test the block and cell bounds with
+   * @param out the output iterator to append to
+   */
+  template <typename P, typename O>
+  void find_if(const P& predicate, O out) const
+  {
+    for (const auto& [block_address, block] : m_blocks)
+    {
+      if (predicate(get_block_bounds(block_address), block.max_extent))
+      {
+        for (const auto& address : block.cells)
+        {
+          const auto& cell = m_cells.at(address);
+          if (predicate(get_cell_bounds(address), cell.max_extent))
+          {
+            for (const auto& e : cell.entries)
+            {
+              out++ = e.data;
+            }
+          }
+        }
+      }
+    }
+  }
+
+private:
+  detail::cell_address get_address(const vm::vec<T, 3>& point) const
+  {
+    return {
+      int64_t(std::floor(point.x() / m_cell_size)),
+      int64_t(std::floor(point.y() / m_cell_size)),
+      int64_t(std::floor(point.z() / m_cell_size))};
+  }
+
+  static detail::cell_address get_block_address(const detail::cell_address& address)
+  {
+    return {
+      detail::floor_div(address.x(), block_size),
+      detail::floor_div(address.y(), block_size),
+      detail::floor_div(address.z(), block_size)};
+  }
+
+  vm::bbox<T, 3> get_cell_bounds(const detail::cell_address& address) const
+  {
+    const auto min = vm::vec<T, 3>{address} * m_cell_size;
+    return {min, min + vm::vec<T, 3>::fill(m_cell_size)};
+  }
+
+  vm::bbox<T, 3> get_block_bounds(const detail::cell_address& address) const
+  {
+    const auto size = m_cell_size * T(block_size);
+    const auto min = vm::vec<T, 3>{address} * size;
+    return {min, min + vm::vec<T, 3>::fill(size)};
+  }
+};
+
+} // namespace tb
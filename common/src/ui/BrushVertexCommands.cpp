@@ -19,26 +19,56 @@
 
 #include "BrushVertexCommands.h"
 
-#include "ui/SwapNodeContentsCommand.h"
+#include "Error.h" // IWYU pragma: keep
+#include "mdl/Brush.h"
+#include "mdl/BrushNode.h"
+#include "ui/MapDocumentCommandFacade.h"
 #include "ui/VertexTool.h"
 
 #include "kdl/range_to_vector.h"
+#include "kdl/result.h"
+#include "kdl/result_fold.h"
+#include "kdl/vector_utils.h"
 
 #include <ranges>
+#include <unordered_map>
 
 namespace tb::ui
 {
+namespace
+{
+
+auto collectBrushNodes(const std::vector<std::pair<mdl::Node*, mdl::NodeContents>>& nodes)
+{
+  return nodes | std::views::filter([](const auto& pair) {
+           return dynamic_cast<mdl::BrushNode*>(pair.first) != nullptr;
+         })
+         | std::views::transform(
+           [](const auto& pair) { return static_cast<mdl::BrushNode*>(pair.first); })
+         | kdl::to_vector;
+}
+
+} // namespace
 
 BrushVertexCommandBase::BrushVertexCommandBase(
   std::string name, std::vector<std::pair<mdl::Node*, mdl::NodeContents>> nodes)
-  : SwapNodeContentsCommand{std::move(name), std::move(nodes)}
+  : UpdateLinkedGroupsCommandBase{std::move(name), true}
+  , m_nodes{std::move(nodes)}
+  , m_brushNodes{collectBrushNodes(m_nodes)}
 {
 }
 
 std::unique_ptr<CommandResult> BrushVertexCommandBase::doPerformDo(
   MapDocumentCommandFacade& document)
 {
-  return createCommandResult(SwapNodeContentsCommand::doPerformDo(document));
+  return createCommandResult(
+    std::make_unique<CommandResult>(swapNodeContents(document, false)));
+}
+
+std::unique_ptr<CommandResult> BrushVertexCommandBase::doPerformUndo(
+  MapDocumentCommandFacade& document)
+{
+  return std::make_unique<CommandResult>(swapNodeContents(document, true));
 }
 
 std::unique_ptr<CommandResult> BrushVertexCommandBase::createCommandResult(
@@ -47,27 +77,99 @@ std::unique_ptr<CommandResult> BrushVertexCommandBase::createCommandResult(
   return swapResult;
 }
 
-static auto collectBrushNodes(
-  const std::vector<std::pair<mdl::Node*, mdl::NodeContents>> nodes)
+bool BrushVertexCommandBase::swapNodeContents(
+  MapDocumentCommandFacade& document, const bool revert)
 {
-  return nodes | std::views::filter([](const auto& pair) {
-           return dynamic_cast<mdl::BrushNode*>(pair.first) != nullptr;
+  const auto& worldBounds = document.worldBounds();
+
+  return m_brushDeltas | std::views::transform([&](const auto& pair) {
+           const auto& [brushNode, delta] = pair;
+           return revert ? delta.revert(worldBounds, brushNode->brush())
+                         : delta.apply(worldBounds, brushNode->brush());
          })
-         | std::views::transform(
-           [](const auto& pair) { return static_cast<mdl::BrushNode*>(pair.first); })
-         | kdl::to_vector;
+         | kdl::fold | kdl::transform([&](auto brushes) {
+             const auto recordDeltas = m_brushDeltas.empty();
+
+             auto nodesToSwap = std::move(m_nodes);
+             for (size_t i = 0; i < brushes.size(); ++i)
+             {
+               nodesToSwap.emplace_back(
+                 m_brushDeltas[i].first, mdl::NodeContents{std::move(brushes[i])});
+             }
+
+             document.performSwapNodeContents(nodesToSwap);
+
+             // only keep the swapped out contents of nodes which aren't brushes
+             m_nodes.clear();
+             for (auto& [node, contents] : nodesToSwap)
+             {
+               if (auto* brushNode = dynamic_cast<mdl::BrushNode*>(node))
+               {
+                 if (recordDeltas)
+                 {
+                   const auto& oldBrush = std::get<mdl::Brush>(contents.get());
+                   m_brushDeltas.emplace_back(
+                     brushNode, mdl::BrushDelta{oldBrush, brushNode->brush()});
+                 }
+               }
+               else
+               {
+                 m_nodes.emplace_back(node, std::move(contents));
+               }
+             }
+             return true;
+           })
+         | kdl::transform_error([&](const auto& e) {
+             document.error() << e.msg;
+             return false;
+           })
+         | kdl::value();
+}
+
+bool BrushVertexCommandBase::doCollateWith(UndoableCommand& command)
+{
+  auto* other = dynamic_cast<BrushVertexCommandBase*>(&command);
+  if (!other)
+  {
+    return false;
+  }
+
+  const auto getNodes = [](const auto& nodes, const auto& brushDeltas) {
+    auto result = kdl::vec_concat(
+      kdl::vec_transform(nodes, [](const auto& pair) { return pair.first; }),
+      kdl::vec_transform(
+        brushDeltas, [](const auto& pair) -> mdl::Node* { return pair.first; }));
+    return kdl::vec_sort(std::move(result));
+  };
+
+  if (
+    getNodes(m_nodes, m_brushDeltas) != getNodes(other->m_nodes, other->m_brushDeltas))
+  {
+    return false;
+  }
+
+  auto otherDeltas = std::unordered_map<const mdl::BrushNode*, const mdl::BrushDelta*>{};
+  for (const auto& [brushNode, delta] : other->m_brushDeltas)
+  {
+    otherDeltas.emplace(brushNode, &delta);
+  }
+
+  for (auto& [brushNode, delta] : m_brushDeltas)
+  {
+    delta = mdl::BrushDelta::compose(delta, *otherDeltas.at(brushNode));
+  }
+
+  return true;
 }
 
 void BrushVertexCommandBase::removeHandles(VertexHandleManagerBase& manager)
 {
-  const auto nodes = collectBrushNodes(m_nodes);
-  manager.removeHandles(std::begin(nodes), std::end(nodes));
+  manager.removeHandles(std::begin(m_brushNodes), std::end(m_brushNodes));
 }
 
 void BrushVertexCommandBase::addHandles(VertexHandleManagerBase& manager)
 {
-  const auto nodes = collectBrushNodes(m_nodes);
-  manager.addHandles(std::begin(nodes), std::end(nodes));
+  manager.addHandles(std::begin(m_brushNodes), std::end(m_brushNodes));
 }
 
 void BrushVertexCommandBase::selectNewHandlePositions(
@@ -129,7 +231,7 @@ bool BrushVertexCommand::doCollateWith(UndoableCommand& command)
 {
   if (auto* other = dynamic_cast<BrushVertexCommand*>(&command);
       other && m_newVertexPositions == other->m_oldVertexPositions
-      && SwapNodeContentsCommand::doCollateWith(command))
+      && BrushVertexCommandBase::doCollateWith(command))
   {
     m_newVertexPositions = std::move(other->m_newVertexPositions);
     return true;
@@ -165,7 +267,7 @@ bool BrushEdgeCommand::doCollateWith(UndoableCommand& command)
 {
   if (auto* other = dynamic_cast<BrushEdgeCommand*>(&command);
       other && m_newEdgePositions == other->m_oldEdgePositions
-      && SwapNodeContentsCommand::doCollateWith(command))
+      && BrushVertexCommandBase::doCollateWith(command))
   {
     m_newEdgePositions = std::move(other->m_newEdgePositions);
     return true;
@@ -201,7 +303,7 @@ bool BrushFaceCommand::doCollateWith(UndoableCommand& command)
 {
   if (auto* other = dynamic_cast<BrushFaceCommand*>(&command);
       other && m_newFacePositions == other->m_oldFacePositions
-      && SwapNodeContentsCommand::doCollateWith(command))
+      && BrushVertexCommandBase::doCollateWith(command))
   {
     m_newFacePositions = std::move(other->m_newFacePositions);
     return true;
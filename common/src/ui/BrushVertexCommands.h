@@ -20,7 +20,9 @@
 #pragma once
 
 #include "Macros.h"
-#include "ui/SwapNodeContentsCommand.h"
+#include "mdl/BrushDelta.h"
+#include "mdl/NodeContents.h"
+#include "ui/UpdateLinkedGroupsCommandBase.h"
 
 #include "vm/polygon.h"
 #include "vm/segment.h"
@@ -29,6 +31,12 @@
 #include <memory>
 #include <vector>
 
+namespace tb::mdl
+{
+class BrushNode;
+class Node;
+} // namespace tb::mdl
+
 namespace tb::ui
 {
 class MapDocument;
@@ -36,17 +44,37 @@ class VertexHandleManagerBase;
 template <typename H>
 class VertexHandleManagerBaseT;
 
-class BrushVertexCommandBase : public SwapNodeContentsCommand
+/**
+ * Base class for commands that move vertices, edges or faces of brushes.
+ *
+ * When the command is performed for the first time, the changes made to each brush are
+ * recorded as a delta, and the old brush is discarded. Undoing and redoing the command
+ * rebuild the brushes from their current faces and the recorded deltas. The contents of
+ * all other nodes are swapped.
+ */
+class BrushVertexCommandBase : public UpdateLinkedGroupsCommandBase
 {
+private:
+  std::vector<std::pair<mdl::Node*, mdl::NodeContents>> m_nodes;
+  std::vector<std::pair<mdl::BrushNode*, mdl::BrushDelta>> m_brushDeltas;
+  std::vector<mdl::BrushNode*> m_brushNodes;
+
 protected:
   BrushVertexCommandBase(
     std::string name, std::vector<std::pair<mdl::Node*, mdl::NodeContents>> nodes);
 
 private:
   std::unique_ptr<CommandResult> doPerformDo(MapDocumentCommandFacade& document) override;
+  std::unique_ptr<CommandResult> doPerformUndo(
+    MapDocumentCommandFacade& document) override;
   virtual std::unique_ptr<CommandResult> createCommandResult(
     std::unique_ptr<CommandResult> swapResult);
 
+  bool swapNodeContents(MapDocumentCommandFacade& document, bool revert);
+
+protected:
+  bool doCollateWith(UndoableCommand& command) override;
+
 public:
   void removeHandles(VertexHandleManagerBase& manager);
   void addHandles(VertexHandleManagerBase& manager);
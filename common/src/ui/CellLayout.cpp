@@ -21,9 +21,65 @@
 
 #include <algorithm>
 #include <cassert>
+#include <iterator>
+#include <utility>
 
 namespace tb::ui
 {
+namespace
+{
+
+struct CellGeometry
+{
+  float scale;
+  LayoutBounds cellBounds;
+  LayoutBounds itemBounds;
+  LayoutBounds titleBounds;
+};
+
+CellGeometry computeCellGeometry(
+  const float x,
+  const float y,
+  const float itemWidth,
+  const float itemHeight,
+  const float titleWidth,
+  const float titleHeight,
+  const float titleMargin,
+  const float maxUpScale,
+  const float minWidth,
+  const float maxWidth,
+  const float minHeight,
+  const float maxHeight)
+{
+  assert(0.0f < minWidth);
+  assert(0.0f < minHeight);
+  assert(minWidth <= maxWidth);
+  assert(minHeight <= maxHeight);
+
+  const auto scale =
+    std::min(std::min(maxWidth / itemWidth, maxHeight / itemHeight), maxUpScale);
+  const auto scaledItemWidth = scale * itemWidth;
+  const auto scaledItemHeight = scale * itemHeight;
+  const auto clippedTitleWidth = std::min(titleWidth, maxWidth);
+  const auto cellWidth = std::max(minWidth, std::max(scaledItemWidth, clippedTitleWidth));
+  const auto cellHeight = std::max(
+    minHeight, std::max(minHeight, scaledItemHeight) + titleHeight + titleMargin);
+  const auto itemY =
+    y + std::max(0.0f, cellHeight - titleHeight - scaledItemHeight - titleMargin);
+
+  const auto cellBounds = LayoutBounds{x, y, cellWidth, cellHeight};
+  const auto itemBounds = LayoutBounds{
+    x + (cellWidth - scaledItemWidth) / 2.0f, itemY, scaledItemWidth, scaledItemHeight};
+  const auto titleBounds = LayoutBounds{
+    x + (cellWidth - clippedTitleWidth) / 2.0f,
+    itemBounds.bottom() + titleMargin,
+    clippedTitleWidth,
+    titleHeight};
+
+  return {scale, cellBounds, itemBounds, titleBounds};
+}
+
+} // namespace
 
 float LayoutBounds::left() const
 {
@@ -145,36 +201,29 @@ void LayoutCell::doLayout(
   const float minHeight,
   const float maxHeight)
 {
-  assert(0.0f < minWidth);
-  assert(0.0f < minHeight);
-  assert(minWidth <= maxWidth);
-  assert(minHeight <= maxHeight);
+  const auto geometry = computeCellGeometry(
+    m_x,
+    m_y,
+    m_itemWidth,
+    m_itemHeight,
+    m_titleWidth,
+    m_titleHeight,
+    m_titleMargin,
+    maxUpScale,
+    minWidth,
+    maxWidth,
+    minHeight,
+    maxHeight);
 
-  m_scale =
-    std::min(std::min(maxWidth / m_itemWidth, maxHeight / m_itemHeight), maxUpScale);
-  const auto scaledItemWidth = m_scale * m_itemWidth;
-  const auto scaledItemHeight = m_scale * m_itemHeight;
-  const auto clippedTitleWidth = std::min(m_titleWidth, maxWidth);
-  const auto cellWidth = std::max(minWidth, std::max(scaledItemWidth, clippedTitleWidth));
-  const auto cellHeight = std::max(
-    minHeight, std::max(minHeight, scaledItemHeight) + m_titleHeight + m_titleMargin);
-  const auto itemY =
-    m_y + std::max(0.0f, cellHeight - m_titleHeight - scaledItemHeight - m_titleMargin);
-
-  m_cellBounds = LayoutBounds{m_x, m_y, cellWidth, cellHeight};
-  m_itemBounds = LayoutBounds{
-    m_x + (m_cellBounds.width - scaledItemWidth) / 2.0f,
-    itemY,
-    scaledItemWidth,
-    scaledItemHeight};
-  m_titleBounds = LayoutBounds{
-    m_x + (m_cellBounds.width - clippedTitleWidth) / 2.0f,
-    m_itemBounds.bottom() + m_titleMargin,
-    clippedTitleWidth,
-    m_titleHeight};
+  m_scale = geometry.scale;
+  m_cellBounds = geometry.cellBounds;
+  m_itemBounds = geometry.itemBounds;
+  m_titleBounds = geometry.titleBounds;
 }
 
 LayoutRow::LayoutRow(
+  const std::vector<LayoutItem>& items,
+  const size_t firstItem,
   const float x,
   const float y,
   const float cellMargin,
@@ -186,7 +235,9 @@ LayoutRow::LayoutRow(
   const float maxCellWidth,
   const float minCellHeight,
   const float maxCellHeight)
-  : m_cellMargin{cellMargin}
+  : m_items{&items}
+  , m_firstItem{firstItem}
+  , m_cellMargin{cellMargin}
   , m_titleMargin{titleMargin}
   , m_maxWidth{maxWidth}
   , m_maxCells{maxCells}
@@ -204,16 +255,52 @@ const LayoutBounds& LayoutRow::bounds() const
   return m_bounds;
 }
 
+size_t LayoutRow::itemCount() const
+{
+  return m_itemCount;
+}
+
 const std::vector<LayoutCell>& LayoutRow::cells() const
 {
+  if (m_cells.size() != m_itemCount)
+  {
+    m_cells.clear();
+    m_cells.reserve(m_itemCount);
+
+    auto x = m_bounds.left();
+    for (size_t i = m_firstItem; i < m_firstItem + m_itemCount; ++i)
+    {
+      const auto& item = (*m_items)[i];
+      m_cells.emplace_back(
+        item.item,
+        item.title,
+        x,
+        m_bounds.top(),
+        item.itemWidth,
+        item.itemHeight,
+        item.titleWidth,
+        item.titleHeight,
+        m_titleMargin,
+        m_maxUpScale,
+        m_minCellWidth,
+        m_maxCellWidth,
+        m_minCellHeight,
+        m_maxCellHeight);
+      x = m_cells.back().cellBounds().right() + m_cellMargin;
+    }
+  }
   return m_cells;
 }
 
 const LayoutCell* LayoutRow::cellAt(const float x, const float y) const
 {
-  for (size_t i = 0; i < m_cells.size(); ++i)
+  if (!m_bounds.containsPoint(x, y))
+  {
+    return nullptr;
+  }
+
+  for (const auto& cell : cells())
   {
-    const auto& cell = m_cells[i];
     const auto& cellBounds = cell.cellBounds();
     if (x > cellBounds.right())
     {
@@ -236,42 +323,19 @@ bool LayoutRow::intersectsY(const float y, const float height) const
   return m_bounds.intersectsY(y, height);
 }
 
-bool LayoutRow::canAddItem(
-  const float itemWidth,
-  const float itemHeight,
-  const float titleWidth,
-  const float titleHeight) const
+bool LayoutRow::canAddItem(const LayoutItem& item) const
 {
-  auto x = m_bounds.right();
-  auto width = m_bounds.width;
-  if (!m_cells.empty())
+  auto width = m_bounds.width + cellWidth(item);
+  if (m_itemCount > 0)
   {
-    x += m_cellMargin;
     width += m_cellMargin;
   }
 
-  auto cell = LayoutCell{
-    std::any{},
-    "",
-    x,
-    m_bounds.top(),
-    itemWidth,
-    itemHeight,
-    titleWidth,
-    titleHeight,
-    m_titleMargin,
-    m_maxUpScale,
-    m_minCellWidth,
-    m_maxCellWidth,
-    m_minCellHeight,
-    m_maxCellHeight};
-  width += cell.cellBounds().width;
-
-  if (m_maxCells == 0 && width > m_maxWidth && !m_cells.empty())
+  if (m_maxCells == 0 && width > m_maxWidth && m_itemCount > 0)
   {
     return false;
   }
-  if (m_maxCells > 0 && m_cells.size() >= m_maxCells - 1)
+  if (m_maxCells > 0 && m_itemCount >= m_maxCells - 1)
   {
     return false;
   }
@@ -279,64 +343,71 @@ bool LayoutRow::canAddItem(
   return true;
 }
 
-void LayoutRow::addItem(
-  std::any item,
-  std::string title,
-  const float itemWidth,
-  const float itemHeight,
-  const float titleWidth,
-  const float titleHeight)
+void LayoutRow::addItem(const LayoutItem& item)
 {
-  float x = m_bounds.right();
-  float width = m_bounds.width;
-  if (!m_cells.empty())
+  assert(m_firstItem + m_itemCount < m_items->size());
+  assert(&item == &(*m_items)[m_firstItem + m_itemCount]);
+
+  auto width = m_bounds.width + cellWidth(item);
+  if (m_itemCount > 0)
   {
-    x += m_cellMargin;
     width += m_cellMargin;
   }
+  ++m_itemCount;
 
-  auto cell = LayoutCell{
-    std::move(item),
-    std::move(title),
-    x,
-    m_bounds.top(),
-    itemWidth,
-    itemHeight,
-    titleWidth,
-    titleHeight,
-    m_titleMargin,
-    m_maxUpScale,
-    m_minCellWidth,
-    m_maxCellWidth,
-    m_minCellHeight,
-    m_maxCellHeight};
-  width += cell.cellBounds().width;
-
-  const auto newItemRowHeight =
-    cell.cellBounds().height - cell.titleBounds().height - m_titleMargin;
+  // a cell's height without its title determines the minimum height of the row's cells
+  const auto newItemRowHeight = cellHeight(item) - item.titleHeight - m_titleMargin;
+  auto height = std::max(m_bounds.height, cellHeight(item));
   if (newItemRowHeight > m_minCellHeight)
   {
     m_minCellHeight = newItemRowHeight;
     assert(m_minCellHeight <= m_maxCellHeight);
-    readjustItems();
+
+    for (size_t i = m_firstItem; i < m_firstItem + m_itemCount; ++i)
+    {
+      height = std::max(height, cellHeight((*m_items)[i]));
+    }
   }
 
-  m_bounds = LayoutBounds{
-    m_bounds.left(),
-    m_bounds.top(),
-    width,
-    std::max(m_bounds.height, cell.cellBounds().height)};
+  m_bounds = LayoutBounds{m_bounds.left(), m_bounds.top(), width, height};
+  m_cells.clear();
+}
 
-  m_cells.push_back(std::move(cell));
+float LayoutRow::cellWidth(const LayoutItem& item) const
+{
+  // the width of a cell does not depend on its position or on the row's height
+  return computeCellGeometry(
+           0.0f,
+           0.0f,
+           item.itemWidth,
+           item.itemHeight,
+           item.titleWidth,
+           item.titleHeight,
+           m_titleMargin,
+           m_maxUpScale,
+           m_minCellWidth,
+           m_maxCellWidth,
+           m_minCellHeight,
+           m_maxCellHeight)
+    .cellBounds.width;
 }
 
-void LayoutRow::readjustItems()
+float LayoutRow::cellHeight(const LayoutItem& item) const
 {
-  for (auto& cell : m_cells)
-  {
-    cell.updateLayout(
-      m_maxUpScale, m_minCellWidth, m_maxCellWidth, m_minCellHeight, m_maxCellHeight);
-  }
+  return computeCellGeometry(
+           0.0f,
+           0.0f,
+           item.itemWidth,
+           item.itemHeight,
+           item.titleWidth,
+           item.titleHeight,
+           m_titleMargin,
+           m_maxUpScale,
+           m_minCellWidth,
+           m_maxCellWidth,
+           m_minCellHeight,
+           m_maxCellHeight)
+    .cellBounds.height;
 }
 
 LayoutGroup::LayoutGroup(
@@ -366,6 +437,7 @@ LayoutGroup::LayoutGroup(
   , m_maxCellHeight{maxCellHeight}
   , m_titleBounds{0.0f, y, width + 2.0f * x, titleHeight}
   , m_contentBounds{x, y + titleHeight + m_rowMargin, width, 0.0f}
+  , m_items{std::make_unique<std::vector<LayoutItem>>()}
 {
 }
 
@@ -393,6 +465,7 @@ LayoutGroup::LayoutGroup(
   , m_maxCellHeight{maxCellHeight}
   , m_titleBounds{x, y, width, 0.0f}
   , m_contentBounds{x, y, width, 0.0f}
+  , m_items{std::make_unique<std::vector<LayoutItem>>()}
 {
 }
 
@@ -444,42 +517,35 @@ const std::vector<LayoutRow>& LayoutGroup::rows() const
   return m_rows;
 }
 
-size_t LayoutGroup::indexOfRowAt(const float y) const
+std::span<const LayoutRow> LayoutGroup::rowsIntersectingY(
+  const float y, const float height) const
 {
-  for (size_t i = 0; i < m_rows.size(); ++i)
-  {
-    const auto& row = m_rows[i];
-    const auto& rowBounds = row.bounds();
-    if (y < rowBounds.bottom())
-    {
-      return i;
-    }
-  }
+  const auto first = std::partition_point(
+    m_rows.begin(), m_rows.end(), [&](const auto& row) {
+      return row.bounds().bottom() < y;
+    });
+  const auto last = std::partition_point(first, m_rows.end(), [&](const auto& row) {
+    return row.bounds().top() <= y + height;
+  });
+  return {first, last};
+}
 
-  return m_rows.size();
+size_t LayoutGroup::indexOfRowAt(const float y) const
+{
+  const auto it = std::partition_point(
+    m_rows.begin(), m_rows.end(), [&](const auto& row) {
+      return y >= row.bounds().bottom();
+    });
+  return size_t(std::distance(m_rows.begin(), it));
 }
 
 const LayoutCell* LayoutGroup::cellAt(const float x, const float y) const
 {
-  for (size_t i = 0; i < m_rows.size(); ++i)
-  {
-    const auto& row = m_rows[i];
-    const auto& rowBounds = row.bounds();
-    if (y > rowBounds.bottom())
-    {
-      continue;
-    }
-    if (y < rowBounds.top())
-    {
-      return nullptr;
-    }
-    if (const auto* cell = row.cellAt(x, y))
-    {
-      return cell;
-    }
-  }
-
-  return nullptr;
+  const auto it = std::partition_point(
+    m_rows.begin(), m_rows.end(), [&](const auto& row) {
+      return y > row.bounds().bottom();
+    });
+  return it != m_rows.end() ? it->cellAt(x, y) : nullptr;
 }
 
 bool LayoutGroup::hitTest(const float x, const float y) const
@@ -492,18 +558,25 @@ bool LayoutGroup::intersectsY(const float y, const float height) const
   return bounds().intersectsY(y, height);
 }
 
-void LayoutGroup::addItem(
-  std::any item,
-  std::string title,
-  const float itemWidth,
-  const float itemHeight,
-  const float titleWidth,
-  const float titleHeight)
+std::vector<LayoutItem> LayoutGroup::takeItems()
 {
+  m_rows.clear();
+  return std::exchange(*m_items, {});
+}
+
+void LayoutGroup::addItem(LayoutItem item)
+{
+  // adding an item may move the existing items, but the rows only refer to them by index
+  m_items->push_back(std::move(item));
+  const auto& newItem = m_items->back();
+  const auto newItemIndex = m_items->size() - 1;
+
   if (m_rows.empty())
   {
     const auto y = m_contentBounds.top();
     m_rows.emplace_back(
+      *m_items,
+      newItemIndex,
       m_contentBounds.left(),
       y,
       m_cellMargin,
@@ -517,11 +590,13 @@ void LayoutGroup::addItem(
       m_maxCellHeight);
   }
 
-  if (!m_rows.back().canAddItem(itemWidth, itemHeight, titleWidth, titleHeight))
+  if (!m_rows.back().canAddItem(newItem))
   {
     const auto oldBounds = m_rows.back().bounds();
     const auto y = oldBounds.bottom() + m_rowMargin;
     m_rows.emplace_back(
+      *m_items,
+      newItemIndex,
       m_contentBounds.left(),
       y,
       m_cellMargin,
@@ -544,9 +619,8 @@ void LayoutGroup::addItem(
 
   const auto oldRowHeight = m_rows.back().bounds().height;
 
-  assert(m_rows.back().canAddItem(itemWidth, itemHeight, titleWidth, titleHeight));
-  m_rows.back().addItem(
-    std::move(item), std::move(title), itemWidth, itemHeight, titleWidth, titleHeight);
+  assert(m_rows.back().canAddItem(newItem));
+  m_rows.back().addItem(newItem);
 
   const auto newRowHeight = m_rows.back().bounds().height;
   m_contentBounds = LayoutBounds{
@@ -895,8 +969,8 @@ void CellLayout::addItem(
   }
 
   const auto oldGroupHeight = m_groups.back().bounds().height;
-  m_groups.back().addItem(
-    std::move(item), std::move(title), itemWidth, itemHeight, titleWidth, titleHeight);
+  m_groups.back().addItem(LayoutItem{
+    std::move(item), std::move(title), itemWidth, itemHeight, titleWidth, titleHeight});
   const auto newGroupHeight = m_groups.back().bounds().height;
 
   m_height += (newGroupHeight - oldGroupHeight);
@@ -919,29 +993,20 @@ void CellLayout::validate()
   m_valid = true;
   if (!m_groups.empty())
   {
-    auto copy = m_groups;
-    m_groups.clear();
+    auto groups = std::exchange(m_groups, {});
 
-    for (auto& group : copy)
+    for (auto& group : groups)
     {
       addGroup(group.title(), group.titleBounds().height);
-      for (const auto& row : group.rows())
+      for (auto& item : group.takeItems())
       {
-        for (const auto& cell : row.cells())
-        {
-          const auto& itemBounds = cell.itemBounds();
-          const auto& titleBounds = cell.titleBounds();
-          const auto scale = cell.scale();
-          const auto itemWidth = itemBounds.width / scale;
-          const auto itemHeight = itemBounds.height / scale;
-          addItem(
-            cell.item(),
-            cell.title(),
-            itemWidth,
-            itemHeight,
-            titleBounds.width,
-            titleBounds.height);
-        }
+        addItem(
+          std::move(item.item),
+          std::move(item.title),
+          item.itemWidth,
+          item.itemHeight,
+          item.titleWidth,
+          item.titleHeight);
       }
     }
   }
@@ -20,6 +20,8 @@
 #pragma once
 
 #include <any>
+#include <memory>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -42,6 +44,20 @@ struct LayoutBounds
   bool intersectsY(float rangeY, float rangeHeight) const;
 };
 
+/**
+ * The unscaled dimensions of an item as passed to CellLayout::addItem. Groups keep these
+ * so that their rows can be recomputed without materializing any cells.
+ */
+struct LayoutItem
+{
+  std::any item;
+  std::string title;
+  float itemWidth;
+  float itemHeight;
+  float titleWidth;
+  float titleHeight;
+};
+
 class LayoutCell
 {
 private:
@@ -108,9 +124,16 @@ private:
     float maxUpScale, float minWidth, float maxWidth, float minHeight, float maxHeight);
 };
 
+/**
+ * A row only stores the range of items it contains and its bounds. The cells are created
+ * on demand when they are accessed, which usually only happens for the visible rows.
+ */
 class LayoutRow
 {
 private:
+  const std::vector<LayoutItem>* m_items;
+  size_t m_firstItem;
+  size_t m_itemCount = 0;
   float m_cellMargin;
   float m_titleMargin;
   float m_maxWidth;
@@ -122,10 +145,12 @@ private:
   float m_maxCellHeight;
   LayoutBounds m_bounds;
 
-  std::vector<LayoutCell> m_cells;
+  mutable std::vector<LayoutCell> m_cells;
 
 public:
   LayoutRow(
+    const std::vector<LayoutItem>& items,
+    size_t firstItem,
     float x,
     float y,
     float cellMargin,
@@ -140,23 +165,19 @@ public:
 
   const LayoutBounds& bounds() const;
 
+  size_t itemCount() const;
+
   const std::vector<LayoutCell>& cells() const;
   const LayoutCell* cellAt(float x, float y) const;
 
   bool intersectsY(float y, float height) const;
 
-  bool canAddItem(
-    float itemWidth, float itemHeight, float titleWidth, float titleHeight) const;
-  void addItem(
-    std::any item,
-    std::string title,
-    float itemWidth,
-    float itemHeight,
-    float titleWidth,
-    float titleHeight);
+  bool canAddItem(const LayoutItem& item) const;
+  void addItem(const LayoutItem& item);
 
 private:
-  void readjustItems();
+  float cellWidth(const LayoutItem& item) const;
+  float cellHeight(const LayoutItem& item) const;
 };
 
 class LayoutGroup
@@ -175,6 +196,8 @@ private:
   LayoutBounds m_titleBounds;
   LayoutBounds m_contentBounds;
 
+  // the rows refer to the items, so they must not move when the group is moved
+  std::unique_ptr<std::vector<LayoutItem>> m_items;
   std::vector<LayoutRow> m_rows;
 
 public:
@@ -216,19 +239,16 @@ public:
   LayoutBounds bounds() const;
 
   const std::vector<LayoutRow>& rows() const;
+  std::span<const LayoutRow> rowsIntersectingY(float y, float height) const;
   size_t indexOfRowAt(float y) const;
   const LayoutCell* cellAt(float x, float y) const;
 
   bool hitTest(float x, float y) const;
   bool intersectsY(float y, float height) const;
 
-  void addItem(
-    std::any item,
-    std::string title,
-    float itemWidth,
-    float itemHeight,
-    float titleWidth,
-    float titleHeight);
+  std::vector<LayoutItem> takeItems();
+
+  void addItem(LayoutItem item);
 };
 
 class CellLayout
@@ -189,39 +189,41 @@ void EntityBrowserView::resourcesWereProcessed(const std::vector<mdl::ResourceId
   update();
 }
 
+namespace
+{
+bool matchesFilterText(
+  const mdl::PointEntityDefinition& definition,
+  const std::vector<std::string>& filterPatterns)
+{
+  return kdl::all_of(filterPatterns, [&](const auto& pattern) {
+    return kdl::ci::str_contains(definition.name(), pattern);
+  });
+}
+} // namespace
+
 void EntityBrowserView::addEntitiesToLayout(
   Layout& layout,
   const std::vector<mdl::EntityDefinition*>& definitions,
   const render::FontDescriptor& font)
 {
+  const auto filterPatterns = kdl::str_split(m_filterText, " ");
   for (const auto* definition : definitions)
   {
     const auto* pointEntityDefinition =
       static_cast<const mdl::PointEntityDefinition*>(definition);
-    addEntityToLayout(layout, pointEntityDefinition, font);
+    if (matchesFilterText(*pointEntityDefinition, filterPatterns))
+    {
+      addEntityToLayout(layout, pointEntityDefinition, font);
+    }
   }
 }
 
-namespace
-{
-bool matchesFilterText(
-  const mdl::PointEntityDefinition& definition, const std::string& filterText)
-{
-  return filterText.empty()
-         || kdl::all_of(kdl::str_split(filterText, " "), [&](const auto& pattern) {
-              return kdl::ci::str_contains(definition.name(), pattern);
-            });
-}
-} // namespace
-
 void EntityBrowserView::addEntityToLayout(
   Layout& layout,
   const mdl::PointEntityDefinition* definition,
   const render::FontDescriptor& font)
 {
-  if (
-    (!m_hideUnused || definition->usageCount() > 0)
-    && matchesFilterText(*definition, m_filterText))
+  if (!m_hideUnused || definition->usageCount() > 0)
   {
     const auto document = kdl::mem_lock(m_document);
     const auto& entityModelManager = document->entityModelManager();
@@ -328,25 +330,22 @@ void EntityBrowserView::renderBounds(Layout& layout, const float y, const float
   {
     if (group.intersectsY(y, height))
     {
-      for (const auto& row : group.rows())
+      for (const auto& row : group.rowsIntersectingY(y, height))
       {
-        if (row.intersectsY(y, height))
+        for (const auto& cell : row.cells())
         {
-          for (const auto& cell : row.cells())
+          const auto* definition = cellData(cell).entityDefinition;
+          auto* modelRenderer = cellData(cell).modelRenderer;
+
+          if (modelRenderer == nullptr)
           {
-            const auto* definition = cellData(cell).entityDefinition;
-            auto* modelRenderer = cellData(cell).modelRenderer;
-
-            if (modelRenderer == nullptr)
-            {
-              const auto itemTrans = itemTransformation(cell, y, height);
-              const auto& color = definition->color();
-              vm::bbox3f{definition->bounds()}.for_each_edge(
-                [&](const vm::vec3f& v1, const vm::vec3f& v2) {
-                  vertices.emplace_back(itemTrans * v1, color);
-                  vertices.emplace_back(itemTrans * v2, color);
-                });
-            }
+            const auto itemTrans = itemTransformation(cell, y, height);
+            const auto& color = definition->color();
+            vm::bbox3f{definition->bounds()}.for_each_edge(
+              [&](const vm::vec3f& v1, const vm::vec3f& v2) {
+                vertices.emplace_back(itemTrans * v1, color);
+                vertices.emplace_back(itemTrans * v2, color);
+              });
           }
         }
       }
@@ -387,27 +386,23 @@ void EntityBrowserView::renderModels(
   {
     if (group.intersectsY(y, height))
     {
-      for (const auto& row : group.rows())
+      for (const auto& row : group.rowsIntersectingY(y, height))
       {
-        if (row.intersectsY(y, height))
+        for (const auto& cell : row.cells())
         {
-          for (const auto& cell : row.cells())
+          if (auto* modelRenderer = cellData(cell).modelRenderer)
           {
-            if (auto* modelRenderer = cellData(cell).modelRenderer)
-            {
-              shader.set(
-                "Orientation", static_cast<int>(cellData(cell).modelOrientation));
+            shader.set("Orientation", static_cast<int>(cellData(cell).modelOrientation));
 
-              const auto itemTrans = itemTransformation(cell, y, height);
-              shader.set("ModelMatrix", itemTrans);
+            const auto itemTrans = itemTransformation(cell, y, height);
+            shader.set("ModelMatrix", itemTrans);
 
-              const auto multMatrix =
-                render::MultiplyModelMatrix{transformation, itemTrans};
+            const auto multMatrix =
+              render::MultiplyModelMatrix{transformation, itemTrans};
 
-              auto renderFunc = render::DefaultMaterialRenderFunc{
-                pref(Preferences::TextureMinFilter), pref(Preferences::TextureMagFilter)};
-              modelRenderer->render(renderFunc);
-            }
+            auto renderFunc = render::DefaultMaterialRenderFunc{
+              pref(Preferences::TextureMinFilter), pref(Preferences::TextureMagFilter)};
+            modelRenderer->render(renderFunc);
           }
         }
       }
@@ -86,7 +86,9 @@ bool GLContextManager::initialize()
       VaryingPUniformCShader,
       MiniMapEdgeShader,
       EntityModelShader,
+      EntityModelInstancedShader,
       FaceShader,
+      FacePackedShader,
       PatchShader,
       EdgeShader,
       ColoredTextShader,
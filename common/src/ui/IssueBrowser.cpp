@@ -85,12 +85,20 @@ void IssueBrowser::connectObservers()
     this, &IssueBrowser::documentWasNewedOrLoaded);
   m_notifierConnection +=
     document->nodesWereAddedNotifier.connect(this, &IssueBrowser::nodesWereAdded);
+  m_notifierConnection += document->nodesWillBeRemovedNotifier.connect(
+    this, &IssueBrowser::nodesWillBeRemoved);
   m_notifierConnection +=
     document->nodesWereRemovedNotifier.connect(this, &IssueBrowser::nodesWereRemoved);
+  m_notifierConnection +=
+    document->nodesWillChangeNotifier.connect(this, &IssueBrowser::nodesWillChange);
   m_notifierConnection +=
     document->nodesDidChangeNotifier.connect(this, &IssueBrowser::nodesDidChange);
   m_notifierConnection += document->brushFacesDidChangeNotifier.connect(
     this, &IssueBrowser::brushFacesDidChange);
+  m_notifierConnection += document->entityDefinitionsDidChangeNotifier.connect(
+    this, &IssueBrowser::entityDefinitionsDidChange);
+  m_notifierConnection +=
+    document->modsDidChangeNotifier.connect(this, &IssueBrowser::modsDidChange);
 }
 
 void IssueBrowser::documentWasNewedOrLoaded(MapDocument*)
@@ -104,24 +112,46 @@ void IssueBrowser::documentWasSaved(MapDocument*)
   m_view->update();
 }
 
-void IssueBrowser::nodesWereAdded(const std::vector<mdl::Node*>&)
+void IssueBrowser::nodesWereAdded(const std::vector<mdl::Node*>& nodes)
 {
-  m_view->reload();
+  m_view->nodesWereAdded(nodes);
 }
 
-void IssueBrowser::nodesWereRemoved(const std::vector<mdl::Node*>&)
+void IssueBrowser::nodesWillBeRemoved(const std::vector<mdl::Node*>& nodes)
 {
-  m_view->reload();
+  m_view->nodesWillBeRemoved(nodes);
 }
 
-void IssueBrowser::nodesDidChange(const std::vector<mdl::Node*>&)
+void IssueBrowser::nodesWereRemoved(const std::vector<mdl::Node*>& nodes)
 {
-  m_view->reload();
+  m_view->nodesWereRemoved(nodes);
 }
 
-void IssueBrowser::brushFacesDidChange(const std::vector<mdl::BrushFaceHandle>&)
+void IssueBrowser::nodesWillChange(const std::vector<mdl::Node*>& nodes)
 {
-  m_view->reload();
+  m_view->nodesWillChange(nodes);
+}
+
+void IssueBrowser::nodesDidChange(const std::vector<mdl::Node*>& nodes)
+{
+  m_view->nodesDidChange(nodes);
+}
+
+void IssueBrowser::brushFacesDidChange(const std::vector<mdl::BrushFaceHandle>& faces)
+{
+  m_view->brushFacesDidChange(faces);
+}
+
+void IssueBrowser::entityDefinitionsDidChange()
+{
+  // the missing definition validator depends on the entity definitions
+  m_view->revalidateAll();
+}
+
+void IssueBrowser::modsDidChange()
+{
+  // the missing mod validator depends on the mods
+  m_view->revalidateAll();
 }
 
 void IssueBrowser::issueIgnoreChanged(mdl::Issue*)
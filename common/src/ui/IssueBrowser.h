@@ -68,9 +68,13 @@ private:
   void documentWasNewedOrLoaded(MapDocument* document);
   void documentWasSaved(MapDocument* document);
   void nodesWereAdded(const std::vector<mdl::Node*>& nodes);
+  void nodesWillBeRemoved(const std::vector<mdl::Node*>& nodes);
   void nodesWereRemoved(const std::vector<mdl::Node*>& nodes);
+  void nodesWillChange(const std::vector<mdl::Node*>& nodes);
   void nodesDidChange(const std::vector<mdl::Node*>& nodes);
   void brushFacesDidChange(const std::vector<mdl::BrushFaceHandle>& faces);
+  void entityDefinitionsDidChange();
+  void modsDidChange();
   void issueIgnoreChanged(mdl::Issue* issue);
 
   void updateFilterFlags();
@@ -25,23 +25,22 @@
 #include <QMenu>
 #include <QTableView>
 
-#include "mdl/BrushNode.h"
-#include "mdl/EntityNode.h"
-#include "mdl/GroupNode.h"
+#include "mdl/BrushFaceHandle.h"
 #include "mdl/Issue.h"
 #include "mdl/IssueQuickFix.h"
-#include "mdl/LayerNode.h"
-#include "mdl/PatchNode.h"
+#include "mdl/ValidationService.h"
 #include "mdl/WorldNode.h"
 #include "ui/MapDocument.h"
 #include "ui/QtUtils.h"
 #include "ui/Transaction.h"
 
 #include "kdl/memory_utils.h"
-#include "kdl/overload.h"
 #include "kdl/vector_set.h"
 #include "kdl/vector_utils.h"
 
+#include <algorithm>
+#include <iterator>
+#include <unordered_set>
 #include <vector>
 
 namespace tb::ui
@@ -50,11 +49,15 @@ namespace tb::ui
 IssueBrowserView::IssueBrowserView(std::weak_ptr<MapDocument> document, QWidget* parent)
   : QWidget{parent}
   , m_document{std::move(document)}
+  , m_validationService{std::make_unique<mdl::ValidationService>(
+      kdl::mem_lock(m_document)->taskManager())}
 {
   createGui();
   bindEvents();
 }
 
+IssueBrowserView::~IssueBrowserView() = default;
+
 void IssueBrowserView::createGui()
 {
   m_tableModel = new IssueBrowserModel{this};
@@ -97,6 +100,11 @@ void IssueBrowserView::setShowHiddenIssues(const bool show)
 
 void IssueBrowserView::reload()
 {
+  auto document = kdl::mem_lock(m_document);
+  m_validationService->reset(document->world());
+  m_issues.clear();
+  m_tableModel->setIssues({});
+
   invalidate();
 }
 
@@ -105,6 +113,42 @@ void IssueBrowserView::deselectAll()
   m_tableView->clearSelection();
 }
 
+void IssueBrowserView::nodesWereAdded(const std::vector<mdl::Node*>& nodes)
+{
+  removeInvalidatedIssues(m_validationService->nodesWereAdded(nodes));
+}
+
+void IssueBrowserView::nodesWillBeRemoved(const std::vector<mdl::Node*>& nodes)
+{
+  removeInvalidatedIssues(m_validationService->nodesWillBeRemoved(nodes));
+}
+
+void IssueBrowserView::nodesWereRemoved(const std::vector<mdl::Node*>& nodes)
+{
+  removeInvalidatedIssues(m_validationService->nodesWereRemoved(nodes));
+}
+
+void IssueBrowserView::nodesWillChange(const std::vector<mdl::Node*>& nodes)
+{
+  removeInvalidatedIssues(m_validationService->nodesWillChange(nodes));
+}
+
+void IssueBrowserView::nodesDidChange(const std::vector<mdl::Node*>& nodes)
+{
+  removeInvalidatedIssues(m_validationService->nodesDidChange(nodes));
+}
+
+void IssueBrowserView::brushFacesDidChange(
+  const std::vector<mdl::BrushFaceHandle>& faceHandles)
+{
+  removeInvalidatedIssues(m_validationService->brushFacesDidChange(faceHandles));
+}
+
+void IssueBrowserView::revalidateAll()
+{
+  removeInvalidatedIssues(m_validationService->invalidateAll());
+}
+
 /**
  * Updates the MapDocument selection to match the table view
  */
@@ -126,51 +170,45 @@ void IssueBrowserView::updateSelection()
   document->selectNodes(nodes);
 }
 
-void IssueBrowserView::updateIssues()
+void IssueBrowserView::applyIssueDelta(mdl::IssueDelta delta)
 {
-  auto document = kdl::mem_lock(m_document);
-  if (document->world() != nullptr)
+  if (!delta.removedIssues.empty())
   {
-    const auto validators = document->world()->registeredValidators();
+    const auto removedIssues = std::unordered_set<const mdl::Issue*>{
+      delta.removedIssues.begin(), delta.removedIssues.end()};
+    std::erase_if(
+      m_issues, [&](const auto* issue) { return removedIssues.contains(issue); });
+  }
+  m_issues = kdl::vec_concat(std::move(m_issues), std::move(delta.addedIssues));
+}
 
-    auto issues = std::vector<const mdl::Issue*>{};
-    const auto collectIssues = [&](auto* node) {
-      for (auto* issue : node->issues(validators))
-      {
-        if (
-          m_showHiddenIssues
-          || (!issue->hidden() && (issue->type() & m_hiddenIssueTypes) == 0))
-        {
-          issues.push_back(issue);
-        }
-      }
-    };
-
-    document->world()->accept(kdl::overload(
-      [&](auto&& thisLambda, mdl::WorldNode* world) {
-        collectIssues(world);
-        world->visitChildren(thisLambda);
-      },
-      [&](auto&& thisLambda, mdl::LayerNode* layer) {
-        collectIssues(layer);
-        layer->visitChildren(thisLambda);
-      },
-      [&](auto&& thisLambda, mdl::GroupNode* group) {
-        collectIssues(group);
-        group->visitChildren(thisLambda);
-      },
-      [&](auto&& thisLambda, mdl::EntityNode* entity) {
-        collectIssues(entity);
-        entity->visitChildren(thisLambda);
-      },
-      [&](mdl::BrushNode* brush) { collectIssues(brush); },
-      [&](mdl::PatchNode* patch) { collectIssues(patch); }));
-
-    issues = kdl::vec_sort(std::move(issues), [](const auto* lhs, const auto* rhs) {
-      return lhs->seqId() > rhs->seqId();
-    });
-    m_tableModel->setIssues(std::move(issues));
+/**
+ * Removes the issues of invalidated nodes from the table right away, since they may refer
+ * to state that no longer exists, and schedules the validation of these nodes.
+ */
+void IssueBrowserView::removeInvalidatedIssues(mdl::IssueDelta delta)
+{
+  if (!delta.removedIssues.empty())
+  {
+    applyIssueDelta(std::move(delta));
+    updateIssues();
   }
+  invalidate();
+}
+
+void IssueBrowserView::updateIssues()
+{
+  auto issues = std::vector<const mdl::Issue*>{};
+  std::copy_if(
+    m_issues.begin(), m_issues.end(), std::back_inserter(issues), [&](const auto* issue) {
+      return m_showHiddenIssues
+             || (!issue->hidden() && (issue->type() & m_hiddenIssueTypes) == 0);
+    });
+
+  issues = kdl::vec_sort(std::move(issues), [](const auto* lhs, const auto* rhs) {
+    return lhs->seqId() > rhs->seqId();
+  });
+  m_tableModel->setIssues(std::move(issues));
 }
 
 void IssueBrowserView::applyQuickFix(const mdl::IssueQuickFix& quickFix)
@@ -322,16 +360,18 @@ void IssueBrowserView::hideIssues()
 
 void IssueBrowserView::invalidate()
 {
-  m_valid = false;
-  m_tableModel->setIssues({});
-
-  QMetaObject::invokeMethod(this, "validate", Qt::QueuedConnection);
+  if (m_valid)
+  {
+    m_valid = false;
+    QMetaObject::invokeMethod(this, "validate", Qt::QueuedConnection);
+  }
 }
 
 void IssueBrowserView::validate()
 {
   if (!m_valid)
   {
+    applyIssueDelta(m_validationService->validate());
     updateIssues();
     m_valid = true;
   }
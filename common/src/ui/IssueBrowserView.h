@@ -34,8 +34,12 @@ namespace tb
 {
 namespace mdl
 {
+class BrushFaceHandle;
 class Issue;
 class IssueQuickFix;
+class Node;
+class ValidationService;
+struct IssueDelta;
 } // namespace mdl
 
 namespace ui
@@ -48,11 +52,13 @@ class IssueBrowserView : public QWidget
   Q_OBJECT
 private:
   std::weak_ptr<MapDocument> m_document;
+  std::unique_ptr<mdl::ValidationService> m_validationService;
+  std::vector<const mdl::Issue*> m_issues;
 
   int m_hiddenIssueTypes = 0;
   bool m_showHiddenIssues = false;
 
-  bool m_valid = false;
+  bool m_valid = true;
 
   QTableView* m_tableView = nullptr;
   IssueBrowserModel* m_tableModel = nullptr;
@@ -60,6 +66,7 @@ private:
 public:
   explicit IssueBrowserView(
     std::weak_ptr<MapDocument> document, QWidget* parent = nullptr);
+  ~IssueBrowserView() override;
 
 private:
   void createGui();
@@ -71,7 +78,17 @@ public:
   void reload();
   void deselectAll();
 
+  void nodesWereAdded(const std::vector<mdl::Node*>& nodes);
+  void nodesWillBeRemoved(const std::vector<mdl::Node*>& nodes);
+  void nodesWereRemoved(const std::vector<mdl::Node*>& nodes);
+  void nodesWillChange(const std::vector<mdl::Node*>& nodes);
+  void nodesDidChange(const std::vector<mdl::Node*>& nodes);
+  void brushFacesDidChange(const std::vector<mdl::BrushFaceHandle>& faceHandles);
+  void revalidateAll();
+
 private:
+  void applyIssueDelta(mdl::IssueDelta delta);
+  void removeInvalidatedIssues(mdl::IssueDelta delta);
   void updateIssues();
 
   std::vector<const mdl::Issue*> collectIssues(const QList<QModelIndex>& indices) const;
@@ -46,6 +46,26 @@ void Lasso::update(const vm::vec3d& point)
   m_cur = point;
 }
 
+bool Lasso::intersects(const vm::bbox3d& bounds) const
+{
+  const auto plane = getPlane();
+
+  // the projection of the bounds is contained in the bounds of its projected vertices
+  auto builder = vm::bbox2d::builder{};
+  for (const auto& vertex : bounds.vertices())
+  {
+    const auto projected = project(vertex, plane);
+    if (!projected)
+    {
+      // the bounds extend behind the camera
+      return true;
+    }
+    builder.add(vm::vec2d{*projected});
+  }
+
+  return builder.bounds().intersects(getBox(getTransform()));
+}
+
 bool Lasso::selects(
   const vm::vec3d& point, const vm::plane3d& plane, const vm::bbox2d& box) const
 {
@@ -48,6 +48,16 @@ public:
 
   void update(const vm::vec3d& point);
 
+  /**
+   * Indicates whether the given bounds may contain a point that is selected by this
+   * lasso. This test is conservative: it can return true for bounds that do not contain
+   * any selected point, but it never returns false for bounds that do.
+   *
+   * @param bounds the bounds to test
+   * @return false if the given bounds cannot contain any selected point
+   */
+  bool intersects(const vm::bbox3d& bounds) const;
+
   template <typename I, typename O>
   void selected(I cur, I end, O out) const
   {
@@ -79,6 +79,8 @@
 #include "mdl/NodeContents.h"
 #include "mdl/NodeQueries.h"
 #include "mdl/NonIntegerVerticesValidator.h"
+#include "mdl/ParallelTraversal.h"
+#include "mdl/PatchGridCache.h"
 #include "mdl/PatchNode.h"
 #include "mdl/PointEntityWithBrushesValidator.h"
 #include "mdl/Polyhedron.h"
@@ -138,12 +140,15 @@
 #include <algorithm>
 #include <cassert>
 #include <cstdlib>
+#include <functional>
+#include <iterator>
 #include <map>
 #include <ranges>
 #include <sstream>
 #include <string>
 #include <type_traits>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 
@@ -153,6 +158,13 @@ namespace tb::ui
 namespace
 {
 
+/**
+ * Evictable resources that were requested during this many recent resource processing
+ * calls are kept resident. Resources are processed every 20ms, so this amounts to
+ * about five seconds.
+ */
+constexpr auto MinIdleTicksBeforeEviction = size_t(250);
+
 template <typename T>
 auto collectContainingGroups(const std::vector<T*>& nodes)
 {
@@ -389,22 +401,23 @@ const std::string MapDocument::DefaultDocumentName("unnamed.map");
 
 MapDocument::MapDocument(kdl::task_manager& taskManager)
   : m_taskManager{taskManager}
-  , m_resourceManager{std::make_unique<mdl::ResourceManager>()}
+  , m_resourceManager{std::make_unique<mdl::ResourceManager>(
+      mdl::defaultMaxConcurrentLoads(m_taskManager.worker_count()))}
   , m_entityDefinitionManager{std::make_unique<mdl::EntityDefinitionManager>()}
   , m_entityModelManager{std::make_unique<mdl::EntityModelManager>(
       [&](auto resourceLoader) {
-        auto resource =
-          std::make_shared<mdl::EntityModelDataResource>(std::move(resourceLoader));
-        m_resourceManager->addResource(resource);
-        return resource;
+        return m_resourceManager->addResource(
+          std::make_shared<mdl::EntityModelDataResource>(std::move(resourceLoader)));
       },
       logger())}
   , m_materialManager{std::make_unique<mdl::MaterialManager>(logger())}
   , m_tagManager{std::make_unique<mdl::TagManager>()}
+  , m_patchGridCache{std::make_unique<mdl::PatchGridCache>()}
   , m_editorContext{std::make_unique<mdl::EditorContext>()}
   , m_grid{std::make_unique<Grid>(4)}
   , m_repeatStack{std::make_unique<RepeatStack>()}
 {
+  updateResidencyBudget();
   connectObservers();
 }
 
@@ -555,6 +568,11 @@ mdl::MaterialManager& MapDocument::materialManager()
   return *m_materialManager;
 }
 
+mdl::PatchGridCache& MapDocument::patchGridCache()
+{
+  return *m_patchGridCache;
+}
+
 Grid& MapDocument::grid() const
 {
   return *m_grid;
@@ -575,6 +593,11 @@ void MapDocument::setViewEffectsService(ViewEffectsService* viewEffectsService)
   m_viewEffectsService = viewEffectsService;
 }
 
+const NodeChangeStats& MapDocument::nodeChangeStats() const
+{
+  return m_nodeChangeBatch.stats();
+}
+
 void MapDocument::createTagActions()
 {
   const auto& actionManager = ActionManager::instance();
@@ -1465,29 +1488,21 @@ void MapDocument::selectInverse()
   // we treat it as partially selected and don't want to try to select the entity if the
   // selection is inverted, which would reselect both children.
 
-  auto nodesToSelect = std::vector<mdl::Node*>{};
-  const auto collectNode = [&](auto* node) {
-    if (
-      !node->transitivelySelected() && !node->descendantSelected()
-      && m_editorContext->selectable(node))
-    {
-      nodesToSelect.push_back(node);
-    }
-  };
-
-  currentGroupOrWorld()->accept(kdl::overload(
-    [](auto&& thisLambda, mdl::WorldNode* world) { world->visitChildren(thisLambda); },
-    [](auto&& thisLambda, mdl::LayerNode* layer) { layer->visitChildren(thisLambda); },
-    [&](auto&& thisLambda, mdl::GroupNode* group) {
-      collectNode(group);
-      group->visitChildren(thisLambda);
-    },
-    [&](auto&& thisLambda, mdl::EntityNode* entity) {
-      collectNode(entity);
-      entity->visitChildren(thisLambda);
+  const auto nodesToSelect = mdl::parallelVisitAllAndReduce(
+    std::vector<mdl::Node*>{currentGroupOrWorld()},
+    taskManager(),
+    std::vector<mdl::Node*>{},
+    [&](std::vector<mdl::Node*>& nodes, auto* node) {
+      if (
+        !node->transitivelySelected() && !node->descendantSelected()
+        && m_editorContext->selectable(node))
+      {
+        nodes.push_back(node);
+      }
     },
-    [&](mdl::BrushNode* brush) { collectNode(brush); },
-    [&](mdl::PatchNode* patch) { collectNode(patch); }));
+    [](std::vector<mdl::Node*> lhs, std::vector<mdl::Node*> rhs) {
+      return kdl::vec_concat(std::move(lhs), std::move(rhs));
+    });
 
   auto transaction = Transaction{*this, "Select Inverse"};
   deselectAll();
@@ -1601,8 +1616,8 @@ void MapDocument::selectFacesWithMaterial(const mdl::Material* material)
 
 void MapDocument::selectBrushesWithMaterial(const mdl::Material* material)
 {
-  const auto selectableNodes =
-    mdl::collectSelectableNodes(std::vector<mdl::Node*>{m_world.get()}, *m_editorContext);
+  const auto selectableNodes = mdl::collectSelectableNodes(
+    std::vector<mdl::Node*>{m_world.get()}, *m_editorContext, taskManager());
   const auto brushes =
     selectableNodes | std::views::filter([&](const auto& node) {
       return std::ranges::any_of(
@@ -1708,6 +1723,49 @@ void MapDocument::invalidateSelectionBounds()
   m_selectionBoundsValid = false;
 }
 
+/**
+ * Updates the selection bounds after the given nodes were added to the selection.
+ *
+ * Layers don't contribute to the selection bounds, so if the selection contains layers,
+ * the current bounds may just be a default value and we fall back to recomputing them.
+ */
+void MapDocument::extendSelectionBounds(const std::vector<mdl::Node*>& selectedNodes)
+{
+  if (
+    m_selectionBoundsValid && m_selectedNodes.nodeCount() > selectedNodes.size()
+    && !m_selectedNodes.hasLayers())
+  {
+    m_selectionBounds = vm::merge(
+      m_selectionBounds, computeLogicalBounds(selectedNodes, m_selectionBounds));
+  }
+  else
+  {
+    invalidateSelectionBounds();
+  }
+}
+
+/**
+ * Updates the selection bounds after the given nodes were removed from the selection.
+ *
+ * The bounds remain unchanged if the deselected nodes don't touch their boundary.
+ * Otherwise, the selection has shrunk and the bounds must be recomputed.
+ */
+void MapDocument::shrinkSelectionBounds(const std::vector<mdl::Node*>& deselectedNodes)
+{
+  if (deselectedNodes.empty())
+  {
+    return;
+  }
+
+  if (
+    !m_selectionBoundsValid || m_selectedNodes.empty() || m_selectedNodes.hasLayers()
+    || !m_selectionBounds.encloses(
+      computeLogicalBounds(deselectedNodes, m_selectionBounds)))
+  {
+    invalidateSelectionBounds();
+  }
+}
+
 void MapDocument::validateSelectionBounds() const
 {
   m_selectionBounds = computeLogicalBounds(m_selectedNodes.nodes());
@@ -2909,7 +2967,7 @@ void MapDocument::setOmitLayerFromExport(
 void MapDocument::selectAllInLayers(const std::vector<mdl::LayerNode*>& layers)
 {
   const auto nodes = mdl::collectSelectableNodes(
-    kdl::vec_static_cast<mdl::Node*>(layers), editorContext());
+    kdl::vec_static_cast<mdl::Node*>(layers), editorContext(), taskManager());
 
   deselectAll();
   selectNodes(nodes);
@@ -4381,8 +4439,10 @@ const std::string& MapDocument::redoCommandName() const
 
 void MapDocument::undoCommand()
 {
+  m_nodeChangeBatch.begin(TransactionScope::Oneshot);
   doUndoCommand();
   updateLinkedGroups();
+  m_nodeChangeBatch.end();
 
   // Undo/redo in the repeat system is not supported for now, so just clear the repeat
   // stack
@@ -4391,8 +4451,10 @@ void MapDocument::undoCommand()
 
 void MapDocument::redoCommand()
 {
+  m_nodeChangeBatch.begin(TransactionScope::Oneshot);
   doRedoCommand();
   updateLinkedGroups();
+  m_nodeChangeBatch.end();
 
   // Undo/redo in the repeat system is not supported for now, so just clear the repeat
   // stack
@@ -4417,6 +4479,7 @@ void MapDocument::clearRepeatableCommands()
 void MapDocument::startTransaction(std::string name, const TransactionScope scope)
 {
   debug("Starting transaction '" + name + "'");
+  m_nodeChangeBatch.begin(scope);
   doStartTransaction(std::move(name), scope);
   m_repeatStack->startTransaction();
 }
@@ -4438,6 +4501,7 @@ bool MapDocument::commitTransaction()
     return false;
   }
 
+  m_nodeChangeBatch.end();
   doCommitTransaction();
   m_repeatStack->commitTransaction();
   return true;
@@ -4448,19 +4512,26 @@ void MapDocument::cancelTransaction()
   debug("Cancelling transaction");
   doRollbackTransaction();
   m_repeatStack->rollbackTransaction();
+  m_nodeChangeBatch.end();
   doCommitTransaction();
   m_repeatStack->commitTransaction();
 }
 
 std::unique_ptr<CommandResult> MapDocument::execute(std::unique_ptr<Command>&& command)
 {
-  return doExecute(std::move(command));
+  m_nodeChangeBatch.begin(TransactionScope::Oneshot);
+  auto result = doExecute(std::move(command));
+  m_nodeChangeBatch.end();
+  return result;
 }
 
 std::unique_ptr<CommandResult> MapDocument::executeAndStore(
   std::unique_ptr<UndoableCommand>&& command)
 {
-  return doExecuteAndStore(std::move(command));
+  m_nodeChangeBatch.begin(TransactionScope::Oneshot);
+  auto result = doExecuteAndStore(std::move(command));
+  m_nodeChangeBatch.end();
+  return result;
 }
 
 void MapDocument::processResourcesSync(const mdl::ProcessContext& processContext)
@@ -4507,6 +4578,20 @@ bool MapDocument::needsResourceProcessing()
   return m_resourceManager->needsProcessing();
 }
 
+void MapDocument::updateResidencyBudget()
+{
+  const auto budgetInMegabytes = pref(Preferences::TextureResidencyBudget);
+  if (budgetInMegabytes > 0)
+  {
+    m_resourceManager->setResidencyBudget(mdl::ResidencyBudget{
+      size_t(budgetInMegabytes) * 1024 * 1024, MinIdleTicksBeforeEviction});
+  }
+  else
+  {
+    m_resourceManager->setResidencyBudget(std::nullopt);
+  }
+}
+
 void MapDocument::pick(const vm::ray3d& pickRay, mdl::PickResult& pickResult) const
 {
   if (m_world)
@@ -4583,26 +4668,31 @@ void MapDocument::setEntityDefinitions(
 
 void MapDocument::reloadMaterialCollections()
 {
-  const auto nodes = std::vector<mdl::Node*>{m_world.get()};
-  NotifyBeforeAndAfter notifyNodes(
-    nodesWillChangeNotifier, nodesDidChangeNotifier, nodes);
-  NotifyBeforeAndAfter notifyMaterialCollections(
-    materialCollectionsWillChangeNotifier, materialCollectionsDidChangeNotifier);
+  // the nodes whose materials change are delivered in a single notification
+  m_nodeChangeBatch.begin(TransactionScope::Oneshot);
+  {
+    NotifyBeforeAndAfter notifyMaterialCollections(
+      materialCollectionsWillChangeNotifier, materialCollectionsDidChangeNotifier);
 
-  info("Reloading material collections");
-  unloadMaterials();
-  // materialCollectionsDidChange will load the collections again
+    info("Reloading material collections");
+    unloadMaterials();
+    // materialCollectionsDidChange will load the collections again
+  }
+  m_nodeChangeBatch.end();
 }
 
 void MapDocument::reloadEntityDefinitions()
 {
-  const auto nodes = std::vector<mdl::Node*>{m_world.get()};
-  NotifyBeforeAndAfter notifyNodes(
-    nodesWillChangeNotifier, nodesDidChangeNotifier, nodes);
-  NotifyBeforeAndAfter notifyEntityDefinitions(
-    entityDefinitionsWillChangeNotifier, entityDefinitionsDidChangeNotifier);
+  // the nodes whose entity definitions or models change are delivered in a single
+  // notification
+  m_nodeChangeBatch.begin(TransactionScope::Oneshot);
+  {
+    NotifyBeforeAndAfter notifyEntityDefinitions(
+      entityDefinitionsWillChangeNotifier, entityDefinitionsDidChangeNotifier);
 
-  info("Reloading entity definitions");
+    info("Reloading entity definitions");
+  }
+  m_nodeChangeBatch.end();
 }
 
 std::vector<std::filesystem::path> MapDocument::enabledMaterialCollections() const
@@ -4664,18 +4754,32 @@ void MapDocument::setEnabledMaterialCollections(
 
 void MapDocument::loadAssets()
 {
+  // the observers are notified when the document has been loaded, so the assets are
+  // bound without notifying them about every changed node
+  const auto nodes = std::vector<mdl::Node*>{m_world.get()};
+
   loadEntityDefinitions();
-  setEntityDefinitions();
-  loadEntityModels();
+  setEntityDefinitions(nodes);
+  setEntityModels(nodes);
   loadMaterials();
-  setMaterials();
+  setMaterials(nodes);
 }
 
 void MapDocument::unloadAssets()
 {
-  unloadEntityDefinitions();
-  unloadEntityModels();
-  unloadMaterials();
+  // the document is cleared afterwards, so the observers are not notified about every
+  // changed node either
+  const auto nodes = std::vector<mdl::Node*>{m_world.get()};
+
+  unsetEntityDefinitions(nodes);
+  m_entityDefinitionManager->clear();
+  m_entityDefinitionActions.clear();
+
+  unsetEntityModels(nodes);
+  m_entityModelManager->clear();
+
+  unsetMaterials(nodes);
+  m_materialManager->clear();
 }
 
 void MapDocument::loadEntityDefinitions()
@@ -4710,16 +4814,6 @@ void MapDocument::unloadEntityDefinitions()
   m_entityDefinitionActions.clear();
 }
 
-void MapDocument::loadEntityModels()
-{
-  setEntityModels();
-}
-
-void MapDocument::unloadEntityModels()
-{
-  clearEntityModels();
-}
-
 void MapDocument::reloadMaterials()
 {
   unloadMaterials();
@@ -4739,9 +4833,10 @@ void MapDocument::loadMaterials()
     m_game->gameFileSystem(),
     m_game->config().materialConfig,
     [&](auto resourceLoader) {
-      auto resource = std::make_shared<mdl::TextureResource>(std::move(resourceLoader));
-      m_resourceManager->addResource(resource);
-      return resource;
+      // Textures are only decoded once a material is used by the map or shown in the
+      // material browser.
+      return m_resourceManager->addResource(std::make_shared<mdl::TextureResource>(
+        std::move(resourceLoader), mdl::LoadPolicy::OnDemand));
     },
     m_taskManager);
 }
@@ -4752,26 +4847,134 @@ void MapDocument::unloadMaterials()
   m_materialManager->clear();
 }
 
-static auto makeSetMaterialsVisitor(mdl::MaterialManager& manager)
+using MaterialCache = std::unordered_map<std::string, mdl::Material*>;
+
+struct MaterialBindings
 {
-  return kdl::overload(
+  MaterialCache materials;
+  std::vector<mdl::Node*> changedNodes;
+};
+
+/**
+ * Looks up the materials of the brush faces and patches in the given nodes and their
+ * descendants in parallel and returns the materials by name together with the nodes
+ * whose materials change. Every batch keeps its own cache of the materials it has looked
+ * up by name, so the material manager is only queried once per distinct material name
+ * and batch.
+ */
+static MaterialBindings findMaterialBindings(
+  const std::vector<mdl::Node*>& nodes,
+  mdl::MaterialManager& manager,
+  kdl::task_manager& taskManager)
+{
+  const auto findMaterial = [&](MaterialCache& cache, const std::string& name) {
+    if (const auto it = cache.find(name); it != cache.end())
+    {
+      return it->second;
+    }
+    return cache.emplace(name, manager.material(name)).first->second;
+  };
+
+  return mdl::parallelVisitAllAndReduce(
+    nodes,
+    taskManager,
+    MaterialBindings{},
+    kdl::overload(
+      [](MaterialBindings&, mdl::WorldNode*) {},
+      [](MaterialBindings&, mdl::LayerNode*) {},
+      [](MaterialBindings&, mdl::GroupNode*) {},
+      [](MaterialBindings&, mdl::EntityNode*) {},
+      [&](MaterialBindings& bindings, mdl::BrushNode* brushNode) {
+        auto changed = false;
+        for (const auto& face : brushNode->brush().faces())
+        {
+          const auto* material =
+            findMaterial(bindings.materials, face.attributes().materialName());
+          changed = changed || face.material() != material;
+        }
+        if (changed)
+        {
+          bindings.changedNodes.push_back(brushNode);
+        }
+      },
+      [&](MaterialBindings& bindings, mdl::PatchNode* patchNode) {
+        const auto& patch = patchNode->patch();
+        if (patch.material() != findMaterial(bindings.materials, patch.materialName()))
+        {
+          bindings.changedNodes.push_back(patchNode);
+        }
+      }),
+    [](MaterialBindings lhs, MaterialBindings rhs) {
+      lhs.materials.merge(rhs.materials);
+      lhs.changedNodes =
+        kdl::vec_concat(std::move(lhs.changedNodes), std::move(rhs.changedNodes));
+      return lhs;
+    });
+}
+
+/**
+ * Sets the materials found by findMaterialBindings on the changed nodes in parallel.
+ * Requesting a texture is not thread safe, so the textures of the found materials are
+ * requested on the calling thread afterwards.
+ */
+static void applyMaterialBindings(
+  const MaterialBindings& bindings, kdl::task_manager& taskManager)
+{
+  const auto& materials = bindings.materials;
+
+  mdl::parallelVisitAll(
+    bindings.changedNodes,
+    taskManager,
+    kdl::overload(
+      [](mdl::WorldNode*) {},
+      [](mdl::LayerNode*) {},
+      [](mdl::GroupNode*) {},
+      [](mdl::EntityNode*) {},
+      [&](mdl::BrushNode* brushNode) {
+        const auto& brush = brushNode->brush();
+        for (size_t i = 0u; i < brush.faceCount(); ++i)
+        {
+          const auto& face = brush.face(i);
+          brushNode->setFaceMaterial(
+            i, materials.at(face.attributes().materialName()));
+        }
+      },
+      [&](mdl::PatchNode* patchNode) {
+        patchNode->setMaterial(materials.at(patchNode->patch().materialName()));
+      }));
+
+  auto usedMaterials = std::unordered_set<mdl::Material*>{};
+  for (const auto& [name, material] : materials)
+  {
+    if (material && usedMaterials.insert(material).second)
+    {
+      material->requestTexture();
+    }
+  }
+}
+
+static std::vector<mdl::Node*> collectNodesWithMaterials(mdl::WorldNode& worldNode)
+{
+  auto result = std::vector<mdl::Node*>{};
+  worldNode.accept(kdl::overload(
     [](auto&& thisLambda, mdl::WorldNode* world) { world->visitChildren(thisLambda); },
     [](auto&& thisLambda, mdl::LayerNode* layer) { layer->visitChildren(thisLambda); },
     [](auto&& thisLambda, mdl::GroupNode* group) { group->visitChildren(thisLambda); },
     [](auto&& thisLambda, mdl::EntityNode* entity) { entity->visitChildren(thisLambda); },
     [&](mdl::BrushNode* brushNode) {
-      const mdl::Brush& brush = brushNode->brush();
-      for (size_t i = 0u; i < brush.faceCount(); ++i)
+      const auto& faces = brushNode->brush().faces();
+      if (std::ranges::any_of(faces, [](const auto& face) { return face.material(); }))
       {
-        const mdl::BrushFace& face = brush.face(i);
-        mdl::Material* material = manager.material(face.attributes().materialName());
-        brushNode->setFaceMaterial(i, material);
+        result.push_back(brushNode);
       }
     },
     [&](mdl::PatchNode* patchNode) {
-      auto* material = manager.material(patchNode->patch().materialName());
-      patchNode->setMaterial(material);
-    });
+      if (patchNode->patch().material())
+      {
+        result.push_back(patchNode);
+      }
+    }));
+  return result;
 }
 
 static auto makeUnsetMaterialsVisitor()
@@ -4793,13 +4996,19 @@ static auto makeUnsetMaterialsVisitor()
 
 void MapDocument::setMaterials()
 {
-  m_world->accept(makeSetMaterialsVisitor(*m_materialManager));
+  const auto bindings =
+    findMaterialBindings({m_world.get()}, *m_materialManager, m_taskManager);
+  {
+    const auto notifyNodes = NotifyNodeChange{m_nodeChangeBatch, bindings.changedNodes};
+    applyMaterialBindings(bindings, m_taskManager);
+  }
   materialUsageCountsDidChangeNotifier();
 }
 
 void MapDocument::setMaterials(const std::vector<mdl::Node*>& nodes)
 {
-  mdl::Node::visitAll(nodes, makeSetMaterialsVisitor(*m_materialManager));
+  applyMaterialBindings(
+    findMaterialBindings(nodes, *m_materialManager, m_taskManager), m_taskManager);
   materialUsageCountsDidChangeNotifier();
 }
 
@@ -4810,6 +5019,10 @@ void MapDocument::setMaterials(const std::vector<mdl::BrushFaceHandle>& faceHand
     mdl::BrushNode* node = faceHandle.node();
     const mdl::BrushFace& face = faceHandle.face();
     auto* material = m_materialManager->material(face.attributes().materialName());
+    if (material)
+    {
+      material->requestTexture();
+    }
     node->setFaceMaterial(faceHandle.faceIndex(), material);
   }
   materialUsageCountsDidChangeNotifier();
@@ -4817,7 +5030,11 @@ void MapDocument::setMaterials(const std::vector<mdl::BrushFaceHandle>& faceHand
 
 void MapDocument::unsetMaterials()
 {
-  m_world->accept(makeUnsetMaterialsVisitor());
+  {
+    const auto changedNodes = collectNodesWithMaterials(*m_world);
+    const auto notifyNodes = NotifyNodeChange{m_nodeChangeBatch, changedNodes};
+    m_world->accept(makeUnsetMaterialsVisitor());
+  }
   materialUsageCountsDidChangeNotifier();
 }
 
@@ -4827,24 +5044,80 @@ void MapDocument::unsetMaterials(const std::vector<mdl::Node*>& nodes)
   materialUsageCountsDidChangeNotifier();
 }
 
-static auto makeSetEntityDefinitionsVisitor(mdl::EntityDefinitionManager& manager)
+using EntityDefinitionBindings =
+  std::vector<std::pair<mdl::EntityNodeBase*, mdl::EntityDefinition*>>;
+
+/**
+ * Looks up the entity definitions of the given nodes and their descendants in parallel
+ * and returns the definitions of the nodes whose definition changes. The definitions must
+ * be set on the calling thread because setting a definition updates its usage count and
+ * notifies the node's parents, neither of which is thread safe.
+ */
+static EntityDefinitionBindings findEntityDefinitionBindings(
+  const std::vector<mdl::Node*>& nodes,
+  const mdl::EntityDefinitionManager& manager,
+  kdl::task_manager& taskManager)
+{
+  const auto findDefinition =
+    [&](EntityDefinitionBindings& bindings, mdl::EntityNodeBase* node) {
+      auto* definition = manager.definition(node);
+      if (node->entity().definition() != definition)
+      {
+        bindings.emplace_back(node, definition);
+      }
+    };
+
+  return mdl::parallelVisitAllAndReduce(
+    nodes,
+    taskManager,
+    EntityDefinitionBindings{},
+    kdl::overload(
+      [&](EntityDefinitionBindings& bindings, mdl::WorldNode* worldNode) {
+        findDefinition(bindings, worldNode);
+      },
+      [](EntityDefinitionBindings&, mdl::LayerNode*) {},
+      [](EntityDefinitionBindings&, mdl::GroupNode*) {},
+      [&](EntityDefinitionBindings& bindings, mdl::EntityNode* entityNode) {
+        findDefinition(bindings, entityNode);
+      },
+      [](EntityDefinitionBindings&, mdl::BrushNode*) {},
+      [](EntityDefinitionBindings&, mdl::PatchNode*) {}),
+    [](EntityDefinitionBindings lhs, EntityDefinitionBindings rhs) {
+      return kdl::vec_concat(std::move(lhs), std::move(rhs));
+    });
+}
+
+static void applyEntityDefinitionBindings(const EntityDefinitionBindings& bindings)
 {
-  // this helper lambda must be captured by value
-  const auto setEntityDefinition = [&](auto* node) {
-    auto* definition = manager.definition(node);
+  for (const auto& [node, definition] : bindings)
+  {
     node->setDefinition(definition);
-  };
+  }
+}
 
-  return kdl::overload(
-    [=](auto&& thisLambda, mdl::WorldNode* world) {
-      setEntityDefinition(world);
+static std::vector<mdl::Node*> collectNodesWithEntityDefinitions(
+  mdl::WorldNode& worldNode)
+{
+  auto result = std::vector<mdl::Node*>{};
+  worldNode.accept(kdl::overload(
+    [&](auto&& thisLambda, mdl::WorldNode* world) {
+      if (world->entity().definition())
+      {
+        result.push_back(world);
+      }
       world->visitChildren(thisLambda);
     },
     [](auto&& thisLambda, mdl::LayerNode* layer) { layer->visitChildren(thisLambda); },
     [](auto&& thisLambda, mdl::GroupNode* group) { group->visitChildren(thisLambda); },
-    [=](mdl::EntityNode* entity) { setEntityDefinition(entity); },
+    [&](mdl::EntityNode* entity) {
+      if (entity->entity().definition())
+      {
+        result.push_back(entity);
+      }
+    },
     [](mdl::BrushNode*) {},
-    [](mdl::PatchNode*) {});
+    [](mdl::PatchNode*) {}));
+  return result;
 }
 
 static auto makeUnsetEntityDefinitionsVisitor()
@@ -4863,16 +5136,25 @@ static auto makeUnsetEntityDefinitionsVisitor()
 
 void MapDocument::setEntityDefinitions()
 {
-  m_world->accept(makeSetEntityDefinitionsVisitor(*m_entityDefinitionManager));
+  const auto bindings = findEntityDefinitionBindings(
+    {m_world.get()}, *m_entityDefinitionManager, m_taskManager);
+  const auto changedNodes = kdl::vec_transform(
+    bindings, [](const auto& binding) -> mdl::Node* { return binding.first; });
+
+  const auto notifyNodes = NotifyNodeChange{m_nodeChangeBatch, changedNodes};
+  applyEntityDefinitionBindings(bindings);
 }
 
 void MapDocument::setEntityDefinitions(const std::vector<mdl::Node*>& nodes)
 {
-  mdl::Node::visitAll(nodes, makeSetEntityDefinitionsVisitor(*m_entityDefinitionManager));
+  applyEntityDefinitionBindings(
+    findEntityDefinitionBindings(nodes, *m_entityDefinitionManager, m_taskManager));
 }
 
 void MapDocument::unsetEntityDefinitions()
 {
+  const auto changedNodes = collectNodesWithEntityDefinitions(*m_world);
+  const auto notifyNodes = NotifyNodeChange{m_nodeChangeBatch, changedNodes};
   m_world->accept(makeUnsetEntityDefinitionsVisitor());
 }
 
@@ -4896,22 +5178,79 @@ void MapDocument::clearEntityModels()
   m_entityModelManager->clear();
 }
 
-static auto makeSetEntityModelsVisitor(mdl::EntityModelManager& manager, Logger& logger)
+using EntityModelBindings =
+  std::vector<std::pair<mdl::EntityNode*, const mdl::EntityModel*>>;
+
+/**
+ * Evaluates the model specifications of the given nodes and their descendants in parallel
+ * and returns the models of the nodes whose model changes. Errors are logged and models
+ * are loaded on the calling thread, because neither the logger nor the model manager are
+ * thread safe.
+ */
+static EntityModelBindings findEntityModelBindings(
+  const std::vector<mdl::Node*>& nodes,
+  mdl::EntityModelManager& manager,
+  Logger& logger,
+  kdl::task_manager& taskManager)
 {
-  return kdl::overload(
+  using ModelSpecifications =
+    std::vector<std::pair<mdl::EntityNode*, Result<mdl::ModelSpecification>>>;
+
+  const auto modelSpecResults = mdl::parallelVisitAllAndReduce(
+    nodes,
+    taskManager,
+    ModelSpecifications{},
+    kdl::overload(
+      [](ModelSpecifications&, mdl::WorldNode*) {},
+      [](ModelSpecifications&, mdl::LayerNode*) {},
+      [](ModelSpecifications&, mdl::GroupNode*) {},
+      [](ModelSpecifications& modelSpecs, mdl::EntityNode* entityNode) {
+        modelSpecs.emplace_back(entityNode, entityNode->entity().modelSpecification());
+      },
+      [](ModelSpecifications&, mdl::BrushNode*) {},
+      [](ModelSpecifications&, mdl::PatchNode*) {}),
+    [](ModelSpecifications lhs, ModelSpecifications rhs) {
+      return kdl::vec_concat(std::move(lhs), std::move(rhs));
+    });
+
+  auto bindings = EntityModelBindings{};
+  for (const auto& [entityNode, modelSpecResult] : modelSpecResults)
+  {
+    const auto modelSpec = mdl::safeGetModelSpecification(
+      logger, entityNode->entity().classname(), [&]() { return modelSpecResult; });
+    const auto* model = manager.model(modelSpec.path);
+    if (entityNode->entity().model() != model)
+    {
+      bindings.emplace_back(entityNode, model);
+    }
+  }
+  return bindings;
+}
+
+static void applyEntityModelBindings(const EntityModelBindings& bindings)
+{
+  for (const auto& [entityNode, model] : bindings)
+  {
+    entityNode->setModel(model);
+  }
+}
+
+static std::vector<mdl::Node*> collectNodesWithEntityModels(mdl::WorldNode& worldNode)
+{
+  auto result = std::vector<mdl::Node*>{};
+  worldNode.accept(kdl::overload(
     [](auto&& thisLambda, mdl::WorldNode* world) { world->visitChildren(thisLambda); },
     [](auto&& thisLambda, mdl::LayerNode* layer) { layer->visitChildren(thisLambda); },
     [](auto&& thisLambda, mdl::GroupNode* group) { group->visitChildren(thisLambda); },
-    [&](mdl::EntityNode* entityNode) {
-      const auto modelSpec =
-        mdl::safeGetModelSpecification(logger, entityNode->entity().classname(), [&]() {
-          return entityNode->entity().modelSpecification();
-        });
-      const auto* model = manager.model(modelSpec.path);
-      entityNode->setModel(model);
+    [&](mdl::EntityNode* entity) {
+      if (entity->entity().model())
+      {
+        result.push_back(entity);
+      }
     },
     [](mdl::BrushNode*) {},
-    [](mdl::PatchNode*) {});
+    [](mdl::PatchNode*) {}));
+  return result;
 }
 
 static auto makeUnsetEntityModelsVisitor()
@@ -4927,16 +5266,25 @@ static auto makeUnsetEntityModelsVisitor()
 
 void MapDocument::setEntityModels()
 {
-  m_world->accept(makeSetEntityModelsVisitor(*m_entityModelManager, *this));
+  const auto bindings = findEntityModelBindings(
+    {m_world.get()}, *m_entityModelManager, *this, m_taskManager);
+  const auto changedNodes = kdl::vec_transform(
+    bindings, [](const auto& binding) -> mdl::Node* { return binding.first; });
+
+  const auto notifyNodes = NotifyNodeChange{m_nodeChangeBatch, changedNodes};
+  applyEntityModelBindings(bindings);
 }
 
 void MapDocument::setEntityModels(const std::vector<mdl::Node*>& nodes)
 {
-  mdl::Node::visitAll(nodes, makeSetEntityModelsVisitor(*m_entityModelManager, *this));
+  applyEntityModelBindings(
+    findEntityModelBindings(nodes, *m_entityModelManager, *this, m_taskManager));
 }
 
 void MapDocument::unsetEntityModels()
 {
+  const auto changedNodes = collectNodesWithEntityModels(*m_world);
+  const auto notifyNodes = NotifyNodeChange{m_nodeChangeBatch, changedNodes};
   m_world->accept(makeUnsetEntityModelsVisitor());
 }
 
@@ -5191,13 +5539,18 @@ void MapDocument::updateFaceTags(const std::vector<mdl::BrushFaceHandle>& faceHa
 
 void MapDocument::updateAllFaceTags()
 {
-  m_world->accept(kdl::overload(
-    [](auto&& thisLambda, mdl::WorldNode* world) { world->visitChildren(thisLambda); },
-    [](auto&& thisLambda, mdl::LayerNode* layer) { layer->visitChildren(thisLambda); },
-    [](auto&& thisLambda, mdl::GroupNode* group) { group->visitChildren(thisLambda); },
-    [](auto&& thisLambda, mdl::EntityNode* entity) { entity->visitChildren(thisLambda); },
-    [&](mdl::BrushNode* brush) { brush->initializeTags(*m_tagManager); },
-    [](mdl::PatchNode*) {}));
+  m_tagManager->clearMaterialTags();
+
+  mdl::parallelVisitAll(
+    {m_world.get()},
+    m_taskManager,
+    kdl::overload(
+      [](mdl::WorldNode*) {},
+      [](mdl::LayerNode*) {},
+      [](mdl::GroupNode*) {},
+      [](mdl::EntityNode*) {},
+      [&](mdl::BrushNode* brushNode) { brushNode->initializeTags(*m_tagManager); },
+      [](mdl::PatchNode*) {}));
 }
 
 void MapDocument::updateFaceTagsAfterResourcesWhereProcessed(
@@ -5210,25 +5563,27 @@ void MapDocument::updateFaceTagsAfterResourcesWhereProcessed(
   const auto materialSet =
     std::unordered_set<const mdl::Material*>{materials.begin(), materials.end()};
 
-  m_world->accept(kdl::overload(
-    [](auto&& thisLambda, mdl::WorldNode* world) { world->visitChildren(thisLambda); },
-    [](auto&& thisLambda, mdl::LayerNode* layer) { layer->visitChildren(thisLambda); },
-    [](auto&& thisLambda, mdl::GroupNode* group) { group->visitChildren(thisLambda); },
-    [](auto&& thisLambda, mdl::EntityNode* entity) { entity->visitChildren(thisLambda); },
-    [&](mdl::BrushNode* brushNode) {
-      const auto& faces = brushNode->brush().faces();
-      for (size_t i = 0; i < faces.size(); ++i)
-      {
+  m_tagManager->clearMaterialTags();
+
+  mdl::parallelVisitAll(
+    {m_world.get()},
+    m_taskManager,
+    kdl::overload(
+      [](mdl::WorldNode*) {},
+      [](mdl::LayerNode*) {},
+      [](mdl::GroupNode*) {},
+      [](mdl::EntityNode*) {},
+      [&](mdl::BrushNode* brushNode) {
+        const auto& faces = brushNode->brush().faces();
+        for (size_t i = 0; i < faces.size(); ++i)
         {
-          const auto& face = faces[i];
-          if (materialSet.contains(face.material()))
+          if (materialSet.contains(faces[i].material()))
           {
             brushNode->updateFaceTags(i, *m_tagManager);
           }
         }
-      }
-    },
-    [](mdl::PatchNode*) {}));
+      },
+      [](mdl::PatchNode*) {}));
 }
 
 bool MapDocument::persistent() const
@@ -5317,7 +5672,7 @@ void MapDocument::connectObservers()
   m_notifierConnection +=
     nodesWillBeRemovedNotifier.connect(this, &MapDocument::clearNodeTags);
   m_notifierConnection +=
-    nodesDidChangeNotifier.connect(this, &MapDocument::updateNodeTags);
+    uncoalescedNodesDidChangeNotifier.connect(this, &MapDocument::updateNodeTags);
   m_notifierConnection +=
     brushFacesDidChangeNotifier.connect(this, &MapDocument::updateFaceTags);
   m_notifierConnection +=
@@ -5373,11 +5728,17 @@ void MapDocument::preferenceDidChange(const std::filesystem::path& path)
     const std::filesystem::path newGamePath = gameFactory.gamePath(m_game->config().name);
     m_game->setGamePath(newGamePath, logger());
 
+    m_nodeChangeBatch.begin(TransactionScope::Oneshot);
     clearEntityModels();
     setEntityModels();
 
     reloadMaterials();
     setMaterials();
+    m_nodeChangeBatch.end();
+  }
+  else if (path == Preferences::TextureResidencyBudget.path())
+  {
+    updateResidencyBudget();
   }
 }
 
@@ -32,6 +32,7 @@
 #include "mdl/PortalFile.h"
 #include "ui/Actions.h"
 #include "ui/CachingLogger.h"
+#include "ui/NodeChangeBatch.h"
 
 #include "vm/bbox.h"
 #include "vm/ray.h"
@@ -70,6 +71,7 @@ class Game;
 class Issue;
 class Material;
 class MaterialManager;
+class PatchGridCache;
 class PickResult;
 class PointTrace;
 class PortalFile;
@@ -131,6 +133,7 @@ protected:
   std::unique_ptr<mdl::EntityModelManager> m_entityModelManager;
   std::unique_ptr<mdl::MaterialManager> m_materialManager;
   std::unique_ptr<mdl::TagManager> m_tagManager;
+  std::unique_ptr<mdl::PatchGridCache> m_patchGridCache;
 
   std::unique_ptr<mdl::EditorContext> m_editorContext;
   std::unique_ptr<Grid> m_grid;
@@ -192,6 +195,8 @@ public: // notification
   Notifier<const std::vector<mdl::Node*>&> nodesWereRemovedNotifier;
   Notifier<const std::vector<mdl::Node*>&> nodesWillChangeNotifier;
   Notifier<const std::vector<mdl::Node*>&> nodesDidChangeNotifier;
+  // not coalesced during transactions, see NodeChangeBatch
+  Notifier<const std::vector<mdl::Node*>&> uncoalescedNodesDidChangeNotifier;
 
   Notifier<const std::vector<mdl::Node*>&> nodeVisibilityDidChangeNotifier;
   Notifier<const std::vector<mdl::Node*>&> nodeLockingDidChangeNotifier;
@@ -220,6 +225,10 @@ public: // notification
   Notifier<> portalFileWasLoadedNotifier;
   Notifier<> portalFileWasUnloadedNotifier;
 
+protected:
+  NodeChangeBatch m_nodeChangeBatch{
+    nodesWillChangeNotifier, nodesDidChangeNotifier, uncoalescedNodesDidChangeNotifier};
+
 private:
   NotifierConnection m_notifierConnection;
 
@@ -271,6 +280,7 @@ public:
   mdl::EntityDefinitionManager& entityDefinitionManager() override;
   mdl::EntityModelManager& entityModelManager() override;
   mdl::MaterialManager& materialManager() override;
+  mdl::PatchGridCache& patchGridCache();
 
   Grid& grid() const;
 
@@ -279,6 +289,11 @@ public:
 
   void setViewEffectsService(ViewEffectsService* viewEffectsService);
 
+  /**
+   * Returns the node change notification stats of the last command or transaction.
+   */
+  const NodeChangeStats& nodeChangeStats() const;
+
 public: // tag and entity definition actions
   template <typename ActionVisitor>
   void visitTagActions(const ActionVisitor& visitor) const
@@ -425,6 +440,8 @@ public: // selection
 protected:
   void updateLastSelectionBounds();
   void invalidateSelectionBounds();
+  void extendSelectionBounds(const std::vector<mdl::Node*>& selectedNodes);
+  void shrinkSelectionBounds(const std::vector<mdl::Node*>& deselectedNodes);
 
 private:
   void validateSelectionBounds() const;
@@ -696,6 +713,9 @@ public: // asset state management
   void processResourcesAsync(const mdl::ProcessContext& processContext);
   bool needsResourceProcessing();
 
+private:
+  void updateResidencyBudget();
+
 public: // picking
   void pick(const vm::ray3d& pickRay, mdl::PickResult& pickResult) const;
   std::vector<mdl::Node*> findNodesContaining(const vm::vec3d& point) const;
@@ -733,9 +753,6 @@ private:
   void loadEntityDefinitions();
   void unloadEntityDefinitions();
 
-  void loadEntityModels();
-  void unloadEntityModels();
-
 protected:
   void reloadMaterials();
   void loadMaterials();
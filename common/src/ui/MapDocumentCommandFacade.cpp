@@ -35,6 +35,7 @@
 #include "mdl/LinkedGroupUtils.h"
 #include "mdl/ModelUtils.h"
 #include "mdl/NodeQueries.h"
+#include "mdl/PatchGridCache.h"
 #include "mdl/PatchNode.h"
 #include "mdl/WorldNode.h"
 #include "ui/CommandProcessor.h"
@@ -111,12 +112,12 @@ void MapDocumentCommandFacade::performSelect(const std::vector<mdl::Node*>& node
   }
 
   m_selectedNodes.addNodes(selected);
+  extendSelectionBounds(selected);
 
   auto selection = Selection{};
   selection.addSelectedNodes(selected);
 
   selectionDidChangeNotifier(selection);
-  invalidateSelectionBounds();
 }
 
 void MapDocumentCommandFacade::performSelect(
@@ -162,7 +163,7 @@ void MapDocumentCommandFacade::performSelectAllNodes()
 
   auto* target = currentGroupOrWorld();
   const auto nodesToSelect =
-    mdl::collectSelectableNodes(target->children(), *m_editorContext);
+    mdl::collectSelectableNodes(target->children(), *m_editorContext, taskManager());
   performSelect(nodesToSelect);
 }
 
@@ -198,12 +199,12 @@ void MapDocumentCommandFacade::performDeselect(const std::vector<mdl::Node*>& no
   }
 
   m_selectedNodes.removeNodes(deselected);
+  shrinkSelectionBounds(deselected);
 
   auto selection = Selection{};
   selection.addDeselectedNodes(deselected);
 
   selectionDidChangeNotifier(selection);
-  invalidateSelectionBounds();
 }
 
 void MapDocumentCommandFacade::performDeselect(
@@ -229,7 +230,10 @@ void MapDocumentCommandFacade::performDeselect(
     }
   }
 
-  m_selectedBrushFaces = kdl::vec_erase_all(std::move(m_selectedBrushFaces), deselected);
+  const auto deselectedSet = kdl::vector_set<mdl::BrushFaceHandle>{deselected};
+  std::erase_if(m_selectedBrushFaces, [&](const auto& handle) {
+    return deselectedSet.count(handle) > 0;
+  });
 
   auto selection = Selection{};
   selection.addDeselectedBrushFaces(deselected);
@@ -274,8 +278,7 @@ void MapDocumentCommandFacade::performAddNodes(
   const std::map<mdl::Node*, std::vector<mdl::Node*>>& nodes)
 {
   const auto parents = collectNodesAndAncestors(kdl::map_keys(nodes));
-  auto notifyParents =
-    NotifyBeforeAndAfter{nodesWillChangeNotifier, nodesDidChangeNotifier, parents};
+  const auto notifyParents = NotifyNodeChange{m_nodeChangeBatch, parents};
 
   auto addedNodes = std::vector<mdl::Node*>{};
   for (const auto& [parent, children] : nodes)
@@ -297,10 +300,10 @@ void MapDocumentCommandFacade::performRemoveNodes(
   const std::map<mdl::Node*, std::vector<mdl::Node*>>& nodes)
 {
   const auto parents = collectNodesAndAncestors(kdl::map_keys(nodes));
-  auto notifyParents =
-    NotifyBeforeAndAfter{nodesWillChangeNotifier, nodesDidChangeNotifier, parents};
+  const auto notifyParents = NotifyNodeChange{m_nodeChangeBatch, parents};
 
   const auto allChildren = kdl::vec_flatten(kdl::map_values(nodes));
+  m_nodeChangeBatch.nodesWillBeRemoved(allChildren);
   auto notifyChildren = NotifyBeforeAndAfter{
     nodesWillBeRemovedNotifier, nodesWereRemovedNotifier, allChildren};
 
@@ -325,10 +328,10 @@ MapDocumentCommandFacade::performReplaceChildren(
   }
 
   const auto parents = collectNodesAndAncestors(kdl::map_keys(nodes));
-  auto notifyParents =
-    NotifyBeforeAndAfter{nodesWillChangeNotifier, nodesDidChangeNotifier, parents};
+  const auto notifyParents = NotifyNodeChange{m_nodeChangeBatch, parents};
 
   const auto allOldChildren = collectOldChildren(nodes);
+  m_nodeChangeBatch.nodesWillBeRemoved(allOldChildren);
   auto notifyChildren = NotifyBeforeAndAfter{
     nodesWillBeRemovedNotifier, nodesWereRemovedNotifier, allOldChildren};
 
@@ -405,12 +408,9 @@ void MapDocumentCommandFacade::performSwapNodeContents(
   const auto parents = collectAncestors(nodes);
   const auto descendants = collectDescendants(nodes);
 
-  auto notifyNodes =
-    NotifyBeforeAndAfter{nodesWillChangeNotifier, nodesDidChangeNotifier, nodes};
-  auto notifyParents =
-    NotifyBeforeAndAfter{nodesWillChangeNotifier, nodesDidChangeNotifier, parents};
-  auto notifyDescendants =
-    NotifyBeforeAndAfter{nodesWillChangeNotifier, nodesDidChangeNotifier, descendants};
+  const auto notifyNodes = NotifyNodeChange{m_nodeChangeBatch, nodes};
+  const auto notifyParents = NotifyNodeChange{m_nodeChangeBatch, parents};
+  const auto notifyDescendants = NotifyNodeChange{m_nodeChangeBatch, descendants};
 
   const auto [notifyWadsChange, notifyEntityDefinitionsChange, notifyModsChange] =
     notifySpecialWorldProperties(*game(), nodesToSwap);
@@ -425,6 +425,18 @@ void MapDocumentCommandFacade::performSwapNodeContents(
   auto notifyMods =
     NotifyBeforeAndAfter{notifyModsChange, modsWillChangeNotifier, modsDidChangeNotifier};
 
+  // tessellate the new patches in parallel, restored patches are found in the cache
+  auto patches = std::vector<const mdl::BezierPatch*>{};
+  for (const auto& [node, contents] : nodesToSwap)
+  {
+    if (const auto* patch = std::get_if<mdl::BezierPatch>(&contents.get()))
+    {
+      patches.push_back(patch);
+    }
+  }
+  auto patchGrids = patchGridCache().get(patches, taskManager());
+  auto nextPatchGrid = patchGrids.begin();
+
   for (auto& pair : nodesToSwap)
   {
     auto* node = pair.first;
@@ -452,8 +464,8 @@ void MapDocumentCommandFacade::performSwapNodeContents(
           brushNode->setBrush(std::get<mdl::Brush>(std::move(contents)))};
       },
       [&](mdl::PatchNode* patchNode) {
-        return mdl::NodeContents{
-          patchNode->setPatch(std::get<mdl::BezierPatch>(std::move(contents)))};
+        return mdl::NodeContents{patchNode->setPatch(
+          std::get<mdl::BezierPatch>(std::move(contents)), std::move(*nextPatchGrid++))};
       }));
   }
 
@@ -47,6 +47,7 @@
 #include "mdl/PointTrace.h"
 #include "mdl/PortalFile.h"
 #include "mdl/WorldNode.h"
+#include "render/AttrString.h"
 #include "render/Camera.h"
 #include "render/Compass.h"
 #include "render/FontDescriptor.h"
@@ -56,6 +57,7 @@
 #include "render/RenderBatch.h"
 #include "render/RenderContext.h"
 #include "render/RenderService.h"
+#include "render/RenderStatistics.h"
 #include "ui/Actions.h"
 #include "ui/Animation.h"
 #include "ui/EnableDisableTagCallback.h"
@@ -1014,20 +1016,33 @@ void MapViewBase::renderContents()
   setupGL(renderContext);
   setRenderOptions(renderContext);
 
-  auto renderBatch = render::RenderBatch{vboManager()};
+  const auto collectStatistics = pref(Preferences::ShowRenderStatistics)
+                                 || !pref(Preferences::RenderStatisticsFile).empty();
 
-  renderGrid(renderContext, renderBatch);
-  renderMap(m_renderer, renderContext, renderBatch);
-  renderTools(m_toolBox, renderContext, renderBatch);
+  {
+    const auto activateStatistics =
+      render::ActivateRenderStatistics{collectStatistics ? &m_renderStatistics : nullptr};
+
+    auto renderBatch = render::RenderBatch{vboManager()};
+
+    renderGrid(renderContext, renderBatch);
+    renderMap(m_renderer, renderContext, renderBatch);
+    renderTools(m_toolBox, renderContext, renderBatch);
+
+    renderCoordinateSystem(renderContext, renderBatch);
+    renderSoftWorldBounds(renderContext, renderBatch);
+    renderPointFile(renderContext, renderBatch);
+    renderPortalFile(renderContext, renderBatch);
+    renderCompass(renderBatch);
+    renderFPS(renderContext, renderBatch);
 
-  renderCoordinateSystem(renderContext, renderBatch);
-  renderSoftWorldBounds(renderContext, renderBatch);
-  renderPointFile(renderContext, renderBatch);
-  renderPortalFile(renderContext, renderBatch);
-  renderCompass(renderBatch);
-  renderFPS(renderContext, renderBatch);
+    renderBatch.render(renderContext);
+  }
 
-  renderBatch.render(renderContext);
+  if (collectStatistics)
+  {
+    writeRenderStatistics();
+  }
 
   if (document->needsResourceProcessing())
   {
@@ -1143,13 +1158,60 @@ void MapViewBase::renderCompass(render::RenderBatch& renderBatch)
 void MapViewBase::renderFPS(
   render::RenderContext& renderContext, render::RenderBatch& renderBatch)
 {
-  if (pref(Preferences::ShowFPS))
+  const auto showFPS = pref(Preferences::ShowFPS);
+  const auto showStatistics =
+    pref(Preferences::ShowRenderStatistics) && m_renderStatistics.frameCount() > 0;
+
+  if (showFPS || showStatistics)
   {
+    auto string = render::AttrString{};
+    if (showFPS)
+    {
+      string.appendLeftJustified(m_currentFPS);
+    }
+    if (showStatistics)
+    {
+      for (auto line : m_renderStatistics.summary())
+      {
+        string.appendLeftJustified(std::move(line));
+      }
+    }
+
     auto renderService = render::RenderService{renderContext, renderBatch};
-    renderService.renderHeadsUp(m_currentFPS);
+    renderService.renderHeadsUp(string);
   }
 }
 
+void MapViewBase::writeRenderStatistics()
+{
+  const auto& path = pref(Preferences::RenderStatisticsFile);
+  if (path != m_renderStatisticsPath)
+  {
+    m_renderStatisticsFile.close();
+    m_renderStatisticsPath = path;
+
+    if (!m_renderStatisticsPath.empty())
+    {
+      // the file is shared by all map views, so we append to it
+      m_renderStatisticsFile.open(m_renderStatisticsPath, std::ios::out | std::ios::app);
+      if (m_renderStatisticsFile.is_open() && m_renderStatisticsFile.tellp() == 0)
+      {
+        render::RenderStatistics::writeCsvHeader(m_renderStatisticsFile);
+      }
+    }
+  }
+
+  if (m_renderStatisticsFile.is_open())
+  {
+    m_renderStatistics.writeCsvRows(m_renderStatisticsFile);
+  }
+}
+
+const render::RenderStatistics& MapViewBase::renderStatistics() const
+{
+  return m_renderStatistics;
+}
+
 void MapViewBase::processEvent(const KeyEvent& event)
 {
   ToolBoxConnector::processEvent(event);
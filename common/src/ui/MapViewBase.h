@@ -20,6 +20,7 @@
 #pragma once
 
 #include "NotifierConnection.h"
+#include "render/RenderStatistics.h"
 #include "ui/ActionContext.h"
 #include "ui/CameraLinkHelper.h"
 #include "ui/MapView.h"
@@ -27,6 +28,7 @@
 #include "ui/ToolBoxConnector.h"
 
 #include <filesystem>
+#include <fstream>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -101,6 +103,10 @@ private:
 
   NotifierConnection m_notifierConnection;
 
+  render::RenderStatistics m_renderStatistics;
+  std::filesystem::path m_renderStatisticsPath;
+  std::ofstream m_renderStatisticsFile;
+
 private: // shortcuts
   std::vector<std::pair<QShortcut*, const Action*>> m_shortcuts;
 
@@ -346,6 +352,19 @@ private: // implement RenderView interface
   void renderCompass(render::RenderBatch& renderBatch);
   void renderFPS(render::RenderContext& renderContext, render::RenderBatch& renderBatch);
 
+  /**
+   * Appends the statistics of the last frame to the render statistics file if one is
+   * configured in the preferences.
+   */
+  void writeRenderStatistics();
+
+public:
+  /**
+   * Returns the render statistics of the last frame. The statistics are only collected
+   * if they are shown or written to a file, see the render statistics preferences.
+   */
+  const render::RenderStatistics& renderStatistics() const;
+
 public: // implement InputEventProcessor interface
   void processEvent(const KeyEvent& event) override;
   void processEvent(const MouseEvent& event) override;
@@ -267,8 +267,7 @@ void MaterialBrowser::reload()
   if (m_view)
   {
     updateSelectedMaterial();
-    m_view->invalidate();
-    m_view->update();
+    m_view->reloadMaterials();
   }
 }
 
@@ -29,6 +29,7 @@
 #include "mdl/MaterialManager.h"
 #include "mdl/Texture.h"
 #include "render/ActiveShader.h"
+#include "render/FontDescriptor.h"
 #include "render/FontManager.h"
 #include "render/GLVertexType.h"
 #include "render/PrimType.h"
@@ -104,7 +105,8 @@ void MaterialBrowserView::setFilterText(const std::string& filterText)
   if (filterText != m_filterText)
   {
     m_filterText = filterText;
-    reloadMaterials();
+    invalidate();
+    update();
   }
 }
 
@@ -137,6 +139,7 @@ void MaterialBrowserView::resourcesWereProcessed(const std::vector<mdl::Resource
 
 void MaterialBrowserView::reloadMaterials()
 {
+  m_allItems = std::nullopt;
   invalidate();
   update();
 }
@@ -162,51 +165,92 @@ void MaterialBrowserView::doReloadLayout(Layout& layout)
 
   const auto font = render::FontDescriptor{fontPath, size_t(fontSize)};
 
-  if (m_group)
+  // material names are single line strings, so their titles all have the same height
+  const auto titleHeight = fontManager().font(font).measure("").y();
+  const auto maxCellWidth = layout.maxCellWidth();
+
+  for (const auto& group : filteredItems())
   {
-    for (const auto* collection : getCollections())
+    if (m_group)
     {
-      layout.addGroup(collection->path().string(), float(fontSize) + 2.0f);
-      addMaterialsToLayout(layout, getMaterials(*collection), font);
+      layout.addGroup(group.title, float(fontSize) + 2.0f);
+    }
+    for (const auto& item : group.items)
+    {
+      layout.addItem(
+        item.material,
+        item.title,
+        item.width,
+        item.height,
+        maxCellWidth,
+        titleHeight + 4.0f);
     }
   }
-  else
+}
+
+const std::vector<MaterialBrowserView::Group>& MaterialBrowserView::filteredItems()
+{
+  if (!m_allItems)
   {
-    addMaterialsToLayout(layout, getMaterials(), font);
+    m_allItems = getAllItems();
+    m_filteredItems = *m_allItems;
+    m_filteredText.clear();
   }
+
+  if (m_filterText != m_filteredText)
+  {
+    // the filter matches if every space separated pattern is contained in the material
+    // name; appending to the filter text can only extend or add patterns
+    if (!m_filterText.starts_with(m_filteredText))
+    {
+      m_filteredItems = *m_allItems;
+    }
+
+    const auto patterns = kdl::str_split(m_filterText, " ");
+    for (auto& group : m_filteredItems)
+    {
+      group.items = kdl::vec_erase_if(std::move(group.items), [&](const auto& item) {
+        return !kdl::all_of(patterns, [&](const auto& pattern) {
+          return kdl::ci::str_contains(item.material->name(), pattern);
+        });
+      });
+    }
+    m_filteredText = m_filterText;
+  }
+
+  return m_filteredItems;
 }
 
-void MaterialBrowserView::addMaterialsToLayout(
-  Layout& layout,
-  const std::vector<const mdl::Material*>& materials,
-  const render::FontDescriptor& font)
+std::vector<MaterialBrowserView::Group> MaterialBrowserView::getAllItems() const
 {
-  for (const auto* material : materials)
+  if (m_group)
   {
-    addMaterialToLayout(layout, *material, font);
+    return kdl::vec_transform(getCollections(), [&](const auto* collection) {
+      return Group{collection->path().string(), getItems(getMaterials(*collection))};
+    });
   }
+  return {Group{"", getItems(getMaterials())}};
 }
 
-void MaterialBrowserView::addMaterialToLayout(
-  Layout& layout, const mdl::Material& material, const render::FontDescriptor& font)
+std::vector<MaterialBrowserView::Item> MaterialBrowserView::getItems(
+  const std::vector<const mdl::Material*>& materials) const
 {
-  const auto maxCellWidth = layout.maxCellWidth();
-
-  const auto materialName = std::filesystem::path{material.name()}.filename().string();
-  const auto titleHeight = fontManager().font(font).measure(materialName).y();
-
   const auto scaleFactor = pref(Preferences::MaterialBrowserIconSize);
-  const auto* texture = material.texture();
-  const auto textureSize = texture ? texture->sizef() : vm::vec2f{64, 64};
-  const auto scaledTextureSize = vm::round(scaleFactor * textureSize);
-
-  layout.addItem(
-    &material,
-    materialName,
-    scaledTextureSize.x(),
-    scaledTextureSize.y(),
-    maxCellWidth,
-    titleHeight + 4.0f);
+
+  return kdl::vec_transform(materials, [&](const auto* material) {
+    const auto textureHeader = mdl::getTextureHeader(material);
+    const auto textureSize =
+      textureHeader
+        ? vm::vec2f{float(textureHeader->width), float(textureHeader->height)}
+        : vm::vec2f{64, 64};
+    const auto scaledTextureSize = vm::round(scaleFactor * textureSize);
+
+    return Item{
+      material,
+      std::filesystem::path{material->name()}.filename().string(),
+      scaledTextureSize.x(),
+      scaledTextureSize.y()};
+  });
 }
 
 std::vector<const mdl::MaterialCollection*> MaterialBrowserView::getCollections() const
@@ -228,13 +272,12 @@ std::vector<const mdl::MaterialCollection*> MaterialBrowserView::getCollections(
 std::vector<const mdl::Material*> MaterialBrowserView::getMaterials(
   const mdl::MaterialCollection& collection) const
 {
-  return sortMaterials(filterMaterials(
+  return sortMaterials(hideUnusedMaterials(
     kdl::vec_transform(collection.materials(), [](const auto& t) { return &t; })));
 }
 
 std::vector<const mdl::Material*> MaterialBrowserView::getMaterials() const
 {
-  auto document = kdl::mem_lock(m_document);
   auto materials = std::vector<const mdl::Material*>{};
   for (const auto& collection : getCollections())
   {
@@ -243,10 +286,10 @@ std::vector<const mdl::Material*> MaterialBrowserView::getMaterials() const
       materials.push_back(&material);
     }
   }
-  return sortMaterials(filterMaterials(materials));
+  return sortMaterials(hideUnusedMaterials(materials));
 }
 
-std::vector<const mdl::Material*> MaterialBrowserView::filterMaterials(
+std::vector<const mdl::Material*> MaterialBrowserView::hideUnusedMaterials(
   std::vector<const mdl::Material*> materials) const
 {
   if (m_hideUnused)
@@ -255,14 +298,6 @@ std::vector<const mdl::Material*> MaterialBrowserView::filterMaterials(
       return material->usageCount() == 0;
     });
   }
-  if (!m_filterText.empty())
-  {
-    materials = kdl::vec_erase_if(std::move(materials), [&](const auto* material) {
-      return !kdl::all_of(kdl::str_split(m_filterText, " "), [&](const auto& pattern) {
-        return kdl::ci::str_contains(material->name(), pattern);
-      });
-    });
-  }
   return materials;
 }
 
@@ -324,27 +359,24 @@ void MaterialBrowserView::renderBounds(Layout& layout, const float y, const floa
   {
     if (group.intersectsY(y, height))
     {
-      for (const auto& row : group.rows())
+      for (const auto& row : group.rowsIntersectingY(y, height))
       {
-        if (row.intersectsY(y, height))
+        for (const auto& cell : row.cells())
         {
-          for (const auto& cell : row.cells())
-          {
-            const auto& bounds = cell.itemBounds();
-            const auto& material = cellData(cell);
-            const auto& color = materialColor(material);
-            vertices.emplace_back(
-              vm::vec2f{bounds.left() - 2.0f, height - (bounds.top() - 2.0f - y)}, color);
-            vertices.emplace_back(
-              vm::vec2f{bounds.left() - 2.0f, height - (bounds.bottom() + 2.0f - y)},
-              color);
-            vertices.emplace_back(
-              vm::vec2f{bounds.right() + 2.0f, height - (bounds.bottom() + 2.0f - y)},
-              color);
-            vertices.emplace_back(
-              vm::vec2f{bounds.right() + 2.0f, height - (bounds.top() - 2.0f - y)},
-              color);
-          }
+          const auto& bounds = cell.itemBounds();
+          const auto& material = cellData(cell);
+          const auto& color = materialColor(material);
+          vertices.emplace_back(
+            vm::vec2f{bounds.left() - 2.0f, height - (bounds.top() - 2.0f - y)}, color);
+          vertices.emplace_back(
+            vm::vec2f{bounds.left() - 2.0f, height - (bounds.bottom() + 2.0f - y)},
+            color);
+          vertices.emplace_back(
+            vm::vec2f{bounds.right() + 2.0f, height - (bounds.bottom() + 2.0f - y)},
+            color);
+          vertices.emplace_back(
+            vm::vec2f{bounds.right() + 2.0f, height - (bounds.top() - 2.0f - y)},
+            color);
         }
       }
     }
@@ -386,30 +418,28 @@ void MaterialBrowserView::renderMaterials(
   {
     if (group.intersectsY(y, height))
     {
-      for (const auto& row : group.rows())
+      for (const auto& row : group.rowsIntersectingY(y, height))
       {
-        if (row.intersectsY(y, height))
+        for (const auto& cell : row.cells())
         {
-          for (const auto& cell : row.cells())
-          {
-            const auto& bounds = cell.itemBounds();
-            const auto& material = cellData(cell);
-
-            auto vertexArray = render::VertexArray::move(std::vector<Vertex>{
-              Vertex{{bounds.left(), height - (bounds.top() - y)}, {0, 0}},
-              Vertex{{bounds.left(), height - (bounds.bottom() - y)}, {0, 1}},
-              Vertex{{bounds.right(), height - (bounds.bottom() - y)}, {1, 1}},
-              Vertex{{bounds.right(), height - (bounds.top() - y)}, {1, 0}},
-            });
-
-            material.activate(
-              pref(Preferences::TextureMinFilter), pref(Preferences::TextureMagFilter));
-
-            vertexArray.prepare(vboManager());
-            vertexArray.render(render::PrimType::Quads);
-
-            material.deactivate();
-          }
+          const auto& bounds = cell.itemBounds();
+          const auto& material = cellData(cell);
+          material.requestTexture(mdl::LoadPriority::High);
+
+          auto vertexArray = render::VertexArray::move(std::vector<Vertex>{
+            Vertex{{bounds.left(), height - (bounds.top() - y)}, {0, 0}},
+            Vertex{{bounds.left(), height - (bounds.bottom() - y)}, {0, 1}},
+            Vertex{{bounds.right(), height - (bounds.bottom() - y)}, {1, 1}},
+            Vertex{{bounds.right(), height - (bounds.top() - y)}, {1, 0}},
+          });
+
+          material.activate(
+            pref(Preferences::TextureMinFilter), pref(Preferences::TextureMagFilter));
+
+          vertexArray.prepare(vboManager());
+          vertexArray.render(render::PrimType::Quads);
+
+          material.deactivate();
         }
       }
     }
@@ -436,9 +466,9 @@ QString MaterialBrowserView::tooltip(const Cell& cell)
   auto ss = QTextStream{&tooltip};
   ss << QString::fromStdString(material.name()) << "\n";
 
-  if (const auto* texture = material.texture())
+  if (const auto textureHeader = mdl::getTextureHeader(&material))
   {
-    ss << texture->width() << "x" << texture->height();
+    ss << textureHeader->width << "x" << textureHeader->height;
   }
   else
   {
@@ -20,10 +20,10 @@
 #pragma once
 
 #include "NotifierConnection.h"
-#include "render/FontDescriptor.h"
 #include "ui/CellView.h"
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -53,12 +53,41 @@ class MaterialBrowserView : public CellView
 {
   Q_OBJECT
 private:
+  struct Item
+  {
+    const mdl::Material* material;
+    std::string title;
+    float width;
+    float height;
+  };
+
+  struct Group
+  {
+    std::string title;
+    std::vector<Item> items;
+  };
+
   std::weak_ptr<MapDocument> m_document;
   bool m_group = false;
   bool m_hideUnused = false;
   MaterialSortOrder m_sortOrder = MaterialSortOrder::Name;
   std::string m_filterText;
 
+  /**
+   * The sorted items of all materials that are shown if the filter text is empty. These
+   * are only rebuilt by reloadMaterials, so changing the filter text does not look up the
+   * collections, sort the materials or compute their titles and sizes again.
+   */
+  std::optional<std::vector<Group>> m_allItems;
+
+  /**
+   * The items of m_allItems that match m_filteredText. If the filter text is extended,
+   * every matching material must also match the previous filter text, so only these items
+   * are filtered again.
+   */
+  std::vector<Group> m_filteredItems;
+  std::string m_filteredText;
+
   const mdl::Material* m_selectedMaterial = nullptr;
 
   NotifierConnection m_notifierConnection;
@@ -80,27 +109,24 @@ public:
 
   void revealMaterial(const mdl::Material* material);
 
+  void reloadMaterials();
+
 private:
   void resourcesWereProcessed(const std::vector<mdl::ResourceId>& resources);
 
-  void reloadMaterials();
-
   void doInitLayout(Layout& layout) override;
   void doReloadLayout(Layout& layout) override;
 
-  void addMaterialsToLayout(
-    Layout& layout,
-    const std::vector<const mdl::Material*>& materials,
-    const render::FontDescriptor& font);
-  void addMaterialToLayout(
-    Layout& layout, const mdl::Material& material, const render::FontDescriptor& font);
+  const std::vector<Group>& filteredItems();
+  std::vector<Group> getAllItems() const;
+  std::vector<Item> getItems(const std::vector<const mdl::Material*>& materials) const;
 
   std::vector<const mdl::MaterialCollection*> getCollections() const;
   std::vector<const mdl::Material*> getMaterials(
     const mdl::MaterialCollection& collection) const;
   std::vector<const mdl::Material*> getMaterials() const;
 
-  std::vector<const mdl::Material*> filterMaterials(
+  std::vector<const mdl::Material*> hideUnusedMaterials(
     std::vector<const mdl::Material*> materials) const;
   std::vector<const mdl::Material*> sortMaterials(
     std::vector<const mdl::Material*> materials) const;
@@ -0,0 +1,192 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "NodeChangeBatch.h"
+
+#include "mdl/Node.h"
+#include "ui/TransactionScope.h"
+
+#include "kdl/reflection_impl.h"
+
+#include <cassert>
+
+namespace tb::ui
+{
+
+kdl_reflect_impl(NodeChangeStats);
+
+NodeChangeBatch::NodeChangeBatch(
+  NodeNotifier& nodesWillChangeNotifier,
+  NodeNotifier& nodesDidChangeNotifier,
+  NodeNotifier& uncoalescedNodesDidChangeNotifier)
+  : m_nodesWillChangeNotifier{nodesWillChangeNotifier}
+  , m_nodesDidChangeNotifier{nodesDidChangeNotifier}
+  , m_uncoalescedNodesDidChangeNotifier{uncoalescedNodesDidChangeNotifier}
+{
+}
+
+void NodeChangeBatch::begin(const TransactionScope scope)
+{
+  if (m_scopes.empty())
+  {
+    m_stats = NodeChangeStats{};
+  }
+
+  m_scopes.push_back(scope);
+  if (scope == TransactionScope::Oneshot)
+  {
+    ++m_oneshotScopeCount;
+  }
+}
+
+void NodeChangeBatch::end()
+{
+  assert(!m_scopes.empty());
+
+  const auto scope = m_scopes.back();
+  m_scopes.pop_back();
+
+  if (scope == TransactionScope::Oneshot && --m_oneshotScopeCount == 0)
+  {
+    const auto changedNodes = std::move(m_changedNodes);
+    m_changedNodes.clear();
+    m_changedNodeSet.clear();
+
+    if (!changedNodes.empty())
+    {
+      deliver(m_nodesDidChangeNotifier, changedNodes);
+    }
+  }
+}
+
+bool NodeChangeBatch::coalescing() const
+{
+  return m_oneshotScopeCount > 0;
+}
+
+void NodeChangeBatch::nodesWillChange(const std::vector<mdl::Node*>& nodes)
+{
+  ++m_stats.requestedNotifications;
+
+  if (!coalescing())
+  {
+    deliver(m_nodesWillChangeNotifier, nodes);
+    return;
+  }
+
+  auto newNodes = std::vector<mdl::Node*>{};
+  for (auto* node : nodes)
+  {
+    if (m_changedNodeSet.insert(node).second)
+    {
+      m_changedNodes.push_back(node);
+      newNodes.push_back(node);
+    }
+  }
+
+  if (!newNodes.empty())
+  {
+    deliver(m_nodesWillChangeNotifier, newNodes);
+  }
+}
+
+void NodeChangeBatch::nodesDidChange(const std::vector<mdl::Node*>& nodes)
+{
+  ++m_stats.requestedNotifications;
+  m_uncoalescedNodesDidChangeNotifier(nodes);
+
+  if (!coalescing())
+  {
+    deliver(m_nodesDidChangeNotifier, nodes);
+    return;
+  }
+
+  for (auto* node : nodes)
+  {
+    if (m_changedNodeSet.insert(node).second)
+    {
+      m_changedNodes.push_back(node);
+    }
+  }
+}
+
+void NodeChangeBatch::nodesWillBeRemoved(const std::vector<mdl::Node*>& nodes)
+{
+  if (m_changedNodes.empty())
+  {
+    return;
+  }
+
+  const auto removedNodes =
+    std::unordered_set<const mdl::Node*>{nodes.begin(), nodes.end()};
+  const auto isRemoved = [&](const mdl::Node* node) {
+    for (; node; node = node->parent())
+    {
+      if (removedNodes.contains(node))
+      {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  auto removedChangedNodes = std::vector<mdl::Node*>{};
+  std::erase_if(m_changedNodes, [&](auto* node) {
+    if (isRemoved(node))
+    {
+      m_changedNodeSet.erase(node);
+      removedChangedNodes.push_back(node);
+      return true;
+    }
+    return false;
+  });
+
+  if (!removedChangedNodes.empty())
+  {
+    deliver(m_nodesDidChangeNotifier, removedChangedNodes);
+  }
+}
+
+const NodeChangeStats& NodeChangeBatch::stats() const
+{
+  return m_stats;
+}
+
+void NodeChangeBatch::deliver(
+  NodeNotifier& notifier, const std::vector<mdl::Node*>& nodes)
+{
+  ++m_stats.deliveredNotifications;
+  m_stats.observerInvocations += notifier.observerCount();
+  notifier(nodes);
+}
+
+NotifyNodeChange::NotifyNodeChange(
+  NodeChangeBatch& batch, const std::vector<mdl::Node*>& nodes)
+  : m_batch{batch}
+  , m_nodes{nodes}
+{
+  m_batch.nodesWillChange(m_nodes);
+}
+
+NotifyNodeChange::~NotifyNodeChange()
+{
+  m_batch.nodesDidChange(m_nodes);
+}
+
+} // namespace tb::ui
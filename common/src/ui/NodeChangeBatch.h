@@ -0,0 +1,144 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Notifier.h"
+
+#include "kdl/reflection_decl.h"
+
+#include <cstddef>
+#include <unordered_set>
+#include <vector>
+
+namespace tb::mdl
+{
+class Node;
+}
+
+namespace tb::ui
+{
+enum class TransactionScope;
+
+/**
+ * Counts the node change notifications of the current command or transaction.
+ */
+struct NodeChangeStats
+{
+  /** The number of notifications that were requested by commands. */
+  size_t requestedNotifications = 0;
+  /** The number of notifications that were actually delivered. */
+  size_t deliveredNotifications = 0;
+  /** The number of times an observer was called by a delivered notification. */
+  size_t observerInvocations = 0;
+
+  kdl_reflect_decl(
+    NodeChangeStats, requestedNotifications, deliveredNotifications, observerInvocations);
+};
+
+/**
+ * Coalesces the node change notifications of a document while a oneshot transaction is
+ * running.
+ *
+ * While coalescing, the observers are notified that a node will change only the first
+ * time the node is passed to nodesWillChange, and the nodes that did change are
+ * accumulated and delivered in a single notification when the outermost oneshot
+ * transaction ends. Long running transactions are not coalesced because the user may
+ * observe their intermediate states.
+ *
+ * Observers of the coalesced notifications must tolerate that they learn about a change
+ * only when the transaction has ended. This is the case for views such as the map
+ * renderer and the issue browser, which only read their state when they are repainted or
+ * refreshed, which cannot happen while a oneshot transaction is running. Observers that
+ * maintain state which the following commands of the same transaction read, such as the
+ * node tags, must observe the uncoalesced notifier instead, which is notified every time
+ * nodes did change.
+ */
+class NodeChangeBatch
+{
+private:
+  using NodeNotifier = Notifier<const std::vector<mdl::Node*>&>;
+
+  NodeNotifier& m_nodesWillChangeNotifier;
+  NodeNotifier& m_nodesDidChangeNotifier;
+  NodeNotifier& m_uncoalescedNodesDidChangeNotifier;
+
+  std::vector<TransactionScope> m_scopes;
+  size_t m_oneshotScopeCount = 0;
+
+  std::vector<mdl::Node*> m_changedNodes;
+  std::unordered_set<mdl::Node*> m_changedNodeSet;
+
+  NodeChangeStats m_stats;
+
+public:
+  NodeChangeBatch(
+    NodeNotifier& nodesWillChangeNotifier,
+    NodeNotifier& nodesDidChangeNotifier,
+    NodeNotifier& uncoalescedNodesDidChangeNotifier);
+
+  /**
+   * Begins a new scope. If this is the outermost scope, the stats are reset.
+   */
+  void begin(TransactionScope scope);
+
+  /**
+   * Ends the innermost scope. If it was the outermost oneshot scope, the accumulated
+   * changed nodes are delivered.
+   */
+  void end();
+
+  bool coalescing() const;
+
+  void nodesWillChange(const std::vector<mdl::Node*>& nodes);
+  void nodesDidChange(const std::vector<mdl::Node*>& nodes);
+
+  /**
+   * Delivers the accumulated changes of the given nodes and their descendants while they
+   * are still part of the document and forgets them, so that every node that was
+   * reported as changing is also reported as changed, but not after it was removed.
+   */
+  void nodesWillBeRemoved(const std::vector<mdl::Node*>& nodes);
+
+  const NodeChangeStats& stats() const;
+
+private:
+  void deliver(NodeNotifier& notifier, const std::vector<mdl::Node*>& nodes);
+};
+
+/**
+ * RAII helper that passes the given nodes to NodeChangeBatch::nodesWillChange when it is
+ * created and to NodeChangeBatch::nodesDidChange when it is destroyed. The given nodes
+ * must outlive this object.
+ */
+class NotifyNodeChange
+{
+private:
+  NodeChangeBatch& m_batch;
+  const std::vector<mdl::Node*>& m_nodes;
+
+public:
+  NotifyNodeChange(NodeChangeBatch& batch, const std::vector<mdl::Node*>& nodes);
+  ~NotifyNodeChange();
+
+  NotifyNodeChange(const NotifyNodeChange&) = delete;
+  NotifyNodeChange& operator=(const NotifyNodeChange&) = delete;
+};
+
+} // namespace tb::ui
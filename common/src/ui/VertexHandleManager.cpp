@@ -28,11 +28,54 @@
 #include "vm/distance.h"
 #include "vm/polygon.h"
 #include "vm/ray.h"
+#include "vm/segment.h"
 #include "vm/vec.h"
 
+#include <algorithm>
+
 namespace tb::ui
 {
 
+namespace detail
+{
+vm::vec3d handlePosition(const vm::vec3d& handle)
+{
+  return handle;
+}
+
+vm::vec3d handlePosition(const vm::segment3d& handle)
+{
+  return handle.center();
+}
+
+vm::vec3d handlePosition(const vm::polygon3d& handle)
+{
+  return handle.center();
+}
+
+double handleExtent(const vm::vec3d& /* handle */)
+{
+  return 0.0;
+}
+
+double handleExtent(const vm::segment3d& handle)
+{
+  return handle.length() / 2.0;
+}
+
+double handleExtent(const vm::polygon3d& handle)
+{
+  const auto center = handle.center();
+
+  auto result = 0.0;
+  for (const auto& vertex : handle.vertices())
+  {
+    result = std::max(result, vm::distance(center, vertex));
+  }
+  return result;
+}
+} // namespace detail
+
 VertexHandleManagerBase::~VertexHandleManagerBase() = default;
 
 const mdl::HitType::Type VertexHandleManager::HandleHitType = mdl::HitType::freeType();
@@ -42,34 +85,32 @@ void VertexHandleManager::pick(
   const render::Camera& camera,
   mdl::PickResult& pickResult) const
 {
-  for (const auto& [position, info] : m_handles)
-  {
-    if (
-      const auto distance = camera.pickPointHandle(
-        pickRay, position, double(pref(Preferences::HandleRadius))))
+  const auto handleRadius = double(pref(Preferences::HandleRadius));
+  forEachPickableHandle(pickRay, camera, handleRadius, [&](const auto& position) {
+    if (const auto distance = camera.pickPointHandle(pickRay, position, handleRadius))
     {
       const auto hitPoint = vm::point_at_distance(pickRay, *distance);
       const auto error = vm::squared_distance(pickRay, position).distance;
       pickResult.addHit(mdl::Hit(HandleHitType, *distance, hitPoint, position, error));
     }
-  }
+  });
 }
 
-void VertexHandleManager::addHandles(const mdl::BrushNode* brushNode)
+void VertexHandleManager::addHandles(mdl::BrushNode* brushNode)
 {
   const auto& brush = brushNode->brush();
   for (const auto* vertex : brush.vertices())
   {
-    add(vertex->position());
+    add(vertex->position(), brushNode);
   }
 }
 
-void VertexHandleManager::removeHandles(const mdl::BrushNode* brushNode)
+void VertexHandleManager::removeHandles(mdl::BrushNode* brushNode)
 {
   const auto& brush = brushNode->brush();
   for (const auto* vertex : brush.vertices())
   {
-    assertResult(remove(vertex->position()));
+    assertResult(remove(vertex->position(), brushNode));
   }
 }
 
@@ -78,13 +119,6 @@ mdl::HitType::Type VertexHandleManager::hitType() const
   return HandleHitType;
 }
 
-bool VertexHandleManager::isIncident(
-  const Handle& handle, const mdl::BrushNode* brushNode) const
-{
-  const auto& brush = brushNode->brush();
-  return brush.hasVertex(handle);
-}
-
 const mdl::HitType::Type EdgeHandleManager::HandleHitType = mdl::HitType::freeType();
 
 void EdgeHandleManager::pickGridHandle(
@@ -93,19 +127,18 @@ void EdgeHandleManager::pickGridHandle(
   const Grid& grid,
   mdl::PickResult& pickResult) const
 {
-  for (const auto& [position, info] : m_handles)
-  {
+  const auto handleRadius = double(pref(Preferences::HandleRadius));
+  forEachPickableHandle(pickRay, camera, handleRadius, [&](const auto& position) {
     if (
-      const auto edgeDist = camera.pickLineSegmentHandle(
-        pickRay, position, double(pref(Preferences::HandleRadius))))
+      const auto edgeDist = camera.pickLineSegmentHandle(pickRay, position, handleRadius))
     {
       if (
         const auto pointHandle =
           grid.snap(vm::point_at_distance(pickRay, *edgeDist), position))
       {
         if (
-          const auto pointDist = camera.pickPointHandle(
-            pickRay, *pointHandle, double(pref(Preferences::HandleRadius))))
+          const auto pointDist =
+            camera.pickPointHandle(pickRay, *pointHandle, handleRadius))
         {
           const auto hitPoint = vm::point_at_distance(pickRay, *pointDist);
           pickResult.addHit(mdl::Hit{
@@ -113,7 +146,7 @@ void EdgeHandleManager::pickGridHandle(
         }
       }
     }
-  }
+  });
 }
 
 void EdgeHandleManager::pickCenterHandle(
@@ -121,36 +154,37 @@ void EdgeHandleManager::pickCenterHandle(
   const render::Camera& camera,
   mdl::PickResult& pickResult) const
 {
-  for (const auto& [position, info] : m_handles)
-  {
+  const auto handleRadius = double(pref(Preferences::HandleRadius));
+  forEachPickableHandle(pickRay, camera, handleRadius, [&](const auto& position) {
     const auto pointHandle = position.center();
 
-    if (
-      const auto pointDist = camera.pickPointHandle(
-        pickRay, pointHandle, double(pref(Preferences::HandleRadius))))
+    if (const auto pointDist = camera.pickPointHandle(pickRay, pointHandle, handleRadius))
     {
       const auto hitPoint = vm::point_at_distance(pickRay, *pointDist);
       pickResult.addHit(mdl::Hit{HandleHitType, *pointDist, hitPoint, position});
     }
-  }
+  });
 }
 
-void EdgeHandleManager::addHandles(const mdl::BrushNode* brushNode)
+void EdgeHandleManager::addHandles(mdl::BrushNode* brushNode)
 {
   const auto& brush = brushNode->brush();
   for (const auto* edge : brush.edges())
   {
-    add(vm::segment3d{edge->firstVertex()->position(), edge->secondVertex()->position()});
+    add(
+      vm::segment3d{edge->firstVertex()->position(), edge->secondVertex()->position()},
+      brushNode);
   }
 }
 
-void EdgeHandleManager::removeHandles(const mdl::BrushNode* brushNode)
+void EdgeHandleManager::removeHandles(mdl::BrushNode* brushNode)
 {
   const auto& brush = brushNode->brush();
   for (const auto* edge : brush.edges())
   {
     assertResult(remove(
-      vm::segment3d{edge->firstVertex()->position(), edge->secondVertex()->position()}));
+      vm::segment3d{edge->firstVertex()->position(), edge->secondVertex()->position()},
+      brushNode));
   }
 }
 
@@ -159,13 +193,6 @@ mdl::HitType::Type EdgeHandleManager::hitType() const
   return HandleHitType;
 }
 
-bool EdgeHandleManager::isIncident(
-  const Handle& handle, const mdl::BrushNode* brushNode) const
-{
-  const auto& brush = brushNode->brush();
-  return brush.hasEdge(handle);
-}
-
 const mdl::HitType::Type FaceHandleManager::HandleHitType = mdl::HitType::freeType();
 
 void FaceHandleManager::pickGridHandle(
@@ -174,8 +201,8 @@ void FaceHandleManager::pickGridHandle(
   const Grid& grid,
   mdl::PickResult& pickResult) const
 {
-  for (const auto& [position, info] : m_handles)
-  {
+  const auto handleRadius = double(pref(Preferences::HandleRadius));
+  forEachPickableHandle(pickRay, camera, handleRadius, [&](const auto& position) {
     if (const auto plane = vm::from_points(std::begin(position), std::end(position)))
     {
       if (
@@ -186,8 +213,8 @@ void FaceHandleManager::pickGridHandle(
           grid.snap(vm::point_at_distance(pickRay, *distance), *plane);
 
         if (
-          const auto pointDist = camera.pickPointHandle(
-            pickRay, pointHandle, double(pref(Preferences::HandleRadius))))
+          const auto pointDist =
+            camera.pickPointHandle(pickRay, pointHandle, handleRadius))
         {
           const auto hitPoint = vm::point_at_distance(pickRay, *pointDist);
           pickResult.addHit(mdl::Hit{
@@ -195,7 +222,7 @@ void FaceHandleManager::pickGridHandle(
         }
       }
     }
-  }
+  });
 }
 
 void FaceHandleManager::pickCenterHandle(
@@ -203,35 +230,33 @@ void FaceHandleManager::pickCenterHandle(
   const render::Camera& camera,
   mdl::PickResult& pickResult) const
 {
-  for (const auto& [position, info] : m_handles)
-  {
+  const auto handleRadius = double(pref(Preferences::HandleRadius));
+  forEachPickableHandle(pickRay, camera, handleRadius, [&](const auto& position) {
     const auto pointHandle = position.center();
 
-    if (
-      const auto pointDist = camera.pickPointHandle(
-        pickRay, pointHandle, double(pref(Preferences::HandleRadius))))
+    if (const auto pointDist = camera.pickPointHandle(pickRay, pointHandle, handleRadius))
     {
       const auto hitPoint = vm::point_at_distance(pickRay, *pointDist);
       pickResult.addHit(mdl::Hit{HandleHitType, *pointDist, hitPoint, position});
     }
-  }
+  });
 }
 
-void FaceHandleManager::addHandles(const mdl::BrushNode* brushNode)
+void FaceHandleManager::addHandles(mdl::BrushNode* brushNode)
 {
   const auto& brush = brushNode->brush();
   for (const auto& face : brush.faces())
   {
-    add(face.polygon());
+    add(face.polygon(), brushNode);
   }
 }
 
-void FaceHandleManager::removeHandles(const mdl::BrushNode* brushNode)
+void FaceHandleManager::removeHandles(mdl::BrushNode* brushNode)
 {
   const auto& brush = brushNode->brush();
   for (const auto& face : brush.faces())
   {
-    assertResult(remove(face.polygon()));
+    assertResult(remove(face.polygon(), brushNode));
   }
 }
 
@@ -240,11 +265,4 @@ mdl::HitType::Type FaceHandleManager::hitType() const
   return HandleHitType;
 }
 
-bool FaceHandleManager::isIncident(
-  const Handle& handle, const mdl::BrushNode* brushNode) const
-{
-  const auto& brush = brushNode->brush();
-  return brush.hasFace(handle);
-}
-
 } // namespace tb::ui
@@ -23,9 +23,18 @@
 #include "mdl/HitType.h"
 #include "mdl/PickResult.h"
 #include "render/Camera.h"
+#include "spatial_grid.h"
 
 #include "kdl/vector_set.h"
 
+#include "vm/bbox.h"
+#include "vm/distance.h"
+#include "vm/polygon.h"
+#include "vm/ray.h"
+#include "vm/segment.h"
+#include "vm/vec.h"
+
+#include <algorithm>
 #include <iterator>
 #include <map>
 #include <vector>
@@ -39,6 +48,24 @@ namespace tb::ui
 {
 class Grid;
 
+namespace detail
+{
+/**
+ * Returns the point at which the given handle is stored in the handle grid. This is the
+ * center point for edge and face handles.
+ */
+vm::vec3d handlePosition(const vm::vec3d& handle);
+vm::vec3d handlePosition(const vm::segment3d& handle);
+vm::vec3d handlePosition(const vm::polygon3d& handle);
+
+/**
+ * Returns the maximum distance of any point of the given handle from its position.
+ */
+double handleExtent(const vm::vec3d& handle);
+double handleExtent(const vm::segment3d& handle);
+double handleExtent(const vm::polygon3d& handle);
+} // namespace detail
+
 class VertexHandleManagerBase
 {
 public:
@@ -67,7 +94,7 @@ public:
    *
    * @param brushNode the brush whose handles to add
    */
-  virtual void addHandles(const mdl::BrushNode* brushNode) = 0;
+  virtual void addHandles(mdl::BrushNode* brushNode) = 0;
 
   /**
    * Removes all handles of the given range of brushes from this handle manager.
@@ -91,7 +118,7 @@ public:
    *
    * @param brushNode the brush whose handles to remove
    */
-  virtual void removeHandles(const mdl::BrushNode* brushNode) = 0;
+  virtual void removeHandles(mdl::BrushNode* brushNode) = 0;
 };
 
 template <typename H>
@@ -104,17 +131,16 @@ public:
 private:
 protected:
   /**
-   * Represents the status of a handle, i.e., how many duplicates exist at the same
+   * Represents the status of a handle, i.e., which brushes have a handle at the same
    * coordinates and whether or not all of these are selected.
    */
   struct HandleInfo
   {
-    size_t count;
+    kdl::vector_set<mdl::BrushNode*> brushes;
     bool selected;
 
     HandleInfo()
-      : count(0)
-      , selected(false)
+      : selected(false)
     {
     }
 
@@ -152,26 +178,33 @@ protected:
       selected = !selected;
       return selected;
     }
-
-    /**
-     * Increments the number of handles at the same coordinates.
-     */
-    void inc() { ++count; }
-
-    /**
-     * Deccrements the number of handles at the same coordinates.
-     */
-    void dec() { --count; }
   };
 
   using HandleMap = std::map<H, HandleInfo>;
   using HandleEntry = typename HandleMap::value_type;
 
+  /**
+   * The edge length of the cells of the handle grid. Brushes are usually built on grid
+   * sizes between 8 and 64 units, so a cell contains only a few handles.
+   */
+  static constexpr double HandleGridCellSize = 64.0;
+
+  /**
+   * The distance at which the perspective scaling factor is sampled when picking. Larger
+   * distances reduce the rounding error of the sampled gradient.
+   */
+  static constexpr double ScalingSampleDistance = 1024.0;
+
   /**
    * Maps a handle position to its info.
    */
   HandleMap m_handles;
 
+  /**
+   * Spatial index over the entries of m_handles, keyed by handle position.
+   */
+  spatial_grid<double, HandleEntry*> m_handleGrid;
+
   /**
    * The total number of selected handles, not counting duplicates.
    */
@@ -179,7 +212,8 @@ protected:
 
 public:
   VertexHandleManagerBaseT()
-    : m_selectedHandleCount(0)
+    : m_handleGrid(HandleGridCellSize)
+    , m_selectedHandleCount(0)
   {
   }
 
@@ -310,34 +344,45 @@ public:
 
 public:
   /**
-   * Adds the given handle to this manager.
+   * Adds the given handle of the given brush to this manager.
    *
    * @param handle the handle to add
+   * @param brushNode the brush that the handle belongs to
    */
-  void add(const Handle& handle)
+  void add(const Handle& handle, mdl::BrushNode* brushNode)
   {
-    m_handles[handle].inc(); // unknown value gets value constructed, which for HandleInfo
-                             // means its default constructor is called
+    const auto [it, inserted] = m_handles.try_emplace(handle);
+    if (inserted)
+    {
+      m_handleGrid.insert(
+        detail::handlePosition(handle), detail::handleExtent(handle), &*it);
+    }
+    it->second.brushes.insert(brushNode);
   }
 
   /**
-   * Removes the given handle from this manager.
+   * Removes the given handle of the given brush from this manager.
    *
    * @param handle the handle to remove
-   * @return true if the given handle was contained in this manager (and therefore
-   * removed) and false otherwise
+   * @param brushNode the brush that the handle belongs to
+   * @return true if the given handle of the given brush was contained in this manager
+   * (and therefore removed) and false otherwise
    */
-  bool remove(const Handle& handle)
+  bool remove(const Handle& handle, mdl::BrushNode* brushNode)
   {
     const auto it = m_handles.find(handle);
     if (it != std::end(m_handles))
     {
       HandleInfo& info = it->second;
-      info.dec();
+      if (info.brushes.erase(brushNode) == 0)
+      {
+        return false;
+      }
 
-      if (info.count == 0)
+      if (info.brushes.empty())
       {
         deselect(info);
+        m_handleGrid.remove(detail::handlePosition(handle), &*it);
         m_handles.erase(it);
       }
       return true;
@@ -352,6 +397,7 @@ public:
   void clear()
   {
     m_handles.clear();
+    m_handleGrid.clear();
     m_selectedHandleCount = 0;
   }
 
@@ -458,11 +504,16 @@ private:
   void forEachCloseHandle(const H& otherHandle, F fun)
   {
     static const auto epsilon = 0.001 * 0.001;
-    for (auto& [handle, info] : m_handles)
+
+    auto entries = std::vector<HandleEntry*>{};
+    m_handleGrid.find_near(
+      detail::handlePosition(otherHandle), epsilon, std::back_inserter(entries));
+
+    for (auto* entry : entries)
     {
-      if (compare(otherHandle, handle, epsilon) == 0)
+      if (compare(otherHandle, entry->first, epsilon) == 0)
       {
-        fun(info);
+        fun(entry->second);
       }
     }
   }
@@ -500,6 +551,36 @@ private:
   }
 
 public:
+  /**
+   * Returns all handles whose position lies in a cell of the handle grid whose bounds
+   * satisfy the given predicate. The position of an edge or face handle is its center.
+   *
+   * The predicate can be called for bounds that contain several cells, and it must not
+   * reject such bounds if it accepts any of the cells contained in them.
+   *
+   * @tparam P the type of the predicate, must accept a const vm::bbox3d&
+   * @param predicate the predicate to test the cell bounds with
+   * @return a list containing the handles in all accepted cells
+   */
+  template <typename P>
+  HandleList findHandles(const P& predicate) const
+  {
+    auto entries = std::vector<HandleEntry*>{};
+    m_handleGrid.find_if(
+      [&](const vm::bbox3d& bounds, const double /* extent */) {
+        return predicate(bounds);
+      },
+      std::back_inserter(entries));
+
+    auto result = HandleList{};
+    result.reserve(entries.size());
+    for (const auto* entry : entries)
+    {
+      result.push_back(entry->first);
+    }
+    return result;
+  }
+
   /**
    * Applies the given picking test to all handles in this manager and adds all hits to
    * the given picking result.
@@ -522,83 +603,112 @@ public:
     }
   }
 
+protected:
+  /**
+   * Calls the given function for every handle that could be hit by the given picking ray
+   * in the context of the given camera. Handles far away from the picking ray are skipped
+   * using the handle grid.
+   *
+   * Any part of a handle can be hit as long as the distance of the hit point to the
+   * picking ray does not exceed the scaled handle radius at that point.
+   *
+   * @tparam F the type of the function to call, must accept a const Handle&
+   * @param pickRay the picking ray
+   * @param camera the camera
+   * @param handleRadius the unscaled handle radius
+   * @param fun the function to call
+   */
+  template <typename F>
+  void forEachPickableHandle(
+    const vm::ray3d& pickRay,
+    const render::Camera& camera,
+    const double handleRadius,
+    const F& fun) const
+  {
+    // The scaling factor is an affine function of the position, so it is determined by
+    // its value at one point and its gradient.
+    const auto scalingAt = [&](const vm::vec3d& position) {
+      return double(camera.perspectiveScalingFactor(vm::vec3f{position}));
+    };
+    const auto origin = pickRay.origin;
+    const auto originScaling = scalingAt(origin);
+    const auto scalingGradient =
+      vm::vec3d{
+        scalingAt(origin + vm::vec3d{ScalingSampleDistance, 0, 0}) - originScaling,
+        scalingAt(origin + vm::vec3d{0, ScalingSampleDistance, 0}) - originScaling,
+        scalingAt(origin + vm::vec3d{0, 0, ScalingSampleDistance}) - originScaling}
+      / ScalingSampleDistance;
+
+    auto entries = std::vector<HandleEntry*>{};
+    m_handleGrid.find_if(
+      [&](const vm::bbox3d& bounds, const double extent) {
+        const auto center = bounds.center();
+        const auto halfSize = bounds.size() / 2.0 + vm::vec3d::fill(extent);
+        const auto maxScaling = originScaling + vm::dot(scalingGradient, center - origin)
+                                + vm::dot(vm::abs(scalingGradient), halfSize);
+
+        const auto maxDistance =
+          vm::length(halfSize) + 2.0 * handleRadius * std::max(maxScaling, 0.0);
+        return vm::squared_distance(pickRay, center).distance
+               <= maxDistance * maxDistance;
+      },
+      std::back_inserter(entries));
+
+    for (const auto* entry : entries)
+    {
+      fun(entry->first);
+    }
+  }
+
 public:
   /**
-   * Finds and returns all brushes in the given range which are incident to the given
-   * handle.
+   * Finds and returns all brushes which are incident to the given handle.
    *
-   * @tparam I the type of the range iterators
    * @param handle the handle
-   * @param begin the beginning of the range of brushes
-   * @param end the end of the range of brushes
    * @return a set of all brushes that are incident to the given handle
    */
-  template <typename I>
-  std::vector<mdl::BrushNode*> findIncidentBrushes(
-    const Handle& handle, I begin, I end) const
+  std::vector<mdl::BrushNode*> findIncidentBrushes(const Handle& handle) const
   {
-    kdl::vector_set<mdl::BrushNode*> result;
-    findIncidentBrushes(handle, begin, end, std::inserter(result, result.end()));
-    return result.release_data();
+    const auto it = m_handles.find(handle);
+    return it != m_handles.end() ? it->second.brushes.get_data()
+                                 : std::vector<mdl::BrushNode*>{};
   }
 
   /**
-   * Finds and returns all brushes in the given range which are incident to any handle in
-   * the given range.
+   * Finds and returns all brushes which are incident to any handle in the given range.
    *
-   * @tparam I1 the type of range iterators for the range of handles
-   * @tparam I2 the type of range iterators for the range of brushes
-   * @param hBegin the beginning of the range of handles
-   * @param hEnd the end of the range of handles
-   * @param bBegin the beginning of the range of brushes
-   * @param bEnd the end of the range of brushes
+   * @tparam I the type of range iterators for the range of handles
+   * @param begin the beginning of the range of handles
+   * @param end the end of the range of handles
    * @return a set containing all incident brushes
    */
-  template <typename I1, typename I2>
-  std::vector<mdl::BrushNode*> findIncidentBrushes(
-    I1 hBegin, I1 hEnd, I2 bBegin, I2 bEnd) const
+  template <typename I>
+  std::vector<mdl::BrushNode*> findIncidentBrushes(I begin, I end) const
   {
     kdl::vector_set<mdl::BrushNode*> result;
     auto out = std::inserter(result, std::end(result));
-    for (auto hCur = hBegin; hCur != hEnd; ++hCur)
+    for (auto cur = begin; cur != end; ++cur)
     {
-      findIncidentBrushes(*hCur, bBegin, bEnd, out);
+      findIncidentBrushes(*cur, out);
     }
     return result.release_data();
   }
 
   /**
-   * Finds all brushes in the given range which are incident to the given handle.
+   * Finds all brushes which are incident to the given handle.
    *
-   * @tparam I the type of the range iterators
    * @tparam O an output iterator to append the resulting brushes to
    * @param handle the handle
-   * @param begin the beginning of the range of brushes
-   * @param end the end of the range of brushes
    * @param out an output iterator that accepts the incident brushes
    */
-  template <typename I, typename O>
-  void findIncidentBrushes(const Handle& handle, I begin, I end, O out) const
+  template <typename O>
+  void findIncidentBrushes(const Handle& handle, O out) const
   {
-    for (auto cur = begin; cur != end; ++cur)
+    if (const auto it = m_handles.find(handle); it != m_handles.end())
     {
-      if (isIncident(handle, *cur))
-      {
-        out++ = *cur;
-      }
+      std::copy(it->second.brushes.begin(), it->second.brushes.end(), out);
     }
   }
-
-private:
-  /**
-   * Checks whether the given brush is incident to the given handle.
-   *
-   * @param handle the handle to check
-   * @param brushNode the brush to check
-   * @return true if and only if the given brush is incident to the given handle
-   */
-  virtual bool isIncident(
-    const Handle& handle, const mdl::BrushNode* brushNode) const = 0;
 };
 
 /**
@@ -628,13 +738,10 @@ public:
     mdl::PickResult& pickResult) const;
 
 public:
-  void addHandles(const mdl::BrushNode* brushNode) override;
-  void removeHandles(const mdl::BrushNode* brushNode) override;
+  void addHandles(mdl::BrushNode* brushNode) override;
+  void removeHandles(mdl::BrushNode* brushNode) override;
 
   mdl::HitType::Type hitType() const override;
-
-private:
-  bool isIncident(const Handle& handle, const mdl::BrushNode* brushNode) const override;
 };
 
 /**
@@ -686,13 +793,10 @@ public:
     mdl::PickResult& pickResult) const;
 
 public:
-  void addHandles(const mdl::BrushNode* brushNode) override;
-  void removeHandles(const mdl::BrushNode* brushNode) override;
+  void addHandles(mdl::BrushNode* brushNode) override;
+  void removeHandles(mdl::BrushNode* brushNode) override;
 
   mdl::HitType::Type hitType() const override;
-
-private:
-  bool isIncident(const Handle& handle, const mdl::BrushNode* brushNode) const override;
 };
 
 /**
@@ -744,13 +848,10 @@ public:
     mdl::PickResult& pickResult) const;
 
 public:
-  void addHandles(const mdl::BrushNode* brushNode) override;
-  void removeHandles(const mdl::BrushNode* brushNode) override;
+  void addHandles(mdl::BrushNode* brushNode) override;
+  void removeHandles(mdl::BrushNode* brushNode) override;
 
   mdl::HitType::Type hitType() const override;
-
-private:
-  bool isIncident(const Handle& handle, const mdl::BrushNode* brushNode) const override;
 };
 
 } // namespace tb::ui
@@ -48,6 +48,7 @@
 #include "kdl/vector_set.h"
 #include "kdl/vector_utils.h"
 
+#include "vm/bbox.h"
 #include "vm/vec.h"
 #include "vm/vec_io.h" // IWYU pragma: keep
 
@@ -55,6 +56,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 namespace tb::mdl
@@ -90,6 +92,12 @@ protected:
 private:
   size_t m_changeCount = 0;
   size_t m_ignoreChangeNotifications = 0;
+  /**
+   * The nodes for which a will change notification was ignored. The document coalesces
+   * change notifications within a transaction, so the matching did change notification
+   * may arrive after the vertex command is done and must be ignored, too.
+   */
+  std::unordered_set<const mdl::Node*> m_ignoredChangingNodes;
   NotifierConnection m_notifierConnection;
 
 protected:
@@ -136,26 +144,14 @@ public:
   std::vector<mdl::BrushNode*> findIncidentBrushes(
     const M& manager, const H2& handle) const
   {
-    const auto& brushes = selectedBrushes();
-    return manager.findIncidentBrushes(handle, std::begin(brushes), std::end(brushes));
+    return manager.findIncidentBrushes(handle);
   }
 
   // FIXME: use vector_set
   template <typename M, typename I>
   std::vector<mdl::BrushNode*> findIncidentBrushes(const M& manager, I cur, I end) const
   {
-    const auto& brushes = selectedBrushes();
-    auto result = kdl::vector_set<mdl::BrushNode*>{};
-    auto out = std::inserter(result, std::end(result));
-
-    while (cur != end)
-    {
-      const auto& handle = *cur;
-      manager.findIncidentBrushes(handle, std::begin(brushes), std::end(brushes), out);
-      ++cur;
-    }
-
-    return result.release_data();
+    return manager.findIncidentBrushes(cur, end);
   }
 
   virtual void pick(
@@ -207,11 +203,12 @@ public: // Handle selection
 
   void select(const Lasso& lasso, const bool modifySelection)
   {
-    const auto allHandles = handleManager().allHandles();
+    const auto candidates = handleManager().findHandles(
+      [&](const vm::bbox3d& bounds) { return lasso.intersects(bounds); });
     auto selectedHandles = std::vector<H>{};
 
     lasso.selected(
-      std::begin(allHandles), std::end(allHandles), std::back_inserter(selectedHandles));
+      std::begin(candidates), std::end(candidates), std::back_inserter(selectedHandles));
     if (!modifySelection)
     {
       handleManager().deselectAll();
@@ -498,6 +495,7 @@ protected: // Tool interface
   bool doDeactivate() override
   {
     m_notifierConnection.disconnect();
+    m_ignoredChangingNodes.clear();
     handleManager().clear();
     return true;
   }
@@ -582,16 +580,26 @@ private: // Observers and state management
         kdl::vec_filter(nodes, [](const auto* node) { return node->selected(); });
       removeHandles(selectedNodes);
     }
+    else
+    {
+      m_ignoredChangingNodes.insert(nodes.begin(), nodes.end());
+    }
   }
 
   void nodesDidChange(const std::vector<mdl::Node*>& nodes)
   {
     if (m_ignoreChangeNotifications == 0u)
     {
-      const auto selectedNodes =
-        kdl::vec_filter(nodes, [](const auto* node) { return node->selected(); });
+      const auto selectedNodes = kdl::vec_filter(nodes, [&](const auto* node) {
+        return node->selected() && !m_ignoredChangingNodes.contains(node);
+      });
       addHandles(selectedNodes);
     }
+
+    for (const auto* node : nodes)
+    {
+      m_ignoredChangingNodes.erase(node);
+    }
   }
 
 protected:
@@ -621,15 +629,15 @@ protected:
   void addHandles(
     const std::vector<mdl::Node*>& nodes, VertexHandleManagerBaseT<HT>& handleManager)
   {
-    for (const auto* node : nodes)
+    for (auto* node : nodes)
     {
       node->accept(kdl::overload(
-        [](const mdl::WorldNode*) {},
-        [](const mdl::LayerNode*) {},
-        [](const mdl::GroupNode*) {},
-        [](const mdl::EntityNode*) {},
-        [&](const mdl::BrushNode* brush) { handleManager.addHandles(brush); },
-        [](const mdl::PatchNode*) {}));
+        [](mdl::WorldNode*) {},
+        [](mdl::LayerNode*) {},
+        [](mdl::GroupNode*) {},
+        [](mdl::EntityNode*) {},
+        [&](mdl::BrushNode* brush) { handleManager.addHandles(brush); },
+        [](mdl::PatchNode*) {}));
     }
   }
 
@@ -637,15 +645,15 @@ protected:
   void removeHandles(
     const std::vector<mdl::Node*>& nodes, VertexHandleManagerBaseT<HT>& handleManager)
   {
-    for (const auto* node : nodes)
+    for (auto* node : nodes)
     {
       node->accept(kdl::overload(
-        [](const mdl::WorldNode*) {},
-        [](const mdl::LayerNode*) {},
-        [](const mdl::GroupNode*) {},
-        [](const mdl::EntityNode*) {},
-        [&](const mdl::BrushNode* brush) { handleManager.removeHandles(brush); },
-        [](const mdl::PatchNode*) {}));
+        [](mdl::WorldNode*) {},
+        [](mdl::LayerNode*) {},
+        [](mdl::GroupNode*) {},
+        [](mdl::EntityNode*) {},
+        [&](mdl::BrushNode* brush) { handleManager.removeHandles(brush); },
+        [](mdl::PatchNode*) {}));
     }
   }
 
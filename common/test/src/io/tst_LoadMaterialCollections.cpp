@@ -27,6 +27,7 @@
 #include "mdl/MaterialCollection.h"
 #include "mdl/Resource.h"
 #include "mdl/Texture.h"
+#include "mdl/TextureResource.h"
 
 #include "kdl/reflection_impl.h"
 #include "kdl/task_manager.h"
@@ -156,6 +157,52 @@ TEST_CASE("loadMaterial")
   }
 }
 
+TEST_CASE("loadMaterialCollections reads texture headers")
+{
+  auto fs = VirtualFileSystem{};
+  auto logger = NullLogger{};
+
+  const auto workDir = std::filesystem::current_path();
+
+  auto taskManager = kdl::task_manager{};
+
+  const auto wadPath = workDir / "fixture/test/io/Wad/cr8_czg.wad";
+  fs.mount("", std::make_unique<DiskFileSystem>(workDir)); // to find the palette
+  fs.mount("textures", openFS<WadFileSystem>(wadPath));
+
+  const auto materialConfig = mdl::MaterialConfig{
+    "textures",
+    {".D"},
+    "fixture/test/palette.lmp",
+    "wad",
+    "",
+    {},
+  };
+
+  const auto createDeferredResource = [](auto resourceLoader) {
+    return std::make_shared<mdl::TextureResource>(
+      std::move(resourceLoader), mdl::LoadPolicy::OnDemand);
+  };
+
+  const auto materialCollections =
+    loadMaterialCollections(
+      fs, materialConfig, createDeferredResource, taskManager, logger)
+    | kdl::value();
+  REQUIRE(materialCollections.size() == 1);
+
+  const auto& materials = materialCollections.front().materials();
+  const auto iMaterial = std::find_if(
+    materials.begin(), materials.end(), [](const auto& material) {
+      return material.name() == "cr8_czg_3";
+    });
+  REQUIRE(iMaterial != materials.end());
+
+  CHECK(iMaterial->texture() == nullptr);
+  CHECK(iMaterial->textureResource().isDeferred());
+  CHECK(
+    iMaterial->textureHeader() == mdl::TextureHeader{64, 128, mdl::NoEmbeddedDefaults{}});
+}
+
 TEST_CASE("loadMaterialCollections")
 {
   auto fs = VirtualFileSystem{};
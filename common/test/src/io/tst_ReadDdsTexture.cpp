@@ -68,4 +68,17 @@ TEST_CASE("ReadDdsTextureTest.testLoadDds")
   assertTexture("dds_bc3.dds", 128, 128, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT);
 }
 
+TEST_CASE("ReadDdsTextureTest.testReadHeader")
+{
+  const auto ddsPath = std::filesystem::current_path() / "fixture/test/io/Dds/";
+  auto diskFS = DiskFileSystem{ddsPath};
+
+  const auto file = diskFS.openFile("dds_rgba.dds") | kdl::value();
+  auto reader = file->reader();
+  CHECK(
+    readDdsTextureHeader(reader)
+    == Result<mdl::TextureHeader>{
+      mdl::TextureHeader{128, 128, mdl::NoEmbeddedDefaults{}}});
+}
+
 } // namespace tb::io
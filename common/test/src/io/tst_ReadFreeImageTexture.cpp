@@ -148,6 +148,29 @@ TEST_CASE("readFreeImageTexture")
   }
 }
 
+TEST_CASE("readFreeImageTextureHeader")
+{
+  auto diskFS =
+    DiskFileSystem{std::filesystem::current_path() / "fixture/test/io/Image/"};
+
+  const auto file = diskFS.openFile("707x710.png") | kdl::value();
+  auto reader = file->reader();
+  CHECK(
+    readFreeImageTextureHeader(reader)
+    == Result<mdl::TextureHeader>{
+      mdl::TextureHeader{707, 710, mdl::NoEmbeddedDefaults{}}});
+
+  SECTION("Does not need the image data")
+  {
+    // the image data of this file starts at offset 110
+    auto headerReader = reader.subReaderFromBegin(0, 128).buffer();
+    CHECK(
+      readFreeImageTextureHeader(headerReader)
+      == Result<mdl::TextureHeader>{
+        mdl::TextureHeader{707, 710, mdl::NoEmbeddedDefaults{}}});
+  }
+}
+
 TEST_CASE("isSupportedFreeImageExtension")
 {
   CHECK(isSupportedFreeImageExtension(".jpg"));
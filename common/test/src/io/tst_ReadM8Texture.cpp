@@ -61,4 +61,15 @@ TEST_CASE("ReadM8TextureTest.testBasicLoading")
   }
 }
 
+TEST_CASE("ReadM8TextureTest.testReadHeader")
+{
+  auto fs = DiskFileSystem{std::filesystem::current_path()};
+  const auto file = fs.openFile("fixture/test/io/M8/test.m8") | kdl::value();
+
+  auto reader = file->reader();
+  CHECK(
+    readM8TextureHeader(reader)
+    == Result<mdl::TextureHeader>{mdl::TextureHeader{64, 64, mdl::NoEmbeddedDefaults{}}});
+}
+
 } // namespace tb::io
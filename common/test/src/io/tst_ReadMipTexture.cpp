@@ -25,6 +25,7 @@
 #include "io/ReadMipTexture.h"
 #include "io/WadFileSystem.h"
 #include "mdl/Palette.h"
+#include "mdl/Texture.h"
 
 #include "kdl/result.h"
 
@@ -85,6 +86,12 @@ TEST_CASE("readIdMipTexture")
 
   CHECK(texture.width() == width);
   CHECK(texture.height() == height);
+
+  auto headerReader = file->reader();
+  CHECK(
+    readMipTextureHeader(headerReader)
+    == Result<mdl::TextureHeader>{
+      mdl::TextureHeader{width, height, mdl::NoEmbeddedDefaults{}}});
 }
 
 TEST_CASE("readHlMipTexture")
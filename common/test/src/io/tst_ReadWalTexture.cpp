@@ -72,6 +72,11 @@ TEST_CASE("readWalTexture")
   CHECK(texture.width() == width);
   CHECK(texture.height() == height);
   CHECK(texture.embeddedDefaults() == embeddedDefaults);
+
+  auto headerReader = file->reader();
+  CHECK(
+    readWalTextureHeader(headerReader)
+    == Result<mdl::TextureHeader>{mdl::TextureHeader{width, height, embeddedDefaults}});
 }
 
 } // namespace tb::io
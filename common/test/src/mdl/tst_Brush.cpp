@@ -31,6 +31,7 @@
 #include "kdl/vector_utils.h"
 
 #include "vm/approx.h"
+#include "vm/mat_ext.h"
 #include "vm/polygon.h"
 #include "vm/segment.h"
 #include "vm/vec.h"
@@ -465,6 +466,32 @@ TEST_CASE("BrushTest.moveVertex")
   assertMaterial("bottom", brush, p1, p3, p7, p5);
 }
 
+TEST_CASE("BrushTest.moveVertexKeepsUnchangedFaces")
+{
+  const auto worldBounds = vm::bbox3d{4096.0};
+
+  auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+  const auto cube =
+    builder.createCube(64.0, "left", "right", "front", "back", "top", "bottom")
+    | kdl::value();
+
+  auto brush = cube;
+  CHECK(brush
+          .moveVertices(
+            worldBounds, {vm::vec3d{+32, +32, +32}}, vm::vec3d{-16, -16, 0})
+          .is_success());
+
+  // the faces that don't contain the moved vertex keep their points
+  for (const auto& name : {"left", "front", "bottom"})
+  {
+    const auto oldFaceIndex = cube.findFace(name);
+    const auto newFaceIndex = brush.findFace(name);
+    REQUIRE(oldFaceIndex);
+    REQUIRE(newFaceIndex);
+    CHECK(brush.face(*newFaceIndex).points() == cube.face(*oldFaceIndex).points());
+  }
+}
+
 TEST_CASE("BrushTest.moveTetrahedronVertexToOpposideSide")
 {
   const auto worldBounds = vm::bbox3d{4096.0};
@@ -2102,6 +2129,71 @@ TEST_CASE("moveFaceWithUVLock")
   }
 }
 
+TEST_CASE("BrushTest.transform")
+{
+  const auto worldBounds = vm::bbox3d{4096.0};
+
+  auto builder = BrushBuilder{MapFormat::Valve, worldBounds};
+  const auto brush = builder.createBrush(
+                       std::vector<vm::vec3d>{
+                         {-16, -16, -16},
+                         {16, -16, -16},
+                         {16, 16, -16},
+                         {-16, 16, -16},
+                         {-16, -16, 16},
+                         {16, -16, 16},
+                         {0, 16, 32}},
+                       "material")
+                     | kdl::value();
+
+  SECTION("Transformed geometry matches rebuilt geometry")
+  {
+    const auto transformation = GENERATE(values<vm::mat4x4d>({
+      vm::translation_matrix(vm::vec3d{32, -16, 8}),
+      vm::translation_matrix(vm::vec3d{0.25, 1024, -0.5}),
+      vm::rotation_matrix(vm::vec3d{0, 0, 1}, vm::to_radians(90.0)),
+      vm::translation_matrix(vm::vec3d{8, 0, 0})
+        * vm::rotation_matrix(vm::vec3d{1, 0, 0}, vm::to_radians(270.0)),
+      vm::rotation_matrix(vm::normalize(vm::vec3d{1, 2, 3}), vm::to_radians(37.0)),
+      vm::mirror_matrix<double>(vm::axis::x),
+      vm::mirror_matrix<double>(vm::axis::y),
+      vm::mirror_matrix<double>(vm::axis::z),
+      vm::translation_matrix(vm::vec3d{-8, 16, 0})
+        * vm::rotation_matrix(vm::vec3d{0, 0, 1}, vm::to_radians(90.0))
+        * vm::mirror_matrix<double>(vm::axis::y),
+      vm::scaling_matrix(vm::vec3d{2, 1, 1}),
+    }));
+    const auto lockMaterials = GENERATE(false, true);
+
+    CAPTURE(transformation, lockMaterials);
+
+    auto transformed = brush;
+    REQUIRE(
+      transformed.transform(worldBounds, transformation, lockMaterials).is_success());
+
+    const auto rebuilt = Brush::create(worldBounds, transformed.faces()) | kdl::value();
+    CHECK(transformed.faces() == rebuilt.faces());
+    CHECK(transformed.bounds().min == vm::approx{rebuilt.bounds().min});
+    CHECK(transformed.bounds().max == vm::approx{rebuilt.bounds().max});
+
+    for (size_t i = 0; i < transformed.faceCount(); ++i)
+    {
+      CHECK(rebuilt.face(i).hasVertices(transformed.face(i).polygon(), 0.0001));
+      CHECK(
+        transformed.face(i).boundary().normal
+        == vm::approx{transformed.face(i).geometry()->normal()});
+    }
+  }
+
+  SECTION("Transforming past world bounds fails")
+  {
+    auto transformed = brush;
+    CHECK(transformed
+            .transform(worldBounds, vm::translation_matrix(vm::vec3d{4096, 0, 0}), false)
+            .is_error());
+  }
+}
+
 TEST_CASE("BrushTest.subtractCuboidFromCuboid")
 {
   const auto worldBounds = vm::bbox3d{4096.0};
@@ -0,0 +1,152 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mdl/Brush.h"
+#include "mdl/BrushBuilder.h"
+#include "mdl/BrushDelta.h"
+#include "mdl/MapFormat.h"
+
+#include "kdl/result.h"
+#include "kdl/vector_utils.h"
+
+#include "vm/mat.h"
+#include "vm/mat_ext.h"
+#include "vm/scalar.h"
+#include "vm/vec.h"
+
+#include "Catch2.h"
+
+namespace tb::mdl
+{
+TEST_CASE("BrushDelta")
+{
+  const auto worldBounds = vm::bbox3d{8192.0};
+
+  auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+  const auto cube = builder.createCube(64.0, "material") | kdl::value();
+
+  SECTION("Delta between equal brushes is empty")
+  {
+    const auto delta = BrushDelta{cube, cube};
+    CHECK(delta.faceCount() == 0u);
+    CHECK(delta.apply(cube.faces()) == cube.faces());
+    CHECK(delta.revert(cube.faces()) == cube.faces());
+  }
+
+  SECTION("Delta only stores changed faces")
+  {
+    auto moved = cube;
+    REQUIRE(moved
+              .moveVertices(
+                worldBounds, {vm::vec3d{32, 32, 32}}, vm::vec3d{-16, -16, -16})
+              .is_success());
+
+    const auto delta = BrushDelta{cube, moved};
+    CHECK(delta.faceCount() > 0u);
+    CHECK(delta.faceCount() < cube.faceCount() + moved.faceCount());
+
+    SECTION("Applying the delta restores the new cube exactly")
+    {
+      const auto applied = delta.apply(worldBounds, cube) | kdl::value();
+      CHECK(applied == moved);
+      CHECK(applied.vertexPositions() == moved.vertexPositions());
+    }
+
+    SECTION("Reverting the delta restores the old cube exactly")
+    {
+      const auto reverted = delta.revert(worldBounds, moved) | kdl::value();
+      CHECK(reverted == cube);
+      CHECK(reverted.vertexPositions() == cube.vertexPositions());
+    }
+  }
+
+  SECTION("Moving off grid vertices of a rotated brush is restored exactly")
+  {
+    const auto transform = GENERATE(
+      vm::mat4x4d::identity(),
+      vm::rotation_matrix(vm::vec3d{0, 0, 1}, vm::to_radians(30.0)),
+      vm::rotation_matrix(vm::normalize(vm::vec3d{1, 2, 3}), vm::to_radians(17.0)));
+    const auto delta = GENERATE(vm::vec3d{-3.3, 1.7, -2.9}, vm::vec3d{-0.125, 0, 0});
+
+    auto rotated = cube;
+    REQUIRE(rotated.transform(worldBounds, transform, false).is_success());
+
+    auto first = rotated;
+    const auto firstVertex = first.vertexPositions().front();
+    REQUIRE(first.canMoveVertices(worldBounds, {firstVertex}, delta));
+    REQUIRE(first.moveVertices(worldBounds, {firstVertex}, delta).is_success());
+
+    auto second = first;
+    const auto secondVertex = second.vertexPositions().back();
+    REQUIRE(second.canMoveVertices(worldBounds, {secondVertex}, -delta));
+    REQUIRE(second.moveVertices(worldBounds, {secondVertex}, -delta).is_success());
+
+    const auto firstDelta = BrushDelta{rotated, first};
+    const auto secondDelta = BrushDelta{first, second};
+    const auto composedDelta = BrushDelta::compose(firstDelta, secondDelta);
+
+    const auto applied = composedDelta.apply(worldBounds, rotated) | kdl::value();
+    CHECK(applied == second);
+    CHECK(applied.vertexPositions() == second.vertexPositions());
+
+    const auto reverted = composedDelta.revert(worldBounds, applied) | kdl::value();
+    CHECK(reverted == rotated);
+    CHECK(
+      kdl::vec_sort(reverted.vertexPositions())
+      == kdl::vec_sort(rotated.vertexPositions()));
+
+    const auto revertedSecond = secondDelta.revert(worldBounds, second) | kdl::value();
+    CHECK(revertedSecond == first);
+    CHECK(revertedSecond.vertexPositions() == first.vertexPositions());
+  }
+
+  SECTION("Deltas can be composed")
+  {
+    auto first = cube;
+    REQUIRE(first
+              .moveVertices(
+                worldBounds, {vm::vec3d{32, 32, 32}}, vm::vec3d{-16, -16, -16})
+              .is_success());
+
+    auto second = first;
+    REQUIRE(second
+              .moveVertices(
+                worldBounds, {vm::vec3d{-32, -32, -32}}, vm::vec3d{8, 8, 8})
+              .is_success());
+
+    const auto firstDelta = BrushDelta{cube, first};
+    const auto secondDelta = BrushDelta{first, second};
+
+    const auto composedDelta = BrushDelta::compose(firstDelta, secondDelta);
+    CHECK(composedDelta.apply(cube.faces()) == second.faces());
+    CHECK(composedDelta.revert(second.faces()) == cube.faces());
+    CHECK((composedDelta.apply(worldBounds, cube) | kdl::value()) == second);
+    CHECK((composedDelta.revert(worldBounds, second) | kdl::value()) == cube);
+
+    SECTION("Composing with the inverse delta")
+    {
+      const auto inverseDelta = BrushDelta{second, first};
+      const auto roundTripDelta = BrushDelta::compose(secondDelta, inverseDelta);
+      CHECK(roundTripDelta.apply(first.faces()) == first.faces());
+      CHECK(roundTripDelta.revert(first.faces()) == first.faces());
+    }
+  }
+}
+
+} // namespace tb::mdl
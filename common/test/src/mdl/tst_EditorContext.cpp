@@ -30,6 +30,8 @@
 #include "mdl/LockState.h"
 #include "mdl/MapFormat.h"
 #include "mdl/PatchNode.h"
+#include "mdl/TagManager.h"
+#include "mdl/TagMatcher.h"
 #include "mdl/VisibilityState.h"
 #include "mdl/WorldNode.h"
 
@@ -1203,4 +1205,108 @@ TEST_CASE_METHOD(EditorContextTest, "EditorContextTest.testGroupedNodes")
   }
 }
 
+TEST_CASE_METHOD(EditorContextTest, "EditorContextTest.cachedStates")
+{
+  auto [groupNode, brushNode] = createGroupedBrush();
+
+  REQUIRE(context.visible(groupNode));
+  REQUIRE(context.visible(brushNode));
+  REQUIRE(context.selectable(groupNode));
+  REQUIRE_FALSE(context.selectable(brushNode));
+
+  SECTION("Changing the visibility of a child updates the visibility of its group")
+  {
+    brushNode->setVisibilityState(VisibilityState::Hidden);
+
+    CHECK_FALSE(context.visible(brushNode));
+    CHECK_FALSE(context.visible(groupNode));
+  }
+
+  SECTION("Locking a group updates the editability of its children")
+  {
+    groupNode->setLockState(LockState::Locked);
+
+    CHECK_FALSE(context.editable(groupNode));
+    CHECK_FALSE(context.editable(brushNode));
+    CHECK_FALSE(context.selectable(groupNode));
+  }
+
+  SECTION("Opening a group updates the selectability of its children")
+  {
+    context.pushGroup(groupNode);
+
+    CHECK_FALSE(context.selectable(groupNode));
+    CHECK(context.selectable(brushNode));
+  }
+
+  SECTION("Adding a child to a group updates the visibility of its group")
+  {
+    brushNode->setVisibilityState(VisibilityState::Hidden);
+    REQUIRE_FALSE(context.visible(groupNode));
+
+    auto* entityNode = new EntityNode{Entity{}};
+    groupNode->addChild(entityNode);
+
+    CHECK(context.visible(groupNode));
+  }
+
+  SECTION("Changing a node keeps the cached states of unrelated nodes")
+  {
+    auto [otherGroupNode, otherBrushNode] = createGroupedBrush();
+    REQUIRE(context.visible(otherGroupNode));
+
+    brushNode->setVisibilityState(VisibilityState::Hidden);
+
+    CHECK(otherGroupNode->cachedEditorState().value != 0);
+    CHECK(groupNode->cachedEditorState().value == 0);
+    CHECK(brushNode->cachedEditorState().value == 0);
+
+    CHECK(context.visible(otherGroupNode));
+    CHECK_FALSE(context.visible(groupNode));
+  }
+
+  SECTION("Tagging the faces of a brush updates the visibility of the brush")
+  {
+    auto tagManager = TagManager{};
+    tagManager.registerSmartTags({
+      SmartTag{"sometex", {}, std::make_unique<MaterialNameTagMatcher>("sometex")},
+    });
+    context.setHiddenTags(tagManager.smartTag("sometex").type());
+    REQUIRE(context.visible(brushNode));
+
+    for (size_t i = 0; i < brushNode->brush().faceCount(); ++i)
+    {
+      brushNode->updateFaceTags(i, tagManager);
+    }
+
+    CHECK_FALSE(context.visible(brushNode));
+    CHECK_FALSE(context.visible(groupNode));
+  }
+
+  SECTION("Changing a preference updates the visibility of brushes")
+  {
+    const auto setPref = TemporarilySetPref{Preferences::ShowBrushes, false};
+
+    CHECK_FALSE(context.visible(brushNode));
+    CHECK_FALSE(context.visible(groupNode));
+  }
+
+  SECTION("Editor contexts do not share their cached states")
+  {
+    auto tag = Tag{"tag", {}};
+    tag.setIndex(0);
+    brushNode->addTag(tag);
+
+    auto otherContext = EditorContext{};
+    otherContext.setHiddenTags(tag.type());
+
+    CHECK(context.visible(brushNode));
+    CHECK_FALSE(otherContext.visible(brushNode));
+    CHECK(context.visible(brushNode));
+    CHECK_FALSE(otherContext.visible(brushNode));
+
+    brushNode->removeTag(tag);
+  }
+}
+
 } // namespace tb::mdl
@@ -38,6 +38,7 @@
 #include "mdl/WorldNode.h"
 
 #include "kdl/result.h"
+#include "kdl/task_manager.h"
 
 #include "vm/bbox.h"
 #include "vm/mat_ext.h"
@@ -428,27 +429,30 @@ TEST_CASE("ModelUtils.collectSelectableNodes")
   worldNode.addChild(layerNode);
 
   auto editorContext = EditorContext{};
+  auto taskManager = kdl::task_manager{4};
 
-  CHECK_THAT(
-    collectSelectableNodes({}, editorContext),
-    Catch::Matchers::Equals(std::vector<Node*>{}));
+  const auto collect = [&](const std::vector<Node*>& nodes) {
+    auto result = collectSelectableNodes(nodes, editorContext);
+    CHECK(collectSelectableNodes(nodes, editorContext, taskManager) == result);
+    return result;
+  };
+
+  CHECK_THAT(collect({}), Catch::Matchers::Equals(std::vector<Node*>{}));
 
   CHECK_THAT(
-    collectSelectableNodes({&worldNode}, editorContext),
-    Catch::Matchers::Equals(std::vector<Node*>{outerGroupNode}));
+    collect({&worldNode}), Catch::Matchers::Equals(std::vector<Node*>{outerGroupNode}));
 
   editorContext.pushGroup(outerGroupNode);
   CHECK_THAT(
-    collectSelectableNodes({&worldNode}, editorContext),
+    collect({&worldNode}),
     Catch::Matchers::Equals(std::vector<Node*>{innerGroupNode, patchNode}));
 
   editorContext.pushGroup(innerGroupNode);
   CHECK_THAT(
-    collectSelectableNodes({&worldNode}, editorContext),
-    Catch::Matchers::Equals(std::vector<Node*>{outerGroupNode}));
+    collect({&worldNode}), Catch::Matchers::Equals(std::vector<Node*>{outerGroupNode}));
 
   CHECK_THAT(
-    collectSelectableNodes({&worldNode, innerGroupNode}, editorContext),
+    collect({&worldNode, innerGroupNode}),
     Catch::Matchers::Equals(std::vector<Node*>{outerGroupNode, entityNode, brushNode}));
 }
 
@@ -400,6 +400,27 @@ TEST_CASE("NodeCollection.addNodes")
   CHECK(nodeCollection.patches() == std::vector<PatchNode*>{&patchNode});
 }
 
+TEST_CASE("NodeCollection.contains")
+{
+  auto entityNode1 = EntityNode{Entity{}};
+  auto entityNode2 = EntityNode{Entity{}};
+
+  auto nodeCollection = NodeCollection{};
+  CHECK_FALSE(nodeCollection.contains(&entityNode1));
+
+  nodeCollection.addNode(&entityNode1);
+  CHECK(nodeCollection.contains(&entityNode1));
+  CHECK_FALSE(nodeCollection.contains(&entityNode2));
+
+  SECTION("Adding a contained node has no effect")
+  {
+    nodeCollection.addNodes({&entityNode2, &entityNode1});
+    CHECK(nodeCollection.nodes() == std::vector<Node*>{&entityNode1, &entityNode2});
+    CHECK(
+      nodeCollection.entities() == std::vector<EntityNode*>{&entityNode1, &entityNode2});
+  }
+}
+
 TEST_CASE("NodeCollection.removeNode")
 {
   const auto mapFormat = MapFormat::Quake3;
@@ -470,6 +491,48 @@ TEST_CASE("NodeCollection.removeNode")
   }
 }
 
+TEST_CASE("NodeCollection.removeNodes")
+{
+  const auto mapFormat = MapFormat::Quake3;
+  const auto worldBounds = vm::bbox3d{8192.0};
+
+  auto layerNode = LayerNode{Layer{"layer"}};
+  auto groupNode = GroupNode{Group{"group"}};
+  auto entityNode = EntityNode{Entity{}};
+  auto brushNode1 = BrushNode{
+    BrushBuilder{mapFormat, worldBounds}.createCube(64.0, "material") | kdl::value()};
+  auto brushNode2 = BrushNode{
+    BrushBuilder{mapFormat, worldBounds}.createCube(64.0, "material") | kdl::value()};
+
+  auto nodeCollection = NodeCollection{};
+  nodeCollection.addNodes(
+    {&layerNode, &brushNode1, &groupNode, &entityNode, &brushNode2});
+
+  nodeCollection.removeNodes({&brushNode1, &layerNode, &entityNode});
+  CHECK(nodeCollection.nodes() == std::vector<Node*>{&groupNode, &brushNode2});
+  CHECK(nodeCollection.layers() == std::vector<LayerNode*>{});
+  CHECK(nodeCollection.groups() == std::vector<GroupNode*>{&groupNode});
+  CHECK(nodeCollection.entities() == std::vector<EntityNode*>{});
+  CHECK(nodeCollection.brushes() == std::vector<BrushNode*>{&brushNode2});
+
+  CHECK_FALSE(nodeCollection.contains(&brushNode1));
+  CHECK(nodeCollection.contains(&brushNode2));
+
+  SECTION("Removing nodes that are not contained has no effect")
+  {
+    nodeCollection.removeNodes({&brushNode1, &layerNode});
+    CHECK(nodeCollection.nodes() == std::vector<Node*>{&groupNode, &brushNode2});
+  }
+
+  SECTION("Removed nodes can be added again")
+  {
+    nodeCollection.addNode(&brushNode1);
+    CHECK(
+      nodeCollection.nodes() == std::vector<Node*>{&groupNode, &brushNode2, &brushNode1});
+    CHECK(nodeCollection.brushes() == std::vector<BrushNode*>{&brushNode2, &brushNode1});
+  }
+}
+
 TEST_CASE("NodeCollection.clear")
 {
   const auto mapFormat = MapFormat::Quake3;
@@ -0,0 +1,173 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mdl/BrushBuilder.h"
+#include "mdl/BrushNode.h"
+#include "mdl/Entity.h"
+#include "mdl/EntityNode.h"
+#include "mdl/Group.h"
+#include "mdl/GroupNode.h"
+#include "mdl/Layer.h"
+#include "mdl/LayerNode.h"
+#include "mdl/MapFormat.h"
+#include "mdl/ParallelTraversal.h"
+#include "mdl/PatchNode.h"
+#include "mdl/WorldNode.h"
+
+#include "kdl/overload.h"
+#include "kdl/result.h"
+#include "kdl/task_manager.h"
+#include "kdl/vector_utils.h"
+
+#include <atomic>
+#include <functional>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace tb::mdl
+{
+namespace
+{
+
+void collectNodesSerially(Node* node, std::vector<Node*>& result)
+{
+  result.push_back(node);
+  for (auto* child : node->children())
+  {
+    collectNodesSerially(child, result);
+  }
+}
+
+} // namespace
+
+TEST_CASE("ParallelTraversal")
+{
+  auto taskManager = kdl::task_manager{4};
+
+  const auto worldBounds = vm::bbox3d{8192.0};
+  const auto builder = BrushBuilder{MapFormat::Quake3, worldBounds};
+
+  auto worldNode = WorldNode{{}, {}, MapFormat::Quake3};
+  auto* layerNode = new LayerNode{Layer{"layer"}};
+  worldNode.addChild(layerNode);
+
+  auto* groupNode = new GroupNode{Group{"group"}};
+  layerNode->addChild(groupNode);
+
+  auto* entityNode = new EntityNode{Entity{}};
+  groupNode->addChild(entityNode);
+
+  // enough brushes to require several batches
+  for (size_t i = 0; i < 2500; ++i)
+  {
+    auto* brushNode = new BrushNode{builder.createCube(64.0, "material") | kdl::value()};
+    (i % 2 == 0 ? static_cast<Node*>(worldNode.defaultLayer()) : entityNode)
+      ->addChild(brushNode);
+  }
+
+  auto expectedNodes = std::vector<Node*>{};
+  collectNodesSerially(&worldNode, expectedNodes);
+  REQUIRE(expectedNodes.size() == 2505);
+
+  SECTION("parallelVisitAll")
+  {
+    auto worldCount = std::atomic<size_t>{0};
+    auto layerCount = std::atomic<size_t>{0};
+    auto groupCount = std::atomic<size_t>{0};
+    auto entityCount = std::atomic<size_t>{0};
+    auto brushCount = std::atomic<size_t>{0};
+
+    parallelVisitAll(
+      {&worldNode},
+      taskManager,
+      kdl::overload(
+        [&](WorldNode*) { ++worldCount; },
+        [&](LayerNode*) { ++layerCount; },
+        [&](GroupNode*) { ++groupCount; },
+        [&](EntityNode*) { ++entityCount; },
+        [&](BrushNode*) { ++brushCount; },
+        [&](PatchNode*) {}));
+
+    CHECK(worldCount == 1);
+    CHECK(layerCount == 2);
+    CHECK(groupCount == 1);
+    CHECK(entityCount == 1);
+    CHECK(brushCount == 2500);
+  }
+
+  SECTION("parallelVisitAll with subtrees")
+  {
+    auto brushCount = std::atomic<size_t>{0};
+
+    parallelVisitAll(
+      {groupNode},
+      taskManager,
+      kdl::overload(
+        [](WorldNode*) {},
+        [](LayerNode*) {},
+        [](GroupNode*) {},
+        [](EntityNode*) {},
+        [&](BrushNode*) { ++brushCount; },
+        [](PatchNode*) {}));
+
+    CHECK(brushCount == 1250);
+  }
+
+  SECTION("parallelVisitAllAndReduce")
+  {
+    const auto visitedNodes = parallelVisitAllAndReduce(
+      {&worldNode},
+      taskManager,
+      std::vector<Node*>{},
+      [](std::vector<Node*>& nodes, Node* node) { nodes.push_back(node); },
+      [](std::vector<Node*> lhs, const std::vector<Node*>& rhs) {
+        lhs.insert(lhs.end(), rhs.begin(), rhs.end());
+        return lhs;
+      });
+
+    CHECK(visitedNodes == expectedNodes);
+  }
+
+  SECTION("parallelFilter")
+  {
+    const auto isBrush = [](const Node* node) {
+      return dynamic_cast<const BrushNode*>(node) != nullptr;
+    };
+
+    const auto filteredNodes = parallelFilter(expectedNodes, taskManager, isBrush);
+
+    CHECK(filteredNodes.size() == 2500);
+    CHECK(filteredNodes == kdl::vec_filter(expectedNodes, isBrush));
+    CHECK(parallelFilter({groupNode}, taskManager, isBrush).empty());
+  }
+
+  SECTION("Empty input")
+  {
+    const auto count = parallelVisitAllAndReduce(
+      {},
+      taskManager,
+      size_t(0),
+      [](size_t& n, Node*) { ++n; },
+      std::plus<size_t>{});
+    CHECK(count == 0);
+  }
+}
+
+} // namespace tb::mdl
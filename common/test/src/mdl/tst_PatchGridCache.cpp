@@ -0,0 +1,106 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mdl/BezierPatch.h"
+#include "mdl/PatchGridCache.h"
+#include "mdl/PatchNode.h"
+
+#include "kdl/task_manager.h"
+
+#include "Catch2.h"
+
+namespace tb::mdl
+{
+
+TEST_CASE("PatchGridCache")
+{
+  using CP = BezierPatch::Point;
+
+  const auto flatPatch = BezierPatch{
+    3,
+    3,
+    {CP{0.0, 2.0, 0.0, 0.0, 0.0},
+     CP{1.0, 2.0, 0.0, 0.5, 0.0},
+     CP{2.0, 2.0, 0.0, 1.0, 0.0},
+     CP{0.0, 1.0, 0.0, 0.0, 0.5},
+     CP{1.0, 1.0, 0.0, 0.5, 0.5},
+     CP{2.0, 1.0, 0.0, 1.0, 0.5},
+     CP{0.0, 0.0, 0.0, 0.0, 1.0},
+     CP{1.0, 0.0, 0.0, 0.5, 1.0},
+     CP{2.0, 0.0, 0.0, 1.0, 1.0}},
+    "material"};
+
+  auto hillPatch = flatPatch;
+  hillPatch.setControlPoint(1, 1, CP{1.0, 1.0, 8.0, 0.5, 0.5});
+
+  auto cache = PatchGridCache{};
+
+  SECTION("Grids are subdivided adaptively")
+  {
+    const auto flatGrid = cache.get(flatPatch);
+    CHECK(flatGrid->pointRowCount == 2u);
+    CHECK(flatGrid->pointColumnCount == 2u);
+
+    const auto hillGrid = cache.get(hillPatch);
+    CHECK(*hillGrid == makePatchGrid(hillPatch, 2u));
+  }
+
+  SECTION("Patches with identical control points share their grid")
+  {
+    const auto grid = cache.get(flatPatch);
+    CHECK(cache.get(flatPatch) == grid);
+
+    auto materialPatch = flatPatch;
+    materialPatch.setMaterialName("other");
+    CHECK(cache.get(materialPatch) == grid);
+
+    CHECK(cache.get(hillPatch) != grid);
+  }
+
+  SECTION("Grids are restored from the cache when a patch is restored")
+  {
+    auto patchNode = PatchNode{flatPatch, cache.get(flatPatch)};
+    const auto* flatGrid = &patchNode.grid();
+
+    auto previousPatch = patchNode.setPatch(hillPatch, cache.get(hillPatch));
+    CHECK(&patchNode.grid() != flatGrid);
+
+    auto previousGrid = cache.get(previousPatch);
+    patchNode.setPatch(std::move(previousPatch), std::move(previousGrid));
+    CHECK(&patchNode.grid() == flatGrid);
+  }
+
+  SECTION("Separate caches do not share grids")
+  {
+    auto otherCache = PatchGridCache{};
+    CHECK(otherCache.get(flatPatch) != cache.get(flatPatch));
+  }
+
+  SECTION("Tessellating in parallel")
+  {
+    auto taskManager = kdl::task_manager{};
+    const auto grids = cache.get({&flatPatch, &hillPatch}, taskManager);
+
+    REQUIRE(grids.size() == 2u);
+    CHECK(grids[0] == cache.get(flatPatch));
+    CHECK(grids[1] == cache.get(hillPatch));
+  }
+}
+
+} // namespace tb::mdl
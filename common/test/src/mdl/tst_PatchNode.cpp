@@ -160,6 +160,92 @@ TEST_CASE("PatchNode.makePatchGrid")
     == kdl::vec_transform(expectedPoints, [](const auto& p) { return vm::approx{p}; }));
 }
 
+TEST_CASE("PatchNode.computeSubdivisionsPerSurface")
+{
+  using CP = BezierPatch::Point;
+  using T = std::tuple<std::vector<CP>, size_t>;
+
+  // clang-format off
+  const auto
+  [controlPoints, expectedSubdivisions] = GENERATE(values<T>({
+  // flat surface with linear UV coordinates
+  {{CP{0.0, 2.0, 0.0, 0.0, 0.0}, CP{1.0, 2.0, 0.0, 0.5, 0.0}, CP{2.0, 2.0, 0.0, 1.0, 0.0},
+    CP{0.0, 1.0, 0.0, 0.0, 0.5}, CP{1.0, 1.0, 0.0, 0.5, 0.5}, CP{2.0, 1.0, 0.0, 1.0, 0.5},
+    CP{0.0, 0.0, 0.0, 0.0, 1.0}, CP{1.0, 0.0, 0.0, 0.5, 1.0}, CP{2.0, 0.0, 0.0, 1.0, 1.0}},
+    0},
+  // flat surface with non-linear UV coordinates
+  {{CP{0.0, 2.0, 0.0, 0.0, 0.0}, CP{1.0, 2.0, 0.0, 0.5, 0.0}, CP{2.0, 2.0, 0.0, 1.0, 0.0},
+    CP{0.0, 1.0, 0.0, 0.0, 0.5}, CP{1.0, 1.0, 0.0, 0.8, 0.5}, CP{2.0, 1.0, 0.0, 1.0, 0.5},
+    CP{0.0, 0.0, 0.0, 0.0, 1.0}, CP{1.0, 0.0, 0.0, 0.5, 1.0}, CP{2.0, 0.0, 0.0, 1.0, 1.0}},
+    3},
+  // hill surface bulging towards +Z, deviating by 4 units from a flat quad
+  {{CP{0.0, 2.0, 0.0, 0.0, 0.0}, CP{1.0, 2.0, 0.0, 0.5, 0.0}, CP{2.0, 2.0, 0.0, 1.0, 0.0},
+    CP{0.0, 1.0, 0.0, 0.0, 0.5}, CP{1.0, 1.0, 8.0, 0.5, 0.5}, CP{2.0, 1.0, 0.0, 1.0, 0.5},
+    CP{0.0, 0.0, 0.0, 0.0, 1.0}, CP{1.0, 0.0, 0.0, 0.5, 1.0}, CP{2.0, 0.0, 0.0, 1.0, 1.0}},
+    2},
+  // quarter of a cylinder with a radius of 256 units
+  {{CP{256.0, 0.0, 0.0, 0.0, 0.0}, CP{256.0, 0.0, 64.0, 0.0, 0.5}, CP{256.0, 0.0, 128.0, 0.0, 1.0},
+    CP{256.0, 256.0, 0.0, 0.5, 0.0}, CP{256.0, 256.0, 64.0, 0.5, 0.5}, CP{256.0, 256.0, 128.0, 0.5, 1.0},
+    CP{0.0, 256.0, 0.0, 1.0, 0.0}, CP{0.0, 256.0, 64.0, 1.0, 0.5}, CP{0.0, 256.0, 128.0, 1.0, 1.0}},
+    3},
+  // twisted surface with straight rows and columns, its center deviates by 2 units from
+  // the midpoints of the diagonals
+  {{CP{0.0, 2.0, 0.0, 0.0, 0.0}, CP{1.0, 2.0, 0.0, 0.5, 0.0}, CP{2.0, 2.0, 0.0, 1.0, 0.0},
+    CP{0.0, 1.0, 0.0, 0.0, 0.5}, CP{1.0, 1.0, 2.0, 0.5, 0.5}, CP{2.0, 1.0, 4.0, 1.0, 0.5},
+    CP{0.0, 0.0, 0.0, 0.0, 1.0}, CP{1.0, 0.0, 4.0, 0.5, 1.0}, CP{2.0, 0.0, 8.0, 1.0, 1.0}},
+    1},
+  }));
+  // clang-format on
+
+  CAPTURE(controlPoints);
+  CHECK(
+    computeSubdivisionsPerSurface(BezierPatch{3, 3, controlPoints, "material"})
+    == expectedSubdivisions);
+}
+
+TEST_CASE("PatchNode.grid")
+{
+  using CP = BezierPatch::Point;
+
+  const auto flatPatch = BezierPatch{
+    3,
+    3,
+    {CP{0.0, 2.0, 0.0, 0.0, 0.0},
+     CP{1.0, 2.0, 0.0, 0.5, 0.0},
+     CP{2.0, 2.0, 0.0, 1.0, 0.0},
+     CP{0.0, 1.0, 0.0, 0.0, 0.5},
+     CP{1.0, 1.0, 0.0, 0.5, 0.5},
+     CP{2.0, 1.0, 0.0, 1.0, 0.5},
+     CP{0.0, 0.0, 0.0, 0.0, 1.0},
+     CP{1.0, 0.0, 0.0, 0.5, 1.0},
+     CP{2.0, 0.0, 0.0, 1.0, 1.0}},
+    "material"};
+
+  auto hillPatch = flatPatch;
+  hillPatch.setControlPoint(1, 1, CP{1.0, 1.0, 8.0, 0.5, 0.5});
+
+  SECTION("Grids are subdivided adaptively")
+  {
+    auto patchNode = PatchNode{flatPatch};
+    CHECK(patchNode.grid().pointRowCount == 2u);
+    CHECK(patchNode.grid().pointColumnCount == 2u);
+
+    patchNode.setPatch(hillPatch);
+    CHECK(patchNode.grid().pointRowCount == 5u);
+    CHECK(patchNode.grid().pointColumnCount == 5u);
+    CHECK(patchNode.grid() == makePatchGrid(hillPatch, 2u));
+  }
+
+  SECTION("Clones share the grid")
+  {
+    const auto worldBounds = vm::bbox3d{8192.0};
+
+    auto patchNode = PatchNode{hillPatch};
+    auto clone = std::unique_ptr<Node>{patchNode.clone(worldBounds)};
+    CHECK(&static_cast<PatchNode*>(clone.get())->grid() == &patchNode.grid());
+  }
+}
+
 TEST_CASE("PatchNode.pickFlatPatch")
 {
   using P = BezierPatch::Point;
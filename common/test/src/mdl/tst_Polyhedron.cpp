@@ -22,6 +22,9 @@
 #include "mdl/Polyhedron_IO.h" // IWYU pragma: keep
 #include "mdl/Polyhedron_Instantiation.h"
 
+#include "vm/approx.h"
+#include "vm/mat_ext.h"
+#include "vm/scalar.h"
 #include "vm/vec.h"
 #include "vm/vec_io.h"
 
@@ -392,6 +395,48 @@ TEST_CASE("PolyhedronTest.swap")
   CHECK(rhs.bounds() == original.bounds());
 }
 
+TEST_CASE("PolyhedronTest.transform")
+{
+  const auto p1 = vm::vec3d{0, 0, 8};
+  const auto p2 = vm::vec3d{8, 0, 0};
+  const auto p3 = vm::vec3d{-8, 0, 0};
+  const auto p4 = vm::vec3d{0, 8, 0};
+
+  const auto transformation = GENERATE(
+    vm::translation_matrix(vm::vec3d{16, 8, 0})
+      * vm::rotation_matrix(vm::vec3d{0, 0, 1}, vm::to_radians(90.0)),
+    vm::translation_matrix(vm::vec3d{16, 8, 0}) * vm::mirror_matrix<double>(vm::axis::y));
+
+  CAPTURE(transformation);
+
+  auto polyhedron = Polyhedron3d{p1, p2, p3, p4};
+  polyhedron.transform(transformation);
+
+  const auto expected = Polyhedron3d{
+    transformation * p1, transformation * p2, transformation * p3, transformation * p4};
+
+  CHECK(polyhedron.vertexCount() == expected.vertexCount());
+  for (const auto* vertex : expected.vertices())
+  {
+    CHECK(polyhedron.hasVertex(vertex->position(), vm::Cd::almost_zero()));
+  }
+  CHECK(polyhedron.bounds().min == vm::approx{expected.bounds().min});
+  CHECK(polyhedron.bounds().max == vm::approx{expected.bounds().max});
+
+  for (const auto* face : polyhedron.faces())
+  {
+    CHECK(face->plane().normal == vm::approx{face->normal()});
+    for (const auto* halfEdge : face->boundary())
+    {
+      CHECK(
+        face->plane().point_distance(halfEdge->origin()->position())
+        == vm::approx{0.0});
+      CHECK(halfEdge->origin()->leaving()->origin() == halfEdge->origin());
+      CHECK(halfEdge->twin()->origin() == halfEdge->destination());
+    }
+  }
+}
+
 TEST_CASE("PolyhedronTest.clipCubeWithHorizontalPlane")
 {
   const auto p1 = vm::vec3d{-64, -64, -64};
@@ -113,6 +113,144 @@ TEST_CASE("Resource")
     CHECK(mockTaskRunner.tasks.empty());
   }
 
+  SECTION("Deferred resource loading")
+  {
+    auto resource = ResourceT{
+      [&]() { return Result<MockResource>{MockResource{}}; }, LoadPolicy::OnDemand};
+
+    CHECK(resource.get() == nullptr);
+    CHECK(std::holds_alternative<ResourceDeferred<MockResource>>(resource.state()));
+    CHECK(resource.isDeferred());
+    CHECK(!resource.needsProcessing());
+
+    SECTION("process")
+    {
+      CHECK(!resource.process(taskRunner, processContext));
+      CHECK(std::holds_alternative<ResourceDeferred<MockResource>>(resource.state()));
+      CHECK(mockTaskRunner.tasks.empty());
+    }
+
+    SECTION("requestLoad")
+    {
+      resource.requestLoad();
+      CHECK(std::holds_alternative<ResourceUnloaded<MockResource>>(resource.state()));
+      CHECK(!resource.isDeferred());
+      CHECK(resource.needsProcessing());
+
+      CHECK(resource.process(taskRunner, processContext));
+      CHECK(std::holds_alternative<ResourceLoading<MockResource>>(resource.state()));
+      CHECK(mockTaskRunner.tasks.size() == 1);
+    }
+
+    SECTION("drop")
+    {
+      resource.drop();
+      CHECK(std::holds_alternative<ResourceDropped>(resource.state()));
+      CHECK(resource.isDropped());
+    }
+
+    SECTION("loadSync")
+    {
+      resource.loadSync();
+      CHECK(resource.get() != nullptr);
+      CHECK(std::holds_alternative<ResourceLoaded<MockResource>>(resource.state()));
+    }
+
+    SECTION("takeRequested")
+    {
+      CHECK(!resource.takeRequested());
+
+      resource.requestLoad();
+      CHECK(resource.takeRequested());
+      CHECK(!resource.takeRequested());
+    }
+
+    SECTION("requestLoad calls processing request handler")
+    {
+      auto processingRequests = 0;
+      resource.setProcessingRequestHandler([&](const auto&) { ++processingRequests; });
+
+      resource.requestLoad();
+      CHECK(processingRequests == 1);
+
+      resource.loadSync();
+      REQUIRE(std::holds_alternative<ResourceLoaded<MockResource>>(resource.state()));
+      processingRequests = 0;
+
+      // the resource was already requested
+      resource.requestLoad();
+      CHECK(processingRequests == 0);
+
+      CHECK(resource.takeRequested());
+      resource.requestLoad();
+      resource.requestLoad();
+      CHECK(processingRequests == 1);
+    }
+
+    SECTION("evict")
+    {
+      CHECK(!resource.isEvictable());
+
+      resource.loadSync();
+      CHECK(resource.isEvictable());
+
+      resource.evict(glContextAvailable);
+      CHECK(std::holds_alternative<ResourceDeferred<MockResource>>(resource.state()));
+      CHECK(resource.get() == nullptr);
+
+      resource.requestLoad();
+      resource.loadSync();
+      resource.uploadSync(glContextAvailable);
+      REQUIRE(std::holds_alternative<ResourceReady<MockResource>>(resource.state()));
+      CHECK(resource.isEvictable());
+
+      resource.evict(glContextAvailable);
+      CHECK(std::holds_alternative<ResourceDeferred<MockResource>>(resource.state()));
+    }
+
+    SECTION("pinned resources are not evictable")
+    {
+      resource.loadSync();
+      resource.pin();
+      resource.pin();
+      CHECK(resource.isPinned());
+      CHECK(!resource.isEvictable());
+
+      resource.evict(glContextAvailable);
+      CHECK(std::holds_alternative<ResourceLoaded<MockResource>>(resource.state()));
+
+      resource.unpin();
+      CHECK(!resource.isEvictable());
+
+      resource.unpin();
+      CHECK(!resource.isPinned());
+      CHECK(resource.isEvictable());
+    }
+
+    SECTION("evict calls eviction handler")
+    {
+      auto evictionHandlerCalls = 0;
+      resource.setEvictionHandler([&](const MockResource&) { ++evictionHandlerCalls; });
+
+      resource.evict(glContextAvailable);
+      CHECK(evictionHandlerCalls == 0);
+
+      resource.loadSync();
+      resource.evict(glContextAvailable);
+      CHECK(evictionHandlerCalls == 1);
+    }
+  }
+
+  SECTION("Immediately loaded resources are not evictable")
+  {
+    auto resource = ResourceT{[&]() { return Result<MockResource>{MockResource{}}; }};
+    resource.loadSync();
+    CHECK(!resource.isEvictable());
+
+    resource.evict(glContextAvailable);
+    CHECK(std::holds_alternative<ResourceLoaded<MockResource>>(resource.state()));
+  }
+
   SECTION("Resource loading fails")
   {
     auto resource =
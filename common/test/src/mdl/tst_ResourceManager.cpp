@@ -25,6 +25,10 @@
 #include "kdl/reflection_impl.h"
 #include "kdl/vector_utils.h"
 
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
 #include "Catch2.h"
 
 namespace tb::mdl
@@ -36,9 +40,11 @@ struct MockResource
 {
   void upload(const bool glContextAvailable) const { mockUpload(glContextAvailable); }
   void drop(const bool glContextAvailable) const { mockDrop(glContextAvailable); }
+  size_t byteSize() const { return mockByteSize; }
 
   std::function<void(bool)> mockUpload = [](auto) {};
   std::function<void(bool)> mockDrop = [](auto) {};
+  size_t mockByteSize = 0;
 
   kdl_reflect_inline_empty(MockResource);
 };
@@ -70,6 +76,19 @@ bool operator==(
 
 } // namespace
 
+TEST_CASE("defaultMaxConcurrentLoads")
+{
+  const auto hardwareConcurrency =
+    std::max(size_t(1), size_t(std::thread::hardware_concurrency()));
+
+  CHECK(defaultMaxConcurrentLoads(0) == 1);
+  CHECK(defaultMaxConcurrentLoads(1) == 1);
+  CHECK(defaultMaxConcurrentLoads(2) == std::min(size_t(1), hardwareConcurrency));
+  CHECK(
+    defaultMaxConcurrentLoads(256)
+    == std::max(size_t(1), std::min(size_t(255), hardwareConcurrency - 1)));
+}
+
 TEST_CASE("ResourceManager")
 {
   const auto mockResourceLoader = [&]() { return Result<MockResource>{MockResource{}}; };
@@ -80,14 +99,15 @@ TEST_CASE("ResourceManager")
   const auto glContextAvailable = GENERATE(true, false);
   const auto processContext = ProcessContext{glContextAvailable, [](auto, auto) {}};
 
-  auto resourceManager = ResourceManager{};
+  // enough concurrent loads to start loading every resource in a section right away
+  auto resourceManager = ResourceManager{16};
 
   SECTION("needsProcessing")
   {
     CHECK(!resourceManager.needsProcessing());
 
-    auto resource1 = std::make_shared<ResourceT>(mockResourceLoader);
-    resourceManager.addResource(resource1);
+    auto resource1 =
+      resourceManager.addResource(std::make_shared<ResourceT>(mockResourceLoader));
 
     REQUIRE(std::holds_alternative<ResourceUnloaded<MockResource>>(resource1->state()));
     CHECK(resourceManager.needsProcessing());
@@ -105,8 +125,8 @@ TEST_CASE("ResourceManager")
     REQUIRE(std::holds_alternative<ResourceReady<MockResource>>(resource1->state()));
     CHECK(!resourceManager.needsProcessing());
 
-    auto resource2 = std::make_shared<ResourceT>(mockResourceLoader);
-    resourceManager.addResource(resource2);
+    auto resource2 =
+      resourceManager.addResource(std::make_shared<ResourceT>(mockResourceLoader));
     REQUIRE(std::holds_alternative<ResourceReady<MockResource>>(resource1->state()));
     REQUIRE(std::holds_alternative<ResourceUnloaded<MockResource>>(resource2->state()));
     CHECK(resourceManager.needsProcessing());
@@ -144,27 +164,39 @@ TEST_CASE("ResourceManager")
 
   SECTION("addResource")
   {
-    auto resource1 = std::make_shared<ResourceT>(mockResourceLoader);
-    resourceManager.addResource(resource1);
+    auto resource1 =
+      resourceManager.addResource(std::make_shared<ResourceT>(mockResourceLoader));
 
     CHECK(resourceManager.resources() == std::vector{resource1});
-    CHECK(resource1.use_count() == 2);
+    CHECK(resource1.use_count() == 1);
     CHECK(std::holds_alternative<ResourceUnloaded<MockResource>>(resource1->state()));
 
-    auto resource2 = std::make_shared<ResourceT>(mockResourceLoader);
-    resourceManager.addResource(resource2);
+    auto resource2 =
+      resourceManager.addResource(std::make_shared<ResourceT>(mockResourceLoader));
 
     CHECK(resourceManager.resources() == std::vector{resource1, resource2});
+
+    SECTION("Resources are dropped when their last handle is destroyed")
+    {
+      auto resource1Copy = resource1;
+      resource1.reset();
+      resourceManager.process(taskRunner, processContext);
+      CHECK(resourceManager.resources() == std::vector{resource1Copy, resource2});
+
+      resource1Copy.reset();
+      resourceManager.process(taskRunner, processContext);
+      CHECK(resourceManager.resources() == std::vector{resource2});
+    }
   }
 
   SECTION("process")
   {
     SECTION("resource loading")
     {
-      auto resource1 = std::make_shared<ResourceT>(mockResourceLoader);
-      auto resource2 = std::make_shared<ResourceT>(mockResourceLoader);
-      resourceManager.addResource(resource1);
-      resourceManager.addResource(resource2);
+      auto resource1 =
+        resourceManager.addResource(std::make_shared<ResourceT>(mockResourceLoader));
+      auto resource2 =
+        resourceManager.addResource(std::make_shared<ResourceT>(mockResourceLoader));
 
       CHECK(
         resourceManager.process(taskRunner, processContext)
@@ -229,34 +261,170 @@ TEST_CASE("ResourceManager")
       }
     }
 
+    SECTION("requested resources")
+    {
+      auto resource1 = resourceManager.addResource(
+        std::make_shared<ResourceT>(mockResourceLoader, LoadPolicy::OnDemand));
+      auto resource2 = resourceManager.addResource(
+        std::make_shared<ResourceT>(mockResourceLoader, LoadPolicy::OnDemand));
+
+      CHECK(!resourceManager.needsProcessing());
+      CHECK(resourceManager.process(taskRunner, processContext).empty());
+
+      resource2->requestLoad();
+      CHECK(resourceManager.needsProcessing());
+      CHECK(
+        resourceManager.process(taskRunner, processContext)
+        == std::vector{resource2->id()});
+      CHECK(std::holds_alternative<ResourceDeferred<MockResource>>(resource1->state()));
+      CHECK(std::holds_alternative<ResourceLoading<MockResource>>(resource2->state()));
+    }
+
+    SECTION("timeout")
+    {
+      using namespace std::chrono_literals;
+
+      auto resource1 =
+        resourceManager.addResource(std::make_shared<ResourceT>(mockResourceLoader));
+
+      CHECK(resourceManager.process(taskRunner, processContext, 0ms).empty());
+      CHECK(std::holds_alternative<ResourceUnloaded<MockResource>>(resource1->state()));
+      CHECK(resourceManager.needsProcessing());
+
+      CHECK(
+        resourceManager.process(taskRunner, processContext)
+        == std::vector{resource1->id()});
+      CHECK(std::holds_alternative<ResourceLoading<MockResource>>(resource1->state()));
+    }
+
+    SECTION("load priority")
+    {
+      auto limitedResourceManager = ResourceManager{1};
+
+      auto loadOrder = std::vector<size_t>{};
+      const auto makeResource = [&](const size_t i) {
+        return std::make_shared<ResourceT>([&, i]() {
+          loadOrder.push_back(i);
+          return Result<MockResource>{MockResource{}};
+        });
+      };
+
+      auto resource1 = limitedResourceManager.addResource(makeResource(1));
+      auto resource2 = limitedResourceManager.addResource(makeResource(2));
+      auto resource3 = limitedResourceManager.addResource(makeResource(3));
+
+      resource3->requestLoad(LoadPriority::High);
+
+      CHECK(
+        limitedResourceManager.process(taskRunner, processContext)
+        == std::vector{resource1->id(), resource2->id(), resource3->id()});
+      CHECK(std::holds_alternative<ResourceLoading<MockResource>>(resource1->state()));
+      CHECK(std::holds_alternative<ResourceLoading<MockResource>>(resource2->state()));
+      CHECK(std::holds_alternative<ResourceLoading<MockResource>>(resource3->state()));
+      CHECK(mockTaskRunner.tasks.size() == 1);
+
+      resource2->requestLoad(LoadPriority::High);
+      CHECK(limitedResourceManager.process(taskRunner, processContext).empty());
+
+      // a completed loader task starts the next one without waiting for process
+      mockTaskRunner.resolveNextPromise();
+      CHECK(loadOrder == std::vector<size_t>{3});
+      CHECK(mockTaskRunner.tasks.size() == 1);
+
+      mockTaskRunner.resolveNextPromise();
+      mockTaskRunner.resolveNextPromise();
+      CHECK(loadOrder == std::vector<size_t>{3, 2, 1});
+      CHECK(mockTaskRunner.tasks.empty());
+
+      CHECK(
+        limitedResourceManager.process(taskRunner, processContext)
+        == std::vector{resource1->id(), resource2->id(), resource3->id()});
+      CHECK(std::holds_alternative<ResourceLoaded<MockResource>>(resource1->state()));
+      CHECK(std::holds_alternative<ResourceLoaded<MockResource>>(resource2->state()));
+      CHECK(std::holds_alternative<ResourceLoaded<MockResource>>(resource3->state()));
+    }
+
+    SECTION("throwing loader tasks")
+    {
+      auto limitedResourceManager = ResourceManager{1};
+
+      auto resource1 =
+        limitedResourceManager.addResource(std::make_shared<ResourceT>([]() {
+          throw std::runtime_error{"loader failed"};
+          return Result<MockResource>{MockResource{}};
+        }));
+      auto resource2 = limitedResourceManager.addResource(
+        std::make_shared<ResourceT>(mockResourceLoader));
+
+      CHECK(
+        limitedResourceManager.process(taskRunner, processContext)
+        == std::vector{resource1->id(), resource2->id()});
+      CHECK(mockTaskRunner.tasks.size() == 1);
+
+      // the throwing loader task releases its slot and starts the next one
+      mockTaskRunner.resolveNextPromise();
+      CHECK(mockTaskRunner.tasks.size() == 1);
+
+      mockTaskRunner.resolveNextPromise();
+      CHECK(mockTaskRunner.tasks.empty());
+
+      CHECK(
+        limitedResourceManager.process(taskRunner, processContext)
+        == std::vector{resource1->id(), resource2->id()});
+      CHECK(
+        resource1->state()
+        == ResourceState<MockResource>{ResourceFailed{"loader failed"}});
+      CHECK(std::holds_alternative<ResourceLoaded<MockResource>>(resource2->state()));
+    }
+
+    SECTION("cancel loading of dropped resources")
+    {
+      auto loaderCalls = 0;
+      auto resource1 = resourceManager.addResource(std::make_shared<ResourceT>([&]() {
+        ++loaderCalls;
+        return Result<MockResource>{MockResource{}};
+      }));
+      const auto resourceId = resource1->id();
+
+      resourceManager.process(taskRunner, processContext);
+      REQUIRE(std::holds_alternative<ResourceLoading<MockResource>>(resource1->state()));
+
+      resource1.reset();
+      CHECK(resourceManager.process(taskRunner, processContext).empty());
+      CHECK(resourceManager.resources().empty());
+      CHECK(!resourceManager.needsProcessing());
+
+      mockTaskRunner.resolveNextPromise();
+      CHECK(loaderCalls == 0);
+      CHECK(!resourceManager.needsProcessing());
+      CHECK(resourceManager.process(taskRunner, processContext).empty());
+    }
+
     SECTION("dropping resources")
     {
       auto mockDropCalls = std::array{std::optional<bool>{}, std::optional<bool>{}};
       auto sharedResources = std::array{
-        std::make_shared<ResourceT>([&]() {
+        resourceManager.addResource(std::make_shared<ResourceT>([&]() {
           return Result<MockResource>{MockResource{
             [](auto) {},
             [&](const auto i_glContextAvailable) {
               mockDropCalls[0] = i_glContextAvailable;
             },
           }};
-        }),
-        std::make_shared<ResourceT>([&]() {
+        })),
+        resourceManager.addResource(std::make_shared<ResourceT>([&]() {
           return Result<MockResource>{MockResource{
             [](auto) {},
             [&](const auto i_glContextAvailable) {
               mockDropCalls[1] = i_glContextAvailable;
             },
           }};
-        }),
+        })),
       };
 
       const auto resourceIds = kdl::vec_transform(
         sharedResources, [](const auto& resource) { return resource->id(); });
 
-      resourceManager.addResource(sharedResources[0]);
-      resourceManager.addResource(sharedResources[1]);
-
       resourceManager.process(taskRunner, processContext);
       mockTaskRunner.resolveNextPromise();
       mockTaskRunner.resolveNextPromise();
@@ -286,6 +454,169 @@ TEST_CASE("ResourceManager")
       CHECK(mockDropCalls[1] == glContextAvailable);
     }
   }
+
+  SECTION("residency budget")
+  {
+    auto mockDropCalls = std::array{std::optional<bool>{}, std::optional<bool>{}};
+    const auto addResource = [&](const size_t i, const LoadPolicy loadPolicy) {
+      return resourceManager.addResource(std::make_shared<ResourceT>(
+        [&, i]() {
+          return Result<MockResource>{MockResource{
+            [](auto) {},
+            [&, i](const auto i_glContextAvailable) {
+              mockDropCalls[i] = i_glContextAvailable;
+            },
+            100,
+          }};
+        },
+        loadPolicy));
+    };
+
+    const auto loadResource = [&](ResourceT& resource) {
+      resource.requestLoad();
+      resourceManager.process(taskRunner, processContext);
+      mockTaskRunner.resolveNextPromise();
+      return resourceManager.process(taskRunner, processContext);
+    };
+
+    resourceManager.setResidencyBudget(ResidencyBudget{150});
+
+    SECTION("Evicts least recently requested resources when over budget")
+    {
+      auto resource1 = addResource(0, LoadPolicy::OnDemand);
+      auto resource2 = addResource(1, LoadPolicy::OnDemand);
+
+      loadResource(*resource1);
+      resourceManager.process(taskRunner, processContext);
+      REQUIRE(std::holds_alternative<ResourceReady<MockResource>>(resource1->state()));
+      CHECK(resourceManager.residentBytes() == 100);
+
+      CHECK(
+        loadResource(*resource2) == std::vector{resource2->id(), resource1->id()});
+      CHECK(std::holds_alternative<ResourceDeferred<MockResource>>(resource1->state()));
+      CHECK(std::holds_alternative<ResourceLoaded<MockResource>>(resource2->state()));
+      CHECK(mockDropCalls[0] == glContextAvailable);
+      CHECK(resourceManager.residentBytes() == 100);
+
+      loadResource(*resource1);
+      CHECK(std::holds_alternative<ResourceLoaded<MockResource>>(resource1->state()));
+      CHECK(std::holds_alternative<ResourceDeferred<MockResource>>(resource2->state()));
+      CHECK(resourceManager.residentBytes() == 100);
+    }
+
+    SECTION("Evicts resources in the order of their last request")
+    {
+      resourceManager.setResidencyBudget(ResidencyBudget{250});
+
+      auto resource1 = addResource(0, LoadPolicy::OnDemand);
+      auto resource2 = addResource(1, LoadPolicy::OnDemand);
+      auto resource3 = addResource(0, LoadPolicy::OnDemand);
+
+      loadResource(*resource1);
+      loadResource(*resource2);
+
+      // requesting a loaded resource makes it the most recently used one
+      resource1->requestLoad();
+      resourceManager.process(taskRunner, processContext);
+
+      CHECK(
+        loadResource(*resource3) == std::vector{resource3->id(), resource2->id()});
+      CHECK(std::holds_alternative<ResourceReady<MockResource>>(resource1->state()));
+      CHECK(std::holds_alternative<ResourceDeferred<MockResource>>(resource2->state()));
+      CHECK(std::holds_alternative<ResourceLoaded<MockResource>>(resource3->state()));
+      CHECK(resourceManager.residentBytes() == 200);
+    }
+
+    SECTION("Does not evict pinned resources")
+    {
+      auto resource1 = addResource(0, LoadPolicy::OnDemand);
+      auto resource2 = addResource(1, LoadPolicy::OnDemand);
+
+      resource1->pin();
+      resource1->requestLoad();
+      resource2->requestLoad();
+      resourceManager.process(taskRunner, processContext);
+      mockTaskRunner.resolveNextPromise();
+      mockTaskRunner.resolveNextPromise();
+      resourceManager.process(taskRunner, processContext);
+
+      CHECK(std::holds_alternative<ResourceLoaded<MockResource>>(resource1->state()));
+      CHECK(std::holds_alternative<ResourceDeferred<MockResource>>(resource2->state()));
+      CHECK(resourceManager.residentBytes() == 100);
+
+      SECTION("Evicts resources once they are unpinned")
+      {
+        resource1->unpin();
+        CHECK(resourceManager.needsProcessing());
+
+        loadResource(*resource2);
+        CHECK(std::holds_alternative<ResourceDeferred<MockResource>>(resource1->state()));
+        CHECK(std::holds_alternative<ResourceLoaded<MockResource>>(resource2->state()));
+        CHECK(resourceManager.residentBytes() == 100);
+      }
+    }
+
+    SECTION("Does not evict resources that were pinned after they were loaded")
+    {
+      auto resource1 = addResource(0, LoadPolicy::OnDemand);
+      auto resource2 = addResource(1, LoadPolicy::OnDemand);
+
+      resource1->requestLoad();
+      resourceManager.process(taskRunner, processContext);
+      mockTaskRunner.resolveNextPromise();
+      resourceManager.process(taskRunner, processContext);
+      REQUIRE(std::holds_alternative<ResourceLoaded<MockResource>>(resource1->state()));
+
+      resource1->pin();
+      resource2->requestLoad();
+      resourceManager.process(taskRunner, processContext);
+      mockTaskRunner.resolveNextPromise();
+      resourceManager.process(taskRunner, processContext);
+
+      CHECK(!resource1->isDeferred());
+      CHECK(std::holds_alternative<ResourceDeferred<MockResource>>(resource2->state()));
+    }
+
+    SECTION("Does not evict recently requested resources")
+    {
+      resourceManager.setResidencyBudget(ResidencyBudget{150, 10});
+
+      auto resource1 = addResource(0, LoadPolicy::OnDemand);
+      auto resource2 = addResource(1, LoadPolicy::OnDemand);
+
+      loadResource(*resource1);
+      loadResource(*resource2);
+      CHECK(std::holds_alternative<ResourceReady<MockResource>>(resource1->state()));
+      CHECK(std::holds_alternative<ResourceLoaded<MockResource>>(resource2->state()));
+      CHECK(resourceManager.residentBytes() == 200);
+    }
+
+    SECTION("Does not evict resources that are loaded immediately")
+    {
+      auto resource1 = addResource(0, LoadPolicy::Immediate);
+      auto resource2 = addResource(1, LoadPolicy::Immediate);
+
+      loadResource(*resource1);
+      mockTaskRunner.resolveNextPromise();
+      resourceManager.process(taskRunner, processContext);
+
+      CHECK(std::holds_alternative<ResourceReady<MockResource>>(resource1->state()));
+      CHECK(std::holds_alternative<ResourceLoaded<MockResource>>(resource2->state()));
+      CHECK(resourceManager.residentBytes() == 200);
+    }
+
+    SECTION("Releases the resident size of dropped resources")
+    {
+      auto resource1 = addResource(0, LoadPolicy::OnDemand);
+
+      loadResource(*resource1);
+      CHECK(resourceManager.residentBytes() == 100);
+
+      resource1.reset();
+      resourceManager.process(taskRunner, processContext);
+      CHECK(resourceManager.residentBytes() == 0);
+    }
+  }
 }
 
 } // namespace tb::mdl
@@ -18,14 +18,20 @@
  */
 
 #include "mdl/BrushBuilder.h"
+#include "mdl/BrushFace.h"
 #include "mdl/BrushNode.h"
 #include "mdl/LayerNode.h"
 #include "mdl/MapFormat.h"
 #include "mdl/Tag.h"
+#include "mdl/TagManager.h"
+#include "mdl/TagMatcher.h"
 #include "mdl/WorldNode.h"
 
 #include "kdl/result.h"
 
+#include <memory>
+#include <vector>
+
 #include "Catch2.h"
 
 namespace tb::mdl
@@ -65,4 +71,73 @@ TEST_CASE("TaggingTest.testTagBrush")
   CHECK_FALSE(brushNode->hasTag(tag2));
 }
 
+TEST_CASE("TaggingTest.updateFaceTags")
+{
+  const auto worldBounds = vm::bbox3d{4096.0};
+
+  auto tagManager = TagManager{};
+  tagManager.registerSmartTags({
+    SmartTag{"clip", {}, std::make_unique<MaterialNameTagMatcher>("*clip*")},
+    SmartTag{"detail", {}, std::make_unique<SurfaceFlagsTagMatcher>(1 << 3)},
+  });
+
+  const auto& clipTag = tagManager.smartTag("clip");
+  const auto& detailTag = tagManager.smartTag("detail");
+  REQUIRE(clipTag.isMaterialTag());
+  REQUIRE_FALSE(detailTag.isMaterialTag());
+
+  auto builder = BrushBuilder{MapFormat::Quake2, worldBounds};
+  auto brush =
+    builder.createCube(64.0, "clip1", "wall", "clip2", "back", "top", "bottom")
+    | kdl::value();
+
+  auto& wallFace = brush.face(*brush.findFace("wall"));
+  auto attributes = wallFace.attributes();
+  attributes.setSurfaceFlags(1 << 3);
+  wallFace.setAttributes(attributes);
+
+  auto brushNode = BrushNode{std::move(brush)};
+  brushNode.initializeTags(tagManager);
+
+  const auto face = [&](const auto& materialName) -> const BrushFace& {
+    return brushNode.brush().face(*brushNode.brush().findFace(materialName));
+  };
+
+  CHECK(face("clip1").hasTag(clipTag));
+  CHECK_FALSE(face("clip1").hasTag(detailTag));
+  CHECK_FALSE(face("wall").hasTag(clipTag));
+  CHECK(face("wall").hasTag(detailTag));
+  CHECK(face("clip2").hasTag(clipTag));
+  CHECK_FALSE(face("back").hasTag(clipTag));
+
+  SECTION("Material tags are updated when the material name changes")
+  {
+    auto newBrush = brushNode.brush();
+    auto& backFace = newBrush.face(*newBrush.findFace("back"));
+    auto newAttributes = backFace.attributes();
+    newAttributes.setMaterialName("clip3");
+    backFace.setAttributes(newAttributes);
+
+    brushNode.setBrush(std::move(newBrush));
+    brushNode.updateTags(tagManager);
+
+    CHECK(face("clip2").hasTag(clipTag));
+    CHECK(face("clip3").hasTag(clipTag));
+    CHECK_FALSE(face("top").hasTag(clipTag));
+  }
+
+  SECTION("Cached material tags are discarded when the tags change")
+  {
+    tagManager.registerSmartTags({
+      SmartTag{"wall", {}, std::make_unique<MaterialNameTagMatcher>("wall")},
+    });
+
+    const auto& wallTag = tagManager.smartTag("wall");
+    brushNode.initializeTags(tagManager);
+
+    CHECK_FALSE(face("clip1").hasTag(wallTag));
+    CHECK(face("wall").hasTag(wallTag));
+  }
+}
+
 } // namespace tb::mdl
@@ -0,0 +1,193 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mdl/EmptyGroupValidator.h"
+#include "mdl/Entity.h"
+#include "mdl/EntityNode.h"
+#include "mdl/EntityProperties.h"
+#include "mdl/Group.h"
+#include "mdl/GroupNode.h"
+#include "mdl/Issue.h"
+#include "mdl/LayerNode.h"
+#include "mdl/LinkTargetValidator.h"
+#include "mdl/MapFormat.h"
+#include "mdl/ValidationService.h"
+#include "mdl/WorldNode.h"
+
+#include "kdl/task_manager.h"
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace tb::mdl
+{
+namespace
+{
+
+std::vector<const Node*> issueNodes(const std::vector<const Issue*>& issues)
+{
+  auto result = std::vector<const Node*>{};
+  std::transform(
+    issues.begin(), issues.end(), std::back_inserter(result), [](const auto* issue) {
+      return &issue->node();
+    });
+  return result;
+}
+
+} // namespace
+
+TEST_CASE("ValidationService")
+{
+  auto taskManager = kdl::task_manager{};
+
+  auto worldNode = WorldNode{{}, {}, MapFormat::Standard};
+  worldNode.registerValidator(std::make_unique<EmptyGroupValidator>());
+  worldNode.registerValidator(std::make_unique<LinkTargetValidator>());
+
+  auto* groupNode = new GroupNode{Group{"group"}};
+  auto* sourceNode = new EntityNode{Entity{{{EntityPropertyKeys::Target, "a"}}}};
+  auto* otherNode = new EntityNode{Entity{}};
+  worldNode.defaultLayer()->addChild(groupNode);
+  worldNode.defaultLayer()->addChild(sourceNode);
+  worldNode.defaultLayer()->addChild(otherNode);
+
+  auto validationService = ValidationService{taskManager};
+  validationService.reset(&worldNode);
+  CHECK(validationService.needsValidation());
+
+  auto delta = validationService.validate();
+  CHECK(delta.removedIssues.empty());
+  CHECK_THAT(
+    issueNodes(delta.addedIssues),
+    Catch::UnorderedEquals(std::vector<const Node*>{groupNode, sourceNode}));
+  CHECK_FALSE(validationService.needsValidation());
+
+  SECTION("Validating without changes does not find any issues")
+  {
+    delta = validationService.validate();
+    CHECK(delta.removedIssues.empty());
+    CHECK(delta.addedIssues.empty());
+    CHECK(validationService.issues().size() == 2);
+  }
+
+  SECTION("Changing a node revalidates only that node")
+  {
+    delta = validationService.nodesDidChange({otherNode});
+    CHECK(delta.removedIssues.empty());
+
+    delta = validationService.validate();
+    CHECK(delta.addedIssues.empty());
+    CHECK(validationService.issues().size() == 2);
+  }
+
+  SECTION("Adding a child to an empty group removes the group's issue")
+  {
+    auto* childNode = new EntityNode{Entity{}};
+    groupNode->addChild(childNode);
+
+    delta = validationService.nodesWereAdded({childNode});
+    CHECK_THAT(
+      issueNodes(delta.removedIssues),
+      Catch::UnorderedEquals(std::vector<const Node*>{groupNode}));
+
+    delta = validationService.validate();
+    CHECK(delta.addedIssues.empty());
+    CHECK_THAT(
+      issueNodes(validationService.issues()),
+      Catch::UnorderedEquals(std::vector<const Node*>{sourceNode}));
+  }
+
+  SECTION("Changing a link target revalidates its link sources")
+  {
+    delta = validationService.nodesWillChange({otherNode});
+    CHECK(delta.removedIssues.empty());
+
+    otherNode->setEntity(Entity{{{EntityPropertyKeys::Targetname, "a"}}});
+
+    delta = validationService.nodesDidChange({otherNode});
+    CHECK_THAT(
+      issueNodes(delta.removedIssues),
+      Catch::UnorderedEquals(std::vector<const Node*>{sourceNode}));
+
+    delta = validationService.validate();
+    CHECK(delta.addedIssues.empty());
+    CHECK_THAT(
+      issueNodes(validationService.issues()),
+      Catch::UnorderedEquals(std::vector<const Node*>{groupNode}));
+
+    SECTION("Removing the link target revalidates its link sources")
+    {
+      delta = validationService.nodesWillBeRemoved({otherNode});
+      CHECK(delta.removedIssues.empty());
+
+      auto removedNode = std::unique_ptr<Node>{otherNode};
+      worldNode.defaultLayer()->removeChild(otherNode);
+
+      delta = validationService.nodesWereRemoved({otherNode});
+      CHECK(delta.removedIssues.empty());
+
+      delta = validationService.validate();
+      CHECK_THAT(
+        issueNodes(delta.addedIssues),
+        Catch::UnorderedEquals(std::vector<const Node*>{sourceNode}));
+    }
+  }
+
+  SECTION("Removing a node removes its issues")
+  {
+    delta = validationService.nodesWillBeRemoved({groupNode});
+    CHECK(delta.removedIssues.empty());
+
+    auto removedNode = std::unique_ptr<Node>{groupNode};
+    worldNode.defaultLayer()->removeChild(groupNode);
+
+    delta = validationService.nodesWereRemoved({groupNode});
+    CHECK_THAT(
+      issueNodes(delta.removedIssues),
+      Catch::UnorderedEquals(std::vector<const Node*>{groupNode}));
+
+    delta = validationService.validate();
+    CHECK(delta.addedIssues.empty());
+    CHECK_THAT(
+      issueNodes(validationService.issues()),
+      Catch::UnorderedEquals(std::vector<const Node*>{sourceNode}));
+  }
+
+  SECTION("Validates many nodes in parallel batches")
+  {
+    auto groupNodes = std::vector<Node*>{};
+    for (size_t i = 0; i < 1000; ++i)
+    {
+      auto* emptyGroupNode = new GroupNode{Group{"group"}};
+      worldNode.defaultLayer()->addChild(emptyGroupNode);
+      groupNodes.push_back(emptyGroupNode);
+    }
+
+    validationService.nodesWereAdded(groupNodes);
+    delta = validationService.validate();
+    CHECK(delta.addedIssues.size() == 1000);
+    CHECK(validationService.issues().size() == 1002);
+  }
+}
+
+} // namespace tb::mdl
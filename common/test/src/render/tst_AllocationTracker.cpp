@@ -276,6 +276,188 @@ TEST_CASE("AllocationTrackerTest.expandWithUsedSpaceAtEnd")
   }
 }
 
+TEST_CASE("AllocationTrackerTest.usedEnd")
+{
+  AllocationTracker t(400);
+  CHECK(t.usedEnd() == 0u);
+
+  AllocationTracker::Block* blocks[4];
+  blocks[0] = t.allocate(100);
+  blocks[1] = t.allocate(100);
+  CHECK(t.usedEnd() == 200u);
+
+  blocks[2] = t.allocate(100);
+  blocks[3] = t.allocate(100);
+  CHECK(t.usedEnd() == 400u);
+
+  t.free(blocks[3]);
+  t.free(blocks[1]);
+  CHECK(t.usedEnd() == 300u);
+}
+
+TEST_CASE("AllocationTrackerTest.compact")
+{
+  AllocationTracker t(500);
+
+  AllocationTracker::Block* blocks[5];
+  for (size_t i = 0; i < 5; ++i)
+  {
+    blocks[i] = t.allocate(100);
+  }
+
+  SECTION("Compacting without free blocks does nothing")
+  {
+    CHECK_FALSE(t.fragmented());
+    CHECK(t.compact(1000).empty());
+  }
+
+  SECTION("Compacting with free space only at the end does nothing")
+  {
+    t.free(blocks[4]);
+    CHECK_FALSE(t.fragmented());
+    CHECK(t.compact(1000).empty());
+  }
+
+  SECTION("Compacting moves used blocks to the start")
+  {
+    t.free(blocks[0]);
+    t.free(blocks[2]);
+    CHECK(t.fragmented());
+
+    const auto moves = t.compact(1000);
+    REQUIRE(moves.size() == 3u);
+    CHECK(moves[0].block == blocks[1]);
+    CHECK(moves[0].oldPos == 100u);
+    CHECK(moves[1].block == blocks[3]);
+    CHECK(moves[1].oldPos == 300u);
+    CHECK(moves[2].block == blocks[4]);
+    CHECK(moves[2].oldPos == 400u);
+
+    CHECK(blocks[1]->pos == 0u);
+    CHECK(blocks[3]->pos == 100u);
+    CHECK(blocks[4]->pos == 200u);
+
+    CHECK(
+      t.usedBlocks()
+      == (std::vector<AllocationTracker::Range>{{0, 100}, {100, 100}, {200, 100}}));
+    CHECK(t.freeBlocks() == (std::vector<AllocationTracker::Range>{{300, 200}}));
+    CHECK(t.largestPossibleAllocation() == 200u);
+    CHECK_FALSE(t.fragmented());
+
+    // the moved blocks can still be freed
+    t.free(blocks[3]);
+    CHECK(
+      t.usedBlocks() == (std::vector<AllocationTracker::Range>{{0, 100}, {200, 100}}));
+    CHECK(
+      t.freeBlocks() == (std::vector<AllocationTracker::Range>{{100, 100}, {300, 200}}));
+  }
+
+  SECTION("Compacting stops when the budget is used up")
+  {
+    t.free(blocks[0]);
+
+    auto moves = t.compact(150);
+    REQUIRE(moves.size() == 2u);
+    CHECK(blocks[1]->pos == 0u);
+    CHECK(blocks[2]->pos == 100u);
+    CHECK(t.freeBlocks() == (std::vector<AllocationTracker::Range>{{200, 100}}));
+    CHECK(t.fragmented());
+
+    moves = t.compact(150);
+    REQUIRE(moves.size() == 2u);
+    CHECK(blocks[3]->pos == 200u);
+    CHECK(blocks[4]->pos == 300u);
+    CHECK(t.freeBlocks() == (std::vector<AllocationTracker::Range>{{400, 100}}));
+    CHECK_FALSE(t.fragmented());
+  }
+}
+
+TEST_CASE("AllocationTrackerTest.fragmentationStats")
+{
+  AllocationTracker t(500);
+  CHECK(
+    t.fragmentationStats() == AllocationTracker::FragmentationStats{500, 0, 0, 1, 500});
+  CHECK(t.fragmentationStats().fragmentation() == 0.0);
+
+  AllocationTracker::Block* blocks[5];
+  for (size_t i = 0; i < 5; ++i)
+  {
+    blocks[i] = t.allocate(100);
+  }
+  CHECK(
+    t.fragmentationStats() == AllocationTracker::FragmentationStats{500, 500, 5, 0, 0});
+  CHECK(t.fragmentationStats().fragmentation() == 0.0);
+
+  t.free(blocks[1]);
+  t.free(blocks[3]);
+  CHECK(
+    t.fragmentationStats() == AllocationTracker::FragmentationStats{500, 300, 3, 2, 100});
+  CHECK(t.fragmentationStats().fragmentation() == 0.5);
+
+  t.compact(1000);
+  CHECK(
+    t.fragmentationStats() == AllocationTracker::FragmentationStats{500, 300, 3, 1, 200});
+  CHECK(t.fragmentationStats().fragmentation() == 0.0);
+}
+
+TEST_CASE("AllocationTrackerTest.wastedSize")
+{
+  AllocationTracker t(500);
+  CHECK(t.wastedSize() == 0u);
+
+  AllocationTracker::Block* blocks[4];
+  for (size_t i = 0; i < 4; ++i)
+  {
+    blocks[i] = t.allocate(100);
+  }
+  CHECK(t.wastedSize() == 0u);
+
+  t.free(blocks[1]);
+  CHECK(t.wastedSize() == 100u);
+
+  // free space at the end is not wasted
+  t.free(blocks[3]);
+  CHECK(t.wastedSize() == 100u);
+
+  blocks[1] = t.allocate(100);
+  CHECK(t.wastedSize() == 0u);
+}
+
+TEST_CASE("AllocationTrackerTest.shrink")
+{
+  AllocationTracker t(500);
+
+  auto* block1 = t.allocate(100);
+  auto* block2 = t.allocate(100);
+  t.free(block1);
+
+  SECTION("Shrink into the free block at the end")
+  {
+    t.shrink(300);
+    CHECK(t.capacity() == 300u);
+    CHECK(t.usedBlocks() == (std::vector<AllocationTracker::Range>{{100, 100}}));
+    CHECK(
+      t.freeBlocks() == (std::vector<AllocationTracker::Range>{{0, 100}, {200, 100}}));
+    CHECK(t.largestPossibleAllocation() == 100u);
+  }
+
+  SECTION("Remove the free block at the end")
+  {
+    t.shrink(200);
+    CHECK(t.capacity() == 200u);
+    CHECK(t.usedBlocks() == (std::vector<AllocationTracker::Range>{{100, 100}}));
+    CHECK(t.freeBlocks() == (std::vector<AllocationTracker::Range>{{0, 100}}));
+    CHECK(t.usedEnd() == 200u);
+
+    // the tracker can grow again
+    t.expand(400);
+    CHECK(
+      t.freeBlocks() == (std::vector<AllocationTracker::Range>{{0, 100}, {200, 200}}));
+    t.free(block2);
+    CHECK_FALSE(t.hasAllocations());
+  }
+}
+
 static constexpr size_t NumBrushes = 64'000;
 
 // between 12 and 140, inclusive.
@@ -396,4 +578,85 @@ TEST_CASE("AllocationTrackerTest.benchmarkAllocAndExpand")
   }
 }
 
+/**
+ * Simulates a long editing session by repeatedly replacing random allocations, and checks
+ * that compacting the tracker while moving the data in a snapshot vector along preserves
+ * the contents of every allocation.
+ */
+TEST_CASE("AllocationTrackerTest.benchmarkEditingSessionWithCompaction")
+{
+  constexpr size_t NumEdits = 16;
+  constexpr size_t NumBrushesPerEdit = NumBrushes / 16;
+  constexpr size_t MaxMovedSizePerStep = 1 << 16;
+
+  std::mt19937 randEngine;
+
+  AllocationTracker t;
+  std::vector<size_t> snapshot;
+  std::vector<std::pair<AllocationTracker::Block*, size_t>> allocations;
+
+  const auto allocate = [&](const size_t value) {
+    const size_t brushSize = getBrushSizeFromRandEngine(randEngine);
+
+    auto* key = t.allocate(brushSize);
+    if (key == nullptr)
+    {
+      const size_t newSize = std::max(2 * t.capacity(), t.capacity() + brushSize);
+      t.expand(newSize);
+      snapshot.resize(newSize);
+
+      key = t.allocate(brushSize);
+    }
+    REQUIRE(key != nullptr);
+
+    std::fill_n(snapshot.begin() + std::ptrdiff_t(key->pos), key->size, value);
+    allocations.emplace_back(key, value);
+  };
+
+  for (size_t i = 0; i < NumBrushes; ++i)
+  {
+    allocate(i);
+  }
+
+  for (size_t edit = 0; edit < NumEdits; ++edit)
+  {
+    shuffle(allocations, randEngine);
+    for (size_t i = 0; i < NumBrushesPerEdit; ++i)
+    {
+      t.free(allocations.back().first);
+      allocations.pop_back();
+    }
+    for (size_t i = 0; i < NumBrushesPerEdit; ++i)
+    {
+      allocate(NumBrushes + edit * NumBrushesPerEdit + i);
+    }
+  }
+
+  CHECK(t.fragmentationStats().freeBlockCount > 1u);
+
+  while (t.fragmented())
+  {
+    for (const auto& move : t.compact(MaxMovedSizePerStep))
+    {
+      std::copy_n(
+        snapshot.begin() + std::ptrdiff_t(move.oldPos),
+        move.block->size,
+        snapshot.begin() + std::ptrdiff_t(move.block->pos));
+    }
+  }
+
+  const auto stats = t.fragmentationStats();
+  CHECK(stats.freeBlockCount <= 1u);
+  CHECK(stats.fragmentation() == 0.0);
+  CHECK(t.usedEnd() == stats.usedSize);
+
+  for (const auto& [key, value] : allocations)
+  {
+    CHECK(std::all_of(
+      snapshot.begin() + std::ptrdiff_t(key->pos),
+      snapshot.begin() + std::ptrdiff_t(key->pos + key->size),
+      [&](const auto v) { return v == value; }));
+  }
+}
+
 } // namespace tb::render
@@ -0,0 +1,128 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "render/BrushEdgeTable.h"
+
+#include "vm/vec.h"
+
+#include <vector>
+
+#include "Catch2.h"
+
+namespace tb::render
+{
+namespace
+{
+
+const auto* brush1 = reinterpret_cast<const mdl::BrushNode*>(1);
+const auto* brush2 = reinterpret_cast<const mdl::BrushNode*>(2);
+
+} // namespace
+
+TEST_CASE("BrushEdgeTable")
+{
+  auto table = BrushEdgeTable{};
+
+  // two unit squares sharing the edge from (1, 0, 0) to (1, 1, 0)
+  // clang-format off
+  table.addBrush(
+    brush1,
+    {
+      {0, 0, 0}, {1, 0, 0},
+      {1, 0, 0}, {1, 1, 0},
+      {1, 1, 0}, {0, 1, 0},
+      {0, 1, 0}, {0, 0, 0},
+    });
+  table.addBrush(
+    brush2,
+    {
+      {1, 0, 0}, {2, 0, 0},
+      {2, 0, 0}, {2, 1, 0},
+      {2, 1, 0}, {1, 1, 0},
+      // the shared edge in the opposite direction, slightly off
+      {1, 1, 0.0001f}, {1, 0, 0},
+    });
+  // clang-format on
+
+  CHECK(table.referenceCount() == 8);
+  CHECK(table.edgeCount() == 7);
+  CHECK(table.vertices().size() == 14);
+
+  SECTION("Removing a brush keeps shared edges")
+  {
+    table.removeBrush(brush1);
+
+    CHECK(table.referenceCount() == 4);
+    CHECK(table.edgeCount() == 4);
+    CHECK(table.vertices().size() == 8);
+
+    table.removeBrush(brush2);
+
+    CHECK(table.referenceCount() == 0);
+    CHECK(table.edgeCount() == 0);
+    CHECK(table.vertices().empty());
+  }
+
+  SECTION("Removed edges can be added again")
+  {
+    table.removeBrush(brush2);
+    CHECK(table.edgeCount() == 4);
+
+    table.addBrush(brush2, {{1, 0, 0}, {2, 0, 0}, {1, 1, 0}, {1, 0, 0}});
+    CHECK(table.referenceCount() == 6);
+    CHECK(table.edgeCount() == 5);
+  }
+
+  SECTION("Removing an unknown brush is ignored")
+  {
+    table.removeBrush(reinterpret_cast<const mdl::BrushNode*>(3));
+    CHECK(table.referenceCount() == 8);
+  }
+
+  SECTION("Only filled and refilled slots are dirty")
+  {
+    using SlotRange = BrushEdgeTable::SlotRange;
+
+    CHECK(table.takeDirtySlotRanges() == std::vector<SlotRange>{{0, 7}});
+    CHECK(table.takeDirtySlotRanges().empty());
+
+    // the last edges are moved into the slots of the removed edges
+    table.removeBrush(brush1);
+    CHECK(table.takeDirtySlotRanges() == std::vector<SlotRange>{{0, 1}, {2, 2}});
+
+    // the shared edge keeps its slot
+    table.addBrush(
+      brush1,
+      {{0, 0, 0}, {1, 0, 0}, {1, 0, 0}, {1, 1, 0}, {1, 1, 0}, {0, 1, 0}});
+    CHECK(table.takeDirtySlotRanges() == std::vector<SlotRange>{{4, 2}});
+
+    // removing the last slots doesn't dirty anything
+    table.removeBrush(brush1);
+    CHECK(table.takeDirtySlotRanges().empty());
+  }
+
+  SECTION("clear")
+  {
+    table.clear();
+    CHECK(table.referenceCount() == 0);
+    CHECK(table.edgeCount() == 0);
+  }
+}
+
+} // namespace tb::render
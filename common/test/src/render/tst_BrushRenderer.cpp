@@ -0,0 +1,95 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mdl/BrushBuilder.h"
+#include "mdl/BrushNode.h"
+#include "mdl/MapFormat.h"
+#include "render/BrushRenderer.h"
+
+#include "kdl/result.h"
+
+#include "vm/bbox.h"
+
+#include <memory>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace tb::render
+{
+
+TEST_CASE("BrushRenderer.compaction")
+{
+  constexpr auto NumBrushes = size_t(1024);
+
+  auto builder = mdl::BrushBuilder{mdl::MapFormat::Standard, vm::bbox3d{4096.0}};
+
+  auto brushNodes = std::vector<std::unique_ptr<mdl::BrushNode>>{};
+  for (size_t i = 0; i < NumBrushes; ++i)
+  {
+    brushNodes.push_back(std::make_unique<mdl::BrushNode>(
+      builder.createCube(64.0, "material") | kdl::value()));
+  }
+
+  auto renderer = BrushRenderer{};
+  for (const auto& brushNode : brushNodes)
+  {
+    renderer.addBrush(brushNode.get());
+  }
+  renderer.validate();
+  REQUIRE_FALSE(renderer.compactionPending());
+
+  SECTION("Removing and adding a single brush does not trigger compaction")
+  {
+    renderer.removeBrush(brushNodes[17].get());
+    CHECK_FALSE(renderer.compactionPending());
+
+    renderer.addBrush(brushNodes[17].get());
+    renderer.validate();
+    CHECK_FALSE(renderer.compactionPending());
+    CHECK(renderer.vertexFragmentationStats().fragmentation() == 0.0);
+  }
+
+  SECTION("Removing many brushes triggers compaction and shrinks the VBOs")
+  {
+    for (size_t i = 0; i < NumBrushes; ++i)
+    {
+      if (i % 8 != 0)
+      {
+        renderer.removeBrush(brushNodes[i].get());
+      }
+    }
+    CHECK(renderer.compactionPending());
+
+    const auto statsBeforeCompaction = renderer.vertexFragmentationStats();
+    CHECK(statsBeforeCompaction.fragmentation() > 0.0);
+
+    while (renderer.compact(1 << 12))
+    {
+    }
+
+    const auto statsAfterCompaction = renderer.vertexFragmentationStats();
+    CHECK(statsAfterCompaction.fragmentation() == 0.0);
+    CHECK(statsAfterCompaction.usedSize == statsBeforeCompaction.usedSize);
+    CHECK(statsAfterCompaction.capacity < statsBeforeCompaction.capacity);
+    CHECK(statsAfterCompaction.capacity >= statsAfterCompaction.usedSize);
+  }
+}
+
+} // namespace tb::render
@@ -0,0 +1,96 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "render/EntityModelInstanceBatch.h"
+#include "render/MaterialIndexRangeRenderer.h"
+
+#include "vm/mat_ext.h"
+
+#include "Catch2.h"
+
+namespace tb::render
+{
+
+TEST_CASE("EntityModelInstanceBatch")
+{
+  auto renderer1 = MaterialIndexRangeRenderer{};
+  auto renderer2 = MaterialIndexRangeRenderer{};
+
+  const auto transformation1 = vm::translation_matrix(vm::vec3f{1, 2, 3});
+  const auto transformation2 = vm::translation_matrix(vm::vec3f{4, 5, 6});
+  const auto transformation3 = vm::scaling_matrix(vm::vec3f{2, 2, 2});
+
+  auto batch = EntityModelInstanceBatch{};
+  CHECK(batch.empty());
+
+  SECTION("Instances are grouped by renderer")
+  {
+    batch.add(renderer1, mdl::Orientation::Oriented, transformation1);
+    batch.add(renderer2, mdl::Orientation::FacingUpright, transformation2);
+    batch.add(renderer1, mdl::Orientation::Oriented, transformation3);
+
+    CHECK_FALSE(batch.empty());
+    CHECK(batch.instanceCount() == 3);
+    CHECK(
+      batch.groups()
+      == std::vector<EntityModelInstances>{
+        {&renderer1, mdl::Orientation::Oriented, {transformation1, transformation3}},
+        {&renderer2, mdl::Orientation::FacingUpright, {transformation2}},
+      });
+
+    batch.clear();
+    CHECK(batch.empty());
+    CHECK(batch.instanceCount() == 0);
+  }
+
+  SECTION("Batches with the same instances are equal")
+  {
+    batch.add(renderer1, mdl::Orientation::Oriented, transformation1);
+
+    auto other = EntityModelInstanceBatch{};
+    other.add(renderer1, mdl::Orientation::Oriented, transformation1);
+    CHECK(batch == other);
+
+    other.add(renderer1, mdl::Orientation::Oriented, transformation2);
+    CHECK(batch != other);
+  }
+
+  SECTION("packTransformations")
+  {
+    batch.add(renderer1, mdl::Orientation::Oriented, transformation1);
+    batch.add(renderer1, mdl::Orientation::Oriented, transformation3);
+
+    const auto vertices =
+      EntityModelInstanceBatch::packTransformations(batch.groups().front());
+    REQUIRE(vertices.size() == 2);
+
+    // the vertices store the columns of the matrices in order
+    static_assert(sizeof(EntityModelInstanceBatch::InstanceVertex) == sizeof(vm::mat4x4f));
+    const auto* values = reinterpret_cast<const float*>(vertices.data());
+    CHECK(values[12] == 1.0f);
+    CHECK(values[13] == 2.0f);
+    CHECK(values[14] == 3.0f);
+    CHECK(values[15] == 1.0f);
+    CHECK(values[16] == 2.0f);
+    CHECK(values[16 + 5] == 2.0f);
+    CHECK(values[16 + 12] == 0.0f);
+  }
+}
+
+} // namespace tb::render
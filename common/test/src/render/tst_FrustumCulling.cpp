@@ -0,0 +1,193 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mdl/Entity.h"
+#include "mdl/EntityNode.h"
+#include "octree.h"
+#include "render/FrustumCulling.h"
+#include "render/PerspectiveCamera.h"
+
+#include "vm/constants.h"
+
+#include <fmt/format.h>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace tb::render
+{
+
+TEST_CASE("ViewFrustum")
+{
+  SECTION("intersects")
+  {
+    // the half space x <= 0
+    const auto frustum =
+      ViewFrustum{{vm::plane3d{vm::vec3d{0, 0, 0}, vm::vec3d{1, 0, 0}}}};
+
+    CHECK(frustum.intersects(vm::bbox3d{{-10, -10, -10}, {-5, 10, 10}}));
+    CHECK(frustum.intersects(vm::bbox3d{{-1, -1, -1}, {1, 1, 1}}));
+    CHECK_FALSE(frustum.intersects(vm::bbox3d{{5, -10, -10}, {10, 10, 10}}));
+  }
+
+  SECTION("classify")
+  {
+    // the half space x <= 0
+    const auto frustum =
+      ViewFrustum{{vm::plane3d{vm::vec3d{0, 0, 0}, vm::vec3d{1, 0, 0}}}};
+
+    CHECK(
+      frustum.classify(vm::bbox3d{{-10, -10, -10}, {-5, 10, 10}})
+      == FrustumContainment::Inside);
+    CHECK(
+      frustum.classify(vm::bbox3d{{-1, -1, -1}, {1, 1, 1}})
+      == FrustumContainment::Intersecting);
+    CHECK(
+      frustum.classify(vm::bbox3d{{5, -10, -10}, {10, 10, 10}})
+      == FrustumContainment::Outside);
+  }
+
+  SECTION("fromCamera")
+  {
+    const auto camera = PerspectiveCamera{
+      90.0f,
+      1.0f,
+      1000.0f,
+      Camera::Viewport{0, 0, 800, 800},
+      vm::vec3f{0, 0, 0},
+      vm::vec3f{1, 0, 0},
+      vm::vec3f{0, 0, 1}};
+    const auto frustum = ViewFrustum::fromCamera(camera);
+
+    CHECK(frustum.intersects(vm::bbox3d{{100, -8, -8}, {116, 8, 8}}));
+    CHECK_FALSE(frustum.intersects(vm::bbox3d{{-116, -8, -8}, {-100, 8, 8}}));
+    CHECK_FALSE(frustum.intersects(vm::bbox3d{{100, 200, -8}, {116, 216, 8}}));
+    CHECK_FALSE(frustum.intersects(vm::bbox3d{{1100, -8, -8}, {1116, 8, 8}}));
+  }
+}
+
+TEST_CASE("VisibleSet")
+{
+  auto camera = PerspectiveCamera{
+    90.0f,
+    1.0f,
+    1000.0f,
+    Camera::Viewport{0, 0, 800, 800},
+    vm::vec3f{0, 0, 0},
+    vm::vec3f{1, 0, 0},
+    vm::vec3f{0, 0, 1}};
+
+  auto entityInFront = mdl::EntityNode{mdl::Entity{{{"origin", "100 0 0"}}}};
+  auto entityBehind = mdl::EntityNode{mdl::Entity{{{"origin", "-100 0 0"}}}};
+
+  auto nodeTree = octree<double, mdl::Node*>{32.0};
+  nodeTree.insert(entityInFront.physicalBounds(), &entityInFront);
+  nodeTree.insert(entityBehind.physicalBounds(), &entityBehind);
+
+  auto visibleSet = VisibleSet{};
+  CHECK(visibleSet.update(nodeTree, ViewFrustum::fromCamera(camera)));
+  CHECK(visibleSet.contains(&entityInFront));
+  CHECK_FALSE(visibleSet.contains(&entityBehind));
+  CHECK(visibleSet.stats() == CullingStats{1, 1});
+
+  const auto generation = visibleSet.generation();
+
+  SECTION("Updating with an unchanged frustum keeps the generation")
+  {
+    CHECK_FALSE(visibleSet.update(nodeTree, ViewFrustum::fromCamera(camera)));
+    CHECK(visibleSet.generation() == generation);
+  }
+
+  SECTION("Updating with a changed frustum assigns a new generation")
+  {
+    camera.setDirection(vm::vec3f{-1, 0, 0}, vm::vec3f{0, 0, 1});
+
+    CHECK(visibleSet.update(nodeTree, ViewFrustum::fromCamera(camera)));
+    CHECK(visibleSet.generation() != generation);
+    CHECK_FALSE(visibleSet.contains(&entityInFront));
+    CHECK(visibleSet.contains(&entityBehind));
+  }
+
+  SECTION("Removing a node from the tree removes it from the set")
+  {
+    nodeTree.remove(&entityInFront);
+
+    CHECK(visibleSet.update(nodeTree, ViewFrustum::fromCamera(camera)));
+    CHECK_FALSE(visibleSet.contains(&entityInFront));
+    CHECK(visibleSet.stats() == CullingStats{0, 1});
+  }
+}
+
+TEST_CASE("VisibleSet.incrementalUpdate")
+{
+  auto camera = PerspectiveCamera{
+    90.0f,
+    1.0f,
+    1000.0f,
+    Camera::Viewport{0, 0, 800, 800},
+    vm::vec3f{0, 0, 0},
+    vm::vec3f{1, 0, 0},
+    vm::vec3f{0, 0, 1}};
+
+  auto entityNodes = std::vector<std::unique_ptr<mdl::EntityNode>>{};
+  for (int x = -1600; x <= 1600; x += 160)
+  {
+    for (int y = -1600; y <= 1600; y += 160)
+    {
+      const auto origin = fmt::format("{} {} 0", x, y);
+      entityNodes.push_back(
+        std::make_unique<mdl::EntityNode>(mdl::Entity{{{"origin", origin}}}));
+    }
+  }
+
+  auto nodeTree = octree<double, mdl::Node*>{32.0};
+  for (const auto& entityNode : entityNodes)
+  {
+    nodeTree.insert(entityNode->physicalBounds(), entityNode.get());
+  }
+
+  auto visibleSet = VisibleSet{};
+
+  // rotate and move the camera so that tree nodes enter and leave the frustum
+  for (size_t i = 0; i < 32; ++i)
+  {
+    const auto angle = float(i) * vm::Cf::two_pi() / 12.0f;
+    camera.moveTo(vm::vec3f{float(i) * 40.0f - 640.0f, 0, 0});
+    camera.setDirection(
+      vm::vec3f{std::cos(angle), std::sin(angle), 0}, vm::vec3f{0, 0, 1});
+
+    const auto frustum = ViewFrustum::fromCamera(camera);
+    visibleSet.update(nodeTree, frustum);
+
+    auto visibleCount = size_t(0);
+    for (const auto& entityNode : entityNodes)
+    {
+      const auto expected = frustum.intersects(entityNode->physicalBounds());
+      CHECK(visibleSet.contains(entityNode.get()) == expected);
+      visibleCount += expected ? 1 : 0;
+    }
+    const auto culledCount = entityNodes.size() - visibleCount;
+    CHECK(visibleSet.stats() == CullingStats{visibleCount, culledCount});
+  }
+}
+
+} // namespace tb::render
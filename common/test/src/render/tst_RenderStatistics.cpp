@@ -0,0 +1,135 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "render/RenderStatistics.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace tb::render
+{
+
+TEST_CASE("RenderStatistics")
+{
+  auto statistics = RenderStatistics{};
+
+  SECTION("Nothing is collected while no statistics are active")
+  {
+    countDrawCall(3, 0);
+    countUpload(64);
+    {
+      const auto timer = ScopedRenderTimer{RenderCategory::Brushes, RenderPhase::Render};
+    }
+
+    CHECK(RenderStatistics::active() == nullptr);
+    CHECK(statistics.frameCount() == 0);
+    CHECK(statistics.lastFrameTotal() == RenderCategoryStats{});
+  }
+
+  SECTION("Draw calls and uploads are attributed to the current category")
+  {
+    {
+      const auto activate = ActivateRenderStatistics{&statistics};
+      CHECK(RenderStatistics::active() == &statistics);
+
+      countDrawCall(3, 0);
+      {
+        const auto timer =
+          ScopedRenderTimer{RenderCategory::Brushes, RenderPhase::Prepare};
+        countUpload(64);
+        countDrawCall(0, 6);
+        countDrawCall(0, 12);
+      }
+      {
+        const auto timer = ScopedRenderTimer{RenderCategory::Text, RenderPhase::Render};
+        countDrawCall(4, 0);
+      }
+    }
+
+    CHECK(RenderStatistics::active() == nullptr);
+    CHECK(statistics.frameCount() == 1);
+
+    const auto& brushes = statistics.lastFrame(RenderCategory::Brushes);
+    CHECK(brushes.drawCalls == 2);
+    CHECK(brushes.vertices == 0);
+    CHECK(brushes.indices == 18);
+    CHECK(brushes.bytesUploaded == 64);
+    CHECK(brushes.prepareMs >= 0.0);
+    CHECK(brushes.renderMs == 0.0);
+
+    CHECK(statistics.lastFrame(RenderCategory::Text).drawCalls == 1);
+    CHECK(statistics.lastFrame(RenderCategory::Guides).vertices == 3);
+    CHECK(statistics.lastFrame(RenderCategory::Entities) == RenderCategoryStats{});
+
+    const auto total = statistics.lastFrameTotal();
+    CHECK(total.drawCalls == 4);
+    CHECK(total.vertices == 7);
+    CHECK(total.indices == 18);
+  }
+
+  SECTION("Each frame starts with empty statistics")
+  {
+    {
+      const auto activate = ActivateRenderStatistics{&statistics};
+      countDrawCall(3, 0);
+    }
+    {
+      const auto activate = ActivateRenderStatistics{&statistics};
+    }
+
+    CHECK(statistics.frameCount() == 2);
+    CHECK(statistics.lastFrameTotal().drawCalls == 0);
+  }
+
+  SECTION("summary")
+  {
+    CHECK(statistics.summary().size() == RenderCategoryCount + 1);
+  }
+
+  SECTION("writeCsvRows")
+  {
+    {
+      const auto activate = ActivateRenderStatistics{&statistics};
+      const auto timer = ScopedRenderTimer{RenderCategory::Entities, RenderPhase::Render};
+      countDrawCall(24, 0);
+    }
+
+    auto str = std::stringstream{};
+    RenderStatistics::writeCsvHeader(str);
+    statistics.writeCsvRows(str);
+
+    auto line = std::string{};
+    auto lines = std::vector<std::string>{};
+    while (std::getline(str, line))
+    {
+      lines.push_back(line);
+    }
+
+    REQUIRE(lines.size() == RenderCategoryCount + 1);
+    CHECK(lines[0].starts_with("frame,category,"));
+    CHECK(lines[1].starts_with("0,brushes,"));
+    CHECK(lines[2].starts_with("0,entities,"));
+    CHECK(lines[2].ends_with(",1,24,0,0"));
+  }
+}
+
+} // namespace tb::render
@@ -0,0 +1,55 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "render/VertexPacking.h"
+
+#include "vm/approx.h"
+#include "vm/vec.h"
+#include "vm/vec_io.h" // IWYU pragma: keep
+
+#include <tuple>
+
+#include "Catch2.h"
+
+namespace tb::render
+{
+
+TEST_CASE("encodeOctahedralNormal")
+{
+  using T = std::tuple<vm::vec3f>;
+
+  const auto [normal] = GENERATE(values<T>({
+    {vm::vec3f{1, 0, 0}},
+    {vm::vec3f{-1, 0, 0}},
+    {vm::vec3f{0, 1, 0}},
+    {vm::vec3f{0, -1, 0}},
+    {vm::vec3f{0, 0, 1}},
+    {vm::vec3f{0, 0, -1}},
+    {vm::normalize(vm::vec3f{1, 2, 3})},
+    {vm::normalize(vm::vec3f{-3, 1, -2})},
+    {vm::normalize(vm::vec3f{0.001f, -1, -0.5f})},
+  }));
+
+  CAPTURE(normal);
+
+  const auto decoded = decodeOctahedralNormal(encodeOctahedralNormal(normal));
+  CHECK(decoded == vm::approx<vm::vec3f>{normal, 0.0001f});
+}
+
+} // namespace tb::render
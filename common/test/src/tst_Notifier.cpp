@@ -70,18 +70,21 @@ TEST_CASE("NotifierTest.testAddRemoveObservers")
   auto o2 = Observer{};
 
   auto obs = Observed{};
+  CHECK(obs.noArgNotifier.observerCount() == 0);
 
   {
     auto con = NotifierConnection{};
     con += obs.noArgNotifier.connect(&o1, &Observer::notify0);
     con += obs.noArgNotifier.connect(&o1, &Observer::notify0);
     con += obs.noArgNotifier.connect(&o2, &Observer::notify0);
+    CHECK(obs.noArgNotifier.observerCount() == 3);
 
     obs.notify0();
     CHECK(o1.notify0Calls == 2);
     CHECK(o2.notify0Calls == 1);
   }
 
+  CHECK(obs.noArgNotifier.observerCount() == 0);
   obs.notify0();
   CHECK(o1.notify0Calls == 2);
   CHECK(o2.notify0Calls == 1);
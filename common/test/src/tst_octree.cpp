@@ -19,6 +19,9 @@
 
 #include "octree.h"
 
+#include <iterator>
+#include <vector>
+
 #include "Catch2.h"
 
 namespace tb
@@ -675,6 +678,65 @@ TEST_CASE("octree.find_intersectors-bbox")
   }
 }
 
+TEST_CASE("octree.find_if")
+{
+  auto tree = octree<double, int>{32.0};
+
+  SECTION("empty tree")
+  {
+    auto result = std::vector<int>{};
+    tree.find_if([](const auto&) { return true; }, std::back_inserter(result));
+    CHECK(result.empty());
+  }
+
+  SECTION("multiple nodes")
+  {
+    tree.insert({{32, 32, 32}, {64, 64, 64}}, 1);
+    tree.insert({{-64, -64, -64}, {-32, -32, -32}}, 2);
+    tree.insert({{-16, -16, -16}, {16, 16, 16}}, 3);
+    REQUIRE(tree.size() == 3);
+
+    const auto findIf = [&](const auto& predicate) {
+      auto result = std::vector<int>{};
+      tree.find_if(predicate, std::back_inserter(result));
+      return kdl::vec_sort(std::move(result));
+    };
+
+    CHECK(findIf([](const auto&) { return true; }) == std::vector<int>{1, 2, 3});
+    CHECK(findIf([](const auto&) { return false; }).empty());
+
+    // the root node contains 3, so it is found whenever the root is accepted
+    CHECK(
+      findIf([](const auto& bounds) { return bounds.max.x() > 0.0; })
+      == std::vector<int>{1, 3});
+  }
+}
+
+TEST_CASE("octree.revision")
+{
+  auto tree = octree<double, int>{32.0};
+  auto otherTree = octree<double, int>{32.0};
+  CHECK(tree.revision() != otherTree.revision());
+
+  auto revision = tree.revision();
+  tree.insert({{32, 32, 32}, {64, 64, 64}}, 1);
+  CHECK(tree.revision() != revision);
+
+  revision = tree.revision();
+  tree.find_intersectors(vm::bbox3d{{0, 0, 0}, {64, 64, 64}});
+  CHECK(tree.revision() == revision);
+
+  tree.remove(2);
+  CHECK(tree.revision() == revision);
+
+  tree.remove(1);
+  CHECK(tree.revision() != revision);
+
+  revision = tree.revision();
+  tree.clear();
+  CHECK(tree.revision() != revision);
+}
+
 TEST_CASE("octree.find_containers")
 {
   auto tree = octree<double, int>{32.0};
@@ -0,0 +1,162 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "spatial_grid.h"
+
+#include "kdl/vector_utils.h"
+
+#include <iterator>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace tb
+{
+namespace
+{
+
+template <typename T, typename U>
+std::vector<U> findNear(
+  const spatial_grid<T, U>& grid, const vm::vec<T, 3>& point, const T epsilon)
+{
+  auto result = std::vector<U>{};
+  grid.find_near(point, epsilon, std::back_inserter(result));
+  return kdl::vec_sort(std::move(result));
+}
+
+template <typename T, typename U, typename P>
+std::vector<U> findIf(const spatial_grid<T, U>& grid, const P& predicate)
+{
+  auto result = std::vector<U>{};
+  grid.find_if(predicate, std::back_inserter(result));
+  return kdl::vec_sort(std::move(result));
+}
+
+} // namespace
+
+TEST_CASE("spatial_grid.insert")
+{
+  auto grid = spatial_grid<double, int>{16.0};
+  CHECK(grid.empty());
+
+  grid.insert({0, 0, 0}, 0.0, 1);
+  grid.insert({-1, 0, 0}, 0.0, 2);
+  grid.insert({0, 0, 0}, 0.0, 3);
+
+  CHECK_FALSE(grid.empty());
+  CHECK(grid.size() == 3u);
+  CHECK(findNear(grid, vm::vec3d{0, 0, 0}, 0.0) == std::vector<int>{1, 3});
+  CHECK(findNear(grid, vm::vec3d{-1, 0, 0}, 0.0) == std::vector<int>{2});
+}
+
+TEST_CASE("spatial_grid.remove")
+{
+  auto grid = spatial_grid<double, int>{16.0};
+  grid.insert({0, 0, 0}, 0.0, 1);
+  grid.insert({-1, 0, 0}, 0.0, 2);
+  grid.insert({256, 0, 0}, 0.0, 3);
+
+  CHECK_FALSE(grid.remove({0, 0, 0}, 2));
+  CHECK_FALSE(grid.remove({32, 0, 0}, 1));
+  CHECK(grid.size() == 3u);
+
+  CHECK(grid.remove({0, 0, 0}, 1));
+  CHECK(grid.size() == 2u);
+  CHECK(findNear(grid, vm::vec3d{0, 0, 0}, 0.0) == std::vector<int>{});
+
+  CHECK(grid.remove({256, 0, 0}, 3));
+  CHECK(grid.remove({-1, 0, 0}, 2));
+  CHECK(grid.empty());
+
+  const auto all = [](const auto&, const auto) { return true; };
+  CHECK(findIf(grid, all) == std::vector<int>{});
+}
+
+TEST_CASE("spatial_grid.clear")
+{
+  auto grid = spatial_grid<double, int>{16.0};
+  grid.insert({0, 0, 0}, 0.0, 1);
+  grid.insert({-1, 0, 0}, 0.0, 2);
+
+  grid.clear();
+  CHECK(grid.empty());
+  CHECK(findNear(grid, vm::vec3d{0, 0, 0}, 1.0) == std::vector<int>{});
+}
+
+TEST_CASE("spatial_grid.find_near")
+{
+  auto grid = spatial_grid<double, int>{16.0};
+  grid.insert({0, 0, 0}, 0.0, 1);
+  grid.insert({-0.5, 0, 0}, 0.0, 2);
+  grid.insert({0, 0.5, 16}, 0.0, 3);
+  grid.insert({16, 16, 16}, 0.0, 4);
+
+  CHECK(findNear(grid, vm::vec3d{0, 0, 0}, 0.0) == std::vector<int>{1});
+  CHECK(findNear(grid, vm::vec3d{0, 0, 0}, 0.5) == std::vector<int>{1, 2});
+  CHECK(findNear(grid, vm::vec3d{0, 0, 15.5}, 0.5) == std::vector<int>{3});
+  CHECK(findNear(grid, vm::vec3d{15.9, 15.9, 15.9}, 0.2) == std::vector<int>{4});
+  CHECK(findNear(grid, vm::vec3d{8, 8, 8}, 1.0) == std::vector<int>{});
+}
+
+TEST_CASE("spatial_grid.find_if")
+{
+  auto grid = spatial_grid<double, int>{16.0};
+  grid.insert({8, 8, 8}, 0.0, 1);
+  grid.insert({-8, 8, 8}, 0.0, 2);
+  grid.insert({1000, 8, 8}, 0.0, 3);
+  grid.insert({40, 8, 8}, 24.0, 4);
+
+  SECTION("Predicate is called with cell bounds")
+  {
+    const auto query = vm::bbox3d{{0, 0, 0}, {1, 1, 1}};
+    const auto intersects = [&](const vm::bbox3d& bounds, const double) {
+      return bounds.intersects(query);
+    };
+
+    // the cells of 1 and 2 touch the query bounds
+    CHECK(findIf(grid, intersects) == std::vector<int>{1, 2});
+  }
+
+  SECTION("Predicate is called with the maximum extent")
+  {
+    const auto query = vm::bbox3d{{18, 0, 0}, {20, 1, 1}};
+    const auto intersects = [&](const vm::bbox3d& bounds, const double extent) {
+      return bounds.expand(extent).intersects(query);
+    };
+
+    CHECK(findIf(grid, intersects) == std::vector<int>{4});
+  }
+
+  SECTION("Cells are skipped if their block is rejected")
+  {
+    auto bounds = std::vector<vm::bbox3d>{};
+    findIf(grid, [&](const vm::bbox3d& b, const double) {
+      bounds.push_back(b);
+      return b.contains(vm::vec3d{1000, 8, 8});
+    });
+
+    // three blocks and one cell
+    CHECK(bounds.size() == 4u);
+    CHECK(findIf(grid, [](const vm::bbox3d& b, const double) {
+            return b.contains(vm::vec3d{1000, 8, 8});
+          }) == std::vector<int>{3});
+  }
+}
+
+} // namespace tb
@@ -0,0 +1,170 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ui/CellLayout.h"
+
+#include <string>
+
+#include "Catch2.h"
+
+namespace tb::ui
+{
+namespace
+{
+
+CellLayout makeLayout(const float width)
+{
+  auto layout = CellLayout{};
+  layout.setWidth(width);
+  layout.setOuterMargin(5.0f);
+  layout.setGroupMargin(5.0f);
+  layout.setRowMargin(10.0f);
+  layout.setCellMargin(10.0f);
+  layout.setCellWidth(64.0f, 64.0f);
+  layout.setCellHeight(64.0f, 128.0f);
+  return layout;
+}
+
+void addItems(CellLayout& layout, const size_t count)
+{
+  for (size_t i = 0; i < count; ++i)
+  {
+    layout.addItem(int(i), std::to_string(i), 64.0f, 64.0f, 64.0f, 12.0f);
+  }
+}
+
+} // namespace
+
+TEST_CASE("CellLayout")
+{
+  // 4 cells of width 64 with a margin of 10 fit into a width of 296 - 2 * 5
+  auto layout = makeLayout(296.0f);
+
+  SECTION("Items are arranged in rows")
+  {
+    addItems(layout, 10);
+
+    const auto& groups = layout.groups();
+    REQUIRE(groups.size() == 1);
+
+    const auto& rows = groups.front().rows();
+    REQUIRE(rows.size() == 3);
+    CHECK(rows[0].itemCount() == 4);
+    CHECK(rows[1].itemCount() == 4);
+    CHECK(rows[2].itemCount() == 2);
+
+    CHECK(rows[1].bounds().top() == rows[0].bounds().bottom() + 10.0f);
+
+    const auto& cells = rows[1].cells();
+    REQUIRE(cells.size() == 4);
+    CHECK(cells[0].itemAs<int>() == 4);
+    CHECK(cells[0].bounds().left() == 5.0f);
+    CHECK(cells[1].bounds().left() == 79.0f);
+    CHECK(cells[3].itemAs<int>() == 7);
+  }
+
+  SECTION("Rows are laid out again when the width changes")
+  {
+    addItems(layout, 10);
+    REQUIRE(layout.groups().front().rows().size() == 3);
+
+    layout.setWidth(148.0f);
+
+    const auto& rows = layout.groups().front().rows();
+    REQUIRE(rows.size() == 5);
+    CHECK(rows[4].itemCount() == 2);
+    CHECK(rows[4].cells()[1].itemAs<int>() == 9);
+    CHECK(rows[4].cells()[1].title() == "9");
+  }
+
+  SECTION("Title widths survive a relayout")
+  {
+    layout.addItem(0, "long title", 64.0f, 64.0f, 200.0f, 12.0f);
+    layout.setWidth(1000.0f);
+    REQUIRE(layout.groups().front().rows().front().cells().front().titleBounds().width
+            == 64.0f);
+
+    layout.setCellWidth(64.0f, 256.0f);
+    CHECK(
+      layout.groups().front().rows().front().cells().front().titleBounds().width
+      == 200.0f);
+  }
+
+  SECTION("rowsIntersectingY")
+  {
+    addItems(layout, 40);
+
+    const auto& group = layout.groups().front();
+    const auto& rows = group.rows();
+    REQUIRE(rows.size() == 10);
+
+    CHECK(group.rowsIntersectingY(rows[0].bounds().top(), 1.0f).size() == 1);
+
+    const auto y = rows[2].bounds().bottom();
+    const auto visibleRows = group.rowsIntersectingY(y, rows[4].bounds().top() - y);
+    CHECK(visibleRows.size() == 3);
+    CHECK(&visibleRows.front() == &rows[2]);
+
+    CHECK(group.rowsIntersectingY(rows[9].bounds().bottom() + 1.0f, 100.0f).empty());
+  }
+
+  SECTION("cellAt")
+  {
+    addItems(layout, 40);
+
+    const auto& rows = layout.groups().front().rows();
+    const auto& rowBounds = rows[7].bounds();
+
+    const auto* cell = layout.cellAt(80.0f, rowBounds.top() + 1.0f);
+    REQUIRE(cell != nullptr);
+    CHECK(cell->itemAs<int>() == 29);
+
+    CHECK(layout.cellAt(74.0f, rowBounds.top() + 1.0f) == nullptr);
+    CHECK(layout.cellAt(80.0f, rowBounds.bottom() + 5.0f) == nullptr);
+  }
+
+  SECTION("rowPosition")
+  {
+    addItems(layout, 40);
+
+    const auto& rows = layout.groups().front().rows();
+    const auto y = rows[4].bounds().top() + 1.0f;
+
+    CHECK(layout.rowPosition(y, 1) == rows[5].bounds().top());
+    CHECK(layout.rowPosition(y, -2) == rows[2].bounds().top());
+    CHECK(layout.rowPosition(y, 0) == y);
+  }
+
+  SECTION("Groups")
+  {
+    layout.addGroup("group 1", 12.0f);
+    addItems(layout, 5);
+    layout.addGroup("group 2", 12.0f);
+    addItems(layout, 3);
+
+    const auto& groups = layout.groups();
+    REQUIRE(groups.size() == 2);
+    CHECK(groups[0].rows().size() == 2);
+    CHECK(groups[1].rows().size() == 1);
+    CHECK(groups[1].titleBounds().top() == groups[0].bounds().bottom() + 5.0f);
+    CHECK(layout.height() == groups[1].bounds().bottom() + 10.0f);
+  }
+}
+
+} // namespace tb::ui
@@ -829,10 +829,19 @@ TEST_CASE("MapDocumentTest")
     REQUIRE(
       kdl::none_of(faces, [](const auto* face) { return face->material() == nullptr; }));
 
+    auto nodesDidChange = std::vector<std::vector<mdl::Node*>>{};
+    auto connection = document->nodesDidChangeNotifier.connect(
+      [&](const auto& nodes) { nodesDidChange.push_back(nodes); });
+
     CHECK_NOTHROW(document->reloadMaterialCollections());
 
     REQUIRE(
       kdl::none_of(faces, [](const auto* face) { return face->material() == nullptr; }));
+
+    REQUIRE(nodesDidChange.size() == 1);
+    CHECK_THAT(
+      nodesDidChange.front(),
+      Catch::UnorderedEquals(document->world()->defaultLayer()->children()));
   }
 }
 
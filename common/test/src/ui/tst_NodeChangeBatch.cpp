@@ -0,0 +1,168 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Notifier.h"
+#include "mdl/Entity.h"
+#include "mdl/EntityNode.h"
+#include "mdl/Group.h"
+#include "mdl/GroupNode.h"
+#include "ui/NodeChangeBatch.h"
+#include "ui/TransactionScope.h"
+
+#include <vector>
+
+#include "Catch2.h"
+
+namespace tb::ui
+{
+
+TEST_CASE("NodeChangeBatch")
+{
+  auto nodesWillChangeNotifier = Notifier<const std::vector<mdl::Node*>&>{};
+  auto nodesDidChangeNotifier = Notifier<const std::vector<mdl::Node*>&>{};
+  auto uncoalescedNodesDidChangeNotifier = Notifier<const std::vector<mdl::Node*>&>{};
+
+  auto willChange = std::vector<std::vector<mdl::Node*>>{};
+  auto didChange = std::vector<std::vector<mdl::Node*>>{};
+  auto uncoalescedDidChange = std::vector<std::vector<mdl::Node*>>{};
+
+  auto connection = NotifierConnection{};
+  connection += nodesWillChangeNotifier.connect(
+    [&](const auto& nodes) { willChange.push_back(nodes); });
+  connection += nodesDidChangeNotifier.connect(
+    [&](const auto& nodes) { didChange.push_back(nodes); });
+  connection += uncoalescedNodesDidChangeNotifier.connect(
+    [&](const auto& nodes) { uncoalescedDidChange.push_back(nodes); });
+
+  auto batch = NodeChangeBatch{
+    nodesWillChangeNotifier, nodesDidChangeNotifier, uncoalescedNodesDidChangeNotifier};
+
+  auto groupNode = mdl::GroupNode{mdl::Group{"group"}};
+  auto* entityNode1 = new mdl::EntityNode{mdl::Entity{}};
+  auto* entityNode2 = new mdl::EntityNode{mdl::Entity{}};
+  groupNode.addChildren({entityNode1, entityNode2});
+
+  const auto nodes1 = std::vector<mdl::Node*>{entityNode1};
+  const auto nodes2 = std::vector<mdl::Node*>{entityNode1, entityNode2};
+  const auto nodes3 = std::vector<mdl::Node*>{&groupNode};
+
+  SECTION("Notifications are delivered immediately outside of a scope")
+  {
+    batch.nodesWillChange(nodes1);
+    CHECK(willChange == std::vector<std::vector<mdl::Node*>>{nodes1});
+
+    batch.nodesDidChange(nodes1);
+    CHECK(didChange == std::vector<std::vector<mdl::Node*>>{nodes1});
+
+    CHECK(batch.stats() == NodeChangeStats{2, 2, 2});
+  }
+
+  SECTION("Notifications are coalesced in a oneshot scope")
+  {
+    batch.begin(TransactionScope::Oneshot);
+    CHECK(batch.coalescing());
+
+    {
+      const auto notifyChange = NotifyNodeChange{batch, nodes1};
+    }
+    {
+      const auto notifyChange = NotifyNodeChange{batch, nodes2};
+    }
+    CHECK(willChange == std::vector<std::vector<mdl::Node*>>{nodes1, {entityNode2}});
+    CHECK(didChange.empty());
+    CHECK(uncoalescedDidChange == std::vector<std::vector<mdl::Node*>>{nodes1, nodes2});
+
+    batch.begin(TransactionScope::Oneshot);
+    {
+      const auto notifyChange = NotifyNodeChange{batch, nodes3};
+    }
+    batch.end();
+    CHECK(didChange.empty());
+
+    batch.end();
+    CHECK_FALSE(batch.coalescing());
+    CHECK(
+      willChange
+      == std::vector<std::vector<mdl::Node*>>{nodes1, {entityNode2}, nodes3});
+    CHECK(
+      didChange
+      == std::vector<std::vector<mdl::Node*>>{{entityNode1, entityNode2, &groupNode}});
+
+    CHECK(batch.stats() == NodeChangeStats{6, 4, 4});
+  }
+
+  SECTION("Notifications are not coalesced in a long running scope")
+  {
+    batch.begin(TransactionScope::LongRunning);
+    CHECK_FALSE(batch.coalescing());
+
+    {
+      const auto notifyChange = NotifyNodeChange{batch, nodes1};
+    }
+    CHECK(didChange == std::vector<std::vector<mdl::Node*>>{nodes1});
+
+    batch.begin(TransactionScope::Oneshot);
+    {
+      const auto notifyChange = NotifyNodeChange{batch, nodes1};
+    }
+    {
+      const auto notifyChange = NotifyNodeChange{batch, nodes1};
+    }
+    CHECK(didChange == std::vector<std::vector<mdl::Node*>>{nodes1});
+
+    batch.end();
+    CHECK(didChange == std::vector<std::vector<mdl::Node*>>{nodes1, nodes1});
+
+    batch.end();
+    CHECK(didChange == std::vector<std::vector<mdl::Node*>>{nodes1, nodes1});
+  }
+
+  SECTION("Removed nodes are delivered before they are removed")
+  {
+    batch.begin(TransactionScope::Oneshot);
+
+    {
+      const auto notifyChange = NotifyNodeChange{batch, nodes2};
+    }
+    {
+      const auto notifyChange = NotifyNodeChange{batch, nodes3};
+    }
+    CHECK(didChange.empty());
+
+    batch.nodesWillBeRemoved(nodes1);
+    CHECK(didChange == std::vector<std::vector<mdl::Node*>>{nodes1});
+
+    batch.end();
+    CHECK(
+      didChange
+      == std::vector<std::vector<mdl::Node*>>{nodes1, {entityNode2, &groupNode}});
+  }
+
+  SECTION("Stats are reset when the outermost scope begins")
+  {
+    batch.nodesWillChange(nodes1);
+    batch.nodesDidChange(nodes1);
+
+    batch.begin(TransactionScope::Oneshot);
+    CHECK(batch.stats() == NodeChangeStats{});
+    batch.end();
+  }
+}
+
+} // namespace tb::ui
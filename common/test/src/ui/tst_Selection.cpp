@@ -588,6 +588,54 @@ TEST_CASE_METHOD(MapDocumentTest, "SelectionTest.updateLastSelectionBounds")
   CHECK(document->lastSelectionBounds() == bounds);
 }
 
+TEST_CASE_METHOD(MapDocumentTest, "SelectionTest.selectionBounds")
+{
+  auto builder =
+    mdl::BrushBuilder{document->world()->mapFormat(), document->worldBounds()};
+  const auto createBrush = [&](const vm::bbox3d& bounds) {
+    return new mdl::BrushNode{builder.createCuboid(bounds, "material") | kdl::value()};
+  };
+
+  auto* leftBrushNode = createBrush(vm::bbox3d{{-64, -16, -16}, {-32, 16, 16}});
+  auto* centerBrushNode = createBrush(vm::bbox3d{{-16, -8, -8}, {16, 8, 8}});
+  auto* rightBrushNode = createBrush(vm::bbox3d{{32, -16, -16}, {64, 16, 16}});
+  document->addNodes(
+    {{document->parentForNodes(), {leftBrushNode, centerBrushNode, rightBrushNode}}});
+
+  document->selectNodes({centerBrushNode});
+  CHECK(document->selectionBounds() == centerBrushNode->logicalBounds());
+
+  document->selectNodes({leftBrushNode, rightBrushNode});
+  CHECK(document->selectionBounds() == vm::bbox3d{{-64, -16, -16}, {64, 16, 16}});
+
+  SECTION("Deselecting an enclosed node keeps the bounds")
+  {
+    document->deselectNodes({centerBrushNode});
+    CHECK(document->selectionBounds() == vm::bbox3d{{-64, -16, -16}, {64, 16, 16}});
+  }
+
+  SECTION("Deselecting a node on the boundary shrinks the bounds")
+  {
+    document->deselectNodes({leftBrushNode});
+    CHECK(document->selectionBounds() == vm::bbox3d{{-16, -16, -16}, {64, 16, 16}});
+
+    document->deselectNodes({rightBrushNode});
+    CHECK(document->selectionBounds() == centerBrushNode->logicalBounds());
+  }
+
+  SECTION("Undoing a selection restores the bounds")
+  {
+    document->undoCommand();
+    CHECK(document->selectionBounds() == centerBrushNode->logicalBounds());
+  }
+
+  SECTION("Translating the selection updates the bounds")
+  {
+    document->translateObjects(vm::vec3d{0, 0, 16});
+    CHECK(document->selectionBounds() == vm::bbox3d{{-64, -16, 0}, {64, 16, 32}});
+  }
+}
+
 TEST_CASE_METHOD(
   MapDocumentTest, "SelectionCommandTest.faceSelectionUndoAfterTranslationUndo")
 {
@@ -30,6 +30,7 @@
 #include "mdl/TestGame.h" // IWYU pragma: keep
 #include "mdl/Texture.h"
 #include "ui/MapDocumentTest.h"
+#include "ui/Transaction.h"
 
 #include "kdl/vector_utils.h"
 
@@ -588,6 +589,28 @@ TEST_CASE_METHOD(MapDocumentTest, "TagManagementTest")
     CHECK(brushNode->hasTag(tag));
   }
 
+  SECTION("tagUpdateBrushTagsInTransaction")
+  {
+    auto* brushNode = createBrushNode("some_material");
+    document->addNodes({{document->parentForNodes(), {brushNode}}});
+
+    auto* entityNode = new mdl::EntityNode{mdl::Entity{{
+      {"classname", "brush_entity"},
+    }}};
+    document->addNodes({{document->parentForNodes(), {entityNode}}});
+
+    const auto& tag = document->smartTag("entity");
+
+    // the node change notifications are coalesced, but the tags must be updated by
+    // every command so that the following commands see them
+    auto transaction = Transaction{document};
+    document->reparentNodes({{entityNode, {brushNode}}});
+    CHECK(brushNode->hasTag(tag));
+
+    transaction.commit();
+    CHECK(brushNode->hasTag(tag));
+  }
+
   SECTION("tagUpdateBrushTagsAfterReparenting")
   {
     auto* lightEntityNode = new mdl::EntityNode{mdl::Entity{{
@@ -20,10 +20,13 @@
 #include "MapDocumentTest.h"
 #include "mdl/Entity.h"
 #include "mdl/EntityNode.h"
+#include "mdl/WorldNode.h"
 #include "ui/Transaction.h"
 
 #include "vm/mat_ext.h"
 
+#include <vector>
+
 #include "Catch2.h"
 
 namespace tb::ui
@@ -86,4 +89,32 @@ TEST_CASE_METHOD(MapDocumentTest, "Transaction")
   }
 }
 
+TEST_CASE_METHOD(MapDocumentTest, "Transaction.coalesceNodeChangeNotifications")
+{
+  auto* entityNode = new mdl::EntityNode{mdl::Entity{}};
+  document->addNodes({{document->parentForNodes(), {entityNode}}});
+  document->selectNodes({entityNode});
+
+  auto nodesDidChange = std::vector<std::vector<mdl::Node*>>{};
+  auto connection = document->nodesDidChangeNotifier.connect(
+    [&](const auto& nodes) { nodesDidChange.push_back(nodes); });
+
+  auto transaction = Transaction{document};
+  document->transformObjects("translate", vm::translation_matrix(vm::vec3d{1, 0, 0}));
+  document->transformObjects("translate", vm::translation_matrix(vm::vec3d{1, 0, 0}));
+
+  CHECK(nodesDidChange.empty());
+
+  transaction.commit();
+
+  REQUIRE(nodesDidChange.size() == 1);
+  CHECK_THAT(
+    nodesDidChange.front(),
+    Catch::UnorderedEquals(std::vector<mdl::Node*>{
+      entityNode, document->parentForNodes(), document->world()}));
+
+  const auto& stats = document->nodeChangeStats();
+  CHECK(stats.deliveredNotifications < stats.requestedNotifications);
+}
+
 } // namespace tb::ui
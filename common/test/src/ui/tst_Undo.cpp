@@ -27,6 +27,12 @@
 #include "mdl/MaterialManager.h"
 #include "ui/MapDocument.h"
 #include "ui/MapDocumentTest.h"
+#include "ui/TransactionScope.h"
+
+#include "kdl/vector_utils.h"
+
+#include "vm/scalar.h"
+#include "vm/vec.h"
 
 #include <cassert>
 
@@ -116,4 +122,70 @@ TEST_CASE_METHOD(MapDocumentTest, "UndoTest.undoRotation")
   CHECK(!entityNode->entity().hasProperty("angle"));
 }
 
+
+TEST_CASE_METHOD(MapDocumentTest, "UndoTest.undoVertexMoves")
+{
+  auto* brushNode = createBrushNode();
+  document->addNodes({{document->parentForNodes(), {brushNode}}});
+  document->selectNodes({brushNode});
+
+  const auto originalBrush = brushNode->brush();
+
+  // like dragging a vertex, the commands are collated
+  document->startTransaction("Move Vertices", TransactionScope::Oneshot);
+  REQUIRE(document->moveVertices({vm::vec3d::fill(16.0)}, vm::vec3d::fill(-8.0)).success);
+  REQUIRE(document->moveVertices({vm::vec3d::fill(8.0)}, vm::vec3d::fill(4.0)).success);
+  document->commitTransaction();
+
+  const auto secondBrush = brushNode->brush();
+  REQUIRE(secondBrush != originalBrush);
+
+  document->undoCommand();
+  CHECK(brushNode->brush() == originalBrush);
+  CHECK(brushNode->brush().vertexPositions() == originalBrush.vertexPositions());
+
+  document->redoCommand();
+  CHECK(brushNode->brush() == secondBrush);
+  CHECK(brushNode->brush().vertexPositions() == secondBrush.vertexPositions());
+}
+
+TEST_CASE_METHOD(MapDocumentTest, "UndoTest.undoOffGridVertexMovesOfRotatedBrush")
+{
+  auto* brushNode = createBrushNode();
+  document->addNodes({{document->parentForNodes(), {brushNode}}});
+  document->selectNodes({brushNode});
+
+  // rotated brushes are transformed in place, so their vertices are not computed from
+  // their faces
+  REQUIRE(document->rotateObjects(
+    vm::vec3d{0, 0, 0}, vm::normalize(vm::vec3d{1, 2, 3}), vm::to_radians(17.0)));
+
+  const auto originalBrush = brushNode->brush();
+  const auto vertex = originalBrush.vertexPositions().front();
+  const auto delta = vm::vec3d{-3.3, 1.7, -2.9};
+
+  document->startTransaction("Move Vertices", TransactionScope::Oneshot);
+  REQUIRE(document->moveVertices({vertex}, delta).success);
+
+  const auto oppositeVertex = brushNode->brush().findClosestVertexPosition(
+    2.0 * originalBrush.bounds().center() - vertex);
+  REQUIRE(document->moveVertices({oppositeVertex}, -delta).success);
+  document->commitTransaction();
+
+  const auto secondBrush = brushNode->brush();
+  REQUIRE(secondBrush != originalBrush);
+
+  document->undoCommand();
+  CHECK(brushNode->brush() == originalBrush);
+  CHECK(
+    kdl::vec_sort(brushNode->brush().vertexPositions())
+    == kdl::vec_sort(originalBrush.vertexPositions()));
+
+  document->redoCommand();
+  CHECK(brushNode->brush() == secondBrush);
+  CHECK(
+    kdl::vec_sort(brushNode->brush().vertexPositions())
+    == kdl::vec_sort(secondBrush.vertexPositions()));
+}
+
 } // namespace tb::ui
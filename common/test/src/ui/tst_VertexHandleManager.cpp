@@ -0,0 +1,283 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PreferenceManager.h"
+#include "Preferences.h"
+#include "mdl/BrushBuilder.h"
+#include "mdl/BrushNode.h"
+#include "mdl/Hit.h"
+#include "mdl/MapFormat.h"
+#include "mdl/PickResult.h"
+#include "render/OrthographicCamera.h"
+#include "render/PerspectiveCamera.h"
+#include "ui/Grid.h"
+#include "ui/Lasso.h"
+#include "ui/VertexHandleManager.h"
+
+#include "kdl/result.h"
+#include "kdl/vector_utils.h"
+
+#include "vm/bbox.h"
+#include "vm/vec.h"
+
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace tb::ui
+{
+namespace
+{
+
+const auto worldBounds = vm::bbox3d{8192.0};
+
+std::vector<std::unique_ptr<mdl::BrushNode>> createBrushNodes(
+  const size_t count, const double spacing)
+{
+  auto builder = mdl::BrushBuilder{mdl::MapFormat::Quake3, worldBounds};
+
+  auto result = std::vector<std::unique_ptr<mdl::BrushNode>>{};
+  for (size_t x = 0; x < count; ++x)
+  {
+    for (size_t y = 0; y < count; ++y)
+    {
+      const auto min = vm::vec3d{double(x) * spacing, double(y) * spacing, 0.0};
+      result.push_back(std::make_unique<mdl::BrushNode>(
+        builder.createCuboid(vm::bbox3d{min, min + vm::vec3d{16, 16, 16}}, "material")
+        | kdl::value()));
+    }
+  }
+  return result;
+}
+
+template <typename H>
+std::vector<H> hitTargets(const mdl::PickResult& pickResult)
+{
+  return kdl::vec_transform(
+    pickResult.all(), [](const auto& hit) { return hit.template target<H>(); });
+}
+
+} // namespace
+
+TEST_CASE("VertexHandleManagerTest.addAndRemoveHandles")
+{
+  auto builder = mdl::BrushBuilder{mdl::MapFormat::Quake3, worldBounds};
+  auto brushNode1 = mdl::BrushNode{
+    builder.createCuboid(vm::bbox3d{{0, 0, 0}, {16, 16, 16}}, "material")
+    | kdl::value()};
+  auto brushNode2 = mdl::BrushNode{
+    builder.createCuboid(vm::bbox3d{{16, 0, 0}, {32, 16, 16}}, "material")
+    | kdl::value()};
+
+  auto manager = VertexHandleManager{};
+  manager.addHandles(&brushNode1);
+  manager.addHandles(&brushNode2);
+
+  CHECK(manager.totalHandleCount() == 12u);
+  CHECK(manager.contains(vm::vec3d{16, 0, 0}));
+  CHECK_THAT(
+    manager.findIncidentBrushes(vm::vec3d{16, 0, 0}),
+    Catch::UnorderedEquals(std::vector<mdl::BrushNode*>{&brushNode1, &brushNode2}));
+  CHECK(
+    manager.findIncidentBrushes(vm::vec3d{0, 0, 0})
+    == std::vector<mdl::BrushNode*>{&brushNode1});
+  CHECK(manager.findIncidentBrushes(vm::vec3d{8, 0, 0}).empty());
+
+  manager.select(vm::vec3d{16, 0, 0});
+  manager.select(vm::vec3d{0, 0, 0});
+  CHECK(manager.selectedHandleCount() == 2u);
+
+  manager.removeHandles(&brushNode1);
+
+  CHECK(manager.totalHandleCount() == 8u);
+  CHECK_FALSE(manager.contains(vm::vec3d{0, 0, 0}));
+  CHECK(manager.selectedHandles() == std::vector<vm::vec3d>{{16, 0, 0}});
+  CHECK(
+    manager.findIncidentBrushes(vm::vec3d{16, 0, 0})
+    == std::vector<mdl::BrushNode*>{&brushNode2});
+
+  manager.removeHandles(&brushNode2);
+  CHECK(manager.totalHandleCount() == 0u);
+  CHECK(manager.selectedHandleCount() == 0u);
+}
+
+TEST_CASE("VertexHandleManagerTest.selectCloseHandles")
+{
+  auto builder = mdl::BrushBuilder{mdl::MapFormat::Quake3, worldBounds};
+  auto brushNode = mdl::BrushNode{
+    builder.createCuboid(vm::bbox3d{{-16, -16, -16}, {0, 0, 0}}, "material")
+    | kdl::value()};
+
+  auto manager = VertexHandleManager{};
+  manager.addHandles(&brushNode);
+
+  manager.select(vm::vec3d{0.0000001, -0.0000001, 0});
+  CHECK(manager.selectedHandles() == std::vector<vm::vec3d>{{0, 0, 0}});
+
+  manager.deselect(vm::vec3d{-0.0000001, 0, 0.0000001});
+  CHECK_FALSE(manager.anySelected());
+
+  manager.select(vm::vec3d{0.1, 0, 0});
+  CHECK_FALSE(manager.anySelected());
+}
+
+TEST_CASE("VertexHandleManagerTest.pick")
+{
+  const auto brushNodes = createBrushNodes(10, 48.0);
+  const auto handleRadius = double(pref(Preferences::HandleRadius));
+
+  auto perspectiveCamera = render::PerspectiveCamera{
+    90.0f,
+    1.0f,
+    8192.0f,
+    render::Camera::Viewport{0, 0, 800, 600},
+    vm::vec3f{-128, -128, 256},
+    vm::normalize(vm::vec3f{1, 1, -1}),
+    vm::normalize(vm::vec3f{1, 1, 2})};
+  auto orthographicCamera = render::OrthographicCamera{
+    1.0f,
+    8192.0f,
+    render::Camera::Viewport{0, 0, 800, 600},
+    vm::vec3f{200, 200, 1024},
+    vm::vec3f{0, 0, -1},
+    vm::vec3f{0, 1, 0}};
+  orthographicCamera.setZoom(0.5f);
+
+  const auto useOrthographicCamera = GENERATE(false, true);
+  const auto* camera = useOrthographicCamera
+                         ? static_cast<const render::Camera*>(&orthographicCamera)
+                         : static_cast<const render::Camera*>(&perspectiveCamera);
+
+  SECTION("Vertex handles")
+  {
+    auto manager = VertexHandleManager{};
+    for (const auto& brushNode : brushNodes)
+    {
+      manager.addHandles(brushNode.get());
+    }
+
+    for (const auto& handle : manager.allHandles())
+    {
+      const auto pickRay = vm::ray3d{camera->pickRay(vm::vec3f{handle})};
+
+      auto expected = std::vector<vm::vec3d>{};
+      for (const auto& other : manager.allHandles())
+      {
+        if (camera->pickPointHandle(pickRay, other, handleRadius))
+        {
+          expected.push_back(other);
+        }
+      }
+
+      auto pickResult = mdl::PickResult{};
+      manager.pick(pickRay, *camera, pickResult);
+
+      CHECK_THAT(hitTargets<vm::vec3d>(pickResult), Catch::UnorderedEquals(expected));
+      CHECK(kdl::vec_contains(expected, handle));
+    }
+  }
+
+  SECTION("Edge grid handles")
+  {
+    const auto grid = Grid{2};
+
+    auto manager = EdgeHandleManager{};
+    for (const auto& brushNode : brushNodes)
+    {
+      manager.addHandles(brushNode.get());
+    }
+
+    for (const auto& handle : manager.allHandles())
+    {
+      const auto point = handle.start() * 0.75 + handle.end() * 0.25;
+      const auto pickRay = vm::ray3d{camera->pickRay(vm::vec3f{point})};
+
+      auto expected = std::vector<vm::segment3d>{};
+      for (const auto& other : manager.allHandles())
+      {
+        if (
+          const auto edgeDist =
+            camera->pickLineSegmentHandle(pickRay, other, handleRadius))
+        {
+          if (
+            const auto pointHandle =
+              grid.snap(vm::point_at_distance(pickRay, *edgeDist), other))
+          {
+            if (camera->pickPointHandle(pickRay, *pointHandle, handleRadius))
+            {
+              expected.push_back(other);
+            }
+          }
+        }
+      }
+
+      auto pickResult = mdl::PickResult{};
+      manager.pickGridHandle(pickRay, *camera, grid, pickResult);
+
+      const auto actual = kdl::vec_transform(
+        hitTargets<EdgeHandleManager::HitType>(pickResult),
+        [](const auto& hit) { return std::get<0>(hit); });
+      CHECK_THAT(actual, Catch::UnorderedEquals(expected));
+    }
+  }
+}
+
+TEST_CASE("VertexHandleManagerTest.findHandles")
+{
+  const auto brushNodes = createBrushNodes(10, 48.0);
+
+  auto manager = VertexHandleManager{};
+  for (const auto& brushNode : brushNodes)
+  {
+    manager.addHandles(brushNode.get());
+  }
+
+  const auto camera = render::PerspectiveCamera{
+    90.0f,
+    1.0f,
+    8192.0f,
+    render::Camera::Viewport{0, 0, 800, 600},
+    vm::vec3f{-128, -128, 256},
+    vm::normalize(vm::vec3f{1, 1, -1}),
+    vm::normalize(vm::vec3f{1, 1, 2})};
+
+  auto lasso = Lasso{camera, 64.0, vm::vec3d{camera.defaultPoint(64.0f)}};
+  lasso.update(
+    vm::vec3d{camera.defaultPoint(64.0f) + 16.0f * camera.right() + 8.0f * camera.up()});
+
+  const auto allHandles = manager.allHandles();
+  auto expected = std::vector<vm::vec3d>{};
+  lasso.selected(
+    std::begin(allHandles), std::end(allHandles), std::back_inserter(expected));
+  REQUIRE_FALSE(expected.empty());
+  REQUIRE(expected.size() < allHandles.size());
+
+  const auto candidates = manager.findHandles(
+    [&](const vm::bbox3d& bounds) { return lasso.intersects(bounds); });
+  CHECK(candidates.size() < allHandles.size());
+
+  auto actual = std::vector<vm::vec3d>{};
+  lasso.selected(
+    std::begin(candidates), std::end(candidates), std::back_inserter(actual));
+  CHECK_THAT(actual, Catch::UnorderedEquals(expected));
+}
+
+} // namespace tb::ui
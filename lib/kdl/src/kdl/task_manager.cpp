@@ -82,4 +82,9 @@ task_manager::~task_manager()
   }
 }
 
+std::size_t task_manager::worker_count() const
+{
+  return m_workers.size();
+}
+
 } // namespace kdl
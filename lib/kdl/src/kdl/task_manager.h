@@ -54,6 +54,8 @@ public:
 
   ~task_manager();
 
+  std::size_t worker_count() const;
+
   template <typename task_result>
   auto run_task(std::function<task_result()> task)
   {
@@ -53,6 +53,7 @@ TEST_CASE("task_manager")
   CAPTURE(max_concurrent_tasks);
 
   auto tm = task_manager{max_concurrent_tasks};
+  CHECK(tm.worker_count() == max_concurrent_tasks);
 
   SECTION("run_task")
   {